@@ -0,0 +1,26 @@
+#include "vepch.h"
+#include "BenchContext.h"
+
+namespace VoxelicousBench
+{
+    HeadlessContext* GetHeadlessContext()
+    {
+        static std::unique_ptr<HeadlessContext> context = []() -> std::unique_ptr<HeadlessContext>
+        {
+            try
+            {
+                auto created = std::make_unique<HeadlessContext>();
+                created->Instance = std::make_unique<VoxelicousEngine::Instance>(true);
+                created->Device = std::make_unique<VoxelicousEngine::Device>(
+                    created->Instance->Get(), VK_NULL_HANDLE);
+                return created;
+            }
+            catch (const std::exception& e)
+            {
+                VE_CORE_ERROR("Failed to create headless Vulkan device: {}", e.what());
+                return nullptr;
+            }
+        }();
+        return context.get();
+    }
+}
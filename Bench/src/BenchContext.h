@@ -0,0 +1,17 @@
+#pragma once
+
+#include "Renderer/Device.h"
+#include "Renderer/Instance.h"
+
+namespace VoxelicousBench
+{
+    // Headless Vulkan instance and device shared by all renderer benchmarks. Created on first use;
+    // nullptr when no Vulkan implementation is available (benchmarks then skip themselves).
+    struct HeadlessContext
+    {
+        std::unique_ptr<VoxelicousEngine::Instance> Instance;
+        std::unique_ptr<VoxelicousEngine::Device> Device;
+    };
+
+    HeadlessContext* GetHeadlessContext();
+}
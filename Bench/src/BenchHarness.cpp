@@ -0,0 +1,190 @@
+#include "BenchHarness.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+
+namespace VoxelicousBench
+{
+    namespace
+    {
+        struct Registration
+        {
+            const char* Name;
+            BenchmarkFn Fn;
+        };
+
+        std::vector<Registration>& GetRegistry()
+        {
+            static std::vector<Registration> registry;
+            return registry;
+        }
+
+        double TimeBatchNs(const std::function<void(uint64_t)>& batch, const uint64_t iterations)
+        {
+            const auto begin = std::chrono::steady_clock::now();
+            batch(iterations);
+            const auto end = std::chrono::steady_clock::now();
+            return std::chrono::duration<double, std::nano>(end - begin).count();
+        }
+
+        bool WriteJson(const std::string& filePath, const std::vector<BenchResult>& results)
+        {
+            std::ofstream file{filePath};
+            if (!file.is_open())
+            {
+                std::fprintf(stderr, "Failed to open %s\n", filePath.c_str());
+                return false;
+            }
+
+            file << "{\n  \"benchmarks\": [";
+            for (size_t i = 0; i < results.size(); i++)
+            {
+                const BenchResult& result = results[i];
+                file << (i == 0 ? "\n" : ",\n") << "    {\"name\": \"" << result.Name << "\"";
+                if (result.Skipped)
+                {
+                    file << ", \"skipped\": true, \"reason\": \"" << result.SkipReason << "\"}";
+                    continue;
+                }
+                if (result.Failed)
+                {
+                    file << ", \"failed\": true, \"reason\": \"" << result.FailReason << "\"}";
+                    continue;
+                }
+                file << ", \"iterations\": " << result.Iterations
+                    << ", \"repetitions\": " << result.Repetitions
+                    << ", \"mean_ns\": " << result.MeanNs
+                    << ", \"median_ns\": " << result.MedianNs
+                    << ", \"stddev_ns\": " << result.StdDevNs
+                    << ", \"min_ns\": " << result.MinNs
+                    << ", \"max_ns\": " << result.MaxNs
+                    << ", \"items_per_iteration\": " << result.ItemsPerIteration;
+                if (!result.Counters.empty())
+                {
+                    file << ", \"counters\": {";
+                    for (size_t counter = 0; counter < result.Counters.size(); counter++)
+                    {
+                        file << (counter == 0 ? "" : ", ") << "\"" << result.Counters[counter].first << "\": "
+                            << result.Counters[counter].second;
+                    }
+                    file << "}";
+                }
+                file << "}";
+            }
+            file << "\n  ]\n}\n";
+            return true;
+        }
+    }
+
+    void State::RunBatches(const std::function<void(uint64_t)>& batch)
+    {
+        // Warm-up: caches, branch predictors, lazily allocated memory and CPU clocks
+        const auto warmupEnd = std::chrono::steady_clock::now() +
+            std::chrono::duration<double, std::milli>(m_Options.WarmupMs);
+        while (std::chrono::steady_clock::now() < warmupEnd)
+        {
+            batch(1);
+        }
+
+        uint64_t iterations = 1;
+        while (TimeBatchNs(batch, iterations) < m_Options.MinRepetitionMs * 1e6 && iterations < (1ull << 40))
+        {
+            iterations *= 2;
+        }
+
+        std::vector<double> samples;
+        samples.reserve(m_Options.Repetitions);
+        for (uint32_t repetition = 0; repetition < m_Options.Repetitions; repetition++)
+        {
+            samples.push_back(TimeBatchNs(batch, iterations) / static_cast<double>(iterations));
+        }
+        std::sort(samples.begin(), samples.end());
+
+        double sum = 0.0;
+        for (const double sample : samples)
+        {
+            sum += sample;
+        }
+        const double mean = sum / static_cast<double>(samples.size());
+
+        double variance = 0.0;
+        for (const double sample : samples)
+        {
+            variance += (sample - mean) * (sample - mean);
+        }
+        variance /= samples.size() > 1 ? static_cast<double>(samples.size() - 1) : 1.0;
+
+        const size_t middle = samples.size() / 2;
+        m_Result.Iterations = iterations;
+        m_Result.Repetitions = static_cast<uint32_t>(samples.size());
+        m_Result.MeanNs = mean;
+        m_Result.MedianNs = samples.size() % 2 == 0 ? (samples[middle - 1] + samples[middle]) / 2.0 : samples[middle];
+        m_Result.StdDevNs = std::sqrt(variance);
+        m_Result.MinNs = samples.front();
+        m_Result.MaxNs = samples.back();
+    }
+
+    bool RegisterBenchmark(const char* name, const BenchmarkFn fn)
+    {
+        GetRegistry().push_back({name, fn});
+        return true;
+    }
+
+    int RunBenchmarks(const BenchOptions& options)
+    {
+        auto& registry = GetRegistry();
+        std::sort(registry.begin(), registry.end(), [](const Registration& a, const Registration& b)
+        {
+            return std::string(a.Name) < b.Name;
+        });
+
+        std::printf("%-40s %14s %14s %10s %14s\n", "benchmark", "median", "mean", "stddev", "items/s");
+
+        std::vector<BenchResult> results;
+        bool failed = false;
+        for (const auto& [name, fn] : registry)
+        {
+            if (!options.Filter.empty() && std::string(name).find(options.Filter) == std::string::npos)
+            {
+                continue;
+            }
+
+            BenchResult& result = results.emplace_back();
+            result.Name = name;
+
+            State state{options, result};
+            fn(state);
+
+            if (result.Skipped)
+            {
+                std::printf("%-40s skipped: %s\n", name, result.SkipReason.c_str());
+                continue;
+            }
+            if (result.Failed)
+            {
+                std::printf("%-40s FAILED: %s\n", name, result.FailReason.c_str());
+                failed = true;
+                continue;
+            }
+
+            const double itemsPerSecond = result.ItemsPerIteration > 0
+                                              ? static_cast<double>(result.ItemsPerIteration) / result.MedianNs * 1e9
+                                              : 0.0;
+            std::printf("%-40s %11.1f ns %11.1f ns %9.1f%% %14.4g\n", name, result.MedianNs, result.MeanNs,
+                        result.MeanNs > 0.0 ? result.StdDevNs / result.MeanNs * 100.0 : 0.0, itemsPerSecond);
+            for (const auto& [counter, value] : result.Counters)
+            {
+                std::printf("%-40s %s = %.4g\n", "", counter.c_str(), value);
+            }
+        }
+
+        if (!options.JsonOutput.empty() && !WriteJson(options.JsonOutput, results))
+        {
+            return 1;
+        }
+        return failed ? 1 : 0;
+    }
+}
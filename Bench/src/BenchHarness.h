@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace VoxelicousBench
+{
+    struct BenchOptions
+    {
+        uint32_t Repetitions = 10;
+        double WarmupMs = 50.0;
+        // Iterations per repetition are doubled until a repetition takes at least this long
+        double MinRepetitionMs = 10.0;
+        std::string Filter;
+        std::string JsonOutput;
+    };
+
+    struct BenchResult
+    {
+        std::string Name;
+        bool Skipped = false;
+        std::string SkipReason;
+        // A correctness check failed, the benchmark reports no timings and the run exits non-zero
+        bool Failed = false;
+        std::string FailReason;
+        uint64_t Iterations = 0;
+        uint32_t Repetitions = 0;
+        double MeanNs = 0.0;
+        double MedianNs = 0.0;
+        double StdDevNs = 0.0;
+        double MinNs = 0.0;
+        double MaxNs = 0.0;
+        // Items (vertices, events, ...) processed per iteration, used for throughput reporting
+        uint64_t ItemsPerIteration = 0;
+        // Named quality metrics (PSNR, ratios, ...) reported next to the timings
+        std::vector<std::pair<std::string, double>> Counters;
+    };
+
+    class State
+    {
+    public:
+        State(const BenchOptions& options, BenchResult& result) : m_Options{options}, m_Result{result}
+        {
+        }
+
+        // Warms up, calibrates and measures fn, which performs one iteration per call.
+        // Setup done before Run and teardown after it are not measured.
+        template <typename Fn>
+        void Run(Fn&& fn)
+        {
+            RunBatches([&fn](const uint64_t iterations)
+            {
+                for (uint64_t i = 0; i < iterations; i++)
+                {
+                    fn();
+                }
+            });
+        }
+
+        void SetItemsPerIteration(const uint64_t items) { m_Result.ItemsPerIteration = items; }
+        void SetCounter(const std::string& name, const double value) { m_Result.Counters.emplace_back(name, value); }
+
+        void Skip(const std::string& reason)
+        {
+            m_Result.Skipped = true;
+            m_Result.SkipReason = reason;
+        }
+
+        void Fail(const std::string& reason)
+        {
+            m_Result.Failed = true;
+            m_Result.FailReason = reason;
+        }
+
+    private:
+        void RunBatches(const std::function<void(uint64_t)>& batch);
+
+        const BenchOptions& m_Options;
+        BenchResult& m_Result;
+    };
+
+    using BenchmarkFn = void (*)(State&);
+
+    bool RegisterBenchmark(const char* name, BenchmarkFn fn);
+    int RunBenchmarks(const BenchOptions& options);
+
+    // Keeps the compiler from optimizing away a computed value
+    template <typename T>
+    void DoNotOptimize(const T& value)
+    {
+#if defined(_MSC_VER)
+        static volatile const void* sink;
+        sink = &value;
+        _ReadWriteBarrier();
+#else
+        asm volatile("" : : "r,m"(value) : "memory");
+#endif
+    }
+}
+
+#define VE_BENCHMARK(name) \
+    static void name(::VoxelicousBench::State& state); \
+    [[maybe_unused]] static const bool name##Registered = ::VoxelicousBench::RegisterBenchmark(#name, name); \
+    static void name(::VoxelicousBench::State& state)
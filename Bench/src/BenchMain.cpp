@@ -0,0 +1,38 @@
+#include "BenchHarness.h"
+
+#include "Core/Log.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// Usage: VoxelicousBench [--filter <substring>] [--json <file>] [--repetitions <n>] [--min-time <ms>]
+//                        [--warmup <ms>]
+int main(const int argc, char** argv)
+{
+    VoxelicousEngine::Log::Init();
+    VoxelicousEngine::Log::GetCoreLogger()->set_level(spdlog::level::warn);
+
+    VoxelicousBench::BenchOptions options;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        if (std::strcmp(argv[i], "--filter") == 0)
+            options.Filter = argv[i + 1];
+        else if (std::strcmp(argv[i], "--json") == 0)
+            options.JsonOutput = argv[i + 1];
+        else if (std::strcmp(argv[i], "--repetitions") == 0)
+            options.Repetitions = static_cast<uint32_t>(std::max(1, std::atoi(argv[i + 1])));
+        else if (std::strcmp(argv[i], "--min-time") == 0)
+            options.MinRepetitionMs = std::atof(argv[i + 1]);
+        else if (std::strcmp(argv[i], "--warmup") == 0)
+            options.WarmupMs = std::atof(argv[i + 1]);
+        else
+        {
+            std::fprintf(stderr, "Unknown option %s\n", argv[i]);
+            return 2;
+        }
+    }
+
+    return VoxelicousBench::RunBenchmarks(options);
+}
@@ -0,0 +1,213 @@
+#include "vepch.h"
+#include "BenchHarness.h"
+
+#include "Core/DeletionQueue.h"
+#include "Core/LinearArena.h"
+#include "Core/ResourcePool.h"
+#include "Core/Transform.h"
+#include "Events/AppEvent.h"
+#include "Events/KeyEvent.h"
+
+using namespace VoxelicousEngine;
+using VoxelicousBench::DoNotOptimize;
+
+VE_BENCHMARK(TransformComponent_Mat4)
+{
+    constexpr size_t count = 1024;
+    std::vector<TransformComponent> transforms(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        const auto f = static_cast<float>(i);
+        transforms[i].Translation = {f, f * 0.5f, -f};
+        transforms[i].Rotation = {f * 0.01f, f * 0.02f, f * 0.03f};
+        transforms[i].Scale = {1.0f, 2.0f, 1.0f};
+    }
+
+    state.SetItemsPerIteration(count);
+    state.Run([&]
+    {
+        for (const TransformComponent& transform : transforms)
+        {
+            DoNotOptimize(transform.Mat4());
+        }
+    });
+}
+
+VE_BENCHMARK(EventDispatcher_Match)
+{
+    WindowResizeEvent event(1280, 720);
+    uint64_t handled = 0;
+
+    state.Run([&]
+    {
+        EventDispatcher dispatcher(event);
+        dispatcher.Dispatch<WindowResizeEvent>([&handled](const WindowResizeEvent& e)
+        {
+            handled += e.GetWidth();
+            return false;
+        });
+        DoNotOptimize(handled);
+    });
+}
+
+VE_BENCHMARK(EventDispatcher_Miss)
+{
+    KeyPressedEvent event(65, 0);
+    uint64_t handled = 0;
+
+    // Layers usually test an event against several types before one matches
+    state.Run([&]
+    {
+        EventDispatcher dispatcher(event);
+        dispatcher.Dispatch<WindowResizeEvent>([&handled](const WindowResizeEvent&)
+        {
+            handled++;
+            return true;
+        });
+        dispatcher.Dispatch<WindowCloseEvent>([&handled](const WindowCloseEvent&)
+        {
+            handled++;
+            return true;
+        });
+        DoNotOptimize(handled);
+    });
+}
+
+namespace
+{
+    struct DrawItemStandIn
+    {
+        const void* Model;
+        glm::mat4 ModelMatrix;
+    };
+
+    constexpr size_t DRAW_LIST_SIZE = 4096;
+}
+
+VE_BENCHMARK(DrawList_Heap)
+{
+    state.SetItemsPerIteration(DRAW_LIST_SIZE);
+    state.Run([&]
+    {
+        std::vector<DrawItemStandIn> drawList;
+        drawList.reserve(DRAW_LIST_SIZE);
+        for (size_t i = 0; i < DRAW_LIST_SIZE; i++)
+        {
+            drawList.push_back({&drawList, glm::mat4{1.0f}});
+        }
+        DoNotOptimize(drawList.data());
+    });
+}
+
+VE_BENCHMARK(DrawList_FrameArena)
+{
+    // Same work as DrawList_Heap, with the arena reset every iteration as the renderer does every frame
+    LinearArena arena;
+
+    state.SetItemsPerIteration(DRAW_LIST_SIZE);
+    state.Run([&]
+    {
+        arena.Reset();
+        ArenaVector<DrawItemStandIn> drawList{ArenaAllocator<DrawItemStandIn>(arena)};
+        drawList.reserve(DRAW_LIST_SIZE);
+        for (size_t i = 0; i < DRAW_LIST_SIZE; i++)
+        {
+            drawList.push_back({&drawList, glm::mat4{1.0f}});
+        }
+        DoNotOptimize(drawList.data());
+    });
+}
+
+namespace
+{
+    // Stand-in for a mesh resource: what a draw reads when resolving its reference
+    struct ResourceStandIn
+    {
+        glm::vec3 BoundsMin;
+        glm::vec3 BoundsMax;
+        uint32_t IndexCount;
+    };
+
+    constexpr uint32_t RESOURCE_COUNT = 256;
+    constexpr uint32_t OBJECT_COUNT = 65536;
+}
+
+// Building a draw list of object references and resolving them, with a shared_ptr per object as GameObject used
+// to hold (every copy is an atomic increment, every drop an atomic decrement) ...
+VE_BENCHMARK(ResourceReference_SharedPtr)
+{
+    std::vector<std::shared_ptr<ResourceStandIn>> resources;
+    for (uint32_t i = 0; i < RESOURCE_COUNT; i++)
+    {
+        resources.push_back(std::make_shared<ResourceStandIn>(ResourceStandIn{{}, {}, i}));
+    }
+    std::vector<std::shared_ptr<ResourceStandIn>> objects;
+    for (uint32_t i = 0; i < OBJECT_COUNT; i++)
+    {
+        objects.push_back(resources[(i * 7919u) % RESOURCE_COUNT]);
+    }
+
+    std::vector<std::shared_ptr<ResourceStandIn>> drawList;
+    state.SetItemsPerIteration(OBJECT_COUNT);
+    state.Run([&]
+    {
+        drawList.assign(objects.begin(), objects.end());
+        uint64_t indexCount = 0;
+        for (const auto& resource : drawList)
+        {
+            indexCount += resource->IndexCount;
+        }
+        drawList.clear();
+        DoNotOptimize(indexCount);
+    });
+}
+
+// ... and with generational handles into a ResourcePool, as MeshComponent::Mesh does now
+VE_BENCHMARK(ResourceReference_Handle)
+{
+    ResourcePool<ResourceStandIn> resources;
+    std::vector<Handle<ResourceStandIn>> handles;
+    for (uint32_t i = 0; i < RESOURCE_COUNT; i++)
+    {
+        handles.push_back(resources.Create(ResourceStandIn{{}, {}, i}));
+    }
+    std::vector<Handle<ResourceStandIn>> objects;
+    for (uint32_t i = 0; i < OBJECT_COUNT; i++)
+    {
+        objects.push_back(handles[(i * 7919u) % RESOURCE_COUNT]);
+    }
+
+    std::vector<Handle<ResourceStandIn>> drawList;
+    state.SetItemsPerIteration(OBJECT_COUNT);
+    state.Run([&]
+    {
+        drawList.assign(objects.begin(), objects.end());
+        uint64_t indexCount = 0;
+        for (const auto handle : drawList)
+        {
+            indexCount += resources.Get(handle)->IndexCount;
+        }
+        drawList.clear();
+        DoNotOptimize(indexCount);
+    });
+}
+
+// Steady state of releasing resources every frame: each frame queues 256 and retires those of two frames ago
+VE_BENCHMARK(DeletionQueue_Frame)
+{
+    constexpr uint32_t releasesPerFrame = 256;
+    constexpr uint32_t framesInFlight = 2;
+    DeletionQueue queue;
+    uint64_t frameNumber = 0;
+
+    state.SetItemsPerIteration(releasesPerFrame);
+    state.Run([&]
+    {
+        queue.BeginFrame(++frameNumber, framesInFlight);
+        for (uint32_t i = 0; i < releasesPerFrame; i++)
+        {
+            queue.Destroy(std::make_unique<ResourceStandIn>());
+        }
+    });
+    queue.Flush();
+}
@@ -0,0 +1,693 @@
+#include "vepch.h"
+#include "BenchHarness.h"
+#include "BenchContext.h"
+
+#include "Assets/MeshOptimizer.h"
+#include "Assets/MeshPack.h"
+#include "Assets/ObjLoader.h"
+#include "Core/Model.h"
+#include "Renderer/Descriptors.h"
+#include "Renderer/GpuObjectTable.h"
+#include "Renderer/GpuProfiler.h"
+#include "Renderer/Pipeline.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+
+#ifdef VE_PLATFORM_LINUX
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace VoxelicousEngine;
+using VoxelicousBench::DoNotOptimize;
+using VoxelicousBench::GetHeadlessContext;
+
+namespace
+{
+    // 708x708 quads with uvs and normals, about 1M triangles and 40 MB of text
+    constexpr uint32_t GRID_SIZE = 708;
+
+    std::string WriteGridObj()
+    {
+        const std::string filePath = (std::filesystem::temp_directory_path() / "ve_bench_grid.obj").string();
+        std::FILE* file = std::fopen(filePath.c_str(), "w");
+        for (uint32_t y = 0; y <= GRID_SIZE; y++)
+        {
+            for (uint32_t x = 0; x <= GRID_SIZE; x++)
+            {
+                const float u = static_cast<float>(x) / GRID_SIZE;
+                const float v = static_cast<float>(y) / GRID_SIZE;
+                std::fprintf(file, "v %.6f %.6f %.6f\nvt %.6f %.6f\nvn 0.000000 1.000000 0.000000\n",
+                             u * 100.0f, 0.25f * static_cast<float>((x * 7 + y * 13) % 17), v * 100.0f, u, v);
+            }
+        }
+        for (uint32_t y = 0; y < GRID_SIZE; y++)
+        {
+            for (uint32_t x = 0; x < GRID_SIZE; x++)
+            {
+                const uint32_t a = y * (GRID_SIZE + 1) + x + 1;
+                const uint32_t b = a + 1;
+                const uint32_t c = a + GRID_SIZE + 1;
+                const uint32_t d = c + 1;
+                std::fprintf(file, "f %u/%u/%u %u/%u/%u %u/%u/%u\nf %u/%u/%u %u/%u/%u %u/%u/%u\n",
+                             a, a, a, c, c, c, b, b, b, b, b, b, c, c, c, d, d, d);
+            }
+        }
+        std::fclose(file);
+        return filePath;
+    }
+
+    // Drops the file from the page cache so the next load reads from disk. Only clean pages are dropped,
+    // which is all of them for files that were written and synced before the benchmark.
+    bool EvictFromPageCache(const std::string& filePath)
+    {
+#ifdef VE_PLATFORM_LINUX
+        const int file = open(filePath.c_str(), O_RDONLY);
+        if (file < 0)
+        {
+            return false;
+        }
+        fdatasync(file);
+        const bool evicted = posix_fadvise(file, 0, 0, POSIX_FADV_DONTNEED) == 0;
+        close(file);
+        return evicted;
+#else
+        (void)filePath;
+        return false;
+#endif
+    }
+
+    // Loads the way a Model does: open, then copy vertices and indices into (here simulated) staging memory
+    void LoadPackToStaging(const std::string& filePath, std::vector<std::byte>& staging)
+    {
+        MeshPack pack;
+        pack.Open(filePath);
+        const MeshView& mesh = pack.GetView();
+        staging.resize(mesh.Vertices.size_bytes() + mesh.Indices.size_bytes());
+        std::memcpy(staging.data(), mesh.Vertices.data(), mesh.Vertices.size_bytes());
+        std::memcpy(staging.data() + mesh.Vertices.size_bytes(), mesh.Indices.data(), mesh.Indices.size_bytes());
+        DoNotOptimize(staging.data());
+    }
+
+    void LoadObjToStaging(const std::string& filePath, std::vector<std::byte>& staging)
+    {
+        MeshData mesh;
+        ObjLoader::Load(filePath, mesh);
+        const size_t vertexBytes = mesh.Vertices.size() * sizeof(Vertex);
+        staging.resize(vertexBytes + mesh.Indices.size() * sizeof(uint32_t));
+        std::memcpy(staging.data(), mesh.Vertices.data(), vertexBytes);
+        std::memcpy(staging.data() + vertexBytes, mesh.Indices.data(), mesh.Indices.size() * sizeof(uint32_t));
+        DoNotOptimize(staging.data());
+    }
+
+    enum class MeshSource
+    {
+        Obj,
+        Pack,
+        CompressedPack
+    };
+
+    // Cold runs evict the file before every load, so they include the disk read (or its virtualized stand-in)
+    void RunMeshLoadBenchmark(VoxelicousBench::State& state, const MeshSource source, const bool cold)
+    {
+        std::string filePath = WriteGridObj();
+        if (source != MeshSource::Obj)
+        {
+            MeshData mesh;
+            ObjLoader::Load(filePath, mesh);
+            std::filesystem::remove(filePath);
+            filePath = (std::filesystem::temp_directory_path() / "ve_bench_grid.vemp").string();
+            MeshPack::Write(filePath, mesh.GetView(), source == MeshSource::CompressedPack);
+
+            const size_t meshBytes = mesh.Vertices.size() * sizeof(Vertex) + mesh.Indices.size() * sizeof(uint32_t);
+            state.SetCounter("compression_ratio",
+                             static_cast<double>(meshBytes) / static_cast<double>(std::filesystem::file_size(filePath)));
+        }
+
+        if (cold && !EvictFromPageCache(filePath))
+        {
+            std::filesystem::remove(filePath);
+            state.Skip("page cache eviction is not supported on this platform");
+            return;
+        }
+
+        std::vector<std::byte> staging;
+        state.SetItemsPerIteration(2ull * GRID_SIZE * GRID_SIZE);
+        state.Run([&]
+        {
+            if (cold)
+            {
+                EvictFromPageCache(filePath);
+            }
+            if (source == MeshSource::Obj)
+            {
+                LoadObjToStaging(filePath, staging);
+            }
+            else
+            {
+                LoadPackToStaging(filePath, staging);
+            }
+        });
+
+        std::filesystem::remove(filePath);
+    }
+
+    struct VertexHash
+    {
+        size_t operator()(const Vertex& vertex) const
+        {
+            size_t seed = 0;
+            const auto combine = [&seed](const float value)
+            {
+                seed ^= std::hash<float>{}(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+            };
+            for (int i = 0; i < 3; i++)
+            {
+                combine(vertex.Position[i]);
+                combine(vertex.Normal[i]);
+            }
+            combine(vertex.Uv[0]);
+            combine(vertex.Uv[1]);
+            return seed;
+        }
+    };
+
+    // What the loader replaced: stream parsing line by line and welding through std::unordered_map<Vertex>,
+    // the way the old tinyobjloader path did. Only handles the v/vt/vn corners the grid uses.
+    void LoadObjReference(const std::string& filePath, MeshData& mesh)
+    {
+        std::ifstream file{filePath};
+        std::vector<glm::vec3> positions;
+        std::vector<glm::vec2> uvs;
+        std::vector<glm::vec3> normals;
+        std::unordered_map<Vertex, uint32_t, VertexHash> uniqueVertices;
+        mesh.Clear();
+
+        std::string line;
+        while (std::getline(file, line))
+        {
+            std::istringstream stream{line};
+            std::string type;
+            stream >> type;
+            if (type == "v")
+            {
+                glm::vec3& position = positions.emplace_back();
+                stream >> position.x >> position.y >> position.z;
+            }
+            else if (type == "vt")
+            {
+                glm::vec2& uv = uvs.emplace_back();
+                stream >> uv.x >> uv.y;
+            }
+            else if (type == "vn")
+            {
+                glm::vec3& normal = normals.emplace_back();
+                stream >> normal.x >> normal.y >> normal.z;
+            }
+            else if (type == "f")
+            {
+                std::string corner;
+                while (stream >> corner)
+                {
+                    uint32_t p = 0, t = 0, n = 0;
+                    std::sscanf(corner.c_str(), "%u/%u/%u", &p, &t, &n);
+                    Vertex vertex{};
+                    vertex.Position = positions[p - 1];
+                    vertex.Color = glm::vec3{1.0f};
+                    vertex.Uv = uvs[t - 1];
+                    vertex.Normal = normals[n - 1];
+                    const auto [it, inserted] = uniqueVertices.try_emplace(vertex,
+                                                                          static_cast<uint32_t>(mesh.Vertices.size()));
+                    if (inserted)
+                    {
+                        mesh.Vertices.push_back(vertex);
+                    }
+                    mesh.Indices.push_back(it->second);
+                }
+            }
+        }
+    }
+
+    // A sphere with radial bumps, so it is not convex and has overdraw even with back faces culled.
+    // Triangles come in random order, the worst case an exporter or a naive merge can produce.
+    // Front faces are clockwise on screen when viewed along +z, matching the default pipeline config.
+    MeshData CreateShuffledBumpySphere(const uint32_t rings, const uint32_t segments)
+    {
+        MeshData mesh;
+        for (uint32_t ring = 0; ring <= rings; ring++)
+        {
+            for (uint32_t segment = 0; segment <= segments; segment++)
+            {
+                const float theta = 3.14159265f * static_cast<float>(ring) / static_cast<float>(rings);
+                const float phi = 6.28318531f * static_cast<float>(segment) / static_cast<float>(segments);
+                const float radius = 1.0f + 0.25f * std::sin(7.0f * theta) * std::sin(7.0f * phi);
+                const glm::vec3 direction{std::sin(theta) * std::cos(phi), std::cos(theta),
+                                          std::sin(theta) * std::sin(phi)};
+                Vertex vertex{};
+                vertex.Position = direction * radius;
+                vertex.Color = {0.5f, 0.5f, 0.5f};
+                vertex.Normal = direction;
+                mesh.Vertices.push_back(vertex);
+            }
+        }
+
+        std::vector<std::array<uint32_t, 3>> triangles;
+        for (uint32_t ring = 0; ring < rings; ring++)
+        {
+            for (uint32_t segment = 0; segment < segments; segment++)
+            {
+                const uint32_t a = ring * (segments + 1) + segment;
+                const uint32_t b = a + 1;
+                const uint32_t c = a + segments + 1;
+                const uint32_t d = c + 1;
+                triangles.push_back({a, c, b});
+                triangles.push_back({b, c, d});
+            }
+        }
+        std::ranges::shuffle(triangles, std::mt19937{42});
+        for (const auto& triangle : triangles)
+        {
+            mesh.Indices.insert(mesh.Indices.end(), triangle.begin(), triangle.end());
+        }
+        return mesh;
+    }
+
+    enum class MeshOrder
+    {
+        Unoptimized,
+        VertexCache,
+        VertexCacheAndOverdraw
+    };
+
+    MeshData CreateOptimizerBenchMesh(const MeshOrder order)
+    {
+        // 32k vertices, so the optimized and unoptimized meshes both get 16-bit indices
+        MeshData mesh = CreateShuffledBumpySphere(180, 180);
+        if (order != MeshOrder::Unoptimized)
+        {
+            MeshOptimizeSettings settings;
+            settings.ReduceOverdraw = order == MeshOrder::VertexCacheAndOverdraw;
+            MeshOptimizer::Optimize(mesh, settings);
+        }
+        return mesh;
+    }
+
+    void RunMeshOptimizerBenchmark(VoxelicousBench::State& state, const bool reduceOverdraw)
+    {
+        const MeshData source = CreateShuffledBumpySphere(180, 180);
+        const auto vertexCount = static_cast<uint32_t>(source.Vertices.size());
+        MeshOptimizeSettings settings;
+        settings.ReduceOverdraw = reduceOverdraw;
+        MeshData mesh;
+
+        state.SetItemsPerIteration(source.Indices.size() / 3);
+        state.Run([&]
+        {
+            mesh = source;
+            MeshOptimizer::Optimize(mesh, settings);
+            DoNotOptimize(mesh.Indices.data());
+        });
+
+        state.SetCounter("acmr_before", MeshOptimizer::ComputeAcmr(source.Indices, vertexCount));
+        state.SetCounter("acmr_after", MeshOptimizer::ComputeAcmr(mesh.Indices, vertexCount));
+    }
+
+    // Color and depth attachments to draw into without a window
+    class OffscreenTarget
+    {
+    public:
+        static constexpr uint32_t SIZE = 1024;
+
+        explicit OffscreenTarget(Device& device) : m_Device{device}
+        {
+            const VkFormat depthFormat = device.FindSupportedFormat(
+                {VK_FORMAT_D32_SFLOAT, VK_FORMAT_D32_SFLOAT_S8_UINT, VK_FORMAT_D24_UNORM_S8_UINT},
+                VK_IMAGE_TILING_OPTIMAL, VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT);
+            CreateAttachment(VK_FORMAT_R8G8B8A8_UNORM, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT,
+                             VK_IMAGE_ASPECT_COLOR_BIT, 0);
+            CreateAttachment(depthFormat, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
+                             VK_IMAGE_ASPECT_DEPTH_BIT, 1);
+
+            std::array<VkAttachmentDescription, 2> attachments{};
+            for (uint32_t i = 0; i < 2; i++)
+            {
+                attachments[i].format = i == 0 ? VK_FORMAT_R8G8B8A8_UNORM : depthFormat;
+                attachments[i].samples = VK_SAMPLE_COUNT_1_BIT;
+                attachments[i].loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+                attachments[i].storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+                attachments[i].stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+                attachments[i].stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+                attachments[i].initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+                attachments[i].finalLayout = i == 0
+                                                 ? VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL
+                                                 : VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+            }
+
+            constexpr VkAttachmentReference colorReference{0, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL};
+            constexpr VkAttachmentReference depthReference{1, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL};
+            VkSubpassDescription subpass{};
+            subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+            subpass.colorAttachmentCount = 1;
+            subpass.pColorAttachments = &colorReference;
+            subpass.pDepthStencilAttachment = &depthReference;
+
+            VkRenderPassCreateInfo renderPassInfo{};
+            renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+            renderPassInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
+            renderPassInfo.pAttachments = attachments.data();
+            renderPassInfo.subpassCount = 1;
+            renderPassInfo.pSubpasses = &subpass;
+            if (vkCreateRenderPass(device.GetDevice(), &renderPassInfo, nullptr, &m_RenderPass) != VK_SUCCESS)
+            {
+                throw std::runtime_error("failed to create offscreen render pass!");
+            }
+
+            VkFramebufferCreateInfo framebufferInfo{};
+            framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+            framebufferInfo.renderPass = m_RenderPass;
+            framebufferInfo.attachmentCount = static_cast<uint32_t>(m_Views.size());
+            framebufferInfo.pAttachments = m_Views.data();
+            framebufferInfo.width = SIZE;
+            framebufferInfo.height = SIZE;
+            framebufferInfo.layers = 1;
+            if (vkCreateFramebuffer(device.GetDevice(), &framebufferInfo, nullptr, &m_Framebuffer) != VK_SUCCESS)
+            {
+                throw std::runtime_error("failed to create offscreen framebuffer!");
+            }
+        }
+
+        ~OffscreenTarget()
+        {
+            vkDestroyFramebuffer(m_Device.GetDevice(), m_Framebuffer, nullptr);
+            vkDestroyRenderPass(m_Device.GetDevice(), m_RenderPass, nullptr);
+            for (uint32_t i = 0; i < 2; i++)
+            {
+                vkDestroyImageView(m_Device.GetDevice(), m_Views[i], nullptr);
+                vkDestroyImage(m_Device.GetDevice(), m_Images[i], nullptr);
+                vkFreeMemory(m_Device.GetDevice(), m_Memory[i], nullptr);
+            }
+        }
+
+        OffscreenTarget(const OffscreenTarget&) = delete;
+        OffscreenTarget& operator=(const OffscreenTarget&) = delete;
+
+        VkRenderPass GetRenderPass() const { return m_RenderPass; }
+
+        void BeginRenderPass(const VkCommandBuffer commandBuffer) const
+        {
+            std::array<VkClearValue, 2> clearValues{};
+            clearValues[1].depthStencil = {1.0f, 0};
+
+            VkRenderPassBeginInfo renderPassInfo{};
+            renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+            renderPassInfo.renderPass = m_RenderPass;
+            renderPassInfo.framebuffer = m_Framebuffer;
+            renderPassInfo.renderArea.extent = {SIZE, SIZE};
+            renderPassInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
+            renderPassInfo.pClearValues = clearValues.data();
+            vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+
+            const VkViewport viewport{0.0f, 0.0f, static_cast<float>(SIZE), static_cast<float>(SIZE), 0.0f, 1.0f};
+            const VkRect2D scissor{{0, 0}, {SIZE, SIZE}};
+            vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+            vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+        }
+
+    private:
+        void CreateAttachment(const VkFormat format, const VkImageUsageFlags usage,
+                              const VkImageAspectFlags aspect, const uint32_t index)
+        {
+            VkImageCreateInfo imageInfo{};
+            imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+            imageInfo.imageType = VK_IMAGE_TYPE_2D;
+            imageInfo.format = format;
+            imageInfo.extent = {SIZE, SIZE, 1};
+            imageInfo.mipLevels = 1;
+            imageInfo.arrayLayers = 1;
+            imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+            imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+            imageInfo.usage = usage;
+            imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+            imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+            m_Device.CreateImageWithInfo(imageInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_Images[index],
+                                         m_Memory[index]);
+
+            VkImageViewCreateInfo viewInfo{};
+            viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+            viewInfo.image = m_Images[index];
+            viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+            viewInfo.format = format;
+            viewInfo.subresourceRange = {aspect, 0, 1, 0, 1};
+            if (vkCreateImageView(m_Device.GetDevice(), &viewInfo, nullptr, &m_Views[index]) != VK_SUCCESS)
+            {
+                throw std::runtime_error("failed to create offscreen image view!");
+            }
+        }
+
+        Device& m_Device;
+        std::array<VkImage, 2> m_Images{};
+        std::array<VkDeviceMemory, 2> m_Memory{};
+        std::array<VkImageView, 2> m_Views{};
+        VkRenderPass m_RenderPass = VK_NULL_HANDLE;
+        VkFramebuffer m_Framebuffer = VK_NULL_HANDLE;
+    };
+
+    // Matches GlobalUbo in simple.vert
+    struct BenchUbo
+    {
+        glm::mat4 Projection{1.f};
+        glm::mat4 View{1.f};
+        glm::vec4 AmbientLightColor{1.f, 1.f, 1.f, .02f};
+        glm::vec3 LightPosition{0.f, 0.f, -2.f};
+        alignas(16) glm::vec4 LightColor{1.f};
+    };
+
+    // GPU time of drawing a 4x4 grid of the mesh into an offscreen target, measured with timestamp queries
+    // around the render pass. Identity camera: the meshes are scaled and pushed into the 0..1 depth range.
+    void RunMeshDrawBenchmark(VoxelicousBench::State& state, const MeshOrder order)
+    {
+        auto* context = GetHeadlessContext();
+        if (!context)
+        {
+            state.Skip("no Vulkan device");
+            return;
+        }
+        Device& device = *context->Device;
+
+        GpuProfiler profiler{device};
+        if (!profiler.IsSupported())
+        {
+            state.Skip("GPU timestamps are not supported");
+            return;
+        }
+        if (Pipeline::GetShaderManager().LoadShader("shaders/simple.vert", ShaderType::Vertex).empty())
+        {
+            state.Skip("shaders/simple.vert could not be loaded or compiled");
+            return;
+        }
+
+        constexpr uint32_t gridSize = 4;
+        constexpr uint32_t instanceCount = gridSize * gridSize;
+        const MeshData mesh = CreateOptimizerBenchMesh(order);
+        const Model model{device, mesh};
+
+        Buffer uboBuffer{
+            device, sizeof(BenchUbo), 1, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+        };
+        const BenchUbo ubo{};
+        uboBuffer.Map();
+        uboBuffer.WriteToBuffer(&ubo);
+
+        Buffer objectBuffer{
+            device, sizeof(GpuObjectData), instanceCount, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+        };
+        objectBuffer.Map();
+        for (uint32_t i = 0; i < instanceCount; i++)
+        {
+            constexpr float scale = 0.9f / gridSize;
+            GpuObjectData object{};
+            object.ModelMatrix[0][0] = scale;
+            object.ModelMatrix[1][1] = scale;
+            object.ModelMatrix[2][2] = scale;
+            object.ModelMatrix[3] = {
+                (static_cast<float>(i % gridSize) + 0.5f) * 2.0f / gridSize - 1.0f,
+                (static_cast<float>(i / gridSize) + 0.5f) * 2.0f / gridSize - 1.0f, 0.5f, 1.0f
+            };
+            objectBuffer.WriteToIndex(&object, static_cast<int>(i));
+        }
+
+        const auto setLayout = DescriptorSetLayout::Builder(device)
+                               .AddBinding(0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_SHADER_STAGE_ALL_GRAPHICS)
+                               .AddBinding(1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_VERTEX_BIT)
+                               .Build();
+        DescriptorAllocator allocator{device, 1};
+        const VkDescriptorBufferInfo uboInfo = uboBuffer.DescriptorInfo();
+        const VkDescriptorBufferInfo objectInfo = objectBuffer.DescriptorInfo();
+        VkDescriptorSet descriptorSet;
+        DescriptorWriter(*setLayout, allocator)
+            .WriteBuffer(0, &uboInfo)
+            .WriteBuffer(1, &objectInfo)
+            .Build(descriptorSet);
+
+        const OffscreenTarget target{device};
+        const std::array setLayouts{setLayout->GetDescriptorSetLayout()};
+        const VkPipelineLayout pipelineLayout = device.GetLayoutCache().GetPipelineLayout(setLayouts);
+        PipelineConfigInfo pipelineConfig{};
+        Pipeline::DefaultPipelineConfigInfo(pipelineConfig);
+        pipelineConfig.RenderPass = target.GetRenderPass();
+        pipelineConfig.PipelineLayout = pipelineLayout;
+        const Pipeline pipeline{device, "shaders/simple.vert", "shaders/simple.frag", pipelineConfig};
+
+        const auto submit = [&](const bool draw)
+        {
+            const VkCommandBuffer commandBuffer = device.BeginSingleTimeCommands();
+            // Collects the previous submission, which EndSingleTimeCommands waited for
+            profiler.BeginFrame(commandBuffer, 0);
+            if (draw)
+            {
+                GpuProfileScope scope{profiler, commandBuffer, "MeshDraw"};
+                target.BeginRenderPass(commandBuffer);
+                pipeline.Bind(commandBuffer);
+                vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1,
+                                        &descriptorSet, 0, nullptr);
+                model.Bind(commandBuffer);
+                model.Draw(commandBuffer, 0, instanceCount);
+                vkCmdEndRenderPass(commandBuffer);
+            }
+            device.EndSingleTimeCommands(commandBuffer);
+        };
+
+        state.SetItemsPerIteration(instanceCount * mesh.Indices.size() / 3);
+        state.Run([&]
+        {
+            submit(true);
+        });
+        submit(false);
+
+        state.SetCounter("acmr", MeshOptimizer::ComputeAcmr(mesh.Indices, static_cast<uint32_t>(mesh.Vertices.size())));
+        if (!profiler.GetResults().empty())
+        {
+            state.SetCounter("gpu_ms", profiler.GetResults().front().AverageGpuMs);
+        }
+    }
+}
+
+VE_BENCHMARK(ObjLoader_Grid1M)
+{
+    const std::string filePath = WriteGridObj();
+    MeshData mesh;
+
+    state.SetItemsPerIteration(2ull * GRID_SIZE * GRID_SIZE);
+    state.Run([&]
+    {
+        ObjLoader::Load(filePath, mesh);
+        DoNotOptimize(mesh.Indices.data());
+    });
+
+    std::filesystem::remove(filePath);
+}
+
+VE_BENCHMARK(ObjLoader_Grid1M_Reference)
+{
+    const std::string filePath = WriteGridObj();
+    MeshData mesh;
+
+    state.SetItemsPerIteration(2ull * GRID_SIZE * GRID_SIZE);
+    state.Run([&]
+    {
+        LoadObjReference(filePath, mesh);
+        DoNotOptimize(mesh.Indices.data());
+    });
+
+    std::filesystem::remove(filePath);
+}
+
+VE_BENCHMARK(ObjLoader_ParseFloat)
+{
+    constexpr size_t count = 4096;
+    std::string text;
+    for (size_t i = 0; i < count; i++)
+    {
+        text += std::to_string(static_cast<double>(i) * 0.731 - 1000.0) + ' ';
+    }
+
+    state.SetItemsPerIteration(count);
+    state.Run([&]
+    {
+        const char* p = text.data();
+        const char* end = p + text.size();
+        float sum = 0.0f;
+        for (size_t i = 0; i < count; i++)
+        {
+            float value;
+            p = ObjLoader::ParseFloat(p, end, value);
+            sum += value;
+        }
+        DoNotOptimize(sum);
+    });
+}
+
+// Reloading a mesh: text OBJ against the binary pack, with the file in the page cache (warm) or not (cold)
+VE_BENCHMARK(MeshLoad_Obj_Warm)
+{
+    RunMeshLoadBenchmark(state, MeshSource::Obj, false);
+}
+
+VE_BENCHMARK(MeshLoad_Obj_Cold)
+{
+    RunMeshLoadBenchmark(state, MeshSource::Obj, true);
+}
+
+VE_BENCHMARK(MeshLoad_Pack_Warm)
+{
+    RunMeshLoadBenchmark(state, MeshSource::Pack, false);
+}
+
+VE_BENCHMARK(MeshLoad_Pack_Cold)
+{
+    RunMeshLoadBenchmark(state, MeshSource::Pack, true);
+}
+
+VE_BENCHMARK(MeshLoad_CompressedPack_Warm)
+{
+    RunMeshLoadBenchmark(state, MeshSource::CompressedPack, false);
+}
+
+VE_BENCHMARK(MeshLoad_CompressedPack_Cold)
+{
+    RunMeshLoadBenchmark(state, MeshSource::CompressedPack, true);
+}
+
+// Triangle order: optimizer throughput and the post-transform cache miss ratio it reaches
+VE_BENCHMARK(MeshOptimizer_VertexCache)
+{
+    RunMeshOptimizerBenchmark(state, false);
+}
+
+VE_BENCHMARK(MeshOptimizer_VertexCacheAndOverdraw)
+{
+    RunMeshOptimizerBenchmark(state, true);
+}
+
+// The same mesh drawn as shuffled, cache-ordered and cache plus overdraw ordered, timed on the GPU
+VE_BENCHMARK(MeshDraw_Unoptimized)
+{
+    RunMeshDrawBenchmark(state, MeshOrder::Unoptimized);
+}
+
+VE_BENCHMARK(MeshDraw_VertexCache)
+{
+    RunMeshDrawBenchmark(state, MeshOrder::VertexCache);
+}
+
+VE_BENCHMARK(MeshDraw_VertexCacheAndOverdraw)
+{
+    RunMeshDrawBenchmark(state, MeshOrder::VertexCacheAndOverdraw);
+}
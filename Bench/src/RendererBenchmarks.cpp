@@ -0,0 +1,173 @@
+#include "vepch.h"
+#include "BenchHarness.h"
+#include "BenchContext.h"
+
+#include "Core/Model.h"
+#include "Core/ModelCache.h"
+#include "Renderer/Descriptors.h"
+#include "Renderer/Pipeline.h"
+
+using namespace VoxelicousEngine;
+using VoxelicousBench::DoNotOptimize;
+using VoxelicousBench::GetHeadlessContext;
+
+namespace
+{
+    // A flat grid of width * width quads, a rough stand-in for a chunk-sized mesh
+    MeshData CreateGridMesh(const uint32_t width)
+    {
+        MeshData builder;
+        for (uint32_t z = 0; z <= width; z++)
+        {
+            for (uint32_t x = 0; x <= width; x++)
+            {
+                Vertex vertex{};
+                vertex.Position = {static_cast<float>(x), 0.0f, static_cast<float>(z)};
+                vertex.Color = {0.0f, 1.0f, 0.0f};
+                vertex.Normal = {0.0f, -1.0f, 0.0f};
+                builder.Vertices.push_back(vertex);
+            }
+        }
+        for (uint32_t z = 0; z < width; z++)
+        {
+            for (uint32_t x = 0; x < width; x++)
+            {
+                const uint32_t i = z * (width + 1) + x;
+                builder.Indices.insert(builder.Indices.end(),
+                                       {i, i + 1, i + width + 1, i + 1, i + width + 2, i + width + 1});
+            }
+        }
+        return builder;
+    }
+}
+
+VE_BENCHMARK(ShaderManager_CacheHit)
+{
+    // Same relative path the render systems use; the shaders are copied next to the executable
+    const std::string shaderPath = "shaders/simple.vert";
+    ShaderManager& shaderManager = Pipeline::GetShaderManager();
+    if (shaderManager.LoadShader(shaderPath, ShaderType::Vertex).empty())
+    {
+        state.Skip("shaders/simple.vert could not be loaded or compiled");
+        return;
+    }
+
+    state.Run([&]
+    {
+        DoNotOptimize(shaderManager.LoadShader(shaderPath, ShaderType::Vertex));
+    });
+}
+
+VE_BENCHMARK(DescriptorWriter_Build)
+{
+    auto* context = GetHeadlessContext();
+    if (!context)
+    {
+        state.Skip("no Vulkan device");
+        return;
+    }
+    Device& device = *context->Device;
+
+    constexpr uint32_t setsPerIteration = 64;
+    const auto setLayout = DescriptorSetLayout::Builder(device)
+                           .AddBinding(0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_SHADER_STAGE_ALL_GRAPHICS)
+                           .Build();
+    // Starts with a pool too small for one iteration, so growth is part of the first iterations only
+    DescriptorAllocator allocator{device, setsPerIteration / 4};
+    const Buffer uniformBuffer{
+        device, 256, 1, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT
+    };
+    const VkDescriptorBufferInfo bufferInfo = uniformBuffer.DescriptorInfo();
+
+    state.SetItemsPerIteration(setsPerIteration);
+    state.Run([&]
+    {
+        for (uint32_t i = 0; i < setsPerIteration; i++)
+        {
+            VkDescriptorSet set;
+            DescriptorWriter(*setLayout, allocator)
+                .WriteBuffer(0, &bufferInfo)
+                .Build(set);
+            DoNotOptimize(set);
+        }
+        allocator.Reset();
+    });
+}
+
+VE_BENCHMARK(Model_Upload)
+{
+    auto* context = GetHeadlessContext();
+    if (!context)
+    {
+        state.Skip("no Vulkan device");
+        return;
+    }
+    Device& device = *context->Device;
+
+    const Model::Builder mesh = CreateGridMesh(64);
+
+    state.SetItemsPerIteration(mesh.Vertices.size());
+    state.Run([&]
+    {
+        const Model model{device, mesh};
+        DoNotOptimize(model);
+    });
+    vkDeviceWaitIdle(device.GetDevice());
+}
+
+// A world of 256 prefab instances built from 8 distinct meshes: every instance asks the cache for its model
+VE_BENCHMARK(ModelCache_Prefabs)
+{
+    auto* context = GetHeadlessContext();
+    if (!context)
+    {
+        state.Skip("no Vulkan device");
+        return;
+    }
+    Device& device = *context->Device;
+
+    constexpr uint32_t instanceCount = 256;
+    constexpr uint32_t prefabCount = 8;
+    std::vector<MeshData> prefabs;
+    for (uint32_t i = 0; i < prefabCount; i++)
+    {
+        prefabs.push_back(CreateGridMesh(8 + i));
+    }
+
+    // The world keeps one reference per prefab, so every instance below is a cache hit
+    ModelCache cache{device};
+    std::vector<MeshHandle> prefabMeshes;
+    for (const MeshData& prefab : prefabs)
+    {
+        prefabMeshes.push_back(cache.Acquire(prefab));
+    }
+
+    std::vector<MeshHandle> instances(instanceCount);
+    state.SetItemsPerIteration(instanceCount);
+    state.Run([&]
+    {
+        for (uint32_t i = 0; i < instanceCount; i++)
+        {
+            instances[i] = cache.Acquire(prefabs[i % prefabCount]);
+        }
+        for (const MeshHandle instance : instances)
+        {
+            cache.Release(instance);
+        }
+    });
+
+    VkDeviceSize uncachedSize = 0;
+    for (uint32_t i = 0; i < instanceCount; i++)
+    {
+        uncachedSize += cache.Get(prefabMeshes[i % prefabCount])->GetMemorySize();
+    }
+    state.SetCounter("live_models", cache.GetModels().GetSize());
+    state.SetCounter("gpu_bytes_cached", static_cast<double>(cache.GetMemorySize()));
+    state.SetCounter("gpu_bytes_uncached", static_cast<double>(uncachedSize));
+
+    for (const MeshHandle prefabMesh : prefabMeshes)
+    {
+        cache.Release(prefabMesh);
+    }
+    vkDeviceWaitIdle(device.GetDevice());
+}
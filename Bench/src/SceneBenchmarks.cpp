@@ -0,0 +1,304 @@
+#include "vepch.h"
+#include "BenchHarness.h"
+
+#include "Core/Components.h"
+#include "Core/TransformSystem.h"
+#include "Core/Scene.h"
+
+using namespace VoxelicousEngine;
+using VoxelicousBench::DoNotOptimize;
+
+namespace
+{
+    constexpr uint32_t ENTITY_COUNT = 1'000'000;
+    constexpr float DELTA_TIME = 1.f / 60.f;
+
+    constexpr uint32_t TRANSFORM_COUNT = 100'000;
+    // 1% of the transforms change every frame
+    constexpr uint32_t CHANGED_PER_FRAME = TRANSFORM_COUNT / 100;
+
+    struct Velocity
+    {
+        glm::vec3 Value{0.f};
+    };
+
+    TransformComponent MakeTransform(const uint32_t i)
+    {
+        TransformComponent transform{};
+        transform.Translation = {static_cast<float>(i % 1000), 0.f, static_cast<float>(i / 1000)};
+        return transform;
+    }
+
+    Velocity MakeVelocity(const uint32_t i)
+    {
+        return {{static_cast<float>(i % 7) - 3.f, 1.f, static_cast<float>(i % 5) - 2.f}};
+    }
+
+    TransformComponent MakeRotatedTransform(const uint32_t i)
+    {
+        TransformComponent transform = MakeTransform(i);
+        const auto f = static_cast<float>(i);
+        transform.Rotation = {f * 0.01f, f * 0.02f, f * 0.03f};
+        transform.Scale = {1.f, 1.f + static_cast<float>(i % 3), 1.f};
+        return transform;
+    }
+
+    // Moves a different 1% of the entities every frame, spread over the whole world
+    void MoveSome(Scene& scene, const std::vector<Entity>& entities, uint32_t& next)
+    {
+        for (uint32_t i = 0; i < CHANGED_PER_FRAME; i++)
+        {
+            scene.Get<TransformComponent>(entities[next])->Rotation.y += DELTA_TIME;
+            next = (next + 7919) % static_cast<uint32_t>(entities.size());
+        }
+    }
+
+    // A third of the entities aren't drawable, so the query skips a whole archetype
+    void Populate(Scene& scene)
+    {
+        for (uint32_t i = 0; i < ENTITY_COUNT; i++)
+        {
+            if (i % 3 == 0)
+            {
+                scene.Create(MakeTransform(i), MakeVelocity(i));
+            }
+            else
+            {
+                scene.Create(MakeTransform(i), MakeVelocity(i), MeshComponent{{i % 64, 1}, i % 8});
+            }
+        }
+    }
+}
+
+VE_BENCHMARK(Scene_Create)
+{
+    Scene scene;
+    state.SetItemsPerIteration(ENTITY_COUNT);
+    state.Run([&]
+    {
+        Populate(scene);
+        scene.Clear();
+    });
+}
+
+// Destroying and respawning a tenth of the entities every frame, which recycles their indices
+VE_BENCHMARK(Scene_DestroyCreate)
+{
+    Scene scene;
+    std::vector<Entity> entities;
+    entities.reserve(ENTITY_COUNT);
+    for (uint32_t i = 0; i < ENTITY_COUNT; i++)
+    {
+        entities.push_back(scene.Create(MakeTransform(i), MakeVelocity(i)));
+    }
+
+    constexpr uint32_t churn = ENTITY_COUNT / 10;
+    uint32_t next = 0;
+    state.SetItemsPerIteration(churn);
+    state.Run([&]
+    {
+        for (uint32_t i = 0; i < churn; i++)
+        {
+            Entity& entity = entities[next];
+            scene.Destroy(entity);
+            entity = scene.Create(MakeTransform(next), MakeVelocity(next));
+            next = (next + 7919) % ENTITY_COUNT;
+        }
+    });
+}
+
+// Integrating velocities the way game objects were stored before: one map node per object
+VE_BENCHMARK(Scene_Update_UnorderedMap)
+{
+    struct Object
+    {
+        TransformComponent Transform;
+        Velocity Motion;
+        MeshComponent Mesh;
+        bool Drawable;
+    };
+
+    std::unordered_map<uint32_t, Object> objects;
+    for (uint32_t i = 0; i < ENTITY_COUNT; i++)
+    {
+        objects.emplace(i, Object{MakeTransform(i), MakeVelocity(i), {{i % 64, 1}, i % 8}, i % 3 != 0});
+    }
+
+    state.SetItemsPerIteration(ENTITY_COUNT);
+    state.Run([&]
+    {
+        for (auto& [id, object] : objects)
+        {
+            object.Transform.Translation += object.Motion.Value * DELTA_TIME;
+        }
+        DoNotOptimize(objects.begin()->second.Transform.Translation);
+    });
+}
+
+VE_BENCHMARK(Scene_Update_Each)
+{
+    Scene scene;
+    Populate(scene);
+
+    state.SetItemsPerIteration(ENTITY_COUNT);
+    state.Run([&]
+    {
+        scene.Each<TransformComponent, const Velocity>([](Entity, TransformComponent& transform, const Velocity& velocity)
+        {
+            transform.Translation += velocity.Value * DELTA_TIME;
+        });
+        DoNotOptimize(scene.GetArchetypes().front());
+    });
+}
+
+VE_BENCHMARK(Scene_Update_ParallelEach)
+{
+    Scene scene;
+    Populate(scene);
+
+    state.SetItemsPerIteration(ENTITY_COUNT);
+    state.SetCounter("threads", JobSystem::Get().GetThreadCount() + 1);
+    state.Run([&]
+    {
+        scene.ParallelEach<TransformComponent, const Velocity>(
+            [](Entity, TransformComponent& transform, const Velocity& velocity)
+        {
+            transform.Translation += velocity.Value * DELTA_TIME;
+        });
+        DoNotOptimize(scene.GetArchetypes().front());
+    });
+}
+
+// Gathering the drawable entities' mesh handles, a read-only query over two thirds of the scene
+VE_BENCHMARK(Scene_Query_Drawable)
+{
+    Scene scene;
+    Populate(scene);
+
+    state.SetItemsPerIteration(scene.Count<MeshComponent>());
+    state.Run([&]
+    {
+        uint64_t materials = 0;
+        scene.ForEachChunk<const MeshComponent>([&](std::span<const Entity>, const std::span<const MeshComponent> meshes)
+        {
+            for (const MeshComponent& mesh : meshes)
+            {
+                materials += mesh.MaterialId;
+            }
+        });
+        DoNotOptimize(materials);
+    });
+}
+
+// Every transform's matrix rebuilt every frame, moving or not, as the renderer did before matrices were cached
+VE_BENCHMARK(Transform_Mat4_All)
+{
+    std::vector<TransformComponent> transforms;
+    for (uint32_t i = 0; i < TRANSFORM_COUNT; i++)
+    {
+        transforms.push_back(MakeRotatedTransform(i));
+    }
+    std::vector<glm::mat4> matrices(TRANSFORM_COUNT);
+
+    state.SetItemsPerIteration(TRANSFORM_COUNT);
+    state.Run([&]
+    {
+        for (uint32_t i = 0; i < TRANSFORM_COUNT; i++)
+        {
+            matrices[i] = transforms[i].Mat4();
+        }
+        DoNotOptimize(matrices.data());
+    });
+}
+
+// ... the same with batched SIMD matrices
+VE_BENCHMARK(Transform_ComputeMatrices_All)
+{
+    std::vector<TransformComponent> transforms;
+    for (uint32_t i = 0; i < TRANSFORM_COUNT; i++)
+    {
+        transforms.push_back(MakeRotatedTransform(i));
+    }
+    std::vector<glm::mat4> matrices(TRANSFORM_COUNT);
+
+    state.SetItemsPerIteration(TRANSFORM_COUNT);
+    state.Run([&]
+    {
+        TransformSystem::ComputeMatrices(transforms, matrices);
+        DoNotOptimize(matrices.data());
+    });
+}
+
+// Cached world matrices with 1% of the transforms changing per frame
+VE_BENCHMARK(TransformSystem_Update)
+{
+    Scene scene;
+    std::vector<Entity> entities;
+    for (uint32_t i = 0; i < TRANSFORM_COUNT; i++)
+    {
+        entities.push_back(scene.Create(MakeRotatedTransform(i), WorldTransformComponent{}));
+    }
+    TransformSystem system;
+    system.Update(scene);
+
+    uint32_t next = 0;
+    state.SetItemsPerIteration(TRANSFORM_COUNT);
+    state.Run([&]
+    {
+        MoveSome(scene, entities, next);
+        system.Update(scene);
+    });
+    state.SetCounter("recomputed", system.GetRecomputedCount());
+}
+
+// ... with the transforms in 10k groups of a root, three children and five grandchildren plus one more
+// root, so a moved root or child also recomputes what hangs below it
+VE_BENCHMARK(TransformSystem_Update_Hierarchy)
+{
+    Scene scene;
+    std::vector<Entity> entities;
+    for (uint32_t i = 0; i < TRANSFORM_COUNT; i++)
+    {
+        entities.push_back(scene.Create(MakeRotatedTransform(i), WorldTransformComponent{}));
+    }
+    for (uint32_t root = 0; root < TRANSFORM_COUNT; root += 10)
+    {
+        for (uint32_t child = 1; child <= 3; child++)
+        {
+            TransformSystem::SetParent(scene, entities[root + child], entities[root]);
+            TransformSystem::SetParent(scene, entities[root + child + 3], entities[root + child]);
+            if (child < 3)
+            {
+                TransformSystem::SetParent(scene, entities[root + child + 6], entities[root + child]);
+            }
+        }
+    }
+    // An untransformed child has to land exactly on its parent, two levels down where errors compound
+    const Entity identity = scene.Create(TransformComponent{}, WorldTransformComponent{});
+    TransformSystem::SetParent(scene, identity, entities[4]);
+    TransformSystem system;
+    system.Update(scene);
+
+    const glm::mat4& parentMatrix = scene.Get<const WorldTransformComponent>(entities[4])->Matrix;
+    const glm::mat4& childMatrix = scene.Get<const WorldTransformComponent>(identity)->Matrix;
+    for (int column = 0; column < 4; column++)
+    {
+        for (int row = 0; row < 4; row++)
+        {
+            if (std::abs(parentMatrix[column][row] - childMatrix[column][row]) > 1e-4f)
+            {
+                state.Fail("an identity child doesn't coincide with its parent");
+                return;
+            }
+        }
+    }
+
+    uint32_t next = 0;
+    state.SetItemsPerIteration(TRANSFORM_COUNT);
+    state.Run([&]
+    {
+        MoveSome(scene, entities, next);
+        system.Update(scene);
+    });
+    state.SetCounter("recomputed", system.GetRecomputedCount());
+}
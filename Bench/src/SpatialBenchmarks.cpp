@@ -0,0 +1,325 @@
+#include "vepch.h"
+#include "BenchHarness.h"
+
+#include "Core/SpatialIndex.h"
+
+using namespace VoxelicousEngine;
+using VoxelicousBench::DoNotOptimize;
+
+namespace
+{
+    constexpr uint32_t OBJECT_COUNT = 100'000;
+    constexpr uint32_t QUERY_COUNT = 256;
+    constexpr float DELTA_TIME = 1.f / 60.f;
+    // Objects drift around a 2 km x 100 m x 2 km level
+    constexpr float WORLD_SIZE = 1000.f;
+    constexpr float WORLD_HEIGHT = 50.f;
+
+    struct MovingObject
+    {
+        glm::vec3 Position;
+        glm::vec3 Velocity;
+        glm::vec3 Extent;
+        SpatialIndex::ProxyId Proxy;
+    };
+
+    float Hash(const uint32_t i, const uint32_t salt)
+    {
+        uint32_t x = i * 0x9E3779B9u ^ salt * 0x85EBCA6Bu;
+        x ^= x >> 16;
+        x *= 0x7FEB352Du;
+        x ^= x >> 15;
+        return static_cast<float>(x & 0xFFFFFF) / static_cast<float>(0x1000000);
+    }
+
+    AABB GetBounds(const MovingObject& object)
+    {
+        return {object.Position - object.Extent, object.Position + object.Extent};
+    }
+
+    std::vector<MovingObject> MakeObjects()
+    {
+        std::vector<MovingObject> objects(OBJECT_COUNT);
+        for (uint32_t i = 0; i < OBJECT_COUNT; i++)
+        {
+            MovingObject& object = objects[i];
+            object.Position = {
+                (Hash(i, 1) * 2.f - 1.f) * WORLD_SIZE, (Hash(i, 2) * 2.f - 1.f) * WORLD_HEIGHT,
+                (Hash(i, 3) * 2.f - 1.f) * WORLD_SIZE
+            };
+            object.Velocity = {(Hash(i, 4) - 0.5f) * 20.f, (Hash(i, 5) - 0.5f) * 2.f, (Hash(i, 6) - 0.5f) * 20.f};
+            object.Extent = glm::vec3{0.5f + Hash(i, 7) * 2.f};
+        }
+        return objects;
+    }
+
+    void Populate(SpatialIndex& index, std::vector<MovingObject>& objects)
+    {
+        for (uint32_t i = 0; i < OBJECT_COUNT; i++)
+        {
+            objects[i].Proxy = index.Insert(Entity{i, 1}, GetBounds(objects[i]));
+        }
+        index.Rebuild();
+    }
+
+    // Every object moves every frame, bouncing off the level's walls
+    void Simulate(std::vector<MovingObject>& objects)
+    {
+        for (MovingObject& object : objects)
+        {
+            object.Position += object.Velocity * DELTA_TIME;
+            for (int axis = 0; axis < 3; axis++)
+            {
+                const float limit = axis == 1 ? WORLD_HEIGHT : WORLD_SIZE;
+                if (std::abs(object.Position[axis]) > limit)
+                {
+                    object.Velocity[axis] = -object.Velocity[axis];
+                }
+            }
+        }
+    }
+
+    // Cameras spread over the level looking along it, each seeing a few percent of the objects
+    std::vector<Frustum> MakeFrustums()
+    {
+        const glm::mat4 projection = glm::perspective(glm::radians(60.f), 16.f / 9.f, 0.1f, 300.f);
+        std::vector<Frustum> frustums;
+        for (uint32_t i = 0; i < QUERY_COUNT; i++)
+        {
+            const glm::vec3 eye{(Hash(i, 8) * 2.f - 1.f) * WORLD_SIZE, 10.f, (Hash(i, 9) * 2.f - 1.f) * WORLD_SIZE};
+            const float angle = Hash(i, 10) * glm::two_pi<float>();
+            const glm::vec3 target = eye + glm::vec3{std::cos(angle), -0.1f, std::sin(angle)};
+            frustums.push_back(Frustum::FromMatrix(projection * glm::lookAt(eye, target, {0.f, 1.f, 0.f})));
+        }
+        return frustums;
+    }
+
+    std::vector<Ray> MakeRays()
+    {
+        std::vector<Ray> rays;
+        for (uint32_t i = 0; i < QUERY_COUNT; i++)
+        {
+            const glm::vec3 origin{(Hash(i, 11) * 2.f - 1.f) * WORLD_SIZE, 0.f, (Hash(i, 12) * 2.f - 1.f) * WORLD_SIZE};
+            const float angle = Hash(i, 13) * glm::two_pi<float>();
+            rays.push_back({origin, {std::cos(angle), Hash(i, 14) * 0.1f - 0.05f, std::sin(angle)}});
+        }
+        return rays;
+    }
+}
+
+// One frame of 100k moving objects: every proxy moved and the tree refit, with a rebuild started in the
+// background every RebuildInterval frames
+VE_BENCHMARK(SpatialIndex_MoveRefit)
+{
+    std::vector<MovingObject> objects = MakeObjects();
+    SpatialIndex index;
+    Populate(index, objects);
+
+    state.SetItemsPerIteration(OBJECT_COUNT);
+    state.Run([&]
+    {
+        Simulate(objects);
+        for (const MovingObject& object : objects)
+        {
+            index.Move(object.Proxy, GetBounds(object));
+        }
+        index.Refit();
+    });
+    state.SetCounter("builds", index.GetBuildCount());
+}
+
+// ... with 1% of the objects moving, which refits only their leaves and ancestors
+VE_BENCHMARK(SpatialIndex_MoveRefit_Some)
+{
+    std::vector<MovingObject> objects = MakeObjects();
+    SpatialIndex index;
+    Populate(index, objects);
+
+    uint32_t next = 0;
+    state.SetItemsPerIteration(OBJECT_COUNT / 100);
+    state.Run([&]
+    {
+        for (uint32_t i = 0; i < OBJECT_COUNT / 100; i++)
+        {
+            MovingObject& object = objects[next];
+            object.Position += object.Velocity * DELTA_TIME;
+            index.Move(object.Proxy, GetBounds(object));
+            next = (next + 7919) % OBJECT_COUNT;
+        }
+        index.Refit();
+    });
+}
+
+VE_BENCHMARK(SpatialIndex_Rebuild)
+{
+    std::vector<MovingObject> objects = MakeObjects();
+    SpatialIndex index;
+    Populate(index, objects);
+
+    state.SetItemsPerIteration(OBJECT_COUNT);
+    state.Run([&] { index.Rebuild(); });
+    state.SetCounter("nodes", index.GetNodeCount());
+}
+
+// Culling a view against every object, as the renderer would without the index
+VE_BENCHMARK(SpatialIndex_QueryFrustum_Linear)
+{
+    const std::vector<MovingObject> objects = MakeObjects();
+    const std::vector<Frustum> frustums = MakeFrustums();
+
+    uint64_t visible = 0;
+    state.SetItemsPerIteration(QUERY_COUNT);
+    state.Run([&]
+    {
+        for (const Frustum& frustum : frustums)
+        {
+            for (const MovingObject& object : objects)
+            {
+                visible += frustum.Intersects(GetBounds(object));
+            }
+        }
+        DoNotOptimize(visible);
+    });
+}
+
+VE_BENCHMARK(SpatialIndex_QueryFrustum)
+{
+    std::vector<MovingObject> objects = MakeObjects();
+    const std::vector<Frustum> frustums = MakeFrustums();
+    SpatialIndex index;
+    Populate(index, objects);
+
+    uint64_t visible = 0;
+    state.SetItemsPerIteration(QUERY_COUNT);
+    state.Run([&]
+    {
+        for (const Frustum& frustum : frustums)
+        {
+            index.QueryFrustum(frustum, [&visible](Entity) { visible++; });
+        }
+        DoNotOptimize(visible);
+    });
+
+    uint64_t perFrustum = 0;
+    index.QueryFrustum(frustums.front(), [&perFrustum](Entity) { perFrustum++; });
+    state.SetCounter("visible", static_cast<double>(perFrustum));
+}
+
+// ... after two seconds of refits without a rebuild, once the boxes have grown apart
+VE_BENCHMARK(SpatialIndex_QueryFrustum_Refitted)
+{
+    std::vector<MovingObject> objects = MakeObjects();
+    const std::vector<Frustum> frustums = MakeFrustums();
+    SpatialIndex index;
+    index.RebuildInterval = UINT32_MAX;
+    Populate(index, objects);
+    for (uint32_t frame = 0; frame < 120; frame++)
+    {
+        Simulate(objects);
+        for (const MovingObject& object : objects)
+        {
+            index.Move(object.Proxy, GetBounds(object));
+        }
+        index.Refit();
+    }
+
+    uint64_t visible = 0;
+    state.SetItemsPerIteration(QUERY_COUNT);
+    state.Run([&]
+    {
+        for (const Frustum& frustum : frustums)
+        {
+            index.QueryFrustum(frustum, [&visible](Entity) { visible++; });
+        }
+        DoNotOptimize(visible);
+    });
+}
+
+// Proximity queries of 10 m around objects, e.g. for AI or triggers
+VE_BENCHMARK(SpatialIndex_QuerySphere)
+{
+    std::vector<MovingObject> objects = MakeObjects();
+    SpatialIndex index;
+    Populate(index, objects);
+
+    uint64_t found = 0;
+    state.SetItemsPerIteration(QUERY_COUNT);
+    state.Run([&]
+    {
+        for (uint32_t i = 0; i < QUERY_COUNT; i++)
+        {
+            index.QuerySphere(objects[i * 331].Position, 10.f, [&found](Entity) { found++; });
+        }
+        DoNotOptimize(found);
+    });
+
+    uint64_t perSphere = 0;
+    index.QuerySphere(objects.front().Position, 10.f, [&perSphere](Entity) { perSphere++; });
+    state.SetCounter("found", static_cast<double>(perSphere));
+}
+
+VE_BENCHMARK(SpatialIndex_QueryAabb)
+{
+    std::vector<MovingObject> objects = MakeObjects();
+    SpatialIndex index;
+    Populate(index, objects);
+
+    uint64_t found = 0;
+    state.SetItemsPerIteration(QUERY_COUNT);
+    state.Run([&]
+    {
+        for (uint32_t i = 0; i < QUERY_COUNT; i++)
+        {
+            const glm::vec3 center = objects[i * 331].Position;
+            index.QueryAabb({center - glm::vec3{10.f}, center + glm::vec3{10.f}}, [&found](Entity) { found++; });
+        }
+        DoNotOptimize(found);
+    });
+}
+
+// Picking the nearest object along a ray by testing every object
+VE_BENCHMARK(SpatialIndex_Raycast_Linear)
+{
+    const std::vector<MovingObject> objects = MakeObjects();
+    const std::vector<Ray> rays = MakeRays();
+
+    state.SetItemsPerIteration(QUERY_COUNT);
+    state.Run([&]
+    {
+        for (const Ray& ray : rays)
+        {
+            const glm::vec3 inverse = 1.f / ray.Direction;
+            float nearest = 500.f;
+            for (const MovingObject& object : objects)
+            {
+                const glm::vec3 t0 = (object.Position - object.Extent - ray.Origin) * inverse;
+                const glm::vec3 t1 = (object.Position + object.Extent - ray.Origin) * inverse;
+                const glm::vec3 entries = glm::min(t0, t1);
+                const glm::vec3 exits = glm::max(t0, t1);
+                const float entry = std::max(std::max(entries.x, entries.y), std::max(entries.z, 0.f));
+                const float exit = std::min(std::min(exits.x, exits.y), std::min(exits.z, nearest));
+                if (entry <= exit) nearest = entry;
+            }
+            DoNotOptimize(nearest);
+        }
+    });
+}
+
+VE_BENCHMARK(SpatialIndex_Raycast)
+{
+    std::vector<MovingObject> objects = MakeObjects();
+    const std::vector<Ray> rays = MakeRays();
+    SpatialIndex index;
+    Populate(index, objects);
+
+    uint32_t hits = 0;
+    state.SetItemsPerIteration(QUERY_COUNT);
+    state.Run([&]
+    {
+        for (const Ray& ray : rays)
+        {
+            hits += index.Raycast(ray, 500.f).has_value();
+        }
+        DoNotOptimize(hits);
+    });
+}
@@ -0,0 +1,212 @@
+#include "vepch.h"
+#include "BenchHarness.h"
+
+#include "Assets/MipGenerator.h"
+#include "Assets/TextureEncoder.h"
+#include "Assets/TexturePack.h"
+
+#include <filesystem>
+
+using namespace VoxelicousEngine;
+using VoxelicousBench::DoNotOptimize;
+
+namespace
+{
+    // Voxel block textures: 1024 layers of 16x16 noise
+    constexpr uint32_t BLOCK_TEXTURE_COUNT = 1024;
+    constexpr uint32_t BLOCK_TEXTURE_SIZE = 16;
+
+    TextureData MakeBlockTextures()
+    {
+        TextureData texture;
+        texture.Width = BLOCK_TEXTURE_SIZE;
+        texture.Height = BLOCK_TEXTURE_SIZE;
+        texture.LayerCount = BLOCK_TEXTURE_COUNT;
+        texture.Pixels.resize(texture.GetMipSize(0));
+        uint32_t state = 0x12345678u;
+        for (std::byte& value : texture.Pixels)
+        {
+            state = state * 1664525u + 1013904223u;
+            value = static_cast<std::byte>(state >> 24);
+        }
+        for (uint32_t layer = 0; layer < texture.LayerCount; layer++)
+        {
+            texture.LayerNames.push_back("block_" + std::to_string(layer));
+        }
+        return texture;
+    }
+
+    // 512x512 texture of smooth gradients with mild noise, closer to real albedo than pure noise, so the
+    // reported PSNR says something about the encoder. Alpha is constant within each block unless cutout is set,
+    // which punches rings of fully transparent pixels through it like foliage, so edges cross the blocks.
+    constexpr uint32_t ENCODER_TEXTURE_SIZE = 512;
+
+    TextureData MakeEncoderSource(const bool cutout = false)
+    {
+        TextureData texture;
+        texture.Width = ENCODER_TEXTURE_SIZE;
+        texture.Height = ENCODER_TEXTURE_SIZE;
+        texture.Pixels.resize(texture.GetMipSize(0));
+        uint32_t state = 0x9e3779b9u;
+        for (uint32_t y = 0; y < texture.Height; y++)
+        {
+            for (uint32_t x = 0; x < texture.Width; x++)
+            {
+                state = state * 1664525u + 1013904223u;
+                const int noise = static_cast<int>(state >> 28) - 8;
+                int values[4] = {
+                    static_cast<int>(x / 2) + noise, static_cast<int>(y / 2) - noise,
+                    static_cast<int>((x + y) / 4) + noise, x / 64 % 2 == 0 ? 255 : 96
+                };
+                if (cutout)
+                {
+                    values[3] = (x * x + y * y) / 997 % 3 == 0 ? 0 : 255;
+                }
+                std::byte* pixel = texture.Pixels.data() + (static_cast<size_t>(y) * texture.Width + x) * 4;
+                for (uint32_t channel = 0; channel < 4; channel++)
+                {
+                    pixel[channel] = static_cast<std::byte>(std::clamp(values[channel], 0, 255));
+                }
+            }
+        }
+        return texture;
+    }
+
+    void RunEncoderBenchmark(
+        VoxelicousBench::State& state, const TextureFormat format, const TextureQuality quality,
+        const bool cutout = false)
+    {
+        const TextureData source = MakeEncoderSource(cutout);
+        TextureData compressed;
+
+        state.SetItemsPerIteration(static_cast<uint64_t>(source.Width) * source.Height);
+        state.Run([&]
+        {
+            compressed = TextureEncoder::Encode(source, {format, quality});
+            DoNotOptimize(compressed.Pixels.data());
+        });
+        state.SetCounter("psnr_db", TextureEncoder::ComputePsnr(source, compressed));
+    }
+
+    void RunMipBenchmark(VoxelicousBench::State& state, const MipFilter filter)
+    {
+        const TextureData source = MakeBlockTextures();
+        TextureData texture;
+
+        state.SetItemsPerIteration(BLOCK_TEXTURE_COUNT);
+        state.Run([&]
+        {
+            texture = source;
+            MipGenerator::Generate(texture, {filter});
+            DoNotOptimize(texture.Pixels.data());
+        });
+    }
+}
+
+VE_BENCHMARK(MipGenerator_Box_1024Blocks)
+{
+    RunMipBenchmark(state, MipFilter::Box);
+}
+
+VE_BENCHMARK(MipGenerator_Kaiser_1024Blocks)
+{
+    RunMipBenchmark(state, MipFilter::Kaiser);
+}
+
+VE_BENCHMARK(MipGenerator_Box_Downsample1024)
+{
+    constexpr uint32_t size = 1024;
+    std::vector<uint8_t> src(size * size * 4, 128);
+    std::vector<uint8_t> dst(size * size);
+
+    state.SetItemsPerIteration(size * size);
+    state.Run([&]
+    {
+        MipGenerator::DownsampleBox(src.data(), size, size, dst.data());
+        DoNotOptimize(dst.data());
+    });
+}
+
+// Startup cost of the block texture array: reading the pack with every mip and layer name
+VE_BENCHMARK(TexturePack_Read_1024Blocks)
+{
+    TextureData texture = MakeBlockTextures();
+    MipGenerator::Generate(texture);
+    const std::string filePath = (std::filesystem::temp_directory_path() / "ve_bench_blocks.vetp").string();
+    TexturePack::Write(filePath, texture);
+
+    state.SetItemsPerIteration(BLOCK_TEXTURE_COUNT);
+    state.Run([&]
+    {
+        TextureData loaded;
+        TexturePack::Read(filePath, loaded);
+        DoNotOptimize(loaded.Pixels.data());
+    });
+
+    std::filesystem::remove(filePath);
+}
+
+// Encode throughput in pixels per second, with the quality of the result as the psnr_db counter
+VE_BENCHMARK(TextureEncoder_BC1_Normal)
+{
+    RunEncoderBenchmark(state, TextureFormat::BC1RgbaSrgb, TextureQuality::Normal);
+}
+
+VE_BENCHMARK(TextureEncoder_BC1_High)
+{
+    RunEncoderBenchmark(state, TextureFormat::BC1RgbaSrgb, TextureQuality::High);
+}
+
+VE_BENCHMARK(TextureEncoder_BC4_Normal)
+{
+    RunEncoderBenchmark(state, TextureFormat::BC4Unorm, TextureQuality::Normal);
+}
+
+VE_BENCHMARK(TextureEncoder_BC5_Normal)
+{
+    RunEncoderBenchmark(state, TextureFormat::BC5Unorm, TextureQuality::Normal);
+}
+
+VE_BENCHMARK(TextureEncoder_BC7_Fast)
+{
+    RunEncoderBenchmark(state, TextureFormat::BC7Srgb, TextureQuality::Fast);
+}
+
+VE_BENCHMARK(TextureEncoder_BC7_Normal)
+{
+    RunEncoderBenchmark(state, TextureFormat::BC7Srgb, TextureQuality::Normal);
+}
+
+VE_BENCHMARK(TextureEncoder_BC7_High)
+{
+    RunEncoderBenchmark(state, TextureFormat::BC7Srgb, TextureQuality::High);
+}
+
+// Cutout alpha, where colour and alpha sharing one line costs the most
+VE_BENCHMARK(TextureEncoder_BC7_Fast_Cutout)
+{
+    RunEncoderBenchmark(state, TextureFormat::BC7Srgb, TextureQuality::Fast, true);
+}
+
+VE_BENCHMARK(TextureEncoder_BC7_Normal_Cutout)
+{
+    RunEncoderBenchmark(state, TextureFormat::BC7Srgb, TextureQuality::Normal, true);
+}
+
+VE_BENCHMARK(TextureEncoder_BC7_High_Cutout)
+{
+    RunEncoderBenchmark(state, TextureFormat::BC7Srgb, TextureQuality::High, true);
+}
+
+// Decoding is what a software fallback or a tool preview pays per texture
+VE_BENCHMARK(TextureEncoder_BC7_Decode)
+{
+    const TextureData compressed = TextureEncoder::Encode(MakeEncoderSource(), {TextureFormat::BC7Srgb});
+
+    state.SetItemsPerIteration(static_cast<uint64_t>(compressed.Width) * compressed.Height);
+    state.Run([&]
+    {
+        const TextureData decoded = TextureEncoder::Decode(compressed);
+        DoNotOptimize(decoded.Pixels.data());
+    });
+}
@@ -0,0 +1,128 @@
+#include "vepch.h"
+#include "BenchHarness.h"
+
+#include "Core/JobSystem.h"
+#include "Voxel/ChunkMesher.h"
+#include "Voxel/World.h"
+#include "Voxel/WorldGenerator.h"
+
+using namespace VoxelicousEngine;
+using VoxelicousBench::DoNotOptimize;
+
+namespace
+{
+    // 4x2x4 chunks of generated terrain around the origin, enough for every meshed chunk to have neighbours
+    World& GetTerrainWorld()
+    {
+        static World world = []
+        {
+            World generated;
+            const WorldGenerator generator;
+            for (int32_t z = -2; z < 2; z++)
+                for (int32_t y = 0; y < 2; y++)
+                    for (int32_t x = -2; x < 2; x++)
+                        generator.Generate(generated.GetOrCreateChunk({x, y, z}), {x, y, z});
+            return generated;
+        }();
+        return world;
+    }
+}
+
+VE_BENCHMARK(WorldGenerator_Chunk)
+{
+    const WorldGenerator generator;
+    Chunk chunk;
+    int32_t x = 0;
+
+    state.SetItemsPerIteration(Chunk::VOLUME);
+    state.Run([&]
+    {
+        generator.Generate(chunk, {x++, 0, 0});
+        DoNotOptimize(chunk.GetSolidCount());
+    });
+}
+
+VE_BENCHMARK(WorldGenerator_ParallelRegion)
+{
+    constexpr uint32_t regionWidth = 8;
+    const WorldGenerator generator;
+    std::vector<Chunk> chunks(regionWidth * regionWidth);
+    JobSystem& jobSystem = JobSystem::Get();
+
+    state.SetItemsPerIteration(chunks.size());
+    state.Run([&]
+    {
+        jobSystem.ParallelFor(static_cast<uint32_t>(chunks.size()), 1, [&](const uint32_t begin, const uint32_t end)
+        {
+            for (uint32_t i = begin; i < end; i++)
+            {
+                const glm::ivec3 coord{static_cast<int32_t>(i % regionWidth), 0, static_cast<int32_t>(i / regionWidth)};
+                generator.Generate(chunks[i], coord);
+            }
+        });
+        DoNotOptimize(chunks.front().GetSolidCount());
+    });
+}
+
+VE_BENCHMARK(ChunkMesher_Terrain)
+{
+    const World& world = GetTerrainWorld();
+    const glm::ivec3 coord{0, 0, 0};
+    const Chunk& chunk = *world.GetChunk(coord);
+    const ChunkNeighbours neighbours = ChunkNeighbours::FromWorld(world, coord);
+    MeshData mesh;
+
+    state.SetItemsPerIteration(Chunk::VOLUME);
+    state.Run([&]
+    {
+        mesh.Clear();
+        DoNotOptimize(ChunkMesher::Mesh(chunk, neighbours, mesh));
+    });
+}
+
+VE_BENCHMARK(ChunkMesher_Checkerboard)
+{
+    // Worst case for the greedy mesher: no two neighbouring faces can be merged
+    Chunk chunk;
+    for (int32_t z = 0; z < Chunk::SIZE; z++)
+        for (int32_t y = 0; y < Chunk::SIZE; y++)
+            for (int32_t x = 0; x < Chunk::SIZE; x++)
+                if ((x + y + z) % 2 == 0)
+                    chunk.Set(x, y, z, Voxels::STONE);
+    MeshData mesh;
+
+    state.SetItemsPerIteration(Chunk::VOLUME);
+    state.Run([&]
+    {
+        mesh.Clear();
+        DoNotOptimize(ChunkMesher::Mesh(chunk, {}, mesh));
+    });
+}
+
+VE_BENCHMARK(ChunkMesher_ParallelWorld)
+{
+    const World& world = GetTerrainWorld();
+    std::vector<const Chunk*> chunks;
+    std::vector<glm::ivec3> coords;
+    for (const auto& [coord, chunk] : world.GetChunks())
+    {
+        coords.push_back(coord);
+        chunks.push_back(chunk.get());
+    }
+    std::vector<MeshData> meshes(chunks.size());
+    JobSystem& jobSystem = JobSystem::Get();
+
+    state.SetItemsPerIteration(chunks.size());
+    state.Run([&]
+    {
+        jobSystem.ParallelFor(static_cast<uint32_t>(chunks.size()), 1, [&](const uint32_t begin, const uint32_t end)
+        {
+            for (uint32_t i = begin; i < end; i++)
+            {
+                meshes[i].Clear();
+                ChunkMesher::Mesh(*chunks[i], ChunkNeighbours::FromWorld(world, coords[i]), meshes[i]);
+            }
+        });
+        DoNotOptimize(meshes.front().Vertices.size());
+    });
+}
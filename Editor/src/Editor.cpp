@@ -29,16 +29,18 @@ struct GlobalUbo
 class FirstApp : public VoxelicousEngine::App
 {
 public:
-	FirstApp()
+	explicit FirstApp(const VoxelicousEngine::AppCommandLineArgs& args)
+		: App(args)
 	{
-		PushLayer(new VoxelicousEngine::ImGuiLayer(*m_Renderer, *m_Device, *m_GlobalPool));
-		PushLayer(new VoxelicousEngine::DefaultLayer(*m_Renderer, *m_Device, *m_GlobalPool));
+		if (!IsHeadless())
+			PushLayer(new VoxelicousEngine::ImGuiLayer(*m_Renderer, *m_Device));
+		PushLayer(new VoxelicousEngine::DefaultLayer(*m_Renderer, *m_Device, *m_GlobalDescriptorAllocator));
 	}
 
 	~FirstApp() override = default;
 };
 
-VoxelicousEngine::App* VoxelicousEngine::CreateApp()
+VoxelicousEngine::App* VoxelicousEngine::CreateApp(const AppCommandLineArgs& args)
 {
-	return new FirstApp();
+	return new FirstApp(args);
 }
\ No newline at end of file
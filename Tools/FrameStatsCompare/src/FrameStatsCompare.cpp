@@ -0,0 +1,215 @@
+// FrameStatsCompare: compares two frame statistics summaries written with --benchmark-output and fails
+// when a metric got slower than the baseline by more than a threshold.
+//
+// Usage: FrameStatsCompare <baseline.json> <current.json> [--threshold <percent>] [--min-delta <ms>]
+//                          [--stats p50,p95,p99]
+// Exit codes: 0 = no regression, 1 = regression, 2 = invalid input
+
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+    // Minimal reader for the summary format: nested objects of numbers, flattened to "a.b.c" keys
+    class SummaryParser
+    {
+    public:
+        explicit SummaryParser(std::string text) : m_Text(std::move(text))
+        {
+        }
+
+        bool Parse(std::map<std::string, double>& values)
+        {
+            SkipWhitespace();
+            return ParseObject("", values);
+        }
+
+    private:
+        bool ParseObject(const std::string& prefix, std::map<std::string, double>& values)
+        {
+            if (!Consume('{'))
+                return false;
+
+            SkipWhitespace();
+            if (Consume('}'))
+                return true;
+
+            while (true)
+            {
+                std::string key;
+                if (!ParseString(key) || !Consume(':'))
+                    return false;
+
+                const std::string path = prefix.empty() ? key : prefix + "." + key;
+                SkipWhitespace();
+                if (Peek() == '{')
+                {
+                    if (!ParseObject(path, values))
+                        return false;
+                }
+                else
+                {
+                    const char* begin = m_Text.c_str() + m_Position;
+                    char* end = nullptr;
+                    const double value = std::strtod(begin, &end);
+                    if (end == begin)
+                        return false;
+                    m_Position += end - begin;
+                    values[path] = value;
+                }
+
+                SkipWhitespace();
+                if (Consume('}'))
+                    return true;
+                if (!Consume(','))
+                    return false;
+            }
+        }
+
+        bool ParseString(std::string& out)
+        {
+            SkipWhitespace();
+            if (!Consume('"'))
+                return false;
+            while (m_Position < m_Text.size() && m_Text[m_Position] != '"')
+                out += m_Text[m_Position++];
+            return Consume('"');
+        }
+
+        bool Consume(const char c)
+        {
+            SkipWhitespace();
+            if (Peek() != c)
+                return false;
+            m_Position++;
+            return true;
+        }
+
+        char Peek() const { return m_Position < m_Text.size() ? m_Text[m_Position] : '\0'; }
+
+        void SkipWhitespace()
+        {
+            while (m_Position < m_Text.size() && std::isspace(static_cast<unsigned char>(m_Text[m_Position])))
+                m_Position++;
+        }
+
+        std::string m_Text;
+        size_t m_Position = 0;
+    };
+
+    bool LoadSummary(const char* filePath, std::map<std::string, double>& values)
+    {
+        std::ifstream file{filePath};
+        if (!file.is_open())
+        {
+            std::fprintf(stderr, "Failed to open %s\n", filePath);
+            return false;
+        }
+
+        std::stringstream buffer;
+        buffer << file.rdbuf();
+        if (!SummaryParser(buffer.str()).Parse(values))
+        {
+            std::fprintf(stderr, "Failed to parse %s\n", filePath);
+            return false;
+        }
+        return true;
+    }
+
+    std::vector<std::string> Split(const std::string& list)
+    {
+        std::vector<std::string> items;
+        std::stringstream stream(list);
+        std::string item;
+        while (std::getline(stream, item, ','))
+        {
+            if (!item.empty())
+                items.push_back(item);
+        }
+        return items;
+    }
+}
+
+int main(const int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        std::fprintf(stderr, "Usage: %s <baseline.json> <current.json> [--threshold <percent>] "
+                     "[--min-delta <ms>] [--stats p50,p95,p99]\n", argv[0]);
+        return 2;
+    }
+
+    double thresholdPercent = 10.0;
+    // Differences below this are noise, however large they are relative to a tiny baseline
+    double minDeltaMs = 0.05;
+    std::vector<std::string> stats = {"p50", "p95", "p99"};
+    for (int i = 3; i + 1 < argc; i += 2)
+    {
+        const std::string option = argv[i];
+        if (option == "--threshold")
+            thresholdPercent = std::atof(argv[i + 1]);
+        else if (option == "--min-delta")
+            minDeltaMs = std::atof(argv[i + 1]);
+        else if (option == "--stats")
+            stats = Split(argv[i + 1]);
+        else
+        {
+            std::fprintf(stderr, "Unknown option %s\n", option.c_str());
+            return 2;
+        }
+    }
+
+    std::map<std::string, double> baseline;
+    std::map<std::string, double> current;
+    if (!LoadSummary(argv[1], baseline) || !LoadSummary(argv[2], current))
+        return 2;
+
+    std::printf("%-16s %-5s %12s %12s %9s\n", "metric", "stat", "baseline ms", "current ms", "change");
+
+    bool regressed = false;
+    for (const auto& [key, count] : baseline)
+    {
+        // Keys look like metrics.<name>.count
+        constexpr std::string_view countSuffix = ".count";
+        if (key.rfind("metrics.", 0) != 0 || !key.ends_with(countSuffix))
+            continue;
+
+        const std::string metricPath = key.substr(0, key.size() - countSuffix.size());
+        const auto currentCount = current.find(key);
+        if (count == 0.0 || currentCount == current.end() || currentCount->second == 0.0)
+            continue;
+
+        for (const std::string& stat : stats)
+        {
+            const auto baselineValue = baseline.find(metricPath + "." + stat);
+            const auto currentValue = current.find(metricPath + "." + stat);
+            if (baselineValue == baseline.end() || currentValue == current.end())
+                continue;
+
+            const double delta = currentValue->second - baselineValue->second;
+            const double changePercent = baselineValue->second > 0.0 ? delta / baselineValue->second * 100.0 : 0.0;
+            const bool failed = changePercent > thresholdPercent && delta > minDeltaMs;
+            regressed |= failed;
+
+            std::printf("%-16s %-5s %12.4f %12.4f %+8.1f%%%s\n",
+                        metricPath.substr(8).c_str(), stat.c_str(), baselineValue->second, currentValue->second,
+                        changePercent, failed ? "  REGRESSION" : "");
+        }
+    }
+
+    if (regressed)
+    {
+        std::printf("FAILED: regression above %.1f%%\n", thresholdPercent);
+        return 1;
+    }
+
+    std::printf("OK\n");
+    return 0;
+}
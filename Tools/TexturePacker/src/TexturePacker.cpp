@@ -0,0 +1,219 @@
+// TexturePacker: packs a directory of equally sized images into one texture array pack (see TexturePack),
+// with the mip chain generated up front so the engine loads it with a single read and no processing.
+// Layers are sorted by file name and named after it without the extension.
+//
+// Usage: TexturePacker <input directory> <output.vetp> [--filter box|kaiser] [--clamp] [--linear]
+//                      [--format rgba|bc1|bc4|bc5|bc7] [--quality fast|normal|high] [--cache <directory>]
+// Inputs are binary PPM (P6) or PAM (P7, RGB or RGB_ALPHA) files with 8 bit channels. Block-compressed
+// output is looked up in and stored to the cache directory when one is given, so unchanged sources aren't
+// encoded again.
+// Exit codes: 0 = success, 1 = packing failed, 2 = invalid arguments
+
+#include "vepch.h"
+
+#include "Assets/MipGenerator.h"
+#include "Assets/TextureCache.h"
+#include "Assets/TexturePack.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+using namespace VoxelicousEngine;
+
+namespace
+{
+    struct Image
+    {
+        uint32_t Width = 0;
+        uint32_t Height = 0;
+        std::vector<uint8_t> Rgba;
+    };
+
+    // Reads the next header token, skipping whitespace and comments
+    std::string ReadToken(std::istream& stream)
+    {
+        std::string token;
+        while (stream >> token && token[0] == '#')
+        {
+            std::string comment;
+            std::getline(stream, comment);
+        }
+        return token;
+    }
+
+    bool ReadImage(const std::filesystem::path& path, Image& image)
+    {
+        std::ifstream file{path, std::ios::binary};
+        if (!file)
+            return false;
+
+        const std::string magic = ReadToken(file);
+        uint32_t depth = 3;
+        uint32_t maxValue = 0;
+        if (magic == "P6")
+        {
+            image.Width = std::stoul(ReadToken(file));
+            image.Height = std::stoul(ReadToken(file));
+            maxValue = std::stoul(ReadToken(file));
+        }
+        else if (magic == "P7")
+        {
+            for (std::string key = ReadToken(file); key != "ENDHDR" && file; key = ReadToken(file))
+            {
+                if (key == "WIDTH")
+                    image.Width = std::stoul(ReadToken(file));
+                else if (key == "HEIGHT")
+                    image.Height = std::stoul(ReadToken(file));
+                else if (key == "DEPTH")
+                    depth = std::stoul(ReadToken(file));
+                else if (key == "MAXVAL")
+                    maxValue = std::stoul(ReadToken(file));
+                else if (key == "TUPLTYPE")
+                    ReadToken(file);
+            }
+        }
+        else
+            return false;
+
+        if (maxValue != 255 || (depth != 3 && depth != 4) || image.Width == 0 || image.Height == 0)
+            return false;
+        // A single whitespace character separates the header from the pixels
+        file.get();
+
+        const size_t pixelCount = static_cast<size_t>(image.Width) * image.Height;
+        std::vector<uint8_t> pixels(pixelCount * depth);
+        if (!file.read(reinterpret_cast<char*>(pixels.data()), static_cast<std::streamsize>(pixels.size())))
+            return false;
+
+        image.Rgba.resize(pixelCount * 4);
+        for (size_t i = 0; i < pixelCount; i++)
+        {
+            image.Rgba[i * 4 + 0] = pixels[i * depth + 0];
+            image.Rgba[i * 4 + 1] = pixels[i * depth + 1];
+            image.Rgba[i * 4 + 2] = pixels[i * depth + 2];
+            image.Rgba[i * 4 + 3] = depth == 4 ? pixels[i * depth + 3] : 255;
+        }
+        return true;
+    }
+}
+
+int main(const int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        std::fprintf(stderr, "Usage: %s <input directory> <output.vetp> [--filter box|kaiser] [--clamp] [--linear] "
+                     "[--format rgba|bc1|bc4|bc5|bc7] [--quality fast|normal|high] [--cache <directory>]\n", argv[0]);
+        return 2;
+    }
+
+    Log::Init();
+
+    MipSettings settings;
+    bool linear = false;
+    std::string format = "rgba";
+    TextureQuality quality = TextureQuality::Normal;
+    std::string cacheDirectory;
+    for (int i = 3; i < argc; i++)
+    {
+        const std::string option = argv[i];
+        if (option == "--filter" && i + 1 < argc)
+        {
+            const std::string filter = argv[++i];
+            settings.Filter = filter == "box" ? MipFilter::Box : MipFilter::Kaiser;
+        }
+        else if (option == "--clamp")
+            settings.EdgeMode = MipEdgeMode::Clamp;
+        else if (option == "--linear")
+            linear = true;
+        else if (option == "--format" && i + 1 < argc)
+            format = argv[++i];
+        else if (option == "--quality" && i + 1 < argc)
+        {
+            const std::string value = argv[++i];
+            quality = value == "fast" ? TextureQuality::Fast : value == "high" ? TextureQuality::High : TextureQuality::Normal;
+        }
+        else if (option == "--cache" && i + 1 < argc)
+            cacheDirectory = argv[++i];
+        else
+        {
+            std::fprintf(stderr, "Unknown option %s\n", option.c_str());
+            return 2;
+        }
+    }
+
+    TextureEncodeSettings encodeSettings{TextureFormat::RGBA8Srgb, quality};
+    if (format == "bc1")
+        encodeSettings.Format = linear ? TextureFormat::BC1RgbaUnorm : TextureFormat::BC1RgbaSrgb;
+    else if (format == "bc4")
+        encodeSettings.Format = TextureFormat::BC4Unorm;
+    else if (format == "bc5")
+        encodeSettings.Format = TextureFormat::BC5Unorm;
+    else if (format == "bc7")
+        encodeSettings.Format = linear ? TextureFormat::BC7Unorm : TextureFormat::BC7Srgb;
+    else if (format != "rgba")
+    {
+        std::fprintf(stderr, "Unknown format %s\n", format.c_str());
+        return 2;
+    }
+
+    std::vector<std::filesystem::path> inputs;
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(argv[1], error))
+    {
+        const std::string extension = entry.path().extension().string();
+        if (entry.is_regular_file() && (extension == ".ppm" || extension == ".pam"))
+            inputs.push_back(entry.path());
+    }
+    if (error || inputs.empty())
+    {
+        std::fprintf(stderr, "No .ppm or .pam images found in %s\n", argv[1]);
+        return 1;
+    }
+    std::ranges::sort(inputs);
+
+    TextureData texture;
+    texture.Format = linear ? TextureFormat::RGBA8Unorm : TextureFormat::RGBA8Srgb;
+    texture.LayerCount = static_cast<uint32_t>(inputs.size());
+    for (const std::filesystem::path& input : inputs)
+    {
+        Image image;
+        if (!ReadImage(input, image))
+        {
+            std::fprintf(stderr, "Failed to read %s\n", input.string().c_str());
+            return 1;
+        }
+        if (texture.Pixels.empty())
+        {
+            texture.Width = image.Width;
+            texture.Height = image.Height;
+            texture.Pixels.reserve(texture.GetLayerSize(0) * texture.LayerCount);
+        }
+        else if (image.Width != texture.Width || image.Height != texture.Height)
+        {
+            std::fprintf(stderr, "%s is %ux%u, expected %ux%u like the other layers\n", input.string().c_str(),
+                         image.Width, image.Height, texture.Width, texture.Height);
+            return 1;
+        }
+        const auto* rgba = reinterpret_cast<const std::byte*>(image.Rgba.data());
+        texture.Pixels.insert(texture.Pixels.end(), rgba, rgba + image.Rgba.size());
+        texture.LayerNames.push_back(input.stem().string());
+    }
+
+    MipGenerator::Generate(texture, settings);
+    if (IsCompressedTextureFormat(encodeSettings.Format))
+    {
+        const TextureData source = std::move(texture);
+        if (!cacheDirectory.empty())
+            texture = TextureCache(cacheDirectory).GetOrEncode(source, encodeSettings);
+        else
+            texture = TextureEncoder::Encode(source, encodeSettings);
+        std::printf("Encoded with %.2f dB PSNR\n", TextureEncoder::ComputePsnr(source, texture));
+    }
+    if (!TexturePack::Write(argv[2], texture))
+        return 1;
+
+    std::printf("Packed %u layers of %ux%u with %u mips into %s (%zu KiB)\n", texture.LayerCount, texture.Width,
+                texture.Height, texture.MipCount, argv[2], texture.Pixels.size() / 1024);
+    return 0;
+}
@@ -0,0 +1,368 @@
+#include "vepch.h"
+#include "MeshOptimizer.h"
+
+#include <cmath>
+
+namespace VoxelicousEngine
+{
+    namespace
+    {
+        // Triangles around each vertex, in compressed rows
+        struct Adjacency
+        {
+            std::vector<uint32_t> Offsets;
+            std::vector<uint32_t> Triangles;
+
+            Adjacency(const std::span<const uint32_t> indices, const uint32_t vertexCount)
+                : Offsets(vertexCount + 1, 0), Triangles(indices.size())
+            {
+                for (const uint32_t index : indices)
+                {
+                    Offsets[index + 1]++;
+                }
+                for (uint32_t vertex = 0; vertex < vertexCount; vertex++)
+                {
+                    Offsets[vertex + 1] += Offsets[vertex];
+                }
+                std::vector<uint32_t> cursor(Offsets.begin(), Offsets.end() - 1);
+                for (size_t corner = 0; corner < indices.size(); corner++)
+                {
+                    Triangles[cursor[indices[corner]]++] = static_cast<uint32_t>(corner / 3);
+                }
+            }
+        };
+
+        // Tipsify output order of the triangles of indices, and where the algorithm had to jump to an unrelated
+        // vertex (the hard cluster boundaries of the overdraw pass)
+        void Tipsify(const std::span<const uint32_t> indices, const uint32_t vertexCount, const uint32_t cacheSize,
+                     std::vector<uint32_t>& order, std::vector<uint32_t>* clusters)
+        {
+            const size_t triangleCount = indices.size() / 3;
+            const Adjacency adjacency{indices, vertexCount};
+
+            std::vector<uint32_t> liveTriangles(vertexCount);
+            for (uint32_t vertex = 0; vertex < vertexCount; vertex++)
+            {
+                liveTriangles[vertex] = adjacency.Offsets[vertex + 1] - adjacency.Offsets[vertex];
+            }
+            std::vector<uint32_t> cacheTime(vertexCount, 0);
+            std::vector<bool> emitted(triangleCount, false);
+            std::vector<uint32_t> deadEnd;
+            std::vector<uint32_t> candidates;
+            order.clear();
+            order.reserve(triangleCount);
+
+            uint32_t time = cacheSize + 1;
+            uint32_t cursor = 0;
+            int64_t fan = 0;
+            while (fan >= 0)
+            {
+                candidates.clear();
+                const auto fanVertex = static_cast<uint32_t>(fan);
+                for (uint32_t i = adjacency.Offsets[fanVertex]; i < adjacency.Offsets[fanVertex + 1]; i++)
+                {
+                    const uint32_t triangle = adjacency.Triangles[i];
+                    if (emitted[triangle])
+                    {
+                        continue;
+                    }
+                    for (uint32_t corner = 0; corner < 3; corner++)
+                    {
+                        const uint32_t vertex = indices[triangle * 3 + corner];
+                        deadEnd.push_back(vertex);
+                        candidates.push_back(vertex);
+                        liveTriangles[vertex]--;
+                        if (time - cacheTime[vertex] > cacheSize)
+                        {
+                            cacheTime[vertex] = time++;
+                        }
+                    }
+                    emitted[triangle] = true;
+                    order.push_back(triangle);
+                }
+
+                // Next fan: the candidate that stays in the cache longest while its remaining triangles are
+                // emitted, otherwise the most recently touched vertex with triangles left
+                int64_t next = -1;
+                int64_t bestPriority = -1;
+                for (const uint32_t vertex : candidates)
+                {
+                    if (liveTriangles[vertex] == 0)
+                    {
+                        continue;
+                    }
+                    int64_t priority = 0;
+                    if (time - cacheTime[vertex] + 2 * liveTriangles[vertex] <= cacheSize)
+                    {
+                        priority = time - cacheTime[vertex];
+                    }
+                    if (priority > bestPriority)
+                    {
+                        bestPriority = priority;
+                        next = vertex;
+                    }
+                }
+
+                if (next < 0)
+                {
+                    while (!deadEnd.empty() && next < 0)
+                    {
+                        const uint32_t vertex = deadEnd.back();
+                        deadEnd.pop_back();
+                        if (liveTriangles[vertex] > 0)
+                        {
+                            next = vertex;
+                        }
+                    }
+                    for (; next < 0 && cursor < vertexCount; cursor++)
+                    {
+                        if (liveTriangles[cursor] > 0)
+                        {
+                            next = cursor;
+                        }
+                    }
+                    if (next >= 0 && clusters && !order.empty())
+                    {
+                        clusters->push_back(static_cast<uint32_t>(order.size()));
+                    }
+                }
+                fan = next;
+            }
+        }
+
+        // FIFO post-transform cache simulation
+        class VertexCache
+        {
+        public:
+            VertexCache(const uint32_t vertexCount, const uint32_t cacheSize)
+                : m_InsertTime(vertexCount, 0), m_CacheSize{cacheSize}
+            {
+            }
+
+            // Returns true when the vertex had to be transformed
+            bool Access(const uint32_t vertex)
+            {
+                // A vertex is cached while fewer than cacheSize others were inserted after it
+                if (m_Time - m_InsertTime[vertex] < m_CacheSize)
+                {
+                    return false;
+                }
+                m_InsertTime[vertex] = m_Time++;
+                return true;
+            }
+
+            void Clear()
+            {
+                m_Time += m_CacheSize;
+            }
+
+        private:
+            std::vector<uint64_t> m_InsertTime;
+            // Starts far from the zeroed insert times, so untouched vertices count as evicted
+            uint64_t m_Time = 1ull << 32;
+            uint32_t m_CacheSize;
+        };
+
+        glm::vec3 Cross(const glm::vec3& a, const glm::vec3& b)
+        {
+            return {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x};
+        }
+
+        float Dot(const glm::vec3& a, const glm::vec3& b)
+        {
+            return a.x * b.x + a.y * b.y + a.z * b.z;
+        }
+    }
+
+    void MeshOptimizer::Optimize(MeshData& mesh, const MeshOptimizeSettings& settings)
+    {
+        VE_PROFILE_FUNCTION();
+
+        const auto vertexCount = static_cast<uint32_t>(mesh.Vertices.size());
+        if (mesh.Indices.empty() || vertexCount == 0)
+        {
+            return;
+        }
+        if (settings.ReduceOverdraw)
+        {
+            OptimizeOverdraw(mesh.Indices, mesh.Vertices, settings.CacheSize, settings.OverdrawThreshold);
+        }
+        else
+        {
+            OptimizeVertexCache(mesh.Indices, vertexCount, settings.CacheSize);
+        }
+        OptimizeVertexFetch(mesh);
+    }
+
+    void MeshOptimizer::OptimizeVertexCache(const std::span<uint32_t> indices, const uint32_t vertexCount,
+                                            const uint32_t cacheSize)
+    {
+        assert(indices.size() % 3 == 0 && "Mesh optimization expects a triangle list");
+        // Tipsify starts its first fan at vertex 0, which an empty mesh doesn't have
+        if (indices.empty() || vertexCount == 0)
+        {
+            return;
+        }
+
+        std::vector<uint32_t> order;
+        Tipsify(indices, vertexCount, cacheSize, order, nullptr);
+
+        const std::vector<uint32_t> source(indices.begin(), indices.end());
+        for (size_t i = 0; i < order.size(); i++)
+        {
+            std::copy_n(source.begin() + order[i] * 3, 3, indices.begin() + i * 3);
+        }
+    }
+
+    void MeshOptimizer::OptimizeOverdraw(const std::span<uint32_t> indices, const std::span<const Vertex> vertices,
+                                         const uint32_t cacheSize, const float threshold)
+    {
+        assert(indices.size() % 3 == 0 && "Mesh optimization expects a triangle list");
+
+        const auto vertexCount = static_cast<uint32_t>(vertices.size());
+        if (indices.empty() || vertexCount == 0)
+        {
+            return;
+        }
+        const size_t triangleCount = indices.size() / 3;
+        std::vector<uint32_t> order;
+        std::vector<uint32_t> hardBoundaries{0};
+        Tipsify(indices, vertexCount, cacheSize, order, &hardBoundaries);
+        hardBoundaries.push_back(static_cast<uint32_t>(triangleCount));
+
+        // Soft boundaries: within each hard cluster, start a new cluster whenever the misses so far are within
+        // threshold of the whole cluster's ACMR, which costs at most that much vertex cache efficiency
+        std::vector<uint32_t> clusterStarts;
+        VertexCache cache{vertexCount, cacheSize};
+        for (size_t cluster = 0; cluster + 1 < hardBoundaries.size(); cluster++)
+        {
+            const uint32_t begin = hardBoundaries[cluster];
+            const uint32_t end = hardBoundaries[cluster + 1];
+            if (begin == end)
+            {
+                continue;
+            }
+
+            cache.Clear();
+            uint32_t clusterMisses = 0;
+            for (uint32_t i = begin; i < end; i++)
+            {
+                for (uint32_t corner = 0; corner < 3; corner++)
+                {
+                    clusterMisses += cache.Access(indices[order[i] * 3 + corner]) ? 1 : 0;
+                }
+            }
+            const float clusterAcmr = static_cast<float>(clusterMisses) / static_cast<float>(end - begin);
+
+            cache.Clear();
+            clusterStarts.push_back(begin);
+            uint32_t misses = 0;
+            uint32_t start = begin;
+            for (uint32_t i = begin; i < end; i++)
+            {
+                for (uint32_t corner = 0; corner < 3; corner++)
+                {
+                    misses += cache.Access(indices[order[i] * 3 + corner]) ? 1 : 0;
+                }
+                const uint32_t count = i + 1 - start;
+                // Tiny clusters sort no better than the triangles around them
+                if (i + 1 < end && count >= 16 &&
+                    static_cast<float>(misses) / static_cast<float>(count) <= threshold * clusterAcmr)
+                {
+                    start = i + 1;
+                    clusterStarts.push_back(start);
+                    misses = 0;
+                    cache.Clear();
+                }
+            }
+        }
+        clusterStarts.push_back(static_cast<uint32_t>(triangleCount));
+
+        // Area-weighted centroid of the mesh and centroid and normal of every cluster
+        const size_t clusterCount = clusterStarts.size() - 1;
+        std::vector<glm::vec3> clusterCentroids(clusterCount, glm::vec3{0.0f});
+        std::vector<glm::vec3> clusterNormals(clusterCount, glm::vec3{0.0f});
+        glm::vec3 meshCentroid{0.0f};
+        float meshArea = 0.0f;
+        for (size_t cluster = 0; cluster < clusterCount; cluster++)
+        {
+            float clusterArea = 0.0f;
+            for (uint32_t i = clusterStarts[cluster]; i < clusterStarts[cluster + 1]; i++)
+            {
+                const glm::vec3& a = vertices[indices[order[i] * 3 + 0]].Position;
+                const glm::vec3& b = vertices[indices[order[i] * 3 + 1]].Position;
+                const glm::vec3& c = vertices[indices[order[i] * 3 + 2]].Position;
+                const glm::vec3 normal = Cross(b - a, c - a);
+                const float area = std::sqrt(Dot(normal, normal));
+                clusterCentroids[cluster] += (a + b + c) * (area / 3.0f);
+                clusterNormals[cluster] += normal;
+                clusterArea += area;
+            }
+            meshCentroid += clusterCentroids[cluster];
+            meshArea += clusterArea;
+            clusterCentroids[cluster] = clusterArea > 0.0f ? clusterCentroids[cluster] / clusterArea : glm::vec3{0.0f};
+        }
+        meshCentroid = meshArea > 0.0f ? meshCentroid / meshArea : glm::vec3{0.0f};
+
+        std::vector<float> sortKeys(clusterCount);
+        std::vector<uint32_t> clusterOrder(clusterCount);
+        for (size_t cluster = 0; cluster < clusterCount; cluster++)
+        {
+            const float length = std::sqrt(Dot(clusterNormals[cluster], clusterNormals[cluster]));
+            const glm::vec3 normal = length > 0.0f ? clusterNormals[cluster] / length : glm::vec3{0.0f};
+            sortKeys[cluster] = Dot(clusterCentroids[cluster] - meshCentroid, normal);
+            clusterOrder[cluster] = static_cast<uint32_t>(cluster);
+        }
+        // Outward-facing clusters first, they are the ones most likely to hide the others
+        std::ranges::stable_sort(clusterOrder, [&sortKeys](const uint32_t a, const uint32_t b)
+        {
+            return sortKeys[a] > sortKeys[b];
+        });
+
+        const std::vector<uint32_t> source(indices.begin(), indices.end());
+        size_t output = 0;
+        for (const uint32_t cluster : clusterOrder)
+        {
+            for (uint32_t i = clusterStarts[cluster]; i < clusterStarts[cluster + 1]; i++)
+            {
+                std::copy_n(source.begin() + order[i] * 3, 3, indices.begin() + output);
+                output += 3;
+            }
+        }
+    }
+
+    void MeshOptimizer::OptimizeVertexFetch(MeshData& mesh)
+    {
+        constexpr uint32_t unused = UINT32_MAX;
+        std::vector<uint32_t> remap(mesh.Vertices.size(), unused);
+        std::vector<Vertex> vertices;
+        vertices.reserve(mesh.Vertices.size());
+        for (uint32_t& index : mesh.Indices)
+        {
+            if (remap[index] == unused)
+            {
+                remap[index] = static_cast<uint32_t>(vertices.size());
+                vertices.push_back(mesh.Vertices[index]);
+            }
+            index = remap[index];
+        }
+        // Vertices no triangle uses are dropped
+        mesh.Vertices = std::move(vertices);
+    }
+
+    float MeshOptimizer::ComputeAcmr(const std::span<const uint32_t> indices, const uint32_t vertexCount,
+                                     const uint32_t cacheSize)
+    {
+        if (indices.size() < 3)
+        {
+            return 0.0f;
+        }
+        VertexCache cache{vertexCount, cacheSize};
+        uint32_t misses = 0;
+        for (const uint32_t index : indices)
+        {
+            misses += cache.Access(index) ? 1 : 0;
+        }
+        return static_cast<float>(misses) / static_cast<float>(indices.size() / 3);
+    }
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "Core/Mesh.h"
+
+namespace VoxelicousEngine
+{
+    struct MeshOptimizeSettings
+    {
+        // Post-transform cache size the triangle order is tuned for, 16 is a safe choice for current GPUs
+        uint32_t CacheSize = 16;
+        bool ReduceOverdraw = true;
+        // How much worse than the cache-optimal ACMR the overdraw pass may make a cluster in exchange for
+        // finer clusters to sort
+        float OverdrawThreshold = 1.05f;
+    };
+
+    // Offline reordering of indexed triangle lists for the GPU, run on imported meshes before upload:
+    //
+    //   Vertex cache    Tipsify (Sander et al. 2007): fans around recently used vertices so most corners hit the
+    //                   post-transform cache, linear in the triangle count
+    //   Overdraw        splits the Tipsify order into clusters and draws the ones facing away from the mesh
+    //                   centre first, so they occlude the rest independently of the view direction
+    //   Vertex fetch    renumbers vertices in first-use order, so vertex fetches walk memory linearly
+    //
+    // Meshes keep the same triangles with the same winding, only their order and the vertex numbering change.
+    class MeshOptimizer
+    {
+    public:
+        static void Optimize(MeshData& mesh, const MeshOptimizeSettings& settings = {});
+
+        static void OptimizeVertexCache(std::span<uint32_t> indices, uint32_t vertexCount, uint32_t cacheSize = 16);
+        static void OptimizeOverdraw(std::span<uint32_t> indices, std::span<const Vertex> vertices,
+                                     uint32_t cacheSize = 16, float threshold = 1.05f);
+        static void OptimizeVertexFetch(MeshData& mesh);
+
+        // Average cache miss ratio: vertex shader invocations per triangle with a FIFO cache of cacheSize
+        // entries, between 0.5 (ideal) and 3
+        static float ComputeAcmr(std::span<const uint32_t> indices, uint32_t vertexCount, uint32_t cacheSize = 16);
+    };
+}
@@ -0,0 +1,269 @@
+#include "vepch.h"
+#include "MeshPack.h"
+
+#include "Core/Hash.h"
+#include "Core/Lz4.h"
+
+#include <cstring>
+#include <fstream>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define VE_MESH_PACK_SSE2 1
+#include <emmintrin.h>
+#else
+#define VE_MESH_PACK_SSE2 0
+#endif
+
+namespace VoxelicousEngine
+{
+    namespace
+    {
+        constexpr std::array<char, 4> PACK_MAGIC{'V', 'E', 'M', 'P'};
+        constexpr uint32_t FLAG_COMPRESSED = 1u << 0;
+
+        struct Section
+        {
+            uint64_t Offset;
+            uint64_t StoredBytes;
+        };
+
+        struct PackHeader
+        {
+            std::array<char, 4> Magic;
+            uint32_t Version;
+            uint32_t Flags;
+            uint32_t VertexStride;
+            uint32_t VertexCount;
+            uint32_t IndexCount;
+            std::array<float, 3> BoundsMin;
+            std::array<float, 3> BoundsMax;
+            uint64_t ContentHash;
+            Section Vertices;
+            Section Indices;
+        };
+
+        static_assert(sizeof(PackHeader) == 88, "Mesh pack header layout changed");
+        static_assert(sizeof(Vertex) % sizeof(uint32_t) == 0, "Mesh packs shuffle vertices as 32-bit words");
+
+        size_t AlignUp(const size_t value)
+        {
+            return (value + MeshPack::DATA_ALIGNMENT - 1) & ~(MeshPack::DATA_ALIGNMENT - 1);
+        }
+
+        // Byte k of word i goes to plane k, position i
+        std::vector<std::byte> ShuffleBytes(const std::byte* data, const size_t size)
+        {
+            const size_t wordCount = size / 4;
+            std::vector<std::byte> shuffled(size);
+            for (size_t i = 0; i < wordCount; i++)
+            {
+                for (size_t plane = 0; plane < 4; plane++)
+                {
+                    shuffled[plane * wordCount + i] = data[i * 4 + plane];
+                }
+            }
+            return shuffled;
+        }
+
+        // Runs on every compressed load, so it interleaves 16 words per step where SSE2 is available
+        void UnshuffleBytes(const std::byte* shuffled, const size_t size, std::byte* data)
+        {
+            const size_t wordCount = size / 4;
+            const auto* plane0 = reinterpret_cast<const uint8_t*>(shuffled);
+            const uint8_t* plane1 = plane0 + wordCount;
+            const uint8_t* plane2 = plane1 + wordCount;
+            const uint8_t* plane3 = plane2 + wordCount;
+            auto* out = reinterpret_cast<uint8_t*>(data);
+
+            size_t i = 0;
+#if VE_MESH_PACK_SSE2
+            for (; i + 16 <= wordCount; i += 16)
+            {
+                const __m128i bytes0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(plane0 + i));
+                const __m128i bytes1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(plane1 + i));
+                const __m128i bytes2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(plane2 + i));
+                const __m128i bytes3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(plane3 + i));
+                const __m128i low01 = _mm_unpacklo_epi8(bytes0, bytes1);
+                const __m128i high01 = _mm_unpackhi_epi8(bytes0, bytes1);
+                const __m128i low23 = _mm_unpacklo_epi8(bytes2, bytes3);
+                const __m128i high23 = _mm_unpackhi_epi8(bytes2, bytes3);
+                auto* words = reinterpret_cast<__m128i*>(out + i * 4);
+                _mm_storeu_si128(words + 0, _mm_unpacklo_epi16(low01, low23));
+                _mm_storeu_si128(words + 1, _mm_unpackhi_epi16(low01, low23));
+                _mm_storeu_si128(words + 2, _mm_unpacklo_epi16(high01, high23));
+                _mm_storeu_si128(words + 3, _mm_unpackhi_epi16(high01, high23));
+            }
+#endif
+            for (; i < wordCount; i++)
+            {
+                out[i * 4 + 0] = plane0[i];
+                out[i * 4 + 1] = plane1[i];
+                out[i * 4 + 2] = plane2[i];
+                out[i * 4 + 3] = plane3[i];
+            }
+        }
+
+        std::vector<std::byte> CompressSection(const void* data, const size_t size)
+        {
+            const std::vector<std::byte> shuffled = ShuffleBytes(static_cast<const std::byte*>(data), size);
+            std::vector<std::byte> compressed(Lz4CompressBound(size));
+            compressed.resize(Lz4Compress(shuffled.data(), shuffled.size(), compressed.data()));
+            return compressed;
+        }
+
+        bool DecompressSection(const std::byte* stored, const size_t storedSize, std::vector<std::byte>& shuffled,
+                               std::byte* data, const size_t size)
+        {
+            shuffled.resize(size);
+            if (!Lz4Decompress(stored, storedSize, shuffled.data(), size))
+            {
+                return false;
+            }
+            UnshuffleBytes(shuffled.data(), size, data);
+            return true;
+        }
+    }
+
+    uint64_t MeshPack::ComputeContentHash(const MeshView& mesh)
+    {
+        return HashBytes(mesh.Indices, HashBytes(mesh.Vertices));
+    }
+
+    bool MeshPack::Write(const std::string& filePath, const MeshView& mesh, const bool compress)
+    {
+        VE_PROFILE_FUNCTION();
+
+        const size_t vertexBytes = mesh.Vertices.size_bytes();
+        const size_t indexBytes = mesh.Indices.size_bytes();
+        std::vector<std::byte> compressedVertices;
+        std::vector<std::byte> compressedIndices;
+        if (compress)
+        {
+            compressedVertices = CompressSection(mesh.Vertices.data(), vertexBytes);
+            compressedIndices = CompressSection(mesh.Indices.data(), indexBytes);
+        }
+
+        PackHeader header{};
+        header.Magic = PACK_MAGIC;
+        header.Version = VERSION;
+        header.Flags = compress ? FLAG_COMPRESSED : 0;
+        header.VertexStride = sizeof(Vertex);
+        header.VertexCount = static_cast<uint32_t>(mesh.Vertices.size());
+        header.IndexCount = static_cast<uint32_t>(mesh.Indices.size());
+        header.BoundsMin = {mesh.Bounds.Min.x, mesh.Bounds.Min.y, mesh.Bounds.Min.z};
+        header.BoundsMax = {mesh.Bounds.Max.x, mesh.Bounds.Max.y, mesh.Bounds.Max.z};
+        header.ContentHash = ComputeContentHash(mesh);
+        header.Vertices = {AlignUp(sizeof(PackHeader)), compress ? compressedVertices.size() : vertexBytes};
+        header.Indices = {AlignUp(header.Vertices.Offset + header.Vertices.StoredBytes),
+                          compress ? compressedIndices.size() : indexBytes};
+
+        std::ofstream file{filePath, std::ios::binary};
+        if (!file)
+        {
+            VE_CORE_ERROR("Failed to open mesh pack {0} for writing", filePath);
+            return false;
+        }
+
+        constexpr std::array<char, DATA_ALIGNMENT> padding{};
+        const auto writeSection = [&](const Section& section, const void* data)
+        {
+            const auto position = static_cast<size_t>(file.tellp());
+            file.write(padding.data(), static_cast<std::streamsize>(section.Offset - position));
+            file.write(static_cast<const char*>(data), static_cast<std::streamsize>(section.StoredBytes));
+        };
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        writeSection(header.Vertices, compress ? compressedVertices.data() : static_cast<const void*>(mesh.Vertices.data()));
+        writeSection(header.Indices, compress ? compressedIndices.data() : static_cast<const void*>(mesh.Indices.data()));
+        return static_cast<bool>(file);
+    }
+
+    bool MeshPack::Open(const std::string& filePath, const bool verifyHash)
+    {
+        VE_PROFILE_FUNCTION();
+
+        Close();
+        if (!m_File.Open(filePath))
+        {
+            return false;
+        }
+
+        PackHeader header{};
+        if (m_File.GetSize() < sizeof(header) ||
+            (std::memcpy(&header, m_File.GetData(), sizeof(header)), header.Magic != PACK_MAGIC))
+        {
+            VE_CORE_ERROR("{0} is not a mesh pack", filePath);
+            Close();
+            return false;
+        }
+        if (header.Version != VERSION || header.VertexStride != sizeof(Vertex))
+        {
+            VE_CORE_ERROR("Mesh pack {0} has unsupported version {1} or vertex stride {2}", filePath, header.Version,
+                          header.VertexStride);
+            Close();
+            return false;
+        }
+
+        m_Compressed = (header.Flags & FLAG_COMPRESSED) != 0;
+        const size_t vertexBytes = static_cast<size_t>(header.VertexCount) * sizeof(Vertex);
+        const size_t indexBytes = static_cast<size_t>(header.IndexCount) * sizeof(uint32_t);
+        const auto isInFile = [this](const Section& section)
+        {
+            return section.Offset % DATA_ALIGNMENT == 0 && section.Offset <= m_File.GetSize() &&
+                section.StoredBytes <= m_File.GetSize() - section.Offset;
+        };
+        if (!isInFile(header.Vertices) || !isInFile(header.Indices) ||
+            (!m_Compressed && (header.Vertices.StoredBytes != vertexBytes || header.Indices.StoredBytes != indexBytes)))
+        {
+            VE_CORE_ERROR("Mesh pack {0} is truncated or has an inconsistent header", filePath);
+            Close();
+            return false;
+        }
+
+        const std::byte* data = m_File.GetData();
+        const Vertex* vertices = reinterpret_cast<const Vertex*>(data + header.Vertices.Offset);
+        const uint32_t* indices = reinterpret_cast<const uint32_t*>(data + header.Indices.Offset);
+        if (m_Compressed)
+        {
+            m_Decompressed.resize((vertexBytes + indexBytes) / sizeof(uint32_t));
+            auto* decompressed = reinterpret_cast<std::byte*>(m_Decompressed.data());
+            std::vector<std::byte> shuffled;
+            if (!DecompressSection(data + header.Vertices.Offset, header.Vertices.StoredBytes, shuffled, decompressed,
+                                   vertexBytes) ||
+                !DecompressSection(data + header.Indices.Offset, header.Indices.StoredBytes, shuffled,
+                                   decompressed + vertexBytes, indexBytes))
+            {
+                VE_CORE_ERROR("Mesh pack {0} has corrupt compressed data", filePath);
+                Close();
+                return false;
+            }
+            vertices = reinterpret_cast<const Vertex*>(decompressed);
+            indices = reinterpret_cast<const uint32_t*>(decompressed + vertexBytes);
+            // Everything was copied out, so the mapping isn't needed any more
+            m_File.Close();
+        }
+
+        m_View.Vertices = {vertices, header.VertexCount};
+        m_View.Indices = {indices, header.IndexCount};
+        m_View.Bounds.Min = {header.BoundsMin[0], header.BoundsMin[1], header.BoundsMin[2]};
+        m_View.Bounds.Max = {header.BoundsMax[0], header.BoundsMax[1], header.BoundsMax[2]};
+        m_ContentHash = header.ContentHash;
+
+        if (verifyHash && ComputeContentHash(m_View) != m_ContentHash)
+        {
+            VE_CORE_ERROR("Mesh pack {0} doesn't match its content hash", filePath);
+            Close();
+            return false;
+        }
+        return true;
+    }
+
+    void MeshPack::Close()
+    {
+        m_File.Close();
+        m_Decompressed.clear();
+        m_Decompressed.shrink_to_fit();
+        m_View = {};
+        m_ContentHash = 0;
+        m_Compressed = false;
+    }
+}
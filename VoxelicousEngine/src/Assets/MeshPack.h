@@ -0,0 +1,48 @@
+#pragma once
+
+#include "Core/MappedFile.h"
+#include "Core/Mesh.h"
+
+namespace VoxelicousEngine
+{
+    // Binary container for one mesh, so a mesh parsed or meshed once reloads as a memory-mapped read:
+    //
+    //   Header          magic "VEMP", version, flags, vertex stride and counts, bounds, content hash and the
+    //                   offset and stored size of both sections
+    //   Vertices        Vertex array, at a DATA_ALIGNMENT boundary
+    //   Indices         uint32_t array, at a DATA_ALIGNMENT boundary
+    //
+    // Uncompressed sections are used in place from the mapping and copied straight into staging memory.
+    // Compressed sections are byte-plane shuffled (all first bytes of each 32-bit word, then all second
+    // bytes, ...), which groups float exponents and index high bytes into long runs, and then compressed
+    // with Lz4. The content hash covers the uncompressed vertex and index bytes. Values are little-endian.
+    class MeshPack
+    {
+    public:
+        static constexpr uint32_t VERSION = 1;
+        static constexpr size_t DATA_ALIGNMENT = 16;
+
+        MeshPack() = default;
+
+        static bool Write(const std::string& filePath, const MeshView& mesh, bool compress = false);
+        static uint64_t ComputeContentHash(const MeshView& mesh);
+
+        // Logs and returns false when the file isn't a valid pack. verifyHash rehashes the mesh to detect
+        // corruption, which costs about as much as touching every page of the mapping.
+        bool Open(const std::string& filePath, bool verifyHash = false);
+        void Close();
+
+        // Valid until the pack is closed or destroyed
+        const MeshView& GetView() const { return m_View; }
+        uint64_t GetContentHash() const { return m_ContentHash; }
+        bool IsCompressed() const { return m_Compressed; }
+
+    private:
+        MappedFile m_File;
+        // Backing memory of compressed packs, uncompressed ones point into the mapping
+        std::vector<uint32_t> m_Decompressed;
+        MeshView m_View;
+        uint64_t m_ContentHash = 0;
+        bool m_Compressed = false;
+    };
+}
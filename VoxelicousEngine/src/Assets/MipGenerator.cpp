@@ -0,0 +1,356 @@
+#include "vepch.h"
+#include "MipGenerator.h"
+
+#include "Core/JobSystem.h"
+
+#include <cmath>
+#include <numbers>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define VE_MIP_SSE2 1
+#include <emmintrin.h>
+#else
+#define VE_MIP_SSE2 0
+#endif
+
+namespace VoxelicousEngine
+{
+    namespace
+    {
+        // Layers are grouped into jobs of at least this many mip 0 pixels, so 16x16 block textures don't
+        // become one job each
+        constexpr uint32_t MIN_PIXELS_PER_JOB = 64 * 1024;
+
+        constexpr uint32_t KAISER_TAPS = 6;
+        constexpr uint32_t LINEAR_TO_SRGB_STEPS = 4096;
+
+        struct ConversionTables
+        {
+            std::array<float, 256> SrgbToLinear;
+            std::array<float, 256> UnormToFloat;
+            std::array<uint8_t, LINEAR_TO_SRGB_STEPS> LinearToSrgb;
+
+            ConversionTables()
+            {
+                for (uint32_t i = 0; i < 256; i++)
+                {
+                    const float value = static_cast<float>(i) / 255.0f;
+                    UnormToFloat[i] = value;
+                    SrgbToLinear[i] = value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+                }
+                for (uint32_t i = 0; i < LINEAR_TO_SRGB_STEPS; i++)
+                {
+                    const float value = static_cast<float>(i) / static_cast<float>(LINEAR_TO_SRGB_STEPS - 1);
+                    const float srgb = value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+                    LinearToSrgb[i] = static_cast<uint8_t>(srgb * 255.0f + 0.5f);
+                }
+            }
+        };
+
+        const ConversionTables& GetConversionTables()
+        {
+            static const ConversionTables tables;
+            return tables;
+        }
+
+        float BesselI0(const float x)
+        {
+            float sum = 1.0f;
+            float term = 1.0f;
+            for (int k = 1; k < 16; k++)
+            {
+                const float factor = x / (2.0f * static_cast<float>(k));
+                term *= factor * factor;
+                sum += term;
+            }
+            return sum;
+        }
+
+        // Weights of the source pixels 2x-2 .. 2x+3 for destination pixel x: a sinc windowed by a Kaiser
+        // window of width 3 and alpha 4, sampled at the source pixel centres in destination pixel units
+        const std::array<float, KAISER_TAPS>& GetKaiserWeights()
+        {
+            static const std::array<float, KAISER_TAPS> weights = []
+            {
+                constexpr float alpha = 4.0f;
+                constexpr float halfWidth = 1.5f;
+                std::array<float, KAISER_TAPS> result{};
+                float total = 0.0f;
+                for (uint32_t i = 0; i < KAISER_TAPS; i++)
+                {
+                    const float d = (static_cast<float>(i) - 2.5f) * 0.5f;
+                    const float x = std::numbers::pi_v<float> * d;
+                    const float sinc = std::sin(x) / x;
+                    const float t = d / halfWidth;
+                    const float window = BesselI0(alpha * std::sqrt(1.0f - t * t)) / BesselI0(alpha);
+                    result[i] = sinc * window;
+                    total += result[i];
+                }
+                for (float& weight : result)
+                {
+                    weight /= total;
+                }
+                return result;
+            }();
+            return weights;
+        }
+
+        uint32_t ResolveEdge(const int32_t index, const uint32_t size, const MipEdgeMode edgeMode)
+        {
+            const auto n = static_cast<int32_t>(size);
+            if (edgeMode == MipEdgeMode::Wrap)
+            {
+                return static_cast<uint32_t>((index % n + n) % n);
+            }
+            return static_cast<uint32_t>(std::clamp(index, 0, n - 1));
+        }
+
+        // Accumulates weighted RGBA float pixels
+        struct PixelSum
+        {
+#if VE_MIP_SSE2
+            __m128 Value = _mm_setzero_ps();
+
+            void Add(const float* pixel, const float weight)
+            {
+                Value = _mm_add_ps(Value, _mm_mul_ps(_mm_loadu_ps(pixel), _mm_set1_ps(weight)));
+            }
+
+            void Store(float* pixel) const { _mm_storeu_ps(pixel, Value); }
+#else
+            float Value[4]{};
+
+            void Add(const float* pixel, const float weight)
+            {
+                for (uint32_t c = 0; c < 4; c++)
+                {
+                    Value[c] += pixel[c] * weight;
+                }
+            }
+
+            void Store(float* pixel) const { std::copy_n(Value, 4, pixel); }
+#endif
+        };
+
+        // Filters RGBA float rows along x (stride 4 floats) or y (stride 4 * width floats), halving that axis
+        void FilterAxis(
+            const float* src, float* dst, const uint32_t srcSize, const uint32_t dstSize, const uint32_t lineCount,
+            const size_t pixelStride, const size_t lineStride, const MipEdgeMode edgeMode)
+        {
+            if (srcSize == 1)
+            {
+                for (uint32_t line = 0; line < lineCount; line++)
+                {
+                    std::copy_n(src + line * lineStride, 4, dst + line * lineStride);
+                }
+                return;
+            }
+
+            const std::array<float, KAISER_TAPS>& weights = GetKaiserWeights();
+            for (uint32_t i = 0; i < dstSize; i++)
+            {
+                std::array<size_t, KAISER_TAPS> taps{};
+                for (uint32_t k = 0; k < KAISER_TAPS; k++)
+                {
+                    const int32_t index = static_cast<int32_t>(i * 2 + k) - 2;
+                    taps[k] = ResolveEdge(index, srcSize, edgeMode) * pixelStride;
+                }
+                for (uint32_t line = 0; line < lineCount; line++)
+                {
+                    const float* srcLine = src + line * lineStride;
+                    PixelSum sum;
+                    for (uint32_t k = 0; k < KAISER_TAPS; k++)
+                    {
+                        sum.Add(srcLine + taps[k], weights[k]);
+                    }
+                    sum.Store(dst + line * lineStride + i * pixelStride);
+                }
+            }
+        }
+
+        // Per-job buffers reused across the layers of the job
+        struct KaiserScratch
+        {
+            std::vector<float> Current;
+            std::vector<float> Next;
+            std::vector<float> Temp;
+        };
+
+        void ToFloat(const uint8_t* src, const size_t pixelCount, const bool srgb, float* dst)
+        {
+            const ConversionTables& tables = GetConversionTables();
+            const std::array<float, 256>& colorTable = srgb ? tables.SrgbToLinear : tables.UnormToFloat;
+            for (size_t i = 0; i < pixelCount * 4; i += 4)
+            {
+                dst[i + 0] = colorTable[src[i + 0]];
+                dst[i + 1] = colorTable[src[i + 1]];
+                dst[i + 2] = colorTable[src[i + 2]];
+                dst[i + 3] = tables.UnormToFloat[src[i + 3]];
+            }
+        }
+
+        uint8_t FloatToUnorm(const float value)
+        {
+            return static_cast<uint8_t>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+        }
+
+        void FromFloat(const float* src, const size_t pixelCount, const bool srgb, uint8_t* dst)
+        {
+            const ConversionTables& tables = GetConversionTables();
+            constexpr auto maxStep = static_cast<float>(LINEAR_TO_SRGB_STEPS - 1);
+            for (size_t i = 0; i < pixelCount * 4; i += 4)
+            {
+                for (size_t c = 0; c < 3; c++)
+                {
+                    if (srgb)
+                    {
+                        const float step = std::clamp(src[i + c], 0.0f, 1.0f) * maxStep + 0.5f;
+                        dst[i + c] = tables.LinearToSrgb[static_cast<uint32_t>(step)];
+                    }
+                    else
+                    {
+                        dst[i + c] = FloatToUnorm(src[i + c]);
+                    }
+                }
+                dst[i + 3] = FloatToUnorm(src[i + 3]);
+            }
+        }
+
+        // Filters each mip from the float result of the previous one, so quantisation doesn't accumulate
+        void GenerateKaiserChain(
+            TextureData& texture, const uint32_t layer, const MipEdgeMode edgeMode, KaiserScratch& scratch)
+        {
+            const bool srgb = GetTextureFormatInfo(texture.Format).IsSrgb;
+            scratch.Current.resize(static_cast<size_t>(texture.Width) * texture.Height * 4);
+            ToFloat(reinterpret_cast<const uint8_t*>(texture.GetLayerData(0, layer)),
+                    static_cast<size_t>(texture.Width) * texture.Height, srgb, scratch.Current.data());
+
+            for (uint32_t mip = 1; mip < texture.MipCount; mip++)
+            {
+                const uint32_t srcWidth = texture.GetMipWidth(mip - 1);
+                const uint32_t srcHeight = texture.GetMipHeight(mip - 1);
+                const uint32_t dstWidth = texture.GetMipWidth(mip);
+                const uint32_t dstHeight = texture.GetMipHeight(mip);
+
+                scratch.Temp.resize(static_cast<size_t>(dstWidth) * srcHeight * 4);
+                scratch.Next.resize(static_cast<size_t>(dstWidth) * dstHeight * 4);
+                // Rows first into a dstWidth x srcHeight image, then its columns
+                for (uint32_t y = 0; y < srcHeight; y++)
+                {
+                    FilterAxis(scratch.Current.data() + static_cast<size_t>(y) * srcWidth * 4,
+                               scratch.Temp.data() + static_cast<size_t>(y) * dstWidth * 4,
+                               srcWidth, dstWidth, 1, 4, 0, edgeMode);
+                }
+                FilterAxis(scratch.Temp.data(), scratch.Next.data(), srcHeight, dstHeight, dstWidth,
+                           static_cast<size_t>(dstWidth) * 4, 4, edgeMode);
+
+                FromFloat(scratch.Next.data(), static_cast<size_t>(dstWidth) * dstHeight, srgb,
+                          reinterpret_cast<uint8_t*>(texture.GetLayerData(mip, layer)));
+                std::swap(scratch.Current, scratch.Next);
+            }
+        }
+    }
+
+    void MipGenerator::DownsampleBox(
+        const uint8_t* src, const uint32_t srcWidth, const uint32_t srcHeight, uint8_t* dst)
+    {
+        const uint32_t dstWidth = std::max(1u, srcWidth / 2);
+        const uint32_t dstHeight = std::max(1u, srcHeight / 2);
+        // A 1 pixel wide or high source averages the same pixel twice along that axis
+        const size_t nextPixel = srcWidth > 1 ? 4 : 0;
+        const size_t nextRow = srcHeight > 1 ? static_cast<size_t>(srcWidth) * 4 : 0;
+
+        for (uint32_t y = 0; y < dstHeight; y++)
+        {
+            const uint8_t* row0 = src + y * 2 * nextRow;
+            const uint8_t* row1 = row0 + nextRow;
+            uint8_t* out = dst + static_cast<size_t>(y) * dstWidth * 4;
+            uint32_t x = 0;
+
+#if VE_MIP_SSE2
+            // 8 source pixels of both rows become 4 destination pixels
+            if (nextPixel != 0)
+            {
+                const __m128i zero = _mm_setzero_si128();
+                const __m128i two = _mm_set1_epi16(2);
+                for (; x + 4 <= dstWidth; x += 4)
+                {
+                    const __m128i a0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + x * 8));
+                    const __m128i a1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + x * 8 + 16));
+                    const __m128i b0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + x * 8));
+                    const __m128i b1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + x * 8 + 16));
+
+                    // Vertical sums of source pixel pairs (0,1), (2,3), (4,5), (6,7) as 16 bit channels
+                    const __m128i s0 = _mm_add_epi16(_mm_unpacklo_epi8(a0, zero), _mm_unpacklo_epi8(b0, zero));
+                    const __m128i s1 = _mm_add_epi16(_mm_unpackhi_epi8(a0, zero), _mm_unpackhi_epi8(b0, zero));
+                    const __m128i s2 = _mm_add_epi16(_mm_unpacklo_epi8(a1, zero), _mm_unpacklo_epi8(b1, zero));
+                    const __m128i s3 = _mm_add_epi16(_mm_unpackhi_epi8(a1, zero), _mm_unpackhi_epi8(b1, zero));
+
+                    // Horizontal sum of each pair lands in the low 64 bits
+                    const __m128i h0 = _mm_add_epi16(s0, _mm_srli_si128(s0, 8));
+                    const __m128i h1 = _mm_add_epi16(s1, _mm_srli_si128(s1, 8));
+                    const __m128i h2 = _mm_add_epi16(s2, _mm_srli_si128(s2, 8));
+                    const __m128i h3 = _mm_add_epi16(s3, _mm_srli_si128(s3, 8));
+
+                    const __m128i lo = _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(h0, h1), two), 2);
+                    const __m128i hi = _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(h2, h3), two), 2);
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + x * 4), _mm_packus_epi16(lo, hi));
+                }
+            }
+#endif
+
+            for (; x < dstWidth; x++)
+            {
+                const uint8_t* p0 = row0 + x * 2 * nextPixel;
+                const uint8_t* p1 = row1 + x * 2 * nextPixel;
+                for (uint32_t c = 0; c < 4; c++)
+                {
+                    const uint32_t sum = p0[c] + p0[c + nextPixel] + p1[c] + p1[c + nextPixel];
+                    out[x * 4 + c] = static_cast<uint8_t>((sum + 2) / 4);
+                }
+            }
+        }
+    }
+
+    void MipGenerator::Generate(TextureData& texture, const MipSettings& settings)
+    {
+        VE_PROFILE_FUNCTION();
+
+        const TextureFormatInfo info = GetTextureFormatInfo(texture.Format);
+        assert(info.BlockWidth == 1 && info.BytesPerBlock == 4 && "Mips can only be generated for RGBA8 textures");
+
+        uint32_t mipCount = TextureData::GetFullMipCount(texture.Width, texture.Height);
+        if (settings.MaxMipCount != 0)
+        {
+            mipCount = std::min(mipCount, settings.MaxMipCount);
+        }
+        // Mip 0 of every layer comes first, so resizing keeps it in place
+        texture.MipCount = mipCount;
+        texture.Pixels.resize(texture.GetTotalSize());
+        if (mipCount == 1)
+        {
+            return;
+        }
+
+        const uint32_t layerPixels = std::max(1u, texture.Width * texture.Height);
+        const uint32_t batchSize = std::max(1u, MIN_PIXELS_PER_JOB / layerPixels);
+        JobSystem::Get().ParallelFor(texture.LayerCount, batchSize, [&](const uint32_t begin, const uint32_t end)
+        {
+            KaiserScratch scratch;
+            for (uint32_t layer = begin; layer < end; layer++)
+            {
+                if (settings.Filter == MipFilter::Kaiser)
+                {
+                    GenerateKaiserChain(texture, layer, settings.EdgeMode, scratch);
+                    continue;
+                }
+                for (uint32_t mip = 1; mip < mipCount; mip++)
+                {
+                    DownsampleBox(reinterpret_cast<const uint8_t*>(texture.GetLayerData(mip - 1, layer)),
+                                  texture.GetMipWidth(mip - 1), texture.GetMipHeight(mip - 1),
+                                  reinterpret_cast<uint8_t*>(texture.GetLayerData(mip, layer)));
+                }
+            }
+        });
+    }
+}
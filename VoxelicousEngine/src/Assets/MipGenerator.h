@@ -0,0 +1,42 @@
+#pragma once
+
+#include "TextureData.h"
+
+namespace VoxelicousEngine
+{
+    enum class MipFilter : uint8_t
+    {
+        // 2x2 average of the encoded values, fastest
+        Box,
+        // 6-tap windowed sinc in linear light, keeps small block textures sharp without ringing
+        Kaiser
+    };
+
+    // How the Kaiser filter samples past the texture border. Tiling block textures should wrap.
+    enum class MipEdgeMode : uint8_t
+    {
+        Clamp,
+        Wrap
+    };
+
+    struct MipSettings
+    {
+        MipFilter Filter = MipFilter::Kaiser;
+        MipEdgeMode EdgeMode = MipEdgeMode::Wrap;
+        // 0 builds the full chain down to 1x1
+        uint32_t MaxMipCount = 0;
+    };
+
+    // Builds mip chains of uncompressed RGBA8 textures on the CPU. Layers are filtered in parallel on the
+    // JobSystem and the filters use SSE2 where available.
+    class MipGenerator
+    {
+    public:
+        // Replaces the mip chain of the texture, reading only mip 0
+        static void Generate(TextureData& texture, const MipSettings& settings = {});
+
+        // Halves one RGBA8 image, srcWidth and srcHeight may be odd or 1
+        static void DownsampleBox(
+            const uint8_t* src, uint32_t srcWidth, uint32_t srcHeight, uint8_t* dst);
+    };
+}
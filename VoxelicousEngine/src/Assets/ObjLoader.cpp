@@ -0,0 +1,604 @@
+#include "vepch.h"
+#include "ObjLoader.h"
+
+#include "Core/JobSystem.h"
+#include "Core/MappedFile.h"
+
+#include <bit>
+#include <climits>
+#include <cmath>
+#include <cstring>
+
+namespace VoxelicousEngine
+{
+    namespace
+    {
+        // Index of a corner attribute that the face didn't specify
+        constexpr int32_t ABSENT = INT32_MIN;
+
+        // Exactly representable powers of ten, so scaling a mantissa below 2^53 rounds only once
+        constexpr std::array<double, 23> POWERS_OF_TEN{
+            1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+            1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+        };
+
+        struct Corner
+        {
+            int32_t Position;
+            int32_t Uv;
+            int32_t Normal;
+
+            bool operator==(const Corner& other) const
+            {
+                return Position == other.Position && Uv == other.Uv && Normal == other.Normal;
+            }
+        };
+
+        // Parse output of one chunk. Negative face indices count back from the end of the chunk's own
+        // attributes at that line, they are stored relative to the chunk start and fixed up once the
+        // attribute counts of the preceding chunks are known.
+        struct Chunk
+        {
+            std::vector<glm::vec3> Positions;
+            std::vector<glm::vec3> Colors;
+            std::vector<glm::vec2> Uvs;
+            std::vector<glm::vec3> Normals;
+            std::vector<Corner> Corners;
+            // Corner index * 3 + attribute (0 = position, 1 = uv, 2 = normal)
+            std::vector<uint32_t> RelativeIndices;
+            const char* Error = nullptr;
+        };
+
+        bool IsSpace(const char c)
+        {
+            return c == ' ' || c == '\t' || c == '\r';
+        }
+
+        const char* SkipSpaces(const char* p, const char* end)
+        {
+            while (p < end && IsSpace(*p))
+            {
+                p++;
+            }
+            return p;
+        }
+
+        const char* SkipLine(const char* p, const char* end)
+        {
+            const void* newline = std::memchr(p, '\n', static_cast<size_t>(end - p));
+            return newline ? static_cast<const char*>(newline) + 1 : end;
+        }
+
+        bool IsDigit(const char c)
+        {
+            return static_cast<unsigned char>(c - '0') < 10;
+        }
+
+        // SWAR digit parsing: eight ASCII digits are checked and converted with a few 64-bit operations
+        // instead of eight dependent multiply-adds
+        uint64_t LoadEightBytes(const char* p)
+        {
+            uint64_t value;
+            std::memcpy(&value, p, sizeof(value));
+            if constexpr (std::endian::native == std::endian::big)
+            {
+                value = ((value & 0x00000000FFFFFFFFull) << 32) | ((value & 0xFFFFFFFF00000000ull) >> 32);
+                value = ((value & 0x0000FFFF0000FFFFull) << 16) | ((value & 0xFFFF0000FFFF0000ull) >> 16);
+                value = ((value & 0x00FF00FF00FF00FFull) << 8) | ((value & 0xFF00FF00FF00FF00ull) >> 8);
+            }
+            return value;
+        }
+
+        bool IsEightDigits(const uint64_t value)
+        {
+            return ((value & 0xF0F0F0F0F0F0F0F0ull) |
+                    (((value + 0x0606060606060606ull) & 0xF0F0F0F0F0F0F0F0ull) >> 4)) == 0x3333333333333333ull;
+        }
+
+        uint32_t ParseEightDigits(uint64_t value)
+        {
+            constexpr uint64_t mask = 0x000000FF000000FFull;
+            constexpr uint64_t multiplier1 = 100 + (1000000ull << 32);
+            constexpr uint64_t multiplier2 = 1 + (10000ull << 32);
+            value -= 0x3030303030303030ull;
+            value = value * 10 + (value >> 8);
+            value = ((value & mask) * multiplier1 + ((value >> 16) & mask) * multiplier2) >> 32;
+            return static_cast<uint32_t>(value);
+        }
+
+        struct DigitCounts
+        {
+            // Digits multiplied into the mantissa
+            int32_t Accepted = 0;
+            // Digits past the precision limit
+            int32_t Dropped = 0;
+        };
+
+        // Accumulates digits into mantissa until it holds 19 significant ones (the most a uint64_t always fits),
+        // later digits are only counted. Leading zeros don't count towards the limit.
+        const char* ParseDigits(const char* p, const char* end, uint64_t& mantissa, int32_t& significant,
+                                DigitCounts& counts)
+        {
+            while (end - p >= 8 && significant <= 11)
+            {
+                const uint64_t bytes = LoadEightBytes(p);
+                if (!IsEightDigits(bytes))
+                {
+                    break;
+                }
+                mantissa = mantissa * 100000000ull + ParseEightDigits(bytes);
+                significant += mantissa != 0 ? 8 : 0;
+                counts.Accepted += 8;
+                p += 8;
+            }
+            for (; p < end && IsDigit(*p); p++)
+            {
+                if (significant >= 19)
+                {
+                    counts.Dropped++;
+                    continue;
+                }
+                mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0');
+                significant += mantissa != 0 ? 1 : 0;
+                counts.Accepted++;
+            }
+            return p;
+        }
+
+        const char* ParseIndex(const char* p, const char* end, int32_t& index)
+        {
+            const bool negative = p < end && *p == '-';
+            p += negative ? 1 : 0;
+            if (p == end || !IsDigit(*p))
+            {
+                return nullptr;
+            }
+            int64_t value = 0;
+            while (p < end && IsDigit(*p) && value <= INT32_MAX)
+            {
+                value = value * 10 + (*p - '0');
+                p++;
+            }
+            if (value == 0 || value > INT32_MAX)
+            {
+                return nullptr;
+            }
+            index = static_cast<int32_t>(negative ? -value : value);
+            return p;
+        }
+
+        struct FaceCorner
+        {
+            Corner Value;
+            // Bit per attribute (0 = position, 1 = uv, 2 = normal) that is relative to the chunk start
+            uint32_t RelativeMask;
+        };
+
+        // Converts a 1-based or negative OBJ index to 0-based, relative to the chunk start for negative ones
+        int32_t ResolveIndex(FaceCorner& corner, const int32_t index, const size_t count, const uint32_t attribute)
+        {
+            if (index > 0)
+            {
+                return index - 1;
+            }
+            corner.RelativeMask |= 1u << attribute;
+            return static_cast<int32_t>(count) + index;
+        }
+
+        const char* ParseCorner(const Chunk& chunk, const char* p, const char* end, FaceCorner& corner)
+        {
+            int32_t index = 0;
+            if (!(p = ParseIndex(p, end, index)))
+            {
+                return nullptr;
+            }
+            corner = {{ABSENT, ABSENT, ABSENT}, 0};
+            corner.Value.Position = ResolveIndex(corner, index, chunk.Positions.size(), 0);
+
+            if (p == end || *p != '/')
+            {
+                return p;
+            }
+            p++;
+            if (p < end && *p != '/')
+            {
+                if (!(p = ParseIndex(p, end, index)))
+                {
+                    return nullptr;
+                }
+                corner.Value.Uv = ResolveIndex(corner, index, chunk.Uvs.size(), 1);
+            }
+            if (p == end || *p != '/')
+            {
+                return p;
+            }
+            if (!(p = ParseIndex(p + 1, end, index)))
+            {
+                return nullptr;
+            }
+            corner.Value.Normal = ResolveIndex(corner, index, chunk.Normals.size(), 2);
+            return p;
+        }
+
+        template <size_t N>
+        const char* ParseFloats(const char* p, const char* end, float (&values)[N])
+        {
+            for (float& value : values)
+            {
+                if (!(p = ObjLoader::ParseFloat(p, end, value)))
+                {
+                    return nullptr;
+                }
+            }
+            return p;
+        }
+
+        void EmitCorner(Chunk& chunk, const FaceCorner& corner)
+        {
+            for (uint32_t attribute = 0; attribute < 3; attribute++)
+            {
+                if (corner.RelativeMask & (1u << attribute))
+                {
+                    chunk.RelativeIndices.push_back(static_cast<uint32_t>(chunk.Corners.size()) * 3 + attribute);
+                }
+            }
+            chunk.Corners.push_back(corner.Value);
+        }
+
+        // Parses whole lines in [begin, end), end is just past a newline or the end of the file
+        void ParseChunk(const char* begin, const char* end, Chunk& chunk)
+        {
+            std::vector<FaceCorner> face;
+            for (const char* p = begin; p < end;)
+            {
+                const char* line = p = SkipSpaces(p, end);
+                if (end - p >= 2 && p[0] == 'v' && IsSpace(p[1]))
+                {
+                    float position[3];
+                    if (!(p = ParseFloats(p + 2, end, position)))
+                    {
+                        chunk.Error = line;
+                        return;
+                    }
+                    chunk.Positions.emplace_back(position[0], position[1], position[2]);
+
+                    float color[3];
+                    p = SkipSpaces(p, end);
+                    if (p < end && *p != '\n' && *p != '#' && ParseFloats(p, end, color))
+                    {
+                        chunk.Colors.emplace_back(color[0], color[1], color[2]);
+                    }
+                    else
+                    {
+                        chunk.Colors.emplace_back(1.0f);
+                    }
+                }
+                else if (end - p >= 3 && p[0] == 'v' && p[1] == 't' && IsSpace(p[2]))
+                {
+                    float uv[2];
+                    if (!(p = ParseFloats(p + 3, end, uv)))
+                    {
+                        chunk.Error = line;
+                        return;
+                    }
+                    chunk.Uvs.emplace_back(uv[0], uv[1]);
+                }
+                else if (end - p >= 3 && p[0] == 'v' && p[1] == 'n' && IsSpace(p[2]))
+                {
+                    float normal[3];
+                    if (!(p = ParseFloats(p + 3, end, normal)))
+                    {
+                        chunk.Error = line;
+                        return;
+                    }
+                    chunk.Normals.emplace_back(normal[0], normal[1], normal[2]);
+                }
+                else if (end - p >= 2 && p[0] == 'f' && IsSpace(p[1]))
+                {
+                    face.clear();
+                    p = SkipSpaces(p + 2, end);
+                    while (p < end && *p != '\n' && *p != '#')
+                    {
+                        FaceCorner corner{};
+                        if (!(p = ParseCorner(chunk, p, end, corner)))
+                        {
+                            chunk.Error = line;
+                            return;
+                        }
+                        face.push_back(corner);
+                        // Polygons become a fan around the first corner
+                        if (face.size() >= 3)
+                        {
+                            EmitCorner(chunk, face[0]);
+                            EmitCorner(chunk, face[face.size() - 2]);
+                            EmitCorner(chunk, face.back());
+                        }
+                        p = SkipSpaces(p, end);
+                    }
+                    if (face.size() < 3)
+                    {
+                        chunk.Error = line;
+                        return;
+                    }
+                }
+                p = SkipLine(p, end);
+            }
+        }
+
+        uint32_t HashCorner(const Corner& corner)
+        {
+            uint64_t hash = static_cast<uint32_t>(corner.Position) * 0x9E3779B97F4A7C15ull;
+            hash ^= (static_cast<uint64_t>(static_cast<uint32_t>(corner.Uv)) << 32 |
+                     static_cast<uint32_t>(corner.Normal)) * 0xC2B2AE3D27D4EB4Full;
+            return static_cast<uint32_t>(hash ^ (hash >> 29));
+        }
+
+        // Open-addressing (linear probing) map from corner to vertex index, kept at most half full. Slots
+        // are 16 bytes in one flat array, so a lookup is usually a single cache miss.
+        class CornerTable
+        {
+        public:
+            explicit CornerTable(const size_t expectedCount)
+            {
+                m_Slots.resize(std::bit_ceil(std::max<size_t>(expectedCount * 2, 64)), {{}, EMPTY});
+            }
+
+            // Index of the vertex with this corner, adding it as vertex nextIndex when it's new
+            uint32_t Insert(const Corner& corner, const uint32_t nextIndex, bool& inserted)
+            {
+                if ((m_Count + 1) * 2 > m_Slots.size())
+                {
+                    Grow();
+                }
+                const size_t mask = m_Slots.size() - 1;
+                for (size_t slot = HashCorner(corner) & mask;; slot = (slot + 1) & mask)
+                {
+                    Slot& entry = m_Slots[slot];
+                    if (entry.Index == EMPTY)
+                    {
+                        entry = {corner, nextIndex};
+                        m_Count++;
+                        inserted = true;
+                        return nextIndex;
+                    }
+                    if (entry.Key == corner)
+                    {
+                        inserted = false;
+                        return entry.Index;
+                    }
+                }
+            }
+
+        private:
+            static constexpr uint32_t EMPTY = UINT32_MAX;
+
+            struct Slot
+            {
+                Corner Key;
+                uint32_t Index;
+            };
+
+            void Grow()
+            {
+                std::vector<Slot> old(m_Slots.size() * 2, {{}, EMPTY});
+                old.swap(m_Slots);
+                const size_t mask = m_Slots.size() - 1;
+                for (const Slot& entry : old)
+                {
+                    if (entry.Index == EMPTY)
+                    {
+                        continue;
+                    }
+                    size_t slot = HashCorner(entry.Key) & mask;
+                    while (m_Slots[slot].Index != EMPTY)
+                    {
+                        slot = (slot + 1) & mask;
+                    }
+                    m_Slots[slot] = entry;
+                }
+            }
+
+            std::vector<Slot> m_Slots;
+            size_t m_Count = 0;
+        };
+
+        template <typename T>
+        void Append(std::vector<T>& destination, const std::vector<T>& source)
+        {
+            destination.insert(destination.end(), source.begin(), source.end());
+        }
+    }
+
+    const char* ObjLoader::ParseFloat(const char* begin, const char* end, float& value)
+    {
+        const char* p = SkipSpaces(begin, end);
+        const bool negative = p < end && *p == '-';
+        p += p < end && (*p == '-' || *p == '+') ? 1 : 0;
+
+        uint64_t mantissa = 0;
+        int32_t significant = 0;
+        DigitCounts integer;
+        const char* digits = p;
+        p = ParseDigits(p, end, mantissa, significant, integer);
+        // Dropped integer digits still scale the value, dropped fraction digits don't
+        int32_t exponent = integer.Dropped;
+        bool hasDigits = p != digits;
+
+        if (p < end && *p == '.')
+        {
+            DigitCounts fraction;
+            const char* fractionStart = ++p;
+            p = ParseDigits(p, end, mantissa, significant, fraction);
+            exponent -= fraction.Accepted;
+            hasDigits |= p != fractionStart;
+        }
+        if (!hasDigits)
+        {
+            return nullptr;
+        }
+
+        if (p < end && (*p == 'e' || *p == 'E'))
+        {
+            const char* exponentStart = p + 1;
+            const bool negativeExponent = exponentStart < end && *exponentStart == '-';
+            exponentStart += exponentStart < end && (*exponentStart == '-' || *exponentStart == '+') ? 1 : 0;
+            if (exponentStart < end && IsDigit(*exponentStart))
+            {
+                int32_t explicitExponent = 0;
+                for (p = exponentStart; p < end && IsDigit(*p); p++)
+                {
+                    explicitExponent = std::min(explicitExponent * 10 + (*p - '0'), 10000);
+                }
+                exponent += negativeExponent ? -explicitExponent : explicitExponent;
+            }
+        }
+
+        double result = static_cast<double>(mantissa);
+        if (mantissa == 0)
+        {
+            result = 0.0;
+        }
+        else if (exponent >= 0 && exponent < static_cast<int32_t>(POWERS_OF_TEN.size()))
+        {
+            result *= POWERS_OF_TEN[exponent];
+        }
+        else if (exponent < 0 && -exponent < static_cast<int32_t>(POWERS_OF_TEN.size()))
+        {
+            result /= POWERS_OF_TEN[-exponent];
+        }
+        else
+        {
+            result *= std::pow(10.0, exponent);
+        }
+        value = static_cast<float>(negative ? -result : result);
+        return p;
+    }
+
+    bool ObjLoader::Load(const std::string& filePath, MeshData& mesh)
+    {
+        VE_PROFILE_FUNCTION();
+
+        MappedFile file;
+        if (!file.Open(filePath))
+        {
+            return false;
+        }
+        if (!Parse({reinterpret_cast<const char*>(file.GetData()), file.GetSize()}, mesh))
+        {
+            VE_CORE_ERROR("Failed to parse OBJ file {0}", filePath);
+            return false;
+        }
+        return true;
+    }
+
+    bool ObjLoader::Parse(const std::string_view text, MeshData& mesh)
+    {
+        VE_PROFILE_FUNCTION();
+
+        mesh.Clear();
+        const char* const begin = text.data();
+        const char* const end = begin + text.size();
+
+        // Chunk boundaries are moved forward to the next line start, so no line is split between chunks
+        const size_t chunkCount = std::max<size_t>(std::min<size_t>(text.size() / MIN_CHUNK_SIZE,
+                                                                    (JobSystem::Get().GetThreadCount() + 1) * 4), 1);
+        std::vector<const char*> boundaries(chunkCount + 1, end);
+        boundaries[0] = begin;
+        for (size_t i = 1; i < chunkCount; i++)
+        {
+            boundaries[i] = std::max(boundaries[i - 1], SkipLine(begin + text.size() * i / chunkCount, end));
+        }
+
+        std::vector<Chunk> chunks(chunkCount);
+        JobSystem::Get().ParallelFor(static_cast<uint32_t>(chunkCount), 1, [&](const uint32_t first, const uint32_t last)
+        {
+            for (uint32_t i = first; i < last; i++)
+            {
+                ParseChunk(boundaries[i], boundaries[i + 1], chunks[i]);
+            }
+        });
+
+        size_t positionCount = 0;
+        size_t uvCount = 0;
+        size_t normalCount = 0;
+        size_t cornerCount = 0;
+        for (Chunk& chunk : chunks)
+        {
+            if (chunk.Error)
+            {
+                const std::string_view line{chunk.Error, static_cast<size_t>(SkipLine(chunk.Error, end) - chunk.Error)};
+                VE_CORE_ERROR("Malformed OBJ line: {0}", line.substr(0, std::min<size_t>(line.find_first_of("\r\n"), 80)));
+                return false;
+            }
+            const std::array<size_t, 3> bases{positionCount, uvCount, normalCount};
+            for (const uint32_t slot : chunk.RelativeIndices)
+            {
+                reinterpret_cast<int32_t*>(chunk.Corners.data())[slot] += static_cast<int32_t>(bases[slot % 3]);
+            }
+            positionCount += chunk.Positions.size();
+            uvCount += chunk.Uvs.size();
+            normalCount += chunk.Normals.size();
+            cornerCount += chunk.Corners.size();
+        }
+
+        std::vector<glm::vec3> positions;
+        std::vector<glm::vec3> colors;
+        std::vector<glm::vec2> uvs;
+        std::vector<glm::vec3> normals;
+        positions.reserve(positionCount);
+        colors.reserve(positionCount);
+        uvs.reserve(uvCount);
+        normals.reserve(normalCount);
+        for (const Chunk& chunk : chunks)
+        {
+            Append(positions, chunk.Positions);
+            Append(colors, chunk.Colors);
+            Append(uvs, chunk.Uvs);
+            Append(normals, chunk.Normals);
+        }
+
+        // Welding is sequential so vertex order is deterministic, it touches 12 bytes per corner and is
+        // cheap next to parsing the text
+        std::vector<Corner> uniqueCorners;
+        uniqueCorners.reserve(positionCount + positionCount / 4);
+        mesh.Indices.reserve(cornerCount);
+        CornerTable table{positionCount + positionCount / 4};
+        for (const Chunk& chunk : chunks)
+        {
+            for (const Corner& corner : chunk.Corners)
+            {
+                if (corner.Position < 0 || static_cast<size_t>(corner.Position) >= positionCount ||
+                    (corner.Uv != ABSENT && (corner.Uv < 0 || static_cast<size_t>(corner.Uv) >= uvCount)) ||
+                    (corner.Normal != ABSENT && (corner.Normal < 0 || static_cast<size_t>(corner.Normal) >= normalCount)))
+                {
+                    VE_CORE_ERROR("OBJ face references a missing vertex attribute");
+                    mesh.Clear();
+                    return false;
+                }
+
+                bool inserted;
+                mesh.Indices.push_back(table.Insert(corner, static_cast<uint32_t>(uniqueCorners.size()), inserted));
+                if (inserted)
+                {
+                    uniqueCorners.push_back(corner);
+                }
+            }
+        }
+
+        mesh.Vertices.resize(uniqueCorners.size());
+        JobSystem::Get().ParallelFor(static_cast<uint32_t>(uniqueCorners.size()), 16384,
+                                     [&](const uint32_t first, const uint32_t last)
+        {
+            for (uint32_t i = first; i < last; i++)
+            {
+                const Corner& corner = uniqueCorners[i];
+                Vertex& vertex = mesh.Vertices[i];
+                vertex.Position = positions[corner.Position];
+                vertex.Color = colors[corner.Position];
+                vertex.Normal = corner.Normal != ABSENT ? normals[corner.Normal] : glm::vec3{0.0f};
+                vertex.Uv = corner.Uv != ABSENT ? uvs[corner.Uv] : glm::vec2{0.0f};
+            }
+        });
+        return true;
+    }
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "Core/Mesh.h"
+
+#include <string>
+#include <string_view>
+
+namespace VoxelicousEngine
+{
+    // Wavefront OBJ loader for static meshes. The file is memory mapped and split at line boundaries into
+    // chunks that are parsed in parallel on the JobSystem, then corners are welded into unique vertices with
+    // an open-addressing table keyed by their (position, uv, normal) indices.
+    //
+    // Supports v (with the optional "x y z r g b" colour extension), vt, vn and f with any corner syntax,
+    // negative indices and polygons, which are fan triangulated. Groups, materials, lines and points are
+    // ignored. Vertices without a colour are white, corners without a uv or normal get zeros.
+    class ObjLoader
+    {
+    public:
+        // Files smaller than this parse on a single thread
+        static constexpr size_t MIN_CHUNK_SIZE = 1024 * 1024;
+
+        // Replaces the contents of mesh, logs and returns false when the file can't be read or is malformed
+        static bool Load(const std::string& filePath, MeshData& mesh);
+        static bool Parse(std::string_view text, MeshData& mesh);
+
+        // Parses a decimal float with optional sign, fraction and exponent after skipping spaces and tabs.
+        // Returns the position after it, or nullptr when there is no number.
+        static const char* ParseFloat(const char* begin, const char* end, float& value);
+    };
+}
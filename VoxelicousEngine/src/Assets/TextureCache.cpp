@@ -0,0 +1,62 @@
+#include "vepch.h"
+#include "TextureCache.h"
+#include "TexturePack.h"
+
+#include "Core/Hash.h"
+
+#include <cstdio>
+#include <filesystem>
+
+namespace VoxelicousEngine
+{
+    TextureCache::TextureCache(std::string directory) : m_Directory{std::move(directory)}
+    {
+        std::error_code error;
+        std::filesystem::create_directories(m_Directory, error);
+        if (error)
+        {
+            VE_CORE_WARN("Failed to create texture cache directory {0}: {1}", m_Directory, error.message());
+        }
+    }
+
+    uint64_t TextureCache::ComputeKey(const TextureData& source, const TextureEncodeSettings& settings)
+    {
+        uint64_t key = HashBytes(source.Pixels.data(), source.Pixels.size());
+        key = HashCombine(key, static_cast<uint64_t>(source.Width) << 32 | source.Height);
+        key = HashCombine(key, static_cast<uint64_t>(source.LayerCount) << 32 | source.MipCount);
+        key = HashCombine(key, static_cast<uint64_t>(source.Format));
+        key = HashCombine(key, static_cast<uint64_t>(settings.Format));
+        key = HashCombine(key, static_cast<uint64_t>(settings.Quality));
+        return HashCombine(key, TextureEncoder::VERSION);
+    }
+
+    std::string TextureCache::GetEntryPath(const uint64_t key) const
+    {
+        char name[32];
+        std::snprintf(name, sizeof(name), "%016llx.vetp", static_cast<unsigned long long>(key));
+        return (std::filesystem::path(m_Directory) / name).string();
+    }
+
+    TextureData TextureCache::GetOrEncode(const TextureData& source, const TextureEncodeSettings& settings)
+    {
+        VE_PROFILE_FUNCTION();
+
+        const std::string path = GetEntryPath(ComputeKey(source, settings));
+        TextureData compressed;
+        if (std::filesystem::exists(path) && TexturePack::Read(path, compressed))
+        {
+            // Layer names aren't part of the key, so renaming a source layer doesn't re-encode it
+            compressed.LayerNames = source.LayerNames;
+            m_HitCount++;
+            return compressed;
+        }
+
+        m_MissCount++;
+        compressed = TextureEncoder::Encode(source, settings);
+        if (!TexturePack::Write(path, compressed))
+        {
+            VE_CORE_WARN("Failed to store {0} in the texture cache", path);
+        }
+        return compressed;
+    }
+}
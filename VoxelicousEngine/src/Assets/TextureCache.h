@@ -0,0 +1,30 @@
+#pragma once
+
+#include "TextureEncoder.h"
+
+namespace VoxelicousEngine
+{
+    // On-disk cache of block-compressed textures, keyed by a hash of the source pixels and layout, the target
+    // format and quality and the encoder version. Entries are texture packs, so a cached result loads without
+    // any transcoding and can be shipped and uploaded as is (see TextureArray::LoadPack).
+    class TextureCache
+    {
+    public:
+        // Creates the directory when it doesn't exist
+        explicit TextureCache(std::string directory);
+
+        static uint64_t ComputeKey(const TextureData& source, const TextureEncodeSettings& settings);
+        std::string GetEntryPath(uint64_t key) const;
+
+        // Returns the cached compressed texture, encoding and storing it on a miss
+        TextureData GetOrEncode(const TextureData& source, const TextureEncodeSettings& settings);
+
+        uint32_t GetHitCount() const { return m_HitCount; }
+        uint32_t GetMissCount() const { return m_MissCount; }
+
+    private:
+        std::string m_Directory;
+        uint32_t m_HitCount = 0;
+        uint32_t m_MissCount = 0;
+    };
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace VoxelicousEngine
+{
+    // Pixel formats of texture assets. The values are stored in texture packs, so only append new ones.
+    enum class TextureFormat : uint32_t
+    {
+        RGBA8Unorm = 0,
+        RGBA8Srgb = 1,
+        // Block-compressed formats, see TextureEncoder
+        BC1RgbaUnorm = 2,
+        BC1RgbaSrgb = 3,
+        BC4Unorm = 4,
+        BC5Unorm = 5,
+        BC7Unorm = 6,
+        BC7Srgb = 7,
+    };
+
+    // Uncompressed formats are 1x1 blocks of one pixel, block-compressed ones 4x4 blocks
+    struct TextureFormatInfo
+    {
+        uint32_t BlockWidth;
+        uint32_t BlockHeight;
+        uint32_t BytesPerBlock;
+        bool IsSrgb;
+    };
+
+    constexpr TextureFormatInfo GetTextureFormatInfo(const TextureFormat format)
+    {
+        switch (format)
+        {
+        case TextureFormat::RGBA8Unorm: return {1, 1, 4, false};
+        case TextureFormat::RGBA8Srgb: return {1, 1, 4, true};
+        case TextureFormat::BC1RgbaUnorm: return {4, 4, 8, false};
+        case TextureFormat::BC1RgbaSrgb: return {4, 4, 8, true};
+        case TextureFormat::BC4Unorm: return {4, 4, 8, false};
+        case TextureFormat::BC5Unorm: return {4, 4, 16, false};
+        case TextureFormat::BC7Unorm: return {4, 4, 16, false};
+        case TextureFormat::BC7Srgb: return {4, 4, 16, true};
+        }
+        return {1, 1, 4, false};
+    }
+
+    constexpr bool IsValidTextureFormat(const uint32_t format)
+    {
+        return format <= static_cast<uint32_t>(TextureFormat::BC7Srgb);
+    }
+
+    constexpr bool IsCompressedTextureFormat(const TextureFormat format)
+    {
+        return GetTextureFormatInfo(format).BlockWidth > 1;
+    }
+
+    // A texture or texture array with its mip chain in CPU memory. Pixels are stored mip-major: every layer of
+    // mip 0, then every layer of mip 1 and so on, so each mip level of an array is one contiguous range that
+    // uploads with a single copy region.
+    struct TextureData
+    {
+        TextureFormat Format = TextureFormat::RGBA8Srgb;
+        uint32_t Width = 0;
+        uint32_t Height = 0;
+        uint32_t LayerCount = 1;
+        uint32_t MipCount = 1;
+        std::vector<std::byte> Pixels;
+        // Optional, one per layer (e.g. the block texture names of an array)
+        std::vector<std::string> LayerNames;
+
+        static uint32_t GetFullMipCount(const uint32_t width, const uint32_t height)
+        {
+            return static_cast<uint32_t>(std::bit_width(std::max(width, height)));
+        }
+
+        uint32_t GetMipWidth(const uint32_t mip) const { return std::max(1u, Width >> mip); }
+        uint32_t GetMipHeight(const uint32_t mip) const { return std::max(1u, Height >> mip); }
+
+        // Bytes of one layer of a mip level
+        size_t GetLayerSize(const uint32_t mip) const
+        {
+            const TextureFormatInfo info = GetTextureFormatInfo(Format);
+            const size_t blocksX = (GetMipWidth(mip) + info.BlockWidth - 1) / info.BlockWidth;
+            const size_t blocksY = (GetMipHeight(mip) + info.BlockHeight - 1) / info.BlockHeight;
+            return blocksX * blocksY * info.BytesPerBlock;
+        }
+
+        size_t GetMipSize(const uint32_t mip) const { return GetLayerSize(mip) * LayerCount; }
+
+        // Offset of a mip level in Pixels, GetMipOffset(MipCount) is the size of the whole chain
+        size_t GetMipOffset(const uint32_t mip) const
+        {
+            size_t offset = 0;
+            for (uint32_t i = 0; i < mip; i++)
+            {
+                offset += GetMipSize(i);
+            }
+            return offset;
+        }
+
+        size_t GetTotalSize() const { return GetMipOffset(MipCount); }
+
+        std::byte* GetLayerData(const uint32_t mip, const uint32_t layer)
+        {
+            return Pixels.data() + GetMipOffset(mip) + GetLayerSize(mip) * layer;
+        }
+
+        const std::byte* GetLayerData(const uint32_t mip, const uint32_t layer) const
+        {
+            return Pixels.data() + GetMipOffset(mip) + GetLayerSize(mip) * layer;
+        }
+    };
+}
@@ -0,0 +1,1266 @@
+#include "vepch.h"
+#include "TextureEncoder.h"
+
+#include "Core/JobSystem.h"
+
+#include <cfloat>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define VE_ENCODER_SSE2 1
+#include <emmintrin.h>
+#else
+#define VE_ENCODER_SSE2 0
+#endif
+
+namespace VoxelicousEngine
+{
+    namespace
+    {
+        constexpr uint32_t BLOCK_PIXELS = 16;
+        // Blocks per job: enough work to amortise scheduling, small enough to balance a single large mip
+        constexpr uint32_t BLOCKS_PER_JOB = 256;
+
+        constexpr std::array<uint32_t, 16> BC7_WEIGHTS{0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+        using Color = std::array<float, 4>;
+        using Indices = std::array<uint8_t, BLOCK_PIXELS>;
+
+        // 16 pixels with one array per channel, so palette searches process 4 pixels per SSE register
+        struct alignas(16) Block
+        {
+            float Channels[4][BLOCK_PIXELS];
+        };
+
+        struct BitWriter
+        {
+            uint8_t* Data;
+            uint32_t Position = 0;
+
+            void Write(const uint32_t value, const uint32_t bitCount)
+            {
+                for (uint32_t i = 0; i < bitCount; i++, Position++)
+                {
+                    Data[Position >> 3] |= static_cast<uint8_t>(((value >> i) & 1u) << (Position & 7));
+                }
+            }
+        };
+
+        struct BitReader
+        {
+            const uint8_t* Data;
+            uint32_t Position = 0;
+
+            uint32_t Read(const uint32_t bitCount)
+            {
+                uint32_t value = 0;
+                for (uint32_t i = 0; i < bitCount; i++, Position++)
+                {
+                    value |= ((Data[Position >> 3] >> (Position & 7)) & 1u) << i;
+                }
+                return value;
+            }
+        };
+
+        uint32_t GetRefinementIterations(const TextureQuality quality)
+        {
+            switch (quality)
+            {
+            case TextureQuality::Fast: return 0;
+            case TextureQuality::Normal: return 1;
+            case TextureQuality::High: return 4;
+            }
+            return 1;
+        }
+
+        uint8_t ToByte(const float value)
+        {
+            return static_cast<uint8_t>(std::clamp(value, 0.0f, 255.0f) + 0.5f);
+        }
+
+        void LoadBlock(const uint8_t* rgba, Block& block)
+        {
+            for (uint32_t i = 0; i < BLOCK_PIXELS; i++)
+            {
+                for (uint32_t c = 0; c < 4; c++)
+                {
+                    block.Channels[c][i] = rgba[i * 4 + c];
+                }
+            }
+        }
+
+        // Pixels past the right or bottom edge repeat the last column or row
+        void LoadBlock(
+            const uint8_t* image, const uint32_t width, const uint32_t height, const uint32_t blockX,
+            const uint32_t blockY, Block& block)
+        {
+            for (uint32_t y = 0; y < 4; y++)
+            {
+                const uint32_t sourceY = std::min(blockY * 4 + y, height - 1);
+                for (uint32_t x = 0; x < 4; x++)
+                {
+                    const uint32_t sourceX = std::min(blockX * 4 + x, width - 1);
+                    const uint8_t* pixel = image + (static_cast<size_t>(sourceY) * width + sourceX) * 4;
+                    for (uint32_t c = 0; c < 4; c++)
+                    {
+                        block.Channels[c][y * 4 + x] = pixel[c];
+                    }
+                }
+            }
+        }
+
+        // Picks the nearest palette entry for every pixel by weighted squared distance, returns the total error
+        float SelectIndices(
+            const Block& block, const Color* palette, const uint32_t paletteSize, const Color& weights,
+            Indices& indices)
+        {
+            float totalError = 0.0f;
+#if VE_ENCODER_SSE2
+            for (uint32_t group = 0; group < BLOCK_PIXELS; group += 4)
+            {
+                __m128 best = _mm_set1_ps(FLT_MAX);
+                __m128 bestIndex = _mm_setzero_ps();
+                for (uint32_t p = 0; p < paletteSize; p++)
+                {
+                    __m128 distance = _mm_setzero_ps();
+                    for (uint32_t c = 0; c < 4; c++)
+                    {
+                        if (weights[c] == 0.0f)
+                        {
+                            continue;
+                        }
+                        const __m128 diff = _mm_sub_ps(_mm_load_ps(&block.Channels[c][group]), _mm_set1_ps(palette[p][c]));
+                        distance = _mm_add_ps(distance, _mm_mul_ps(_mm_mul_ps(diff, diff), _mm_set1_ps(weights[c])));
+                    }
+                    const __m128 closer = _mm_cmplt_ps(distance, best);
+                    best = _mm_min_ps(distance, best);
+                    bestIndex = _mm_or_ps(_mm_and_ps(closer, _mm_set1_ps(static_cast<float>(p))),
+                                          _mm_andnot_ps(closer, bestIndex));
+                }
+
+                alignas(16) float errors[4];
+                alignas(16) float selected[4];
+                _mm_store_ps(errors, best);
+                _mm_store_ps(selected, bestIndex);
+                for (uint32_t k = 0; k < 4; k++)
+                {
+                    indices[group + k] = static_cast<uint8_t>(selected[k]);
+                    totalError += errors[k];
+                }
+            }
+#else
+            for (uint32_t i = 0; i < BLOCK_PIXELS; i++)
+            {
+                float best = FLT_MAX;
+                for (uint32_t p = 0; p < paletteSize; p++)
+                {
+                    float distance = 0.0f;
+                    for (uint32_t c = 0; c < 4; c++)
+                    {
+                        const float diff = block.Channels[c][i] - palette[p][c];
+                        distance += diff * diff * weights[c];
+                    }
+                    if (distance < best)
+                    {
+                        best = distance;
+                        indices[i] = static_cast<uint8_t>(p);
+                    }
+                }
+                totalError += best;
+            }
+#endif
+            return totalError;
+        }
+
+        // Projects every pixel onto the line between the first and last palette entry, for evenly spaced palettes
+        float ProjectIndices(
+            const Block& block, const Color* palette, const uint32_t paletteSize, const Color& weights,
+            Indices& indices)
+        {
+            Color axis{};
+            float lengthSquared = 0.0f;
+            for (uint32_t c = 0; c < 4; c++)
+            {
+                axis[c] = (palette[paletteSize - 1][c] - palette[0][c]) * weights[c];
+                lengthSquared += axis[c] * axis[c];
+            }
+
+            const auto maxIndex = static_cast<float>(paletteSize - 1);
+            float totalError = 0.0f;
+            for (uint32_t i = 0; i < BLOCK_PIXELS; i++)
+            {
+                float t = 0.0f;
+                for (uint32_t c = 0; c < 4; c++)
+                {
+                    t += (block.Channels[c][i] - palette[0][c]) * axis[c];
+                }
+                t = lengthSquared > 0.0f ? t / lengthSquared : 0.0f;
+                indices[i] = static_cast<uint8_t>(std::clamp(t * maxIndex + 0.5f, 0.0f, maxIndex));
+                for (uint32_t c = 0; c < 4; c++)
+                {
+                    const float diff = block.Channels[c][i] - palette[indices[i]][c];
+                    totalError += diff * diff * weights[c];
+                }
+            }
+            return totalError;
+        }
+
+        // Endpoints spanning the per-channel range, inset slightly since the extremes are rarely all hit
+        void ComputeBoundingBoxEndpoints(const Block& block, const Color& weights, Color& e0, Color& e1)
+        {
+            for (uint32_t c = 0; c < 4; c++)
+            {
+                if (weights[c] == 0.0f)
+                {
+                    e0[c] = e1[c] = 255.0f;
+                    continue;
+                }
+                const auto [minIt, maxIt] = std::minmax_element(block.Channels[c], block.Channels[c] + BLOCK_PIXELS);
+                const float inset = (*maxIt - *minIt) / 16.0f;
+                e0[c] = *minIt + inset;
+                e1[c] = *maxIt - inset;
+            }
+        }
+
+        // Endpoints at the extremes of the pixels projected onto their principal axis (found by power iteration
+        // on the covariance matrix), which follows the colour gradient of the block
+        void ComputePrincipalEndpoints(const Block& block, const Color& weights, Color& e0, Color& e1)
+        {
+            Color mean{};
+            for (uint32_t c = 0; c < 4; c++)
+            {
+                for (uint32_t i = 0; i < BLOCK_PIXELS; i++)
+                {
+                    mean[c] += block.Channels[c][i];
+                }
+                mean[c] /= static_cast<float>(BLOCK_PIXELS);
+            }
+
+            float covariance[4][4]{};
+            for (uint32_t i = 0; i < BLOCK_PIXELS; i++)
+            {
+                for (uint32_t a = 0; a < 4; a++)
+                {
+                    const float da = (block.Channels[a][i] - mean[a]) * weights[a];
+                    for (uint32_t b = 0; b < 4; b++)
+                    {
+                        covariance[a][b] += da * (block.Channels[b][i] - mean[b]) * weights[b];
+                    }
+                }
+            }
+
+            // Start from the row of the channel with the largest variance
+            uint32_t largest = 0;
+            for (uint32_t c = 1; c < 4; c++)
+            {
+                if (covariance[c][c] > covariance[largest][largest])
+                {
+                    largest = c;
+                }
+            }
+            Color axis{covariance[largest][0], covariance[largest][1], covariance[largest][2], covariance[largest][3]};
+            for (uint32_t iteration = 0; iteration < 8; iteration++)
+            {
+                Color next{};
+                float largestComponent = 0.0f;
+                for (uint32_t a = 0; a < 4; a++)
+                {
+                    for (uint32_t b = 0; b < 4; b++)
+                    {
+                        next[a] += covariance[a][b] * axis[b];
+                    }
+                    largestComponent = std::max(largestComponent, std::abs(next[a]));
+                }
+                if (largestComponent < 1e-6f)
+                {
+                    break;
+                }
+                for (uint32_t c = 0; c < 4; c++)
+                {
+                    axis[c] = next[c] / largestComponent;
+                }
+            }
+
+            const float length = std::sqrt(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2] + axis[3] * axis[3]);
+            if (length < 1e-6f)
+            {
+                e0 = e1 = mean;
+                return;
+            }
+
+            float minT = FLT_MAX;
+            float maxT = -FLT_MAX;
+            for (uint32_t i = 0; i < BLOCK_PIXELS; i++)
+            {
+                float t = 0.0f;
+                for (uint32_t c = 0; c < 4; c++)
+                {
+                    t += (block.Channels[c][i] - mean[c]) * axis[c] / length;
+                }
+                minT = std::min(minT, t);
+                maxT = std::max(maxT, t);
+            }
+            for (uint32_t c = 0; c < 4; c++)
+            {
+                e0[c] = std::clamp(mean[c] + axis[c] / length * minT, 0.0f, 255.0f);
+                e1[c] = std::clamp(mean[c] + axis[c] / length * maxT, 0.0f, 255.0f);
+            }
+        }
+
+        // Least-squares endpoints for fixed indices, where index i interpolates (1 - w) * e0 + w * e1 with
+        // w = indexWeights[i]. Pixels whose index has a negative weight are ignored. Only fits weighted channels.
+        bool FitEndpoints(
+            const Block& block, const Indices& indices, const float* indexWeights, const Color& weights,
+            Color& e0, Color& e1)
+        {
+            float a = 0.0f;
+            float b = 0.0f;
+            float c = 0.0f;
+            Color x0{};
+            Color x1{};
+            for (uint32_t i = 0; i < BLOCK_PIXELS; i++)
+            {
+                const float w = indexWeights[indices[i]];
+                if (w < 0.0f)
+                {
+                    continue;
+                }
+                const float iw = 1.0f - w;
+                a += iw * iw;
+                b += iw * w;
+                c += w * w;
+                for (uint32_t channel = 0; channel < 4; channel++)
+                {
+                    x0[channel] += iw * block.Channels[channel][i];
+                    x1[channel] += w * block.Channels[channel][i];
+                }
+            }
+
+            const float determinant = a * c - b * b;
+            if (std::abs(determinant) < 1e-6f)
+            {
+                return false;
+            }
+            for (uint32_t channel = 0; channel < 4; channel++)
+            {
+                if (weights[channel] == 0.0f)
+                {
+                    continue;
+                }
+                e0[channel] = std::clamp((c * x0[channel] - b * x1[channel]) / determinant, 0.0f, 255.0f);
+                e1[channel] = std::clamp((a * x1[channel] - b * x0[channel]) / determinant, 0.0f, 255.0f);
+            }
+            return true;
+        }
+
+        // BC1 ------------------------------------------------------------------------------------------------
+
+        uint16_t To565(const Color& color)
+        {
+            const auto r = static_cast<uint32_t>(std::clamp(color[0], 0.0f, 255.0f) * 31.0f / 255.0f + 0.5f);
+            const auto g = static_cast<uint32_t>(std::clamp(color[1], 0.0f, 255.0f) * 63.0f / 255.0f + 0.5f);
+            const auto b = static_cast<uint32_t>(std::clamp(color[2], 0.0f, 255.0f) * 31.0f / 255.0f + 0.5f);
+            return static_cast<uint16_t>(r << 11 | g << 5 | b);
+        }
+
+        std::array<uint32_t, 3> From565(const uint16_t color)
+        {
+            const uint32_t r = color >> 11;
+            const uint32_t g = (color >> 5) & 63;
+            const uint32_t b = color & 31;
+            return {r << 3 | r >> 2, g << 2 | g >> 4, b << 3 | b >> 2};
+        }
+
+        // The palette as the decoder builds it. Three-colour mode has a transparent black fourth entry.
+        void GetBC1Palette(const uint16_t c0, const uint16_t c1, const bool threeColor, uint8_t palette[4][4])
+        {
+            const std::array<uint32_t, 3> a = From565(c0);
+            const std::array<uint32_t, 3> b = From565(c1);
+            for (uint32_t c = 0; c < 3; c++)
+            {
+                palette[0][c] = static_cast<uint8_t>(a[c]);
+                palette[1][c] = static_cast<uint8_t>(b[c]);
+                if (threeColor)
+                {
+                    palette[2][c] = static_cast<uint8_t>((a[c] + b[c] + 1) / 2);
+                    palette[3][c] = 0;
+                }
+                else
+                {
+                    palette[2][c] = static_cast<uint8_t>((2 * a[c] + b[c] + 1) / 3);
+                    palette[3][c] = static_cast<uint8_t>((a[c] + 2 * b[c] + 1) / 3);
+                }
+            }
+            palette[0][3] = palette[1][3] = palette[2][3] = 255;
+            palette[3][3] = threeColor ? 0 : 255;
+        }
+
+        void EncodeBC1(const Block& block, const TextureQuality quality, uint8_t* out)
+        {
+            // Any cutout pixel switches the block to three colours plus transparent black
+            bool transparent = false;
+            for (uint32_t i = 0; i < BLOCK_PIXELS; i++)
+            {
+                transparent |= block.Channels[3][i] < 128.0f;
+            }
+
+            constexpr Color weights{1.0f, 1.0f, 1.0f, 0.0f};
+            constexpr float fourColorWeights[4]{0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f};
+            constexpr float threeColorWeights[4]{0.0f, 1.0f, 0.5f, -1.0f};
+
+            Color e0;
+            Color e1;
+            if (quality == TextureQuality::Fast)
+            {
+                ComputeBoundingBoxEndpoints(block, weights, e0, e1);
+            }
+            else
+            {
+                ComputePrincipalEndpoints(block, weights, e0, e1);
+            }
+
+            const uint32_t iterations = GetRefinementIterations(quality);
+            uint16_t bestC0 = 0;
+            uint16_t bestC1 = 0;
+            Indices bestIndices{};
+            float bestError = FLT_MAX;
+            Indices indices{};
+            for (uint32_t iteration = 0;; iteration++)
+            {
+                const uint16_t c0 = To565(e0);
+                const uint16_t c1 = To565(e1);
+                uint8_t bytePalette[4][4];
+                GetBC1Palette(c0, c1, transparent, bytePalette);
+                Color palette[4];
+                for (uint32_t p = 0; p < 4; p++)
+                {
+                    palette[p] = {
+                        static_cast<float>(bytePalette[p][0]), static_cast<float>(bytePalette[p][1]),
+                        static_cast<float>(bytePalette[p][2]), 0.0f
+                    };
+                }
+
+                const float error = SelectIndices(block, palette, transparent ? 3 : 4, weights, indices);
+                for (uint32_t i = 0; transparent && i < BLOCK_PIXELS; i++)
+                {
+                    if (block.Channels[3][i] < 128.0f)
+                    {
+                        indices[i] = 3;
+                    }
+                }
+                if (error < bestError)
+                {
+                    bestError = error;
+                    bestC0 = c0;
+                    bestC1 = c1;
+                    bestIndices = indices;
+                }
+
+                if (iteration == iterations ||
+                    !FitEndpoints(block, indices, transparent ? threeColorWeights : fourColorWeights, weights, e0, e1))
+                {
+                    break;
+                }
+            }
+
+            // The decoder picks the mode from the endpoint order: c0 > c1 is four colours
+            if (!transparent && bestC0 < bestC1)
+            {
+                std::swap(bestC0, bestC1);
+                constexpr uint8_t remap[4]{1, 0, 3, 2};
+                for (uint8_t& index : bestIndices)
+                {
+                    index = remap[index];
+                }
+            }
+            else if (!transparent && bestC0 == bestC1)
+            {
+                bestIndices.fill(0);
+            }
+            else if (transparent && bestC0 > bestC1)
+            {
+                std::swap(bestC0, bestC1);
+                constexpr uint8_t remap[4]{1, 0, 2, 3};
+                for (uint8_t& index : bestIndices)
+                {
+                    index = remap[index];
+                }
+            }
+
+            std::fill_n(out, 8, uint8_t{0});
+            BitWriter writer{out};
+            writer.Write(bestC0, 16);
+            writer.Write(bestC1, 16);
+            for (const uint8_t index : bestIndices)
+            {
+                writer.Write(index, 2);
+            }
+        }
+
+        void DecodeBC1(const uint8_t* block, uint8_t* rgba)
+        {
+            BitReader reader{block};
+            const auto c0 = static_cast<uint16_t>(reader.Read(16));
+            const auto c1 = static_cast<uint16_t>(reader.Read(16));
+            uint8_t palette[4][4];
+            GetBC1Palette(c0, c1, c0 <= c1, palette);
+            for (uint32_t i = 0; i < BLOCK_PIXELS; i++)
+            {
+                std::copy_n(palette[reader.Read(2)], 4, rgba + i * 4);
+            }
+        }
+
+        // BC4 ------------------------------------------------------------------------------------------------
+
+        // r0 > r1 interpolates 8 values, otherwise 6 values plus 0 and 255
+        void GetBC4Palette(const uint8_t r0, const uint8_t r1, uint8_t palette[8])
+        {
+            palette[0] = r0;
+            palette[1] = r1;
+            if (r0 > r1)
+            {
+                for (uint32_t i = 2; i < 8; i++)
+                {
+                    palette[i] = static_cast<uint8_t>(((8 - i) * r0 + (i - 1) * r1 + 3) / 7);
+                }
+            }
+            else
+            {
+                for (uint32_t i = 2; i < 6; i++)
+                {
+                    palette[i] = static_cast<uint8_t>(((6 - i) * r0 + (i - 1) * r1 + 2) / 5);
+                }
+                palette[6] = 0;
+                palette[7] = 255;
+            }
+        }
+
+        void EncodeBC4(const Block& block, const uint32_t channel, const TextureQuality quality, uint8_t* out)
+        {
+            Color weights{};
+            weights[channel] = 1.0f;
+            constexpr float eightValueWeights[8]{
+                0.0f, 1.0f, 1.0f / 7.0f, 2.0f / 7.0f, 3.0f / 7.0f, 4.0f / 7.0f, 5.0f / 7.0f, 6.0f / 7.0f
+            };
+
+            const auto evaluate = [&](const uint8_t r0, const uint8_t r1, Indices& indices)
+            {
+                uint8_t bytePalette[8];
+                GetBC4Palette(r0, r1, bytePalette);
+                Color palette[8]{};
+                for (uint32_t p = 0; p < 8; p++)
+                {
+                    palette[p][channel] = bytePalette[p];
+                }
+                return SelectIndices(block, palette, 8, weights, indices);
+            };
+
+            const float* values = block.Channels[channel];
+            const auto [minIt, maxIt] = std::minmax_element(values, values + BLOCK_PIXELS);
+            uint8_t bestR0 = ToByte(*maxIt);
+            uint8_t bestR1 = ToByte(*minIt);
+            Indices bestIndices{};
+            float bestError = evaluate(bestR0, bestR1, bestIndices);
+
+            // Least-squares refinement of the eight-value mode
+            Indices indices = bestIndices;
+            for (uint32_t iteration = 0; iteration < GetRefinementIterations(quality) && bestR0 != bestR1; iteration++)
+            {
+                Color e0{};
+                Color e1{};
+                if (!FitEndpoints(block, indices, eightValueWeights, weights, e0, e1))
+                {
+                    break;
+                }
+                const uint8_t r0 = ToByte(std::max(e0[channel], e1[channel]));
+                const uint8_t r1 = ToByte(std::min(e0[channel], e1[channel]));
+                if (r0 == r1)
+                {
+                    break;
+                }
+                const float error = evaluate(r0, r1, indices);
+                if (error >= bestError)
+                {
+                    break;
+                }
+                bestError = error;
+                bestR0 = r0;
+                bestR1 = r1;
+                bestIndices = indices;
+            }
+
+            // Blocks mixing 0 or 255 with mid values fit the six-value mode better
+            if (quality == TextureQuality::High)
+            {
+                float innerMin = 255.0f;
+                float innerMax = 0.0f;
+                for (uint32_t i = 0; i < BLOCK_PIXELS; i++)
+                {
+                    if (values[i] > 0.0f && values[i] < 255.0f)
+                    {
+                        innerMin = std::min(innerMin, values[i]);
+                        innerMax = std::max(innerMax, values[i]);
+                    }
+                }
+                if (innerMin <= innerMax)
+                {
+                    const uint8_t r0 = ToByte(innerMin);
+                    const uint8_t r1 = ToByte(innerMax);
+                    if (const float error = evaluate(r0, r1, indices); error < bestError)
+                    {
+                        bestError = error;
+                        bestR0 = r0;
+                        bestR1 = r1;
+                        bestIndices = indices;
+                    }
+                }
+            }
+
+            std::fill_n(out, 8, uint8_t{0});
+            BitWriter writer{out};
+            writer.Write(bestR0, 8);
+            writer.Write(bestR1, 8);
+            for (const uint8_t index : bestIndices)
+            {
+                writer.Write(index, 3);
+            }
+        }
+
+        void DecodeBC4(const uint8_t* block, const uint32_t channel, uint8_t* rgba)
+        {
+            BitReader reader{block};
+            const auto r0 = static_cast<uint8_t>(reader.Read(8));
+            const auto r1 = static_cast<uint8_t>(reader.Read(8));
+            uint8_t palette[8];
+            GetBC4Palette(r0, r1, palette);
+            for (uint32_t i = 0; i < BLOCK_PIXELS; i++)
+            {
+                rgba[i * 4 + channel] = palette[reader.Read(3)];
+            }
+        }
+
+        // BC7 mode 6 -----------------------------------------------------------------------------------------
+
+        // 7 bits per channel plus one p-bit shared by the channels of each endpoint
+        struct BC7Endpoints
+        {
+            std::array<uint8_t, 4> Q0;
+            std::array<uint8_t, 4> Q1;
+            uint8_t P0;
+            uint8_t P1;
+        };
+
+        std::array<uint8_t, 4> QuantizeBC7Endpoint(const Color& endpoint, const uint8_t pBit)
+        {
+            std::array<uint8_t, 4> quantized{};
+            for (uint32_t c = 0; c < 4; c++)
+            {
+                const float value = (endpoint[c] - static_cast<float>(pBit)) / 2.0f;
+                quantized[c] = static_cast<uint8_t>(std::clamp(value + 0.5f, 0.0f, 127.0f));
+            }
+            return quantized;
+        }
+
+        float GetBC7EndpointError(const Color& endpoint, const std::array<uint8_t, 4>& quantized, const uint8_t pBit)
+        {
+            float error = 0.0f;
+            for (uint32_t c = 0; c < 4; c++)
+            {
+                const float diff = static_cast<float>(quantized[c] << 1 | pBit) - endpoint[c];
+                error += diff * diff;
+            }
+            return error;
+        }
+
+        // The p-bit reconstructing this endpoint best on its own
+        uint8_t ChooseBC7PBit(const Color& endpoint)
+        {
+            return GetBC7EndpointError(endpoint, QuantizeBC7Endpoint(endpoint, 1), 1) <
+                   GetBC7EndpointError(endpoint, QuantizeBC7Endpoint(endpoint, 0), 0) ? 1 : 0;
+        }
+
+        void GetBC7Palette(const BC7Endpoints& endpoints, Color palette[16])
+        {
+            for (uint32_t c = 0; c < 4; c++)
+            {
+                const uint32_t a = static_cast<uint32_t>(endpoints.Q0[c]) << 1 | endpoints.P0;
+                const uint32_t b = static_cast<uint32_t>(endpoints.Q1[c]) << 1 | endpoints.P1;
+                for (uint32_t i = 0; i < 16; i++)
+                {
+                    palette[i][c] = static_cast<float>(((64 - BC7_WEIGHTS[i]) * a + BC7_WEIGHTS[i] * b + 32) >> 6);
+                }
+            }
+        }
+
+        // Returns the block's squared error
+        float EncodeBC7Mode6(const Block& block, const TextureQuality quality, uint8_t* out)
+        {
+            constexpr Color weights{1.0f, 1.0f, 1.0f, 1.0f};
+            float indexWeights[16];
+            for (uint32_t i = 0; i < 16; i++)
+            {
+                indexWeights[i] = static_cast<float>(BC7_WEIGHTS[i]) / 64.0f;
+            }
+
+            Color e0;
+            Color e1;
+            if (quality == TextureQuality::Fast)
+            {
+                ComputeBoundingBoxEndpoints(block, weights, e0, e1);
+            }
+            else
+            {
+                ComputePrincipalEndpoints(block, weights, e0, e1);
+            }
+
+            const uint32_t iterations = GetRefinementIterations(quality);
+            BC7Endpoints best{};
+            Indices bestIndices{};
+            float bestError = FLT_MAX;
+            for (uint32_t iteration = 0;; iteration++)
+            {
+                // High tries every p-bit pair against the whole block, the others pick each p-bit on its own
+                std::array<std::pair<uint8_t, uint8_t>, 4> pBits{};
+                uint32_t pBitCount = 0;
+                if (quality == TextureQuality::High)
+                {
+                    pBits = {{{0, 0}, {0, 1}, {1, 0}, {1, 1}}};
+                    pBitCount = 4;
+                }
+                else
+                {
+                    pBits[0] = {ChooseBC7PBit(e0), ChooseBC7PBit(e1)};
+                    pBitCount = 1;
+                }
+
+                Indices iterationIndices{};
+                float iterationError = FLT_MAX;
+                for (uint32_t candidate = 0; candidate < pBitCount; candidate++)
+                {
+                    const auto [p0, p1] = pBits[candidate];
+                    const BC7Endpoints endpoints{QuantizeBC7Endpoint(e0, p0), QuantizeBC7Endpoint(e1, p1), p0, p1};
+                    Color palette[16];
+                    GetBC7Palette(endpoints, palette);
+
+                    Indices indices{};
+                    const float error = quality == TextureQuality::Fast
+                                            ? ProjectIndices(block, palette, 16, weights, indices)
+                                            : SelectIndices(block, palette, 16, weights, indices);
+                    if (error < iterationError)
+                    {
+                        iterationError = error;
+                        iterationIndices = indices;
+                    }
+                    if (error < bestError)
+                    {
+                        bestError = error;
+                        best = endpoints;
+                        bestIndices = indices;
+                    }
+                }
+
+                if (iteration == iterations || !FitEndpoints(block, iterationIndices, indexWeights, weights, e0, e1))
+                {
+                    break;
+                }
+            }
+
+            // The first index is stored without its top bit, so it must be below 8
+            if (bestIndices[0] >= 8)
+            {
+                std::swap(best.Q0, best.Q1);
+                std::swap(best.P0, best.P1);
+                for (uint8_t& index : bestIndices)
+                {
+                    index = static_cast<uint8_t>(15 - index);
+                }
+            }
+
+            std::fill_n(out, 16, uint8_t{0});
+            BitWriter writer{out};
+            writer.Write(1u << 6, 7);
+            for (uint32_t c = 0; c < 4; c++)
+            {
+                writer.Write(best.Q0[c], 7);
+                writer.Write(best.Q1[c], 7);
+            }
+            writer.Write(best.P0, 1);
+            writer.Write(best.P1, 1);
+            for (uint32_t i = 0; i < BLOCK_PIXELS; i++)
+            {
+                writer.Write(bestIndices[i], i == 0 ? 3 : 4);
+            }
+            return bestError;
+        }
+
+        void DecodeBC7Mode6(BitReader& reader, uint8_t* rgba)
+        {
+            BC7Endpoints endpoints{};
+            for (uint32_t c = 0; c < 4; c++)
+            {
+                endpoints.Q0[c] = static_cast<uint8_t>(reader.Read(7));
+                endpoints.Q1[c] = static_cast<uint8_t>(reader.Read(7));
+            }
+            endpoints.P0 = static_cast<uint8_t>(reader.Read(1));
+            endpoints.P1 = static_cast<uint8_t>(reader.Read(1));
+            Color palette[16];
+            GetBC7Palette(endpoints, palette);
+            for (uint32_t i = 0; i < BLOCK_PIXELS; i++)
+            {
+                const Color& color = palette[reader.Read(i == 0 ? 3 : 4)];
+                for (uint32_t c = 0; c < 4; c++)
+                {
+                    rgba[i * 4 + c] = static_cast<uint8_t>(color[c]);
+                }
+            }
+        }
+
+        // BC7 mode 5 -----------------------------------------------------------------------------------------
+
+        // Colour and alpha each get their own endpoints and 2-bit indices, so cutout or independent alpha doesn't
+        // pull the colour line off course. The rotation swaps alpha with red, green or blue first (1 to 3), which
+        // gives that channel the separate indices instead.
+        constexpr uint32_t BC7_MODE5_WEIGHTS[4]{0, 21, 43, 64};
+
+        uint8_t QuantizeBC7Color(const float value)
+        {
+            return static_cast<uint8_t>(std::clamp(value, 0.0f, 255.0f) * 127.0f / 255.0f + 0.5f);
+        }
+
+        uint32_t ExpandBC7Color(const uint8_t quantized)
+        {
+            return static_cast<uint32_t>(quantized) << 1 | quantized >> 6;
+        }
+
+        void GetBC7Mode5Palette(const uint32_t a, const uint32_t b, const uint32_t channel, Color palette[4])
+        {
+            for (uint32_t i = 0; i < 4; i++)
+            {
+                palette[i][channel] =
+                    static_cast<float>(((64 - BC7_MODE5_WEIGHTS[i]) * a + BC7_MODE5_WEIGHTS[i] * b + 32) >> 6);
+            }
+        }
+
+        // Returns the block's squared error
+        float EncodeBC7Mode5(const Block& source, const uint32_t rotation, const TextureQuality quality, uint8_t* out)
+        {
+            Block block = source;
+            if (rotation != 0)
+            {
+                std::swap(block.Channels[3], block.Channels[rotation - 1]);
+            }
+
+            constexpr Color colorWeights{1.0f, 1.0f, 1.0f, 0.0f};
+            constexpr Color alphaWeights{0.0f, 0.0f, 0.0f, 1.0f};
+            float indexWeights[4];
+            for (uint32_t i = 0; i < 4; i++)
+            {
+                indexWeights[i] = static_cast<float>(BC7_MODE5_WEIGHTS[i]) / 64.0f;
+            }
+            const uint32_t iterations = GetRefinementIterations(quality);
+
+            // Colour: 7-bit endpoints refined like mode 6
+            Color e0{};
+            Color e1{};
+            ComputePrincipalEndpoints(block, colorWeights, e0, e1);
+            std::array<uint8_t, 3> bestC0{};
+            std::array<uint8_t, 3> bestC1{};
+            Indices bestColorIndices{};
+            float bestColorError = FLT_MAX;
+            Indices indices{};
+            for (uint32_t iteration = 0;; iteration++)
+            {
+                std::array<uint8_t, 3> c0{};
+                std::array<uint8_t, 3> c1{};
+                Color palette[4]{};
+                for (uint32_t c = 0; c < 3; c++)
+                {
+                    c0[c] = QuantizeBC7Color(e0[c]);
+                    c1[c] = QuantizeBC7Color(e1[c]);
+                    GetBC7Mode5Palette(ExpandBC7Color(c0[c]), ExpandBC7Color(c1[c]), c, palette);
+                }
+                const float error = SelectIndices(block, palette, 4, colorWeights, indices);
+                if (error < bestColorError)
+                {
+                    bestColorError = error;
+                    bestC0 = c0;
+                    bestC1 = c1;
+                    bestColorIndices = indices;
+                }
+                if (iteration == iterations || !FitEndpoints(block, indices, indexWeights, colorWeights, e0, e1))
+                {
+                    break;
+                }
+            }
+
+            // Alpha: 8-bit endpoints from the range, then refined
+            const float* alpha = block.Channels[3];
+            const auto [minIt, maxIt] = std::minmax_element(alpha, alpha + BLOCK_PIXELS);
+            e0[3] = *minIt;
+            e1[3] = *maxIt;
+            uint8_t bestA0 = 0;
+            uint8_t bestA1 = 0;
+            Indices bestAlphaIndices{};
+            float bestAlphaError = FLT_MAX;
+            for (uint32_t iteration = 0;; iteration++)
+            {
+                const uint8_t a0 = ToByte(e0[3]);
+                const uint8_t a1 = ToByte(e1[3]);
+                Color palette[4]{};
+                GetBC7Mode5Palette(a0, a1, 3, palette);
+                const float error = SelectIndices(block, palette, 4, alphaWeights, indices);
+                if (error < bestAlphaError)
+                {
+                    bestAlphaError = error;
+                    bestA0 = a0;
+                    bestA1 = a1;
+                    bestAlphaIndices = indices;
+                }
+                if (iteration == iterations || a0 == a1 ||
+                    !FitEndpoints(block, indices, indexWeights, alphaWeights, e0, e1))
+                {
+                    break;
+                }
+            }
+
+            // The first index of each set is stored without its top bit, so it must be below 2
+            if (bestColorIndices[0] >= 2)
+            {
+                std::swap(bestC0, bestC1);
+                for (uint8_t& index : bestColorIndices)
+                {
+                    index = static_cast<uint8_t>(3 - index);
+                }
+            }
+            if (bestAlphaIndices[0] >= 2)
+            {
+                std::swap(bestA0, bestA1);
+                for (uint8_t& index : bestAlphaIndices)
+                {
+                    index = static_cast<uint8_t>(3 - index);
+                }
+            }
+
+            std::fill_n(out, 16, uint8_t{0});
+            BitWriter writer{out};
+            writer.Write(1u << 5, 6);
+            writer.Write(rotation, 2);
+            for (uint32_t c = 0; c < 3; c++)
+            {
+                writer.Write(bestC0[c], 7);
+                writer.Write(bestC1[c], 7);
+            }
+            writer.Write(bestA0, 8);
+            writer.Write(bestA1, 8);
+            for (uint32_t i = 0; i < BLOCK_PIXELS; i++)
+            {
+                writer.Write(bestColorIndices[i], i == 0 ? 1 : 2);
+            }
+            for (uint32_t i = 0; i < BLOCK_PIXELS; i++)
+            {
+                writer.Write(bestAlphaIndices[i], i == 0 ? 1 : 2);
+            }
+            return bestColorError + bestAlphaError;
+        }
+
+        void DecodeBC7Mode5(BitReader& reader, uint8_t* rgba)
+        {
+            const uint32_t rotation = reader.Read(2);
+            Color palette[4]{};
+            for (uint32_t c = 0; c < 3; c++)
+            {
+                const auto c0 = static_cast<uint8_t>(reader.Read(7));
+                const auto c1 = static_cast<uint8_t>(reader.Read(7));
+                GetBC7Mode5Palette(ExpandBC7Color(c0), ExpandBC7Color(c1), c, palette);
+            }
+            const uint32_t a0 = reader.Read(8);
+            const uint32_t a1 = reader.Read(8);
+            GetBC7Mode5Palette(a0, a1, 3, palette);
+
+            for (uint32_t i = 0; i < BLOCK_PIXELS; i++)
+            {
+                const Color& color = palette[reader.Read(i == 0 ? 1 : 2)];
+                for (uint32_t c = 0; c < 3; c++)
+                {
+                    rgba[i * 4 + c] = static_cast<uint8_t>(color[c]);
+                }
+            }
+            for (uint32_t i = 0; i < BLOCK_PIXELS; i++)
+            {
+                rgba[i * 4 + 3] = static_cast<uint8_t>(palette[reader.Read(i == 0 ? 1 : 2)][3]);
+                if (rotation != 0)
+                {
+                    std::swap(rgba[i * 4 + 3], rgba[i * 4 + rotation - 1]);
+                }
+            }
+        }
+
+        // BC7 ------------------------------------------------------------------------------------------------
+
+        // Mode 6 puts colour and alpha on one line, which suits opaque blocks. Blocks whose alpha varies also try
+        // mode 5, which wins on cutout alpha or alpha unrelated to colour; High tries every rotation on every block.
+        void EncodeBC7(const Block& block, const TextureQuality quality, uint8_t* out)
+        {
+            float bestError = EncodeBC7Mode6(block, quality, out);
+
+            const float* alpha = block.Channels[3];
+            const bool alphaVaries = std::any_of(alpha + 1, alpha + BLOCK_PIXELS, [alpha](const float value)
+            {
+                return value != alpha[0];
+            });
+            const uint32_t rotations = quality == TextureQuality::High ? 4 : alphaVaries ? 1 : 0;
+            for (uint32_t rotation = 0; rotation < rotations; rotation++)
+            {
+                uint8_t candidate[16];
+                if (const float error = EncodeBC7Mode5(block, rotation, quality, candidate); error < bestError)
+                {
+                    bestError = error;
+                    std::copy_n(candidate, 16, out);
+                }
+            }
+        }
+
+        void DecodeBC7(const uint8_t* block, uint8_t* rgba)
+        {
+            BitReader reader{block};
+            // The mode is the position of the lowest set bit
+            if ((block[0] & 0x7F) == 1u << 6)
+            {
+                reader.Read(7);
+                DecodeBC7Mode6(reader, rgba);
+                return;
+            }
+            if ((block[0] & 0x3F) == 1u << 5)
+            {
+                reader.Read(6);
+                DecodeBC7Mode5(reader, rgba);
+                return;
+            }
+
+            // Not written by this encoder, decode as magenta like a missing texture
+            for (uint32_t i = 0; i < BLOCK_PIXELS; i++)
+            {
+                rgba[i * 4 + 0] = 255;
+                rgba[i * 4 + 1] = 0;
+                rgba[i * 4 + 2] = 255;
+                rgba[i * 4 + 3] = 255;
+            }
+        }
+
+        void EncodeFormatBlock(const TextureFormat format, const Block& block, const TextureQuality quality, uint8_t* out)
+        {
+            switch (format)
+            {
+            case TextureFormat::BC1RgbaUnorm:
+            case TextureFormat::BC1RgbaSrgb:
+                EncodeBC1(block, quality, out);
+                break;
+            case TextureFormat::BC4Unorm:
+                EncodeBC4(block, 0, quality, out);
+                break;
+            case TextureFormat::BC5Unorm:
+                EncodeBC4(block, 0, quality, out);
+                EncodeBC4(block, 1, quality, out + 8);
+                break;
+            case TextureFormat::BC7Unorm:
+            case TextureFormat::BC7Srgb:
+                EncodeBC7(block, quality, out);
+                break;
+            default:
+                assert(false && "Not a block-compressed format");
+            }
+        }
+
+        // Channels stored by each format, compared when measuring quality
+        std::array<bool, 4> GetStoredChannels(const TextureFormat format)
+        {
+            switch (format)
+            {
+            case TextureFormat::BC1RgbaUnorm:
+            case TextureFormat::BC1RgbaSrgb: return {true, true, true, false};
+            case TextureFormat::BC4Unorm: return {true, false, false, false};
+            case TextureFormat::BC5Unorm: return {true, true, false, false};
+            default: return {true, true, true, true};
+            }
+        }
+    }
+
+    void TextureEncoder::EncodeBlock(
+        const TextureFormat format, const uint8_t* rgba, const TextureQuality quality, uint8_t* block)
+    {
+        Block pixels;
+        LoadBlock(rgba, pixels);
+        EncodeFormatBlock(format, pixels, quality, block);
+    }
+
+    void TextureEncoder::DecodeBlock(const TextureFormat format, const uint8_t* block, uint8_t* rgba)
+    {
+        switch (format)
+        {
+        case TextureFormat::BC1RgbaUnorm:
+        case TextureFormat::BC1RgbaSrgb:
+            DecodeBC1(block, rgba);
+            return;
+        case TextureFormat::BC4Unorm:
+        case TextureFormat::BC5Unorm:
+            for (uint32_t i = 0; i < BLOCK_PIXELS; i++)
+            {
+                rgba[i * 4 + 1] = rgba[i * 4 + 2] = 0;
+                rgba[i * 4 + 3] = 255;
+            }
+            DecodeBC4(block, 0, rgba);
+            if (format == TextureFormat::BC5Unorm)
+            {
+                DecodeBC4(block + 8, 1, rgba);
+            }
+            return;
+        case TextureFormat::BC7Unorm:
+        case TextureFormat::BC7Srgb:
+            DecodeBC7(block, rgba);
+            return;
+        default:
+            assert(false && "Not a block-compressed format");
+        }
+    }
+
+    TextureData TextureEncoder::Encode(const TextureData& source, const TextureEncodeSettings& settings)
+    {
+        VE_PROFILE_FUNCTION();
+
+        assert(!IsCompressedTextureFormat(source.Format) && "Source must be an uncompressed RGBA8 texture");
+        assert(IsCompressedTextureFormat(settings.Format) && "Target must be a block-compressed format");
+        assert(source.Pixels.size() == source.GetTotalSize() && "Source pixels don't match the texture size");
+
+        TextureData result;
+        result.Format = settings.Format;
+        result.Width = source.Width;
+        result.Height = source.Height;
+        result.LayerCount = source.LayerCount;
+        result.MipCount = source.MipCount;
+        result.LayerNames = source.LayerNames;
+        result.Pixels.resize(result.GetTotalSize());
+
+        // Blocks of every mip and layer share one index space, in the order they are stored in the result
+        std::vector<uint32_t> mipFirstBlock(source.MipCount + 1, 0);
+        std::vector<size_t> sourceMipOffsets(source.MipCount);
+        for (uint32_t mip = 0; mip < source.MipCount; mip++)
+        {
+            const uint32_t blocksX = (source.GetMipWidth(mip) + 3) / 4;
+            const uint32_t blocksY = (source.GetMipHeight(mip) + 3) / 4;
+            mipFirstBlock[mip + 1] = mipFirstBlock[mip] + blocksX * blocksY * source.LayerCount;
+            sourceMipOffsets[mip] = source.GetMipOffset(mip);
+        }
+
+        const uint32_t bytesPerBlock = GetTextureFormatInfo(settings.Format).BytesPerBlock;
+        const auto* sourcePixels = reinterpret_cast<const uint8_t*>(source.Pixels.data());
+        auto* resultBlocks = reinterpret_cast<uint8_t*>(result.Pixels.data());
+        JobSystem::Get().ParallelFor(mipFirstBlock.back(), BLOCKS_PER_JOB, [&](const uint32_t begin, const uint32_t end)
+        {
+            uint32_t mip = 0;
+            Block block;
+            for (uint32_t blockIndex = begin; blockIndex < end; blockIndex++)
+            {
+                while (blockIndex >= mipFirstBlock[mip + 1])
+                {
+                    mip++;
+                }
+                const uint32_t width = source.GetMipWidth(mip);
+                const uint32_t height = source.GetMipHeight(mip);
+                const uint32_t blocksX = (width + 3) / 4;
+                const uint32_t blocksPerLayer = blocksX * ((height + 3) / 4);
+                const uint32_t local = blockIndex - mipFirstBlock[mip];
+                const uint32_t layer = local / blocksPerLayer;
+                const uint32_t inLayer = local % blocksPerLayer;
+
+                const uint8_t* image = sourcePixels + sourceMipOffsets[mip] + source.GetLayerSize(mip) * layer;
+                LoadBlock(image, width, height, inLayer % blocksX, inLayer / blocksX, block);
+                EncodeFormatBlock(settings.Format, block, settings.Quality,
+                                  resultBlocks + static_cast<size_t>(blockIndex) * bytesPerBlock);
+            }
+        });
+        return result;
+    }
+
+    TextureData TextureEncoder::Decode(const TextureData& compressed)
+    {
+        VE_PROFILE_FUNCTION();
+
+        assert(IsCompressedTextureFormat(compressed.Format) && "Texture is not block-compressed");
+
+        TextureData result;
+        result.Format = GetTextureFormatInfo(compressed.Format).IsSrgb ? TextureFormat::RGBA8Srgb : TextureFormat::RGBA8Unorm;
+        result.Width = compressed.Width;
+        result.Height = compressed.Height;
+        result.LayerCount = compressed.LayerCount;
+        result.MipCount = compressed.MipCount;
+        result.LayerNames = compressed.LayerNames;
+        result.Pixels.resize(result.GetTotalSize());
+
+        const uint32_t bytesPerBlock = GetTextureFormatInfo(compressed.Format).BytesPerBlock;
+        for (uint32_t mip = 0; mip < compressed.MipCount; mip++)
+        {
+            const uint32_t width = compressed.GetMipWidth(mip);
+            const uint32_t height = compressed.GetMipHeight(mip);
+            const uint32_t blocksX = (width + 3) / 4;
+            const uint32_t blocksY = (height + 3) / 4;
+            for (uint32_t layer = 0; layer < compressed.LayerCount; layer++)
+            {
+                const auto* blocks = reinterpret_cast<const uint8_t*>(compressed.GetLayerData(mip, layer));
+                auto* image = reinterpret_cast<uint8_t*>(result.GetLayerData(mip, layer));
+                for (uint32_t blockY = 0; blockY < blocksY; blockY++)
+                {
+                    for (uint32_t blockX = 0; blockX < blocksX; blockX++)
+                    {
+                        uint8_t rgba[BLOCK_PIXELS * 4];
+                        DecodeBlock(compressed.Format, blocks + (blockY * blocksX + blockX) * bytesPerBlock, rgba);
+                        // Edge blocks only write the pixels inside the image
+                        for (uint32_t y = 0; y < 4 && blockY * 4 + y < height; y++)
+                        {
+                            for (uint32_t x = 0; x < 4 && blockX * 4 + x < width; x++)
+                            {
+                                const size_t pixel = static_cast<size_t>(blockY * 4 + y) * width + blockX * 4 + x;
+                                std::copy_n(rgba + (y * 4 + x) * 4, 4, image + pixel * 4);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+        return result;
+    }
+
+    double TextureEncoder::ComputePsnr(const TextureData& source, const TextureData& compressed)
+    {
+        assert(source.Width == compressed.Width && source.Height == compressed.Height &&
+            source.LayerCount == compressed.LayerCount && source.MipCount == compressed.MipCount &&
+            "Textures differ in size");
+
+        const TextureData decoded = Decode(compressed);
+        const std::array<bool, 4> channels = GetStoredChannels(compressed.Format);
+        double squaredError = 0.0;
+        size_t sampleCount = 0;
+        // BC1 stores cutout pixels as transparent black, their colour is meant to be lost
+        const bool skipCutout = !channels[3] && channels[2];
+        for (size_t pixel = 0; pixel < decoded.Pixels.size(); pixel += 4)
+        {
+            if (skipCutout && std::to_integer<int>(source.Pixels[pixel + 3]) < 128)
+            {
+                continue;
+            }
+            for (size_t c = 0; c < 4; c++)
+            {
+                if (channels[c])
+                {
+                    const double diff = std::to_integer<int>(source.Pixels[pixel + c]) -
+                        std::to_integer<int>(decoded.Pixels[pixel + c]);
+                    squaredError += diff * diff;
+                    sampleCount++;
+                }
+            }
+        }
+
+        // Identical data reports 100 dB rather than infinity
+        const double meanSquaredError = squaredError / static_cast<double>(std::max<size_t>(sampleCount, 1));
+        return meanSquaredError > 0.0 ? 10.0 * std::log10(255.0 * 255.0 / meanSquaredError) : 100.0;
+    }
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "TextureData.h"
+
+namespace VoxelicousEngine
+{
+    enum class TextureQuality : uint8_t
+    {
+        // Bounding box endpoints, for iteration times
+        Fast,
+        // Principal axis endpoints refined once by least squares
+        Normal,
+        // More refinement and exhaustive BC7 p-bit search, for shipping assets
+        High
+    };
+
+    struct TextureEncodeSettings
+    {
+        TextureFormat Format = TextureFormat::BC7Srgb;
+        TextureQuality Quality = TextureQuality::Normal;
+    };
+
+    // Compresses RGBA8 textures into GPU block formats on the CPU:
+    //
+    //   BC1  RGB with 1-bit alpha (pixels below 50% alpha become transparent), 4 bpp, e.g. opaque and cutout blocks
+    //   BC4  one channel (red), 4 bpp, e.g. height or roughness maps
+    //   BC5  two channels (red, green), 8 bpp, e.g. tangent-space normal maps
+    //   BC7  RGBA, 8 bpp, highest quality. Emits mode 6 (one subset, 4-bit indices) and, for blocks with varying
+    //        alpha, mode 5 (separate alpha endpoints and indices) where that fits the block better.
+    //
+    // Blocks are encoded in parallel on the JobSystem and palette searches use SSE2 where available. sRGB
+    // sources are encoded in their stored (gamma) space, like the hardware decodes them.
+    class TextureEncoder
+    {
+    public:
+        // Bumped whenever the encoded output changes, so caches keyed on it rebuild
+        static constexpr uint32_t VERSION = 2;
+
+        // Encodes every mip and layer of an uncompressed RGBA8 texture. Unorm sources may target sRGB formats
+        // (and the reverse), only the stored bytes are encoded.
+        static TextureData Encode(const TextureData& source, const TextureEncodeSettings& settings);
+
+        // Decodes a texture written by Encode back to RGBA8, e.g. to measure quality. BC4 and BC5 decode to
+        // (r, 0, 0, 255) and (r, g, 0, 255) like the GPU samples them.
+        static TextureData Decode(const TextureData& compressed);
+
+        // Peak signal-to-noise ratio in dB of a compressed texture against its RGBA8 source, over every mip and
+        // layer and only the channels the format stores
+        static double ComputePsnr(const TextureData& source, const TextureData& compressed);
+
+        // Single 4x4 blocks, rgba holds 16 pixels row by row
+        static void EncodeBlock(TextureFormat format, const uint8_t* rgba, TextureQuality quality, uint8_t* block);
+        static void DecodeBlock(TextureFormat format, const uint8_t* block, uint8_t* rgba);
+    };
+}
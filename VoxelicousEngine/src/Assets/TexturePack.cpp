@@ -0,0 +1,140 @@
+#include "vepch.h"
+#include "TexturePack.h"
+
+#include <fstream>
+
+namespace VoxelicousEngine
+{
+    namespace
+    {
+        constexpr std::array<char, 4> PACK_MAGIC{'V', 'E', 'T', 'P'};
+
+        struct PackHeader
+        {
+            std::array<char, 4> Magic;
+            uint32_t Version;
+            uint32_t Format;
+            uint32_t Width;
+            uint32_t Height;
+            uint32_t LayerCount;
+            uint32_t MipCount;
+            uint32_t NameBytes;
+            uint64_t PixelBytes;
+        };
+
+        static_assert(sizeof(PackHeader) == 40, "Texture pack header layout changed");
+    }
+
+    bool TexturePack::Write(const std::string& filePath, const TextureData& texture)
+    {
+        VE_PROFILE_FUNCTION();
+
+        if (texture.Pixels.size() != texture.GetTotalSize())
+        {
+            VE_CORE_ERROR("Texture pack {0}: pixel data doesn't match the texture size", filePath);
+            return false;
+        }
+        if (!texture.LayerNames.empty() && texture.LayerNames.size() != texture.LayerCount)
+        {
+            VE_CORE_ERROR("Texture pack {0}: expected {1} layer names, got {2}", filePath, texture.LayerCount,
+                          texture.LayerNames.size());
+            return false;
+        }
+
+        std::string names;
+        for (const std::string& name : texture.LayerNames)
+        {
+            names.append(name);
+            names.push_back('\0');
+        }
+
+        const PackHeader header{
+            PACK_MAGIC, VERSION, static_cast<uint32_t>(texture.Format), texture.Width, texture.Height,
+            texture.LayerCount, texture.MipCount, static_cast<uint32_t>(names.size()), texture.Pixels.size()
+        };
+
+        std::ofstream file{filePath, std::ios::binary};
+        if (!file)
+        {
+            VE_CORE_ERROR("Failed to open texture pack {0} for writing", filePath);
+            return false;
+        }
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(names.data(), static_cast<std::streamsize>(names.size()));
+        file.write(reinterpret_cast<const char*>(texture.Pixels.data()),
+                   static_cast<std::streamsize>(texture.Pixels.size()));
+        return static_cast<bool>(file);
+    }
+
+    bool TexturePack::Read(const std::string& filePath, TextureData& texture)
+    {
+        VE_PROFILE_FUNCTION();
+
+        std::ifstream file{filePath, std::ios::binary | std::ios::ate};
+        if (!file)
+        {
+            VE_CORE_ERROR("Failed to open texture pack {0}", filePath);
+            return false;
+        }
+        const auto fileSize = static_cast<uint64_t>(file.tellg());
+        file.seekg(0);
+
+        PackHeader header{};
+        if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) || header.Magic != PACK_MAGIC)
+        {
+            VE_CORE_ERROR("{0} is not a texture pack", filePath);
+            return false;
+        }
+        if (header.Version != VERSION || !IsValidTextureFormat(header.Format))
+        {
+            VE_CORE_ERROR("Texture pack {0} has unsupported version {1} or format {2}", filePath, header.Version,
+                          header.Format);
+            return false;
+        }
+
+        texture.Format = static_cast<TextureFormat>(header.Format);
+        texture.Width = header.Width;
+        texture.Height = header.Height;
+        texture.LayerCount = header.LayerCount;
+        texture.MipCount = header.MipCount;
+        if (header.Width == 0 || header.Height == 0 || header.LayerCount == 0 || header.MipCount == 0 ||
+            header.MipCount > TextureData::GetFullMipCount(header.Width, header.Height) ||
+            header.PixelBytes != texture.GetTotalSize())
+        {
+            VE_CORE_ERROR("Texture pack {0} has an inconsistent header", filePath);
+            return false;
+        }
+
+        // The sizes come from the file, check them before allocating so a corrupt header can't request gigabytes
+        const uint64_t remaining = fileSize - sizeof(header);
+        if (header.NameBytes > remaining || header.PixelBytes > remaining - header.NameBytes)
+        {
+            VE_CORE_ERROR("Texture pack {0} is truncated", filePath);
+            return false;
+        }
+
+        std::string names(header.NameBytes, '\0');
+        texture.Pixels.resize(header.PixelBytes);
+        if (!file.read(names.data(), header.NameBytes) ||
+            !file.read(reinterpret_cast<char*>(texture.Pixels.data()), static_cast<std::streamsize>(header.PixelBytes)))
+        {
+            VE_CORE_ERROR("Texture pack {0} is truncated", filePath);
+            return false;
+        }
+
+        texture.LayerNames.clear();
+        for (size_t begin = 0; begin < names.size();)
+        {
+            const size_t end = names.find('\0', begin);
+            texture.LayerNames.emplace_back(names, begin, end - begin);
+            begin = end == std::string::npos ? names.size() : end + 1;
+        }
+        if (!texture.LayerNames.empty() && texture.LayerNames.size() != texture.LayerCount)
+        {
+            VE_CORE_ERROR("Texture pack {0} has {1} layer names for {2} layers", filePath, texture.LayerNames.size(),
+                          texture.LayerCount);
+            return false;
+        }
+        return true;
+    }
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "TextureData.h"
+
+namespace VoxelicousEngine
+{
+    // Binary container for one texture or texture array with its full mip chain, laid out exactly like
+    // TextureData so loading is a header check and a single read into the pixel vector:
+    //
+    //   Header          magic "VETP", version, format, size, layer and mip counts, name and pixel byte counts
+    //   Layer names     NameBytes of '\0' terminated names, one per layer or none
+    //   Pixels          PixelBytes of mip-major pixel data
+    //
+    // Values are little-endian. Packs are built offline by the TexturePacker tool.
+    class TexturePack
+    {
+    public:
+        static constexpr uint32_t VERSION = 1;
+
+        static bool Write(const std::string& filePath, const TextureData& texture);
+        static bool Read(const std::string& filePath, TextureData& texture);
+    };
+}
@@ -0,0 +1,298 @@
+#include "vepch.h"
+#include "AllocationTracker.h"
+
+#include <cstdlib>
+#include <new>
+
+namespace VoxelicousEngine
+{
+    namespace
+    {
+        constexpr size_t TAG_COUNT = static_cast<size_t>(AllocationTag::Count);
+
+        struct ThreadCounters
+        {
+            // Written only by the owning thread, read by the main thread at frame boundaries
+            std::array<std::atomic<uint64_t>, TAG_COUNT> Allocations{};
+            std::array<std::atomic<uint64_t>, TAG_COUNT> Bytes{};
+            std::atomic<uint64_t> Frees{0};
+        };
+
+        // Fixed storage so registering a thread never allocates. Threads beyond MAX_THREADS share the last slot.
+        std::array<ThreadCounters, AllocationFrameReport::MAX_THREADS> s_Threads;
+        std::atomic<uint32_t> s_ThreadCount{0};
+
+        // Constant-initialized, so they are safe to touch from inside operator new
+        thread_local ThreadCounters* t_Counters = nullptr;
+        thread_local AllocationTag t_Tag = AllocationTag::Untagged;
+
+        ThreadCounters& GetThreadCounters()
+        {
+            if (!t_Counters)
+            {
+                const uint32_t index = s_ThreadCount.fetch_add(1, std::memory_order_relaxed);
+                t_Counters = &s_Threads[std::min<uint32_t>(index, AllocationFrameReport::MAX_THREADS - 1)];
+            }
+            return *t_Counters;
+        }
+
+        void Increment(std::atomic<uint64_t>& counter, const uint64_t value)
+        {
+            counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+        }
+    }
+
+    AllocationFrameReport AllocationTracker::s_FrameStart;
+    AllocationFrameReport AllocationTracker::s_LastFrame;
+    uint64_t AllocationTracker::s_FrameNumber = 0;
+
+    void AllocationTracker::RecordAllocation(const size_t size)
+    {
+        ThreadCounters& counters = GetThreadCounters();
+        const auto tag = static_cast<size_t>(t_Tag);
+        // The last slot may be shared, everything else has a single writer
+        if (&counters == &s_Threads.back())
+        {
+            counters.Allocations[tag].fetch_add(1, std::memory_order_relaxed);
+            counters.Bytes[tag].fetch_add(size, std::memory_order_relaxed);
+            return;
+        }
+        Increment(counters.Allocations[tag], 1);
+        Increment(counters.Bytes[tag], size);
+    }
+
+    void AllocationTracker::RecordFree()
+    {
+        GetThreadCounters().Frees.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    AllocationTag AllocationTracker::GetCurrentTag()
+    {
+        return t_Tag;
+    }
+
+    AllocationTag AllocationTracker::SetCurrentTag(const AllocationTag tag)
+    {
+        const AllocationTag previous = t_Tag;
+        t_Tag = tag;
+        return previous;
+    }
+
+    AllocationCounters AllocationTracker::ReadThreadCounters(const uint32_t thread, const AllocationTag tag)
+    {
+        const ThreadCounters& counters = s_Threads[thread];
+        const auto index = static_cast<size_t>(tag);
+        return {
+            counters.Allocations[index].load(std::memory_order_relaxed),
+            counters.Bytes[index].load(std::memory_order_relaxed),
+            0
+        };
+    }
+
+    void AllocationTracker::BeginFrame()
+    {
+        if constexpr (!IsEnabled())
+            return;
+
+        // Snapshot the running totals; EndFrame reports the difference
+        AllocationFrameReport& start = s_FrameStart;
+        start = {};
+        start.ThreadCount = std::min(s_ThreadCount.load(std::memory_order_relaxed),
+                                     AllocationFrameReport::MAX_THREADS);
+        for (uint32_t thread = 0; thread < start.ThreadCount; thread++)
+        {
+            for (size_t tag = 0; tag < TAG_COUNT; tag++)
+            {
+                const AllocationCounters counters = ReadThreadCounters(thread, static_cast<AllocationTag>(tag));
+                start.Threads[thread].Allocations += counters.Allocations;
+                start.Threads[thread].Bytes += counters.Bytes;
+                start.Tags[tag].Allocations += counters.Allocations;
+                start.Tags[tag].Bytes += counters.Bytes;
+            }
+            start.Threads[thread].Frees = s_Threads[thread].Frees.load(std::memory_order_relaxed);
+            start.Total.Frees += start.Threads[thread].Frees;
+        }
+    }
+
+    const AllocationFrameReport& AllocationTracker::EndFrame()
+    {
+        if constexpr (!IsEnabled())
+            return s_LastFrame;
+
+        AllocationFrameReport& report = s_LastFrame;
+        report = {};
+        report.FrameNumber = s_FrameNumber++;
+        report.ThreadCount = std::min(s_ThreadCount.load(std::memory_order_relaxed),
+                                      AllocationFrameReport::MAX_THREADS);
+        for (uint32_t thread = 0; thread < report.ThreadCount; thread++)
+        {
+            for (size_t tag = 0; tag < TAG_COUNT; tag++)
+            {
+                const AllocationCounters counters = ReadThreadCounters(thread, static_cast<AllocationTag>(tag));
+                report.Threads[thread].Allocations += counters.Allocations;
+                report.Threads[thread].Bytes += counters.Bytes;
+                report.Tags[tag].Allocations += counters.Allocations;
+                report.Tags[tag].Bytes += counters.Bytes;
+            }
+            report.Threads[thread].Frees = s_Threads[thread].Frees.load(std::memory_order_relaxed);
+
+            // Threads registered during the frame have an all-zero start snapshot
+            const AllocationCounters& start = s_FrameStart.Threads[thread];
+            report.Threads[thread].Allocations -= start.Allocations;
+            report.Threads[thread].Bytes -= start.Bytes;
+            report.Threads[thread].Frees -= start.Frees;
+
+            report.Total.Allocations += report.Threads[thread].Allocations;
+            report.Total.Bytes += report.Threads[thread].Bytes;
+            report.Total.Frees += report.Threads[thread].Frees;
+        }
+
+        for (size_t tag = 0; tag < TAG_COUNT; tag++)
+        {
+            report.Tags[tag].Allocations -= s_FrameStart.Tags[tag].Allocations;
+            report.Tags[tag].Bytes -= s_FrameStart.Tags[tag].Bytes;
+        }
+        return report;
+    }
+
+    void AllocationTracker::LogReport(const AllocationFrameReport& report)
+    {
+        VE_CORE_WARN("Frame {}: {} allocations ({} bytes), {} frees", report.FrameNumber,
+                     report.Total.Allocations, report.Total.Bytes, report.Total.Frees);
+        for (size_t tag = 0; tag < TAG_COUNT; tag++)
+        {
+            if (const AllocationCounters& counters = report.Tags[tag]; counters.Allocations > 0)
+            {
+                VE_CORE_WARN("    {}: {} allocations ({} bytes)", GetTagName(static_cast<AllocationTag>(tag)),
+                             counters.Allocations, counters.Bytes);
+            }
+        }
+        for (uint32_t thread = 0; thread < report.ThreadCount; thread++)
+        {
+            if (const AllocationCounters& counters = report.Threads[thread]; counters.Allocations > 0)
+            {
+                VE_CORE_WARN("    thread {}: {} allocations ({} bytes)", thread, counters.Allocations,
+                             counters.Bytes);
+            }
+        }
+    }
+
+    const char* AllocationTracker::GetTagName(const AllocationTag tag)
+    {
+        switch (tag)
+        {
+        case AllocationTag::Untagged: return "Untagged";
+        case AllocationTag::Layers: return "Layers";
+        case AllocationTag::Renderer: return "Renderer";
+        case AllocationTag::Shaders: return "Shaders";
+        case AllocationTag::Descriptors: return "Descriptors";
+        case AllocationTag::Events: return "Events";
+        case AllocationTag::Profiler: return "Profiler";
+        case AllocationTag::ImGui: return "ImGui";
+        case AllocationTag::Jobs: return "Jobs";
+        case AllocationTag::Voxel: return "Voxel";
+        default: return "Unknown";
+        }
+    }
+}
+
+#ifdef VE_TRACK_ALLOCATIONS
+
+// Replacements for the global allocation operators. They live in the same translation unit as the tracker
+// so linking anything that uses the tracker also pulls them in.
+namespace
+{
+    void* TrackedAllocate(const size_t size)
+    {
+        VoxelicousEngine::AllocationTracker::RecordAllocation(size);
+        return std::malloc(size == 0 ? 1 : size);
+    }
+
+    void* TrackedAllocateAligned(const size_t size, const std::align_val_t alignment)
+    {
+        VoxelicousEngine::AllocationTracker::RecordAllocation(size);
+        const auto align = static_cast<size_t>(alignment);
+#ifdef _MSC_VER
+        return _aligned_malloc(size == 0 ? 1 : size, align);
+#else
+        // aligned_alloc wants the size to be a multiple of the alignment
+        return std::aligned_alloc(align, (std::max<size_t>(size, 1) + align - 1) / align * align);
+#endif
+    }
+
+    void TrackedFree(void* pointer)
+    {
+        if (!pointer)
+            return;
+        VoxelicousEngine::AllocationTracker::RecordFree();
+        std::free(pointer);
+    }
+
+    void TrackedFreeAligned(void* pointer)
+    {
+        if (!pointer)
+            return;
+        VoxelicousEngine::AllocationTracker::RecordFree();
+#ifdef _MSC_VER
+        _aligned_free(pointer);
+#else
+        std::free(pointer);
+#endif
+    }
+}
+
+void* operator new(const size_t size)
+{
+    if (void* pointer = TrackedAllocate(size))
+        return pointer;
+    throw std::bad_alloc();
+}
+
+void* operator new[](const size_t size)
+{
+    if (void* pointer = TrackedAllocate(size))
+        return pointer;
+    throw std::bad_alloc();
+}
+
+void* operator new(const size_t size, const std::align_val_t alignment)
+{
+    if (void* pointer = TrackedAllocateAligned(size, alignment))
+        return pointer;
+    throw std::bad_alloc();
+}
+
+void* operator new[](const size_t size, const std::align_val_t alignment)
+{
+    if (void* pointer = TrackedAllocateAligned(size, alignment))
+        return pointer;
+    throw std::bad_alloc();
+}
+
+void* operator new(const size_t size, const std::nothrow_t&) noexcept { return TrackedAllocate(size); }
+void* operator new[](const size_t size, const std::nothrow_t&) noexcept { return TrackedAllocate(size); }
+
+void* operator new(const size_t size, const std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return TrackedAllocateAligned(size, alignment);
+}
+
+void* operator new[](const size_t size, const std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return TrackedAllocateAligned(size, alignment);
+}
+
+void operator delete(void* pointer) noexcept { TrackedFree(pointer); }
+void operator delete[](void* pointer) noexcept { TrackedFree(pointer); }
+void operator delete(void* pointer, size_t) noexcept { TrackedFree(pointer); }
+void operator delete[](void* pointer, size_t) noexcept { TrackedFree(pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { TrackedFree(pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { TrackedFree(pointer); }
+void operator delete(void* pointer, std::align_val_t) noexcept { TrackedFreeAligned(pointer); }
+void operator delete[](void* pointer, std::align_val_t) noexcept { TrackedFreeAligned(pointer); }
+void operator delete(void* pointer, size_t, std::align_val_t) noexcept { TrackedFreeAligned(pointer); }
+void operator delete[](void* pointer, size_t, std::align_val_t) noexcept { TrackedFreeAligned(pointer); }
+void operator delete(void* pointer, std::align_val_t, const std::nothrow_t&) noexcept { TrackedFreeAligned(pointer); }
+void operator delete[](void* pointer, std::align_val_t, const std::nothrow_t&) noexcept { TrackedFreeAligned(pointer); }
+
+#endif
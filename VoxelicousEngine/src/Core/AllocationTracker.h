@@ -0,0 +1,101 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace VoxelicousEngine
+{
+    // Subsystems allocations are attributed to, set with VE_ALLOCATION_SCOPE
+    enum class AllocationTag : uint8_t
+    {
+        Untagged,
+        Layers,
+        Renderer,
+        Shaders,
+        Descriptors,
+        Events,
+        Profiler,
+        ImGui,
+        Jobs,
+        Voxel,
+        Count
+    };
+
+    struct AllocationCounters
+    {
+        uint64_t Allocations = 0;
+        uint64_t Bytes = 0;
+        uint64_t Frees = 0;
+    };
+
+    // Allocations made between AllocationTracker::BeginFrame and EndFrame
+    struct AllocationFrameReport
+    {
+        static constexpr uint32_t MAX_THREADS = 64;
+
+        uint64_t FrameNumber = 0;
+        AllocationCounters Total;
+        std::array<AllocationCounters, static_cast<size_t>(AllocationTag::Count)> Tags{};
+        // Indexed by the tracker's thread index, the main thread is usually 0
+        std::array<AllocationCounters, MAX_THREADS> Threads{};
+        uint32_t ThreadCount = 0;
+    };
+
+    // Counts every global operator new/delete per thread and per tag when the engine is built with
+    // VE_TRACK_ALLOCATIONS. The counters are plain per-thread atomics, so the hook itself never allocates
+    // or locks. Without VE_TRACK_ALLOCATIONS the allocation operators are left alone and all reports are empty.
+    class AllocationTracker
+    {
+    public:
+        static constexpr bool IsEnabled()
+        {
+#ifdef VE_TRACK_ALLOCATIONS
+            return true;
+#else
+            return false;
+#endif
+        }
+
+        // Called from the main thread around the frame that should be measured
+        static void BeginFrame();
+        static const AllocationFrameReport& EndFrame();
+        static const AllocationFrameReport& GetLastFrame() { return s_LastFrame; }
+
+        static AllocationTag GetCurrentTag();
+        // Returns the previous tag of the calling thread so scopes can restore it
+        static AllocationTag SetCurrentTag(AllocationTag tag);
+
+        // Writes a per-tag and per-thread breakdown of a frame to the core log
+        static void LogReport(const AllocationFrameReport& report);
+
+        static const char* GetTagName(AllocationTag tag);
+
+        static void RecordAllocation(size_t size);
+        static void RecordFree();
+
+    private:
+        static AllocationCounters ReadThreadCounters(uint32_t thread, AllocationTag tag);
+
+        static AllocationFrameReport s_FrameStart;
+        static AllocationFrameReport s_LastFrame;
+        static uint64_t s_FrameNumber;
+    };
+
+    // Attributes allocations of the calling thread to a tag until the end of the scope
+    class AllocationScope
+    {
+    public:
+        explicit AllocationScope(const AllocationTag tag) : m_PreviousTag{AllocationTracker::SetCurrentTag(tag)}
+        {
+        }
+
+        ~AllocationScope() { AllocationTracker::SetCurrentTag(m_PreviousTag); }
+
+        AllocationScope(const AllocationScope&) = delete;
+        AllocationScope& operator=(const AllocationScope&) = delete;
+
+    private:
+        AllocationTag m_PreviousTag;
+    };
+}
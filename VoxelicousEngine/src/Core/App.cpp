@@ -2,52 +2,104 @@
 #include "App.h"
 
 #include "Log.h"
+#include "FrameStats.h"
 #include "Renderer/SwapChain.h"
 #include "GLFW/glfw3.h"
 
 #include <filesystem>
+#include <fstream>
 
 namespace VoxelicousEngine
 {
 #define BIND_EVENT_FN(x) std::bind(&App::x, this, std::placeholders::_1)
 
+    // Each thread buffers up to ProfileThreadBuffer::CAPACITY events between flushes
+    static constexpr uint32_t PROFILE_FLUSH_INTERVAL = 16;
+
     static void GLFWErrorCallback(int error, const char* description)
     {
         VE_CORE_ERROR("GLFW Error ({0}): {1}", error, description);
     }
 
+    bool AppCommandLineArgs::HasFlag(const std::string_view flag) const
+    {
+        for (int i = 1; i < Count; i++)
+        {
+            if (flag == Args[i])
+                return true;
+        }
+        return false;
+    }
+
+    const char* AppCommandLineArgs::GetValue(const std::string_view flag) const
+    {
+        for (int i = 1; i < Count - 1; i++)
+        {
+            if (flag == Args[i])
+                return Args[i + 1];
+        }
+        return nullptr;
+    }
+
     App* App::s_Instance = nullptr;
 
-    App::App()
+    App::App(const AppCommandLineArgs& args)
+        : m_CommandLineArgs{args}
     {
         VE_CORE_INFO("Started app!");
         VE_CORE_ASSERT(!s_Instance, "Application already exists!");
         s_Instance = this;
 
-        int success = glfwInit();
-        VE_CORE_ASSERT(success, "Could not intialize GLFW!");
+        const bool headless = args.HasFlag("--headless");
+        if (const char* frames = args.GetValue("--frames"))
+        {
+            m_FrameLimit = std::strtoull(frames, nullptr, 10);
+        }
+        if (const char* warmupFrames = args.GetValue("--warmup-frames"))
+        {
+            m_WarmupFrames = std::strtoull(warmupFrames, nullptr, 10);
+        }
+        m_AssertNoAllocations = args.HasFlag("--assert-no-allocations");
+        if (m_AssertNoAllocations && !AllocationTracker::IsEnabled())
+        {
+            VE_CORE_ERROR("--assert-no-allocations needs an engine built with VE_TRACK_ALLOCATIONS");
+            m_ExitCode = 1;
+        }
+        if (const char* tracePath = args.GetValue("--trace"))
+        {
+            VE_PROFILE_BEGIN_SESSION(tracePath);
+        }
 
-        glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
+        if (!headless)
+        {
+            int success = glfwInit();
+            VE_CORE_ASSERT(success, "Could not intialize GLFW!");
+
+            glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
 
-        glfwSetErrorCallback(GLFWErrorCallback);
+            glfwSetErrorCallback(GLFWErrorCallback);
+        }
+        else
+        {
+            VE_CORE_INFO("Running headless");
+        }
 
-        m_Instance = std::make_unique<Instance>();
+        m_Instance = std::make_unique<Instance>(headless);
 
-        m_Window = std::unique_ptr<Window>(Window::Create(*m_Instance));
+        m_Window = std::unique_ptr<Window>(
+            Window::Create(*m_Instance, WindowProps("VoxelicousEngine", 1280, 720, headless)));
         m_Window->SetEventCallback(BIND_EVENT_FN(OnEvent));
 
         m_Device = std::make_unique<Device>(m_Instance->Get(), m_Window->GetVkSurfaceKHR());
-        m_GlobalPool = DescriptorPool::Builder(*m_Device)
-                       .SetMaxSets(SwapChain::MAX_FRAMES_IN_FLIGHT * 2)
-                       .AddPoolSize(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, SwapChain::MAX_FRAMES_IN_FLIGHT * 2)
-                       .SetPoolFlags(VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT)
-                       .Build();
+        m_GlobalDescriptorAllocator = std::make_unique<DescriptorAllocator>(*m_Device);
+        m_ModelCache = std::make_unique<ModelCache>(*m_Device);
 
         m_Renderer = std::make_unique<Renderer>(*m_Window, *m_Device);
     }
 
     App::~App()
     {
+        VE_PROFILE_END_SESSION();
         s_Instance = nullptr;
     }
 
@@ -63,8 +115,16 @@ namespace VoxelicousEngine
         layer->OnAttach();
     }
 
+    void App::Close()
+    {
+        WindowCloseEvent event;
+        OnEvent(event);
+    }
+
     void App::OnEvent(Event& e)
     {
+        VE_ALLOCATION_SCOPE(Events);
+
         EventDispatcher dispatcher(e);
         dispatcher.Dispatch<WindowCloseEvent>(BIND_EVENT_FN(OnWindowClose));
 
@@ -88,24 +148,125 @@ namespace VoxelicousEngine
             VE_TRACE(e);
         }
 
+        VE_PROFILE_FUNCTION();
+
+        int64_t lastFrameEnd = Profiler::Now();
+        uint32_t framesSinceFlush = 0;
         while (m_Running)
         {
-            if (const VkCommandBuffer commandBuffer = m_Renderer->BeginFrame())
             {
-                m_Renderer->BeginSwapChainRendererPass(commandBuffer);
-                for (Layer* layer : m_LayerStack)
-                    layer->OnUpdate(commandBuffer);
-                m_Renderer->EndSwapChainRendererPass(commandBuffer);
-                m_Renderer->EndFrame();
+                VE_PROFILE_SCOPE("App::Run frame");
 
-                m_Window->OnUpdate();
+                AllocationTracker::BeginFrame();
+                if (const VkCommandBuffer commandBuffer = m_Renderer->BeginFrame())
+                {
+                    GpuProfiler& profiler = m_Renderer->GetProfiler();
+                    {
+                        GpuProfileScope passScope(profiler, commandBuffer, "SwapChainPass");
+                        m_Renderer->BeginSwapChainRendererPass(commandBuffer);
+                        for (Layer* layer : m_LayerStack)
+                        {
+                            VE_PROFILE_SCOPE(layer->GetProfileName());
+                            VE_ALLOCATION_SCOPE(Layers);
+                            GpuProfileScope layerScope(profiler, commandBuffer, layer->GetProfileName());
+                            layer->OnUpdate(commandBuffer);
+                        }
+                        m_Renderer->EndSwapChainRendererPass(commandBuffer);
+                    }
+                    m_Renderer->EndFrame();
+
+                    m_Window->OnUpdate();
+                    CheckFrameAllocations();
+
+                    const int64_t frameEnd = Profiler::Now();
+                    FrameStats::Get().Record(FrameMetric::CpuFrame, frameEnd - lastFrameEnd);
+                    lastFrameEnd = frameEnd;
+
+                    // Startup hitches (pipeline creation, first uploads) should not skew benchmark results
+                    if (++m_FrameCount == m_WarmupFrames)
+                    {
+                        FrameStats::Get().Reset();
+                    }
+
+                    if (m_FrameLimit != 0 && m_FrameCount >= m_FrameLimit)
+                    {
+                        if (const char* capturePath = m_CommandLineArgs.GetValue("--capture"))
+                        {
+                            WriteCapture(capturePath);
+                        }
+                        Close();
+                    }
+                }
+            }
+
+            // Writing the trace takes a lock and file IO, so it runs between frames every few frames and is
+            // kept out of both the frame scope and the CPU frame time
+            if (++framesSinceFlush == PROFILE_FLUSH_INTERVAL)
+            {
+                framesSinceFlush = 0;
+                VE_PROFILE_FLUSH();
+                lastFrameEnd = Profiler::Now();
             }
         }
     }
 
+    void App::CheckFrameAllocations()
+    {
+        const AllocationFrameReport& report = AllocationTracker::EndFrame();
+        if (!m_AssertNoAllocations || m_FrameCount < m_WarmupFrames || report.Total.Allocations == 0)
+        {
+            return;
+        }
+
+        // The steady-state loop is expected to reuse its memory; report where this frame allocated and stop
+        VE_CORE_ERROR("Frame {0} allocated memory in the steady state", m_FrameCount);
+        AllocationTracker::LogReport(report);
+        m_ExitCode = 1;
+        m_FrameLimit = m_FrameCount + 1;
+    }
+
+    void App::WriteCapture(const std::string& path) const
+    {
+        std::vector<uint8_t> pixels;
+        m_Renderer->CaptureFrame(pixels);
+        if (pixels.empty())
+        {
+            return;
+        }
+
+        const SwapChain& swapChain = m_Renderer->GetSwapChain();
+        const bool bgra = swapChain.GetSwapChainImageFormat() == VK_FORMAT_B8G8R8A8_SRGB ||
+            swapChain.GetSwapChainImageFormat() == VK_FORMAT_B8G8R8A8_UNORM;
+
+        std::ofstream file{path, std::ios::binary};
+        if (!file.is_open())
+        {
+            VE_CORE_ERROR("Failed to open capture file {0}", path);
+            return;
+        }
+
+        file << "P6\n" << swapChain.Width() << " " << swapChain.Height() << "\n255\n";
+        for (size_t i = 0; i < pixels.size(); i += 4)
+        {
+            const char rgb[3] = {
+                static_cast<char>(pixels[i + (bgra ? 2 : 0)]),
+                static_cast<char>(pixels[i + 1]),
+                static_cast<char>(pixels[i + (bgra ? 0 : 2)])
+            };
+            file.write(rgb, sizeof(rgb));
+        }
+
+        VE_CORE_INFO("Captured frame to {0}", path);
+    }
+
     bool App::OnWindowClose(const WindowCloseEvent& e)
     {
         vkDeviceWaitIdle(m_Device->GetDevice());
+        if (const char* benchmarkPath = m_CommandLineArgs.GetValue("--benchmark-output"))
+        {
+            FrameStats::Get().WriteJson(benchmarkPath);
+        }
+
         for (Layer* layer : m_LayerStack)
             layer->OnDetach();
         m_Running = false;
@@ -1,20 +1,47 @@
 #pragma once
 
+#include "Core.h"
 #include "Window.h"
 #include "Renderer/Instance.h"
 #include "Renderer/Renderer.h"
 #include "Renderer/Device.h"
 #include "Renderer/Descriptors.h"
 #include "LayerStack.h"
+#include "ModelCache.h"
 #include "Events/Event.h"
 #include "Events/AppEvent.h"
 
 namespace VoxelicousEngine
 {
+    struct AppCommandLineArgs
+    {
+        int Count = 0;
+        char** Args = nullptr;
+
+        const char* operator[](const int index) const
+        {
+            VE_CORE_ASSERT(index < Count, "Command line argument index out of range!");
+            return Args[index];
+        }
+
+        bool HasFlag(std::string_view flag) const;
+        // Returns the argument following flag, or nullptr if the flag is missing or has no value
+        const char* GetValue(std::string_view flag) const;
+    };
+
+    // Supported command line options:
+    //   --headless                 render offscreen without a window (no display or presentation support needed)
+    //   --frames <n>               close the app after n rendered frames
+    //   --capture <file>           write the last rendered frame to a binary PPM file (headless only)
+    //   --trace <file>             record CPU profiling scopes into a Chrome trace JSON file
+    //   --warmup-frames <n>        discard frame statistics of the first n frames
+    //   --benchmark-output <file>  write a JSON frame statistics summary on exit (see FrameStatsCompare)
+    //   --assert-no-allocations    fail (exit code 1) if a frame after the warm-up frames allocates; needs a
+    //                              build with VE_TRACK_ALLOCATIONS
     class App
     {
     public:
-        App();
+        explicit App(const AppCommandLineArgs& args = AppCommandLineArgs());
         virtual ~App();
 
         void Run();
@@ -27,23 +54,45 @@ namespace VoxelicousEngine
         Window& GetWindow() const { return *m_Window; }
         Device& GetDevice() const { return *m_Device; }
         Instance& GetInstance() const { return *m_Instance; }
+        ModelCache& GetModelCache() const { return *m_ModelCache; }
+
+        const AppCommandLineArgs& GetCommandLineArgs() const { return m_CommandLineArgs; }
+        bool IsHeadless() const { return m_Window->IsHeadless(); }
+
+        // Requests a regular shutdown, exactly as if the window had been closed
+        void Close();
+
+        // Process exit code, non-zero when a check such as --assert-no-allocations failed
+        int GetExitCode() const { return m_ExitCode; }
 
         static App& Get() { return *s_Instance; }
 
     protected:
         bool OnWindowClose(const WindowCloseEvent& e);
+        void WriteCapture(const std::string& path) const;
+        void CheckFrameAllocations();
+
+        AppCommandLineArgs m_CommandLineArgs;
 
         std::unique_ptr<Instance> m_Instance;
         std::unique_ptr<Window> m_Window;
         std::unique_ptr<Device> m_Device;
-        std::unique_ptr<DescriptorPool> m_GlobalPool;
+        // Long-lived descriptor sets, never reset; per-frame sets come from Renderer::GetFrameDescriptorAllocator
+        std::unique_ptr<DescriptorAllocator> m_GlobalDescriptorAllocator;
+        // Shared by all layers, so identical meshes are uploaded once app-wide
+        std::unique_ptr<ModelCache> m_ModelCache;
         std::unique_ptr<Renderer> m_Renderer;
         bool m_Running{true};
+        uint64_t m_FrameCount{0};
+        uint64_t m_FrameLimit{0};
+        uint64_t m_WarmupFrames{0};
+        bool m_AssertNoAllocations{false};
+        int m_ExitCode{0};
         LayerStack m_LayerStack;
 
         static App* s_Instance;
     };
 
     // To be defined in CLIENT
-    App* CreateApp();
+    App* CreateApp(const AppCommandLineArgs& args);
 }
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "Handle.h"
+#include "Transform.h"
+
+namespace VoxelicousEngine
+{
+    // World matrix of an entity, cached by TransformSystem and only recomputed when its TransformComponent or
+    // its parent's matrix changed. Entities need both components to take part in the system.
+    struct WorldTransformComponent
+    {
+        glm::mat4 Matrix{1.f};
+        // Bumped on every recompute, so children and the GPU object table can tell the matrix changed
+        uint32_t Version{0};
+        // Forces a recompute even though Local matches, e.g. after the entity was detached from its parent
+        bool Dirty{true};
+        // The local transform Matrix was computed from
+        TransformComponent Local{};
+    };
+
+    // Makes an entity's transform relative to another entity's. Set through TransformSystem::SetParent, which
+    // rejects cycles.
+    struct ParentComponent
+    {
+        Entity Parent{};
+        // Parent matrix version the child's matrix was computed with
+        uint32_t ParentVersion{0};
+        // Last TransformSystem update that brought the matrix up to date
+        uint64_t ResolvedUpdate{0};
+    };
+
+    // Makes an entity drawable. Resolved through the app's ModelCache; the code that acquired the mesh also
+    // releases it.
+    struct MeshComponent
+    {
+        MeshHandle Mesh{};
+        // Index into the renderer's material table, uploaded with the object's GPU data
+        uint32_t MaterialId{0};
+    };
+}
@@ -1,13 +1,18 @@
 #pragma once
 
-#ifdef VE_PLATFORM_WINDOWS
+#if defined(VE_PLATFORM_WINDOWS)
+	#define VE_DEBUGBREAK() __debugbreak()
+#elif defined(VE_PLATFORM_LINUX)
+	// Linux is supported for headless rendering (CI, benchmarks)
+	#include <csignal>
+	#define VE_DEBUGBREAK() raise(SIGTRAP)
 #else
-#error Voxelicous Engine only supports Windows!
+#error Voxelicous Engine only supports Windows and Linux!
 #endif
 
 #ifdef VE_ENABLE_ASSERTS
-	#define VE_ASSERT(x, ...) { if(!(x)) { VE_ERROR("Assertion Failed: {0}", __VA_ARGS__); __debugbreak(); } }
-	#define VE_CORE_ASSERT(x, ...) { if(!(x)) { VE_CORE_ERROR("Assertion Failed: {0}", __VA_ARGS__); __debugbreak(); } }
+	#define VE_ASSERT(x, ...) { if(!(x)) { VE_ERROR("Assertion Failed: {0}", __VA_ARGS__); VE_DEBUGBREAK(); } }
+	#define VE_CORE_ASSERT(x, ...) { if(!(x)) { VE_CORE_ERROR("Assertion Failed: {0}", __VA_ARGS__); VE_DEBUGBREAK(); } }
 #else
 #define VE_ASSERT(x, ...)
 #define VE_CORE_ASSERT(x, ...)
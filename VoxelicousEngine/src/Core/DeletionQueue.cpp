@@ -0,0 +1,53 @@
+#include "vepch.h"
+#include "DeletionQueue.h"
+
+namespace VoxelicousEngine
+{
+    DeletionQueue::~DeletionQueue()
+    {
+        Flush();
+    }
+
+    void DeletionQueue::Defer(std::function<void()> destroy)
+    {
+        using Function = std::function<void()>;
+        Push(new Function(std::move(destroy)), [](void* object)
+        {
+            const auto* function = static_cast<Function*>(object);
+            (*function)();
+            delete function;
+        });
+    }
+
+    void DeletionQueue::Push(void* object, void (*destroy)(void*))
+    {
+        m_Entries.push_back({m_CurrentFrame, object, destroy});
+    }
+
+    void DeletionQueue::BeginFrame(const uint64_t frameNumber, const uint32_t framesInFlight)
+    {
+        VE_PROFILE_FUNCTION();
+
+        assert(frameNumber > m_CurrentFrame && "Frame numbers must increase");
+        m_CurrentFrame = frameNumber;
+
+        // The fence of frameNumber - framesInFlight was waited on, so it and every earlier frame are complete
+        while (!m_Entries.empty() && m_Entries.front().Frame + framesInFlight <= frameNumber)
+        {
+            // Popped first, so a destructor that queues something else doesn't see a half-retired entry
+            const Entry entry = m_Entries.front();
+            m_Entries.pop_front();
+            entry.Destroy(entry.Object);
+        }
+    }
+
+    void DeletionQueue::Flush()
+    {
+        while (!m_Entries.empty())
+        {
+            const Entry entry = m_Entries.front();
+            m_Entries.pop_front();
+            entry.Destroy(entry.Object);
+        }
+    }
+}
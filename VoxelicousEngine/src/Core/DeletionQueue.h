@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <type_traits>
+
+namespace VoxelicousEngine
+{
+    // Destroys resources once no frame that may still use them is in flight, instead of waiting for the device to
+    // go idle. Every entry is tagged with the frame that was being recorded when it was queued: that frame and the
+    // ones before it may reference the resource, frames recorded later can't. The renderer calls BeginFrame after
+    // waiting on the fence of the frame framesInFlight frames back, which retires everything tagged up to that one.
+    //
+    // Entries are retired in FIFO order, so destruction order matches the order they were queued in. Resources
+    // queued outside a frame count as part of the last frame begun. Not thread-safe.
+    class DeletionQueue
+    {
+    public:
+        DeletionQueue() = default;
+        // Destroys whatever is still queued; by then the owner must have waited for the device to be idle
+        ~DeletionQueue();
+
+        DeletionQueue(const DeletionQueue&) = delete;
+        DeletionQueue& operator=(const DeletionQueue&) = delete;
+
+        // Takes ownership of a movable resource (Buffer, Model, Pipeline, Texture, a unique_ptr to one, ...)
+        template <typename T>
+        void Destroy(T&& resource)
+        {
+            static_assert(!std::is_lvalue_reference_v<T>, "Move the resource into the queue");
+            using Resource = std::remove_cvref_t<T>;
+            Push(new Resource(std::move(resource)), [](void* object) { delete static_cast<Resource*>(object); });
+        }
+
+        // Runs destroy once the current frame has completed, e.g. for raw Vulkan handles
+        void Defer(std::function<void()> destroy);
+
+        // Frame numbers increase by one per frame, starting at 1
+        void BeginFrame(uint64_t frameNumber, uint32_t framesInFlight);
+        // Destroys everything right away, for when the device was just waited on
+        void Flush();
+
+        size_t GetPendingCount() const { return m_Entries.size(); }
+
+    private:
+        struct Entry
+        {
+            uint64_t Frame;
+            void* Object;
+            void (*Destroy)(void*);
+        };
+
+        void Push(void* object, void (*destroy)(void*));
+
+        std::deque<Entry> m_Entries;
+        uint64_t m_CurrentFrame = 0;
+    };
+}
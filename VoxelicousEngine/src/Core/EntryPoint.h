@@ -1,16 +1,18 @@
 #pragma once
-#ifdef VE_PLATFORM_WINDOWS
+#if defined(VE_PLATFORM_WINDOWS) || defined(VE_PLATFORM_LINUX)
 
-extern auto VoxelicousEngine::CreateApp() -> VoxelicousEngine::App*;
+extern auto VoxelicousEngine::CreateApp(const AppCommandLineArgs& args) -> VoxelicousEngine::App*;
 
-auto main(int  /*argc*/, char**  /*argv*/) -> int
+auto main(int argc, char** argv) -> int
 {
     VoxelicousEngine::Log::Init();
     VE_CORE_WARN("Init Log!");
 
-    auto *const app = VoxelicousEngine::CreateApp();
+    auto *const app = VoxelicousEngine::CreateApp({argc, argv});
     app->Run();
+    const int exitCode = app->GetExitCode();
     delete app;
+    return exitCode;
 }
 
 #endif
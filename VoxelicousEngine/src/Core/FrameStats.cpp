@@ -0,0 +1,215 @@
+#include "vepch.h"
+#include "FrameStats.h"
+
+#include <bit>
+#include <cmath>
+#include <fstream>
+
+namespace VoxelicousEngine
+{
+    // *************** Latency Histogram *********************
+
+    uint32_t LatencyHistogram::GetBucketIndex(uint64_t value)
+    {
+        value = std::min<uint64_t>(value, (1ull << MAX_VALUE_BITS) - 1);
+        const auto msb = static_cast<uint32_t>(std::bit_width(value | 1)) - 1;
+        if (msb < SUB_BUCKET_BITS)
+        {
+            return static_cast<uint32_t>(value);
+        }
+
+        // Keep SUB_BUCKET_BITS bits below the most significant one
+        const uint32_t shift = msb - SUB_BUCKET_BITS;
+        return ((shift + 1) << SUB_BUCKET_BITS) + static_cast<uint32_t>((value >> shift) - SUB_BUCKET_COUNT);
+    }
+
+    uint64_t LatencyHistogram::GetBucketLowerBound(const uint32_t index)
+    {
+        const uint32_t group = index >> SUB_BUCKET_BITS;
+        const uint64_t subBucket = index & (SUB_BUCKET_COUNT - 1);
+        if (group == 0)
+        {
+            return subBucket;
+        }
+        return (subBucket + SUB_BUCKET_COUNT) << (group - 1);
+    }
+
+    uint64_t LatencyHistogram::GetBucketUpperBound(const uint32_t index)
+    {
+        const uint32_t group = index >> SUB_BUCKET_BITS;
+        return GetBucketLowerBound(index) + (group == 0 ? 0 : (1ull << (group - 1)) - 1);
+    }
+
+    void LatencyHistogram::Record(const uint64_t value)
+    {
+        m_Buckets[GetBucketIndex(value)]++;
+        m_Count++;
+    }
+
+    void LatencyHistogram::Remove(const uint64_t value)
+    {
+        auto& bucket = m_Buckets[GetBucketIndex(value)];
+        assert(bucket > 0 && "Removing a value that was never recorded");
+        bucket--;
+        m_Count--;
+    }
+
+    void LatencyHistogram::Reset()
+    {
+        m_Buckets.fill(0);
+        m_Count = 0;
+    }
+
+    uint64_t LatencyHistogram::GetPercentile(const double percentile) const
+    {
+        if (m_Count == 0)
+        {
+            return 0;
+        }
+
+        const double fraction = std::clamp(percentile, 0.0, 100.0) / 100.0;
+        const auto rank = std::max<uint64_t>(
+            1, static_cast<uint64_t>(std::ceil(fraction * static_cast<double>(m_Count))));
+
+        uint64_t seen = 0;
+        for (uint32_t i = 0; i < BUCKET_COUNT; i++)
+        {
+            seen += m_Buckets[i];
+            if (seen >= rank)
+            {
+                return (GetBucketLowerBound(i) + GetBucketUpperBound(i)) / 2;
+            }
+        }
+        return GetBucketUpperBound(BUCKET_COUNT - 1);
+    }
+
+    // *************** Frame Stats *********************
+
+    FrameStats& FrameStats::Get()
+    {
+        static FrameStats frameStats;
+        return frameStats;
+    }
+
+    void FrameStats::Record(const FrameMetric metric, const uint64_t nanoseconds)
+    {
+        MetricData& data = m_Metrics[static_cast<size_t>(metric)];
+
+        data.Total.Record(nanoseconds);
+        data.TotalSum += nanoseconds;
+        data.TotalMax = std::max(data.TotalMax, nanoseconds);
+
+        // Once the window is full the oldest sample falls out of the window histogram
+        if (data.Window.GetCount() == WINDOW_SIZE)
+        {
+            data.Window.Remove(data.WindowSamples[data.WindowNext]);
+        }
+        data.Window.Record(nanoseconds);
+        data.WindowSamples[data.WindowNext] = nanoseconds;
+        data.WindowNext = (data.WindowNext + 1) % WINDOW_SIZE;
+    }
+
+    void FrameStats::Reset()
+    {
+        for (MetricData& data : m_Metrics)
+        {
+            data.Total.Reset();
+            data.Window.Reset();
+            data.WindowNext = 0;
+            data.TotalSum = 0;
+            data.TotalMax = 0;
+        }
+    }
+
+    FrameStats::Summary FrameStats::GetWindowSummary(const FrameMetric metric) const
+    {
+        const MetricData& data = m_Metrics[static_cast<size_t>(metric)];
+        const auto count = static_cast<size_t>(data.Window.GetCount());
+
+        Summary summary;
+        summary.Count = count;
+        if (count == 0)
+        {
+            return summary;
+        }
+
+        // The window is small enough to get the exact mean and maximum from the raw samples
+        uint64_t sum = 0;
+        uint64_t max = 0;
+        for (size_t i = 0; i < count; i++)
+        {
+            const uint64_t sample = data.WindowSamples[(data.WindowNext + WINDOW_SIZE - 1 - i) % WINDOW_SIZE];
+            sum += sample;
+            max = std::max(max, sample);
+        }
+
+        summary.MeanMs = static_cast<double>(sum) / static_cast<double>(count) * 1e-6;
+        summary.P50Ms = static_cast<double>(data.Window.GetPercentile(50.0)) * 1e-6;
+        summary.P95Ms = static_cast<double>(data.Window.GetPercentile(95.0)) * 1e-6;
+        summary.P99Ms = static_cast<double>(data.Window.GetPercentile(99.0)) * 1e-6;
+        summary.MaxMs = static_cast<double>(max) * 1e-6;
+        return summary;
+    }
+
+    FrameStats::Summary FrameStats::GetTotalSummary(const FrameMetric metric) const
+    {
+        const MetricData& data = m_Metrics[static_cast<size_t>(metric)];
+
+        Summary summary;
+        summary.Count = data.Total.GetCount();
+        if (summary.Count == 0)
+        {
+            return summary;
+        }
+
+        summary.MeanMs = static_cast<double>(data.TotalSum) / static_cast<double>(summary.Count) * 1e-6;
+        summary.P50Ms = static_cast<double>(data.Total.GetPercentile(50.0)) * 1e-6;
+        summary.P95Ms = static_cast<double>(data.Total.GetPercentile(95.0)) * 1e-6;
+        summary.P99Ms = static_cast<double>(data.Total.GetPercentile(99.0)) * 1e-6;
+        summary.MaxMs = static_cast<double>(data.TotalMax) * 1e-6;
+        return summary;
+    }
+
+    bool FrameStats::WriteJson(const std::string& filePath) const
+    {
+        std::ofstream file{filePath};
+        if (!file.is_open())
+        {
+            VE_CORE_ERROR("Failed to open frame statistics file {0}", filePath);
+            return false;
+        }
+
+        file << std::fixed;
+        file.precision(4);
+        file << "{\n  \"frames\": " << GetTotalSummary(FrameMetric::CpuFrame).Count << ",\n  \"metrics\": {";
+        for (size_t i = 0; i < m_Metrics.size(); i++)
+        {
+            const auto metric = static_cast<FrameMetric>(i);
+            const Summary summary = GetTotalSummary(metric);
+            file << (i == 0 ? "\n" : ",\n")
+                << "    \"" << GetMetricName(metric) << "\": {"
+                << "\"count\": " << summary.Count
+                << ", \"mean\": " << summary.MeanMs
+                << ", \"p50\": " << summary.P50Ms
+                << ", \"p95\": " << summary.P95Ms
+                << ", \"p99\": " << summary.P99Ms
+                << ", \"max\": " << summary.MaxMs << "}";
+        }
+        file << "\n  }\n}\n";
+
+        VE_CORE_INFO("Wrote frame statistics to {0}", filePath);
+        return true;
+    }
+
+    const char* FrameStats::GetMetricName(const FrameMetric metric)
+    {
+        switch (metric)
+        {
+        case FrameMetric::CpuFrame: return "cpu_frame_ms";
+        case FrameMetric::GpuFrame: return "gpu_frame_ms";
+        case FrameMetric::FenceWait: return "fence_wait_ms";
+        case FrameMetric::Present: return "present_ms";
+        default: return "unknown";
+        }
+    }
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace VoxelicousEngine
+{
+    // Log-linear histogram in the spirit of HdrHistogram: every power of two is split into
+    // 2^SUB_BUCKET_BITS linear buckets, which bounds the relative error of any reported value to
+    // below 1% while covering nanoseconds to minutes in a few thousand counters.
+    class LatencyHistogram
+    {
+    public:
+        static constexpr uint32_t SUB_BUCKET_BITS = 7;
+        static constexpr uint32_t SUB_BUCKET_COUNT = 1u << SUB_BUCKET_BITS;
+        // Values are clamped to 2^40 ns (about 18 minutes)
+        static constexpr uint32_t MAX_VALUE_BITS = 40;
+        static constexpr uint32_t BUCKET_COUNT = (MAX_VALUE_BITS - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT;
+
+        void Record(uint64_t value);
+        void Remove(uint64_t value);
+        void Reset();
+
+        uint64_t GetCount() const { return m_Count; }
+        // Value at percentile (0-100], reported as the middle of the containing bucket
+        uint64_t GetPercentile(double percentile) const;
+
+        static uint32_t GetBucketIndex(uint64_t value);
+        static uint64_t GetBucketLowerBound(uint32_t index);
+        static uint64_t GetBucketUpperBound(uint32_t index);
+
+    private:
+        std::array<uint32_t, BUCKET_COUNT> m_Buckets{};
+        uint64_t m_Count{0};
+    };
+
+    enum class FrameMetric
+    {
+        CpuFrame,
+        GpuFrame,
+        FenceWait,
+        Present,
+        Count
+    };
+
+    // Collects per-frame timings of the whole run and of a sliding window over the most recent frames.
+    // Timings are recorded from the main thread only.
+    class FrameStats
+    {
+    public:
+        static constexpr size_t WINDOW_SIZE = 300;
+
+        struct Summary
+        {
+            uint64_t Count = 0;
+            double MeanMs = 0.0;
+            double P50Ms = 0.0;
+            double P95Ms = 0.0;
+            double P99Ms = 0.0;
+            double MaxMs = 0.0;
+        };
+
+        static FrameStats& Get();
+
+        void Record(FrameMetric metric, uint64_t nanoseconds);
+        void Reset();
+
+        Summary GetWindowSummary(FrameMetric metric) const;
+        Summary GetTotalSummary(FrameMetric metric) const;
+
+        // Writes the whole-run summaries of every metric, the input format of FrameStatsCompare
+        bool WriteJson(const std::string& filePath) const;
+
+        static const char* GetMetricName(FrameMetric metric);
+
+    private:
+        struct MetricData
+        {
+            LatencyHistogram Total;
+            LatencyHistogram Window;
+            std::array<uint64_t, WINDOW_SIZE> WindowSamples{};
+            size_t WindowNext = 0;
+            uint64_t TotalSum = 0;
+            uint64_t TotalMax = 0;
+        };
+
+        std::array<MetricData, static_cast<size_t>(FrameMetric::Count)> m_Metrics;
+    };
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+
+namespace VoxelicousEngine
+{
+    // Reference to an object in a ResourcePool<T>: the slot index and the generation the slot had when the object
+    // was created. Destroying the object bumps the slot's generation, so every handle to it resolves to nullptr
+    // afterwards, even once the slot holds a new object. A plain 64-bit value, copied without any refcounting;
+    // the default (generation 0) is the null handle.
+    template <typename T>
+    struct Handle
+    {
+        uint32_t Index = 0;
+        uint32_t Generation = 0;
+
+        bool IsNull() const { return Generation == 0; }
+        explicit operator bool() const { return Generation != 0; }
+        bool operator==(const Handle&) const = default;
+
+        // Unique per live object, e.g. as a sort or map key
+        uint64_t GetKey() const { return static_cast<uint64_t>(Generation) << 32 | Index; }
+    };
+
+    class Model;
+    class Buffer;
+    class Texture;
+    class Pipeline;
+    class Scene;
+
+    using MeshHandle = Handle<Model>;
+    using BufferHandle = Handle<Buffer>;
+    using TextureHandle = Handle<Texture>;
+    using PipelineHandle = Handle<Pipeline>;
+    // Entities aren't pooled objects, but Scene hands out and checks their handles the same way
+    using Entity = Handle<Scene>;
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace VoxelicousEngine
+{
+    // 64-bit non-cryptographic content hash (the xxHash64 algorithm), used to key on-disk asset caches by
+    // their source data. Hashes several GB/s, so hashing a source is much cheaper than rebuilding from it.
+    uint64_t HashBytes(const void* data, size_t size, uint64_t seed = 0);
+
+    template <typename T>
+    uint64_t HashBytes(const std::span<const T> values, const uint64_t seed = 0)
+    {
+        return HashBytes(values.data(), values.size_bytes(), seed);
+    }
+
+    // Mixes a value into a running hash, e.g. the settings an asset was built with
+    inline uint64_t HashCombine(const uint64_t seed, const uint64_t value)
+    {
+        return seed ^ (value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2));
+    }
+}
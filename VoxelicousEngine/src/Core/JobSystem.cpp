@@ -0,0 +1,166 @@
+#include "vepch.h"
+#include "JobSystem.h"
+
+namespace VoxelicousEngine
+{
+    JobSystem::JobSystem(uint32_t threadCount)
+    {
+        if (threadCount == 0)
+        {
+            threadCount = std::max(1u, std::thread::hardware_concurrency()) - 1;
+        }
+
+        m_Workers.reserve(threadCount);
+        for (uint32_t i = 0; i < threadCount; i++)
+        {
+            m_Workers.emplace_back([this] { WorkerLoop(); });
+        }
+    }
+
+    JobSystem::~JobSystem()
+    {
+        {
+            std::lock_guard lock(m_Mutex);
+            m_Stopping = true;
+        }
+        m_WakeCondition.notify_all();
+
+        for (std::thread& worker : m_Workers)
+        {
+            worker.join();
+        }
+    }
+
+    JobSystem& JobSystem::Get()
+    {
+        static JobSystem jobSystem;
+        return jobSystem;
+    }
+
+    void JobSystem::Execute(Job job, JobCounter* counter)
+    {
+        if (counter)
+        {
+            counter->Remaining.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        // Without workers the job runs inline, which keeps single-core machines working
+        if (m_Workers.empty())
+        {
+            job();
+            if (counter)
+            {
+                counter->Remaining.fetch_sub(1, std::memory_order_release);
+            }
+            return;
+        }
+
+        {
+            std::lock_guard lock(m_Mutex);
+            PushJob({std::move(job), counter});
+        }
+        m_WakeCondition.notify_one();
+    }
+
+    void JobSystem::Wait(const JobCounter& counter)
+    {
+        while (!counter.IsDone())
+        {
+            if (!TryRunOne())
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void JobSystem::ParallelFor(const uint32_t count, uint32_t batchSize,
+                                const std::function<void(uint32_t, uint32_t)>& fn)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+        batchSize = std::max(1u, batchSize);
+
+        JobCounter counter;
+        for (uint32_t begin = batchSize; begin < count; begin += batchSize)
+        {
+            const uint32_t end = std::min(count, begin + batchSize);
+            Execute([&fn, begin, end] { fn(begin, end); }, &counter);
+        }
+
+        // The first batch runs on the calling thread while the workers pick up the rest
+        fn(0, std::min(count, batchSize));
+        Wait(counter);
+    }
+
+    void JobSystem::PushJob(QueuedJob&& job)
+    {
+        if (m_QueueSize == m_Queue.size())
+        {
+            // Unwrap into a buffer twice the size, oldest job first
+            std::vector<QueuedJob> queue(std::max<size_t>(64, m_Queue.size() * 2));
+            for (size_t i = 0; i < m_QueueSize; i++)
+            {
+                queue[i] = std::move(m_Queue[(m_QueueHead + i) & (m_Queue.size() - 1)]);
+            }
+            m_Queue = std::move(queue);
+            m_QueueHead = 0;
+        }
+        m_Queue[(m_QueueHead + m_QueueSize) & (m_Queue.size() - 1)] = std::move(job);
+        m_QueueSize++;
+    }
+
+    JobSystem::QueuedJob JobSystem::PopJob()
+    {
+        QueuedJob job = std::move(m_Queue[m_QueueHead]);
+        m_QueueHead = (m_QueueHead + 1) & (m_Queue.size() - 1);
+        m_QueueSize--;
+        return job;
+    }
+
+    bool JobSystem::TryRunOne()
+    {
+        QueuedJob job;
+        {
+            std::lock_guard lock(m_Mutex);
+            if (m_QueueSize == 0)
+            {
+                return false;
+            }
+            job = PopJob();
+        }
+
+        job.Function();
+        if (job.Counter)
+        {
+            job.Counter->Remaining.fetch_sub(1, std::memory_order_release);
+        }
+        return true;
+    }
+
+    void JobSystem::WorkerLoop()
+    {
+        VE_ALLOCATION_SCOPE(Jobs);
+
+        while (true)
+        {
+            QueuedJob job;
+            {
+                std::unique_lock lock(m_Mutex);
+                m_WakeCondition.wait(lock, [this] { return m_Stopping || m_QueueSize != 0; });
+                if (m_QueueSize == 0)
+                {
+                    return;
+                }
+                job = PopJob();
+            }
+
+            job.Function();
+            if (job.Counter)
+            {
+                job.Counter->Remaining.fetch_sub(1, std::memory_order_release);
+            }
+        }
+    }
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace VoxelicousEngine
+{
+    // Counts the unfinished jobs of a batch. Jobs decrement it when they complete.
+    struct JobCounter
+    {
+        std::atomic<uint32_t> Remaining{0};
+
+        bool IsDone() const { return Remaining.load(std::memory_order_acquire) == 0; }
+    };
+
+    // Fixed pool of worker threads consuming a shared job queue. Threads waiting on a counter run queued
+    // jobs themselves instead of blocking, so nested waits cannot starve the pool.
+    class JobSystem
+    {
+    public:
+        using Job = std::function<void()>;
+
+        // 0 threads picks one worker per hardware thread minus the calling thread
+        explicit JobSystem(uint32_t threadCount = 0);
+        ~JobSystem();
+
+        JobSystem(const JobSystem&) = delete;
+        JobSystem& operator=(const JobSystem&) = delete;
+
+        static JobSystem& Get();
+
+        void Execute(Job job, JobCounter* counter = nullptr);
+        void Wait(const JobCounter& counter);
+
+        // Splits [0, count) into batches of batchSize and calls fn(begin, end) for each, returning when all
+        // batches are done. The calling thread takes part in the work.
+        void ParallelFor(uint32_t count, uint32_t batchSize, const std::function<void(uint32_t, uint32_t)>& fn);
+
+        uint32_t GetThreadCount() const { return static_cast<uint32_t>(m_Workers.size()); }
+
+    private:
+        struct QueuedJob
+        {
+            Job Function;
+            JobCounter* Counter;
+        };
+
+        bool TryRunOne();
+        void WorkerLoop();
+        // Both need m_Mutex held
+        void PushJob(QueuedJob&& job);
+        QueuedJob PopJob();
+
+        std::vector<std::thread> m_Workers;
+        // Ring buffer with a power-of-two capacity. It only ever grows, so once it has seen the largest batch,
+        // queueing jobs allocates nothing (a deque allocates and frees blocks as the queue moves).
+        std::vector<QueuedJob> m_Queue;
+        size_t m_QueueHead = 0;
+        size_t m_QueueSize = 0;
+        std::mutex m_Mutex;
+        std::condition_variable m_WakeCondition;
+        bool m_Stopping = false;
+    };
+}
@@ -3,7 +3,7 @@
 
 namespace VoxelicousEngine
 {
-    void KeyboardCameraController::MoveInPlaneXZ(GLFWwindow* window, const float dt, GameObject& gameObject)
+    void KeyboardCameraController::MoveInPlaneXZ(GLFWwindow* window, const float dt, TransformComponent& transform)
     {
         glm::vec3 rotate{0};
         if (glfwGetKey(window, Keys.LookRight) == GLFW_PRESS) rotate.y += 1.f;
@@ -13,13 +13,13 @@ namespace VoxelicousEngine
 
         if (dot(rotate, rotate) > std::numeric_limits<float>::epsilon())
         {
-            gameObject.Transform.Rotation += LookSpeed * dt * normalize(rotate);
+            transform.Rotation += LookSpeed * dt * normalize(rotate);
         }
 
-        gameObject.Transform.Rotation.x = glm::clamp(gameObject.Transform.Rotation.x, -1.5f, 1.5f);
-        gameObject.Transform.Rotation.y = glm::mod(gameObject.Transform.Rotation.y, glm::two_pi<float>());
+        transform.Rotation.x = glm::clamp(transform.Rotation.x, -1.5f, 1.5f);
+        transform.Rotation.y = glm::mod(transform.Rotation.y, glm::two_pi<float>());
 
-        const float yaw = gameObject.Transform.Rotation.y;
+        const float yaw = transform.Rotation.y;
         const glm::vec3 forwardDir{sin(yaw), 0.f, cos(yaw)};
         const glm::vec3 rightDir{forwardDir.z, 0.f, -forwardDir.x};
         const glm::vec3 upDir{0.f, -1.f, 0.f};
@@ -35,7 +35,7 @@ namespace VoxelicousEngine
 
         if (dot(MoveDir, MoveDir) > std::numeric_limits<float>::epsilon())
         {
-            gameObject.Transform.Translation += MoveSpeed * dt * normalize(MoveDir);
+            transform.Translation += MoveSpeed * dt * normalize(MoveDir);
         }
     }
 
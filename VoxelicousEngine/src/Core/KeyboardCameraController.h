@@ -1,6 +1,6 @@
 #pragma once
 
-#include "GameObject.h"
+#include "Transform.h"
 #include "Window.h"
 
 namespace VoxelicousEngine
@@ -22,7 +22,7 @@ namespace VoxelicousEngine
             int LookDown = GLFW_KEY_DOWN;
         };
 
-        void MoveInPlaneXZ(GLFWwindow* window, float dt, GameObject& gameObject);
+        void MoveInPlaneXZ(GLFWwindow* window, float dt, TransformComponent& transform);
         glm::vec3 GetMoveDirection(GLFWwindow* window);
 
         KeyMappings Keys{};
@@ -1,10 +1,11 @@
 #include "vepch.h"
 #include "Layer.h"
+#include "Profiler.h"
 
 namespace VoxelicousEngine
 {
     Layer::Layer(std::string name)
-        : m_DebugName(std::move(name))
+        : m_DebugName(std::move(name)), m_ProfileName(Profiler::Intern(m_DebugName))
     {
     }
 
@@ -28,8 +28,11 @@ namespace VoxelicousEngine
         }
 
         const std::string& GetName() const { return m_DebugName; }
+        // The name interned by the profiler, safe to keep in profiler scopes after the layer is gone
+        const char* GetProfileName() const { return m_ProfileName; }
 
     private:
         std::string m_DebugName;
+        const char* m_ProfileName;
     };
 }
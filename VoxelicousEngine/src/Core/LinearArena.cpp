@@ -0,0 +1,103 @@
+#include "vepch.h"
+#include "LinearArena.h"
+
+namespace VoxelicousEngine
+{
+    LinearArena::LinearArena(const size_t initialSize)
+    {
+        AddBlock(initialSize);
+    }
+
+    void* LinearArena::Allocate(const size_t size, const size_t alignment)
+    {
+        assert((alignment & (alignment - 1)) == 0 && "Alignment must be a power of two");
+
+        while (true)
+        {
+            Block& block = m_Blocks[m_CurrentBlock];
+            const auto base = reinterpret_cast<uintptr_t>(block.Memory.get());
+            const uintptr_t aligned = (base + block.Offset + alignment - 1) & ~(alignment - 1);
+            const size_t end = aligned - base + size;
+            if (end <= block.Size)
+            {
+                block.Offset = end;
+                return reinterpret_cast<void*>(aligned);
+            }
+
+            // Blocks after the current one are empty after a Rewind and can be reused as they are
+            if (m_CurrentBlock + 1 < m_Blocks.size() && m_Blocks[m_CurrentBlock + 1].Size >= size + alignment)
+            {
+                m_CurrentBlock++;
+                m_Blocks[m_CurrentBlock].Offset = 0;
+                continue;
+            }
+
+            AddBlock(std::max(block.Size * 2, size + alignment));
+        }
+    }
+
+    void LinearArena::Rewind(const Marker& marker)
+    {
+        assert(marker.Block <= m_CurrentBlock && "Marker is newer than the arena state");
+
+        for (size_t i = marker.Block + 1; i <= m_CurrentBlock; i++)
+        {
+            m_Blocks[i].Offset = 0;
+        }
+        m_CurrentBlock = marker.Block;
+        m_Blocks[m_CurrentBlock].Offset = marker.Offset;
+    }
+
+    void LinearArena::Reset()
+    {
+        // Merge chained blocks into one that fits everything, so the next cycle needs no new blocks
+        if (m_Blocks.size() > 1)
+        {
+            const size_t capacity = GetCapacity();
+            m_Blocks.clear();
+            AddBlock(capacity);
+        }
+        m_CurrentBlock = 0;
+        m_Blocks[0].Offset = 0;
+    }
+
+    size_t LinearArena::GetUsed() const
+    {
+        size_t used = 0;
+        for (size_t i = 0; i <= m_CurrentBlock; i++)
+        {
+            used += m_Blocks[i].Offset;
+        }
+        return used;
+    }
+
+    size_t LinearArena::GetCapacity() const
+    {
+        size_t capacity = 0;
+        for (const Block& block : m_Blocks)
+        {
+            capacity += block.Size;
+        }
+        return capacity;
+    }
+
+    LinearArena& LinearArena::GetThreadScratch()
+    {
+        thread_local LinearArena scratch;
+        return scratch;
+    }
+
+    void LinearArena::AddBlock(const size_t minimumSize)
+    {
+        Block block;
+        block.Size = std::max(minimumSize, static_cast<size_t>(1));
+        block.Memory = std::make_unique_for_overwrite<std::byte[]>(block.Size);
+        // New blocks go right after the current one; anything past it is empty anyway
+        m_Blocks.insert(m_Blocks.begin() + static_cast<ptrdiff_t>(std::min(m_CurrentBlock + 1, m_Blocks.size())),
+                        std::move(block));
+        if (m_Blocks.size() > 1)
+        {
+            m_CurrentBlock++;
+        }
+    }
+}
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace VoxelicousEngine
+{
+    // Bump allocator for short-lived data. Allocation is a pointer increment and memory is only released all
+    // at once by Reset (or back to a marker by Rewind); destructors are never run. When a block runs out a
+    // larger one is chained, and the next Reset merges all blocks into one, so an arena that is reset every
+    // frame stops touching the heap after the first few frames.
+    class LinearArena
+    {
+    public:
+        static constexpr size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+        struct Marker
+        {
+            size_t Block = 0;
+            size_t Offset = 0;
+        };
+
+        explicit LinearArena(size_t initialSize = DEFAULT_BLOCK_SIZE);
+
+        LinearArena(const LinearArena&) = delete;
+        LinearArena& operator=(const LinearArena&) = delete;
+
+        void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+        template <typename T, typename... Args>
+        T* New(Args&&... args)
+        {
+            static_assert(std::is_trivially_destructible_v<T>, "Arena memory is released without running destructors");
+            return new(Allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+        }
+
+        // Default-initialized, so trivial types are left uninitialized
+        template <typename T>
+        T* AllocateArray(const size_t count)
+        {
+            static_assert(std::is_trivially_destructible_v<T>, "Arena memory is released without running destructors");
+            return new(Allocate(sizeof(T) * count, alignof(T))) T[count];
+        }
+
+        Marker GetMarker() const { return {m_CurrentBlock, m_Blocks[m_CurrentBlock].Offset}; }
+        // Frees everything allocated after the marker was taken
+        void Rewind(const Marker& marker);
+        void Reset();
+
+        size_t GetUsed() const;
+        size_t GetCapacity() const;
+
+        // Per-thread arena for temporary data of jobs and other helpers; use it through an ArenaScope
+        static LinearArena& GetThreadScratch();
+
+    private:
+        struct Block
+        {
+            std::unique_ptr<std::byte[]> Memory;
+            size_t Size = 0;
+            size_t Offset = 0;
+        };
+
+        void AddBlock(size_t minimumSize);
+
+        std::vector<Block> m_Blocks;
+        size_t m_CurrentBlock = 0;
+    };
+
+    // Rewinds an arena to where it was when the scope was entered
+    class ArenaScope
+    {
+    public:
+        explicit ArenaScope(LinearArena& arena) : m_Arena{arena}, m_Marker{arena.GetMarker()}
+        {
+        }
+
+        ~ArenaScope() { m_Arena.Rewind(m_Marker); }
+
+        ArenaScope(const ArenaScope&) = delete;
+        ArenaScope& operator=(const ArenaScope&) = delete;
+
+        LinearArena& GetArena() const { return m_Arena; }
+
+    private:
+        LinearArena& m_Arena;
+        LinearArena::Marker m_Marker;
+    };
+
+    // Standard allocator backed by a LinearArena. Deallocation is a no-op, so reserve containers up front:
+    // every reallocation leaves the old buffer behind until the arena is reset.
+    template <typename T>
+    class ArenaAllocator
+    {
+    public:
+        using value_type = T;
+
+        explicit ArenaAllocator(LinearArena& arena) noexcept : m_Arena{&arena}
+        {
+        }
+
+        template <typename U>
+        ArenaAllocator(const ArenaAllocator<U>& other) noexcept : m_Arena{other.GetArena()}
+        {
+        }
+
+        T* allocate(const size_t count) { return static_cast<T*>(m_Arena->Allocate(sizeof(T) * count, alignof(T))); }
+        void deallocate(T*, size_t) noexcept
+        {
+        }
+
+        LinearArena* GetArena() const { return m_Arena; }
+
+        template <typename U>
+        bool operator==(const ArenaAllocator<U>& other) const { return m_Arena == other.GetArena(); }
+
+    private:
+        LinearArena* m_Arena;
+    };
+
+    template <typename T>
+    using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+}
@@ -4,6 +4,9 @@
 // ReSharper disable once CppUnusedIncludeDirective
 #include "spdlog/fmt/ostr.h"
 
+#include "AllocationTracker.h"
+#include "Profiler.h"
+
 namespace VoxelicousEngine
 {
     class Log
@@ -33,3 +36,43 @@ namespace VoxelicousEngine
 #define VE_WARN(...)	      ::VoxelicousEngine::Log::GetClientLogger()->warn(__VA_ARGS__)
 #define VE_ERROR(...)	      ::VoxelicousEngine::Log::GetClientLogger()->error(__VA_ARGS__)
 #define VE_FATAL(...)         ::VoxelicousEngine::Log::GetCoreLogger()->critical(__VA_ARGS__)
+
+// Profiling macros, compiled out of distribution builds
+#ifndef VE_DIST
+	#define VE_PROFILE 1
+#else
+	#define VE_PROFILE 0
+#endif
+
+#if VE_PROFILE
+	#if defined(_MSC_VER)
+		#define VE_FUNC_SIG __FUNCSIG__
+	#else
+		#define VE_FUNC_SIG __PRETTY_FUNCTION__
+	#endif
+
+	#define VE_PROFILE_CONCAT_IMPL(a, b) a##b
+	#define VE_PROFILE_CONCAT(a, b) VE_PROFILE_CONCAT_IMPL(a, b)
+
+	#define VE_PROFILE_BEGIN_SESSION(filePath) ::VoxelicousEngine::Profiler::BeginSession(filePath)
+	#define VE_PROFILE_END_SESSION()           ::VoxelicousEngine::Profiler::EndSession()
+	#define VE_PROFILE_FLUSH()                 ::VoxelicousEngine::Profiler::Flush()
+	#define VE_PROFILE_SCOPE(name)             ::VoxelicousEngine::ProfileScope VE_PROFILE_CONCAT(veProfileScope, __LINE__)(name)
+	#define VE_PROFILE_FUNCTION()              VE_PROFILE_SCOPE(VE_FUNC_SIG)
+#else
+	#define VE_PROFILE_BEGIN_SESSION(filePath)
+	#define VE_PROFILE_END_SESSION()
+	#define VE_PROFILE_FLUSH()
+	#define VE_PROFILE_SCOPE(name)
+	#define VE_PROFILE_FUNCTION()
+#endif
+
+// Allocation tagging, only active in builds with VE_TRACK_ALLOCATIONS
+#ifdef VE_TRACK_ALLOCATIONS
+	#define VE_ALLOCATION_CONCAT_IMPL(a, b) a##b
+	#define VE_ALLOCATION_CONCAT(a, b) VE_ALLOCATION_CONCAT_IMPL(a, b)
+
+	#define VE_ALLOCATION_SCOPE(tag) ::VoxelicousEngine::AllocationScope VE_ALLOCATION_CONCAT(veAllocationScope, __LINE__)(::VoxelicousEngine::AllocationTag::tag)
+#else
+	#define VE_ALLOCATION_SCOPE(tag)
+#endif
@@ -0,0 +1,219 @@
+#include "vepch.h"
+#include "Lz4.h"
+
+#include <cstring>
+
+namespace VoxelicousEngine
+{
+    namespace
+    {
+        constexpr size_t MIN_MATCH = 4;
+        // The format requires the last 5 bytes to be literals and the last match to start 12 bytes before the end
+        constexpr size_t LAST_LITERALS = 5;
+        constexpr size_t MATCH_FIND_LIMIT = 12;
+        constexpr size_t MAX_OFFSET = 65535;
+        constexpr uint32_t HASH_BITS = 14;
+
+        uint32_t Read32(const uint8_t* p)
+        {
+            uint32_t value;
+            std::memcpy(&value, p, sizeof(value));
+            return value;
+        }
+
+        uint32_t HashSequence(const uint32_t sequence)
+        {
+            return (sequence * 2654435761u) >> (32 - HASH_BITS);
+        }
+
+        uint8_t* WriteLength(uint8_t* out, size_t length)
+        {
+            for (; length >= 255; length -= 255)
+            {
+                *out++ = 255;
+            }
+            *out++ = static_cast<uint8_t>(length);
+            return out;
+        }
+
+        uint8_t* WriteSequence(uint8_t* out, const uint8_t* literals, const size_t literalCount, const size_t offset,
+                               const size_t matchLength)
+        {
+            uint8_t* token = out++;
+            *token = static_cast<uint8_t>(std::min<size_t>(literalCount, 15) << 4);
+            if (literalCount >= 15)
+            {
+                out = WriteLength(out, literalCount - 15);
+            }
+            if (literalCount > 0)
+            {
+                std::memcpy(out, literals, literalCount);
+                out += literalCount;
+            }
+            if (matchLength == 0)
+            {
+                return out;
+            }
+
+            *out++ = static_cast<uint8_t>(offset);
+            *out++ = static_cast<uint8_t>(offset >> 8);
+            const size_t length = matchLength - MIN_MATCH;
+            *token |= static_cast<uint8_t>(std::min<size_t>(length, 15));
+            if (length >= 15)
+            {
+                out = WriteLength(out, length - 15);
+            }
+            return out;
+        }
+
+        // Reads an extended length, returns false when it runs past end
+        bool ReadLength(const uint8_t*& in, const uint8_t* end, size_t& length)
+        {
+            uint8_t value;
+            do
+            {
+                if (in == end)
+                {
+                    return false;
+                }
+                value = *in++;
+                length += value;
+            }
+            while (value == 255);
+            return true;
+        }
+    }
+
+    size_t Lz4CompressBound(const size_t size)
+    {
+        return size + size / 255 + 16;
+    }
+
+    size_t Lz4Compress(const std::byte* src, const size_t srcSize, std::byte* dst)
+    {
+        const auto* const begin = reinterpret_cast<const uint8_t*>(src);
+        const uint8_t* const end = begin + srcSize;
+        auto* out = reinterpret_cast<uint8_t*>(dst);
+
+        const uint8_t* anchor = begin;
+        if (srcSize > MATCH_FIND_LIMIT)
+        {
+            // Positions of the last sequence seen per hash, 0 means empty since position 0 is never matched
+            std::vector<uint32_t> table(size_t{1} << HASH_BITS, 0);
+            const uint8_t* const matchLimit = end - MATCH_FIND_LIMIT;
+            const uint8_t* const copyLimit = end - LAST_LITERALS;
+
+            for (const uint8_t* p = begin + 1; p < matchLimit;)
+            {
+                const uint32_t sequence = Read32(p);
+                uint32_t& slot = table[HashSequence(sequence)];
+                const uint8_t* candidate = begin + slot;
+                slot = static_cast<uint32_t>(p - begin);
+                if (candidate == begin || static_cast<size_t>(p - candidate) > MAX_OFFSET || Read32(candidate) != sequence)
+                {
+                    // Step faster through incompressible data, the way the reference encoder accelerates
+                    p += 1 + (static_cast<size_t>(p - anchor) >> 6);
+                    continue;
+                }
+
+                const uint8_t* matchEnd = p + MIN_MATCH;
+                const uint8_t* candidateEnd = candidate + MIN_MATCH;
+                while (matchEnd < copyLimit && *matchEnd == *candidateEnd)
+                {
+                    matchEnd++;
+                    candidateEnd++;
+                }
+                // Extend backwards over literals that also match
+                while (p > anchor && candidate > begin && p[-1] == candidate[-1])
+                {
+                    p--;
+                    candidate--;
+                }
+
+                out = WriteSequence(out, anchor, static_cast<size_t>(p - anchor), static_cast<size_t>(p - candidate),
+                                    static_cast<size_t>(matchEnd - p));
+                anchor = p = matchEnd;
+                if (p < matchLimit)
+                {
+                    table[HashSequence(Read32(p - 2))] = static_cast<uint32_t>(p - 2 - begin);
+                }
+            }
+        }
+
+        out = WriteSequence(out, anchor, static_cast<size_t>(end - anchor), 0, 0);
+        return static_cast<size_t>(out - reinterpret_cast<uint8_t*>(dst));
+    }
+
+    bool Lz4Decompress(const std::byte* src, const size_t srcSize, std::byte* dst, const size_t dstSize)
+    {
+        const auto* in = reinterpret_cast<const uint8_t*>(src);
+        const uint8_t* const inEnd = in + srcSize;
+        auto* const outBegin = reinterpret_cast<uint8_t*>(dst);
+        uint8_t* out = outBegin;
+        uint8_t* const outEnd = outBegin + dstSize;
+
+        while (in < inEnd)
+        {
+            const uint8_t token = *in++;
+            size_t literalCount = token >> 4;
+            if (literalCount == 15 && !ReadLength(in, inEnd, literalCount))
+            {
+                return false;
+            }
+            if (literalCount > static_cast<size_t>(inEnd - in) || literalCount > static_cast<size_t>(outEnd - out))
+            {
+                return false;
+            }
+            if (literalCount > 0)
+            {
+                std::memcpy(out, in, literalCount);
+                in += literalCount;
+                out += literalCount;
+            }
+
+            // The last sequence has no match
+            if (in == inEnd)
+            {
+                break;
+            }
+
+            if (inEnd - in < 2)
+            {
+                return false;
+            }
+            const size_t offset = in[0] | static_cast<size_t>(in[1]) << 8;
+            in += 2;
+            size_t matchLength = token & 15;
+            if (matchLength == 15 && !ReadLength(in, inEnd, matchLength))
+            {
+                return false;
+            }
+            matchLength += MIN_MATCH;
+            if (offset == 0 || offset > static_cast<size_t>(out - outBegin) ||
+                matchLength > static_cast<size_t>(outEnd - out))
+            {
+                return false;
+            }
+
+            const uint8_t* match = out - offset;
+            if (offset >= matchLength)
+            {
+                std::memcpy(out, match, matchLength);
+                out += matchLength;
+            }
+            else
+            {
+                // Overlapping matches repeat the last offset bytes. Everything from match to out is periodic, so
+                // copying all of it at once keeps the period and doubles the copy size every step.
+                for (size_t remaining = matchLength; remaining > 0;)
+                {
+                    const size_t chunk = std::min(static_cast<size_t>(out - match), remaining);
+                    std::memcpy(out, match, chunk);
+                    out += chunk;
+                    remaining -= chunk;
+                }
+            }
+        }
+        return out == outEnd;
+    }
+}
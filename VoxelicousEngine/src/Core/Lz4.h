@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstddef>
+
+namespace VoxelicousEngine
+{
+    // Block compression in the LZ4 block format: byte-aligned literal runs and matches with no entropy coding,
+    // so decompression runs at memory-copy speeds. Used for asset caches where load time matters more than
+    // size; the output is readable by any LZ4 block decoder.
+
+    // Worst-case compressed size of size input bytes
+    size_t Lz4CompressBound(size_t size);
+
+    // Compresses src into dst, which must hold Lz4CompressBound(srcSize) bytes. Returns the compressed size.
+    size_t Lz4Compress(const std::byte* src, size_t srcSize, std::byte* dst);
+
+    // Decompresses exactly dstSize bytes. Returns false for malformed or truncated input, never reading or
+    // writing out of bounds.
+    bool Lz4Decompress(const std::byte* src, size_t srcSize, std::byte* dst, size_t dstSize);
+}
@@ -0,0 +1,140 @@
+#include "vepch.h"
+#include "MappedFile.h"
+
+#ifndef VE_PLATFORM_WINDOWS
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace VoxelicousEngine
+{
+    MappedFile::~MappedFile()
+    {
+        Close();
+    }
+
+    MappedFile::MappedFile(MappedFile&& other) noexcept
+    {
+        *this = std::move(other);
+    }
+
+    MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+    {
+        if (this != &other)
+        {
+            Close();
+            m_Data = std::exchange(other.m_Data, nullptr);
+            m_Size = std::exchange(other.m_Size, 0);
+            m_Open = std::exchange(other.m_Open, false);
+#ifdef VE_PLATFORM_WINDOWS
+            m_File = std::exchange(other.m_File, nullptr);
+            m_Mapping = std::exchange(other.m_Mapping, nullptr);
+#endif
+        }
+        return *this;
+    }
+
+#ifdef VE_PLATFORM_WINDOWS
+    bool MappedFile::Open(const std::string& filePath)
+    {
+        Close();
+
+        const HANDLE file = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            VE_CORE_ERROR("Failed to open {0}", filePath);
+            return false;
+        }
+
+        LARGE_INTEGER size{};
+        GetFileSizeEx(file, &size);
+        m_File = file;
+        m_Size = static_cast<size_t>(size.QuadPart);
+        m_Open = true;
+        if (m_Size == 0)
+        {
+            return true;
+        }
+
+        m_Mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        m_Data = m_Mapping ? static_cast<const std::byte*>(MapViewOfFile(m_Mapping, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+        if (!m_Data)
+        {
+            VE_CORE_ERROR("Failed to map {0}", filePath);
+            Close();
+            return false;
+        }
+        return true;
+    }
+
+    void MappedFile::Close()
+    {
+        if (m_Data)
+        {
+            UnmapViewOfFile(m_Data);
+        }
+        if (m_Mapping)
+        {
+            CloseHandle(m_Mapping);
+        }
+        if (m_File)
+        {
+            CloseHandle(m_File);
+        }
+        m_Data = nullptr;
+        m_Mapping = nullptr;
+        m_File = nullptr;
+        m_Size = 0;
+        m_Open = false;
+    }
+#else
+    bool MappedFile::Open(const std::string& filePath)
+    {
+        Close();
+
+        const int file = open(filePath.c_str(), O_RDONLY);
+        if (file < 0)
+        {
+            VE_CORE_ERROR("Failed to open {0}", filePath);
+            return false;
+        }
+
+        struct stat status{};
+        fstat(file, &status);
+        m_Size = static_cast<size_t>(status.st_size);
+        m_Open = true;
+        if (m_Size > 0)
+        {
+            void* data = mmap(nullptr, m_Size, PROT_READ, MAP_PRIVATE, file, 0);
+            if (data == MAP_FAILED)
+            {
+                VE_CORE_ERROR("Failed to map {0}", filePath);
+                close(file);
+                m_Size = 0;
+                m_Open = false;
+                return false;
+            }
+            // Loaders read front to back, so ask for aggressive read-ahead
+            madvise(data, m_Size, MADV_SEQUENTIAL);
+            m_Data = static_cast<const std::byte*>(data);
+        }
+        // The mapping keeps the file referenced
+        close(file);
+        return true;
+    }
+
+    void MappedFile::Close()
+    {
+        if (m_Data)
+        {
+            munmap(const_cast<std::byte*>(m_Data), m_Size);
+        }
+        m_Data = nullptr;
+        m_Size = 0;
+        m_Open = false;
+    }
+#endif
+}
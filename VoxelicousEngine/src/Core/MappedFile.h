@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <string>
+
+namespace VoxelicousEngine
+{
+    // Read-only memory mapping of a whole file. Pages are faulted in by the OS on first access, so opening is
+    // cheap and large assets are parsed or copied straight from the page cache without an intermediate read.
+    class MappedFile
+    {
+    public:
+        MappedFile() = default;
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+
+        // Logs and returns false when the file can't be opened or mapped. Empty files map successfully.
+        bool Open(const std::string& filePath);
+        void Close();
+
+        bool IsOpen() const { return m_Open; }
+        const std::byte* GetData() const { return m_Data; }
+        size_t GetSize() const { return m_Size; }
+        std::span<const std::byte> GetBytes() const { return {m_Data, m_Size}; }
+
+    private:
+        const std::byte* m_Data = nullptr;
+        size_t m_Size = 0;
+        bool m_Open = false;
+#ifdef VE_PLATFORM_WINDOWS
+        void* m_File = nullptr;
+        void* m_Mapping = nullptr;
+#endif
+    };
+}
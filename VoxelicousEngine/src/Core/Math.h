@@ -0,0 +1,8 @@
+#pragma once
+
+// Single place for the GLM configuration; include this instead of GLM directly so every
+// translation unit agrees on radians and a [0, 1] clip-space depth range.
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
@@ -0,0 +1,15 @@
+#include "vepch.h"
+#include "Mesh.h"
+
+#include "Assets/ObjLoader.h"
+
+namespace VoxelicousEngine
+{
+    void MeshData::LoadModel(const std::string& filePath)
+    {
+        if (!ObjLoader::Load(filePath, *this))
+        {
+            throw std::runtime_error("failed to load model " + filePath + "!");
+        }
+    }
+}
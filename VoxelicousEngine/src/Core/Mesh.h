@@ -0,0 +1,74 @@
+#pragma once
+
+#include "Math.h"
+
+#include <span>
+#include <string>
+#include <vector>
+
+namespace VoxelicousEngine
+{
+    struct Vertex
+    {
+        glm::vec3 Position{};
+        glm::vec3 Color{};
+        glm::vec3 Normal{};
+        glm::vec2 Uv{};
+
+        bool operator==(const Vertex& other) const
+        {
+            return Position == other.Position && Color == other.Color && Normal == other.Normal && Uv == other.Uv;
+        }
+    };
+
+    struct AABB
+    {
+        glm::vec3 Min{0.0f};
+        glm::vec3 Max{0.0f};
+
+        glm::vec3 GetCenter() const { return (Min + Max) * 0.5f; }
+        glm::vec3 GetExtent() const { return (Max - Min) * 0.5f; }
+    };
+
+    // Non-owning mesh, e.g. a memory-mapped mesh pack, which the renderer's Model uploads without a copy
+    struct MeshView
+    {
+        std::span<const Vertex> Vertices{};
+        std::span<const uint32_t> Indices{};
+        AABB Bounds{};
+    };
+
+    // CPU-side mesh, produced by the voxel mesher and loaders and uploaded by the renderer's Model
+    struct MeshData
+    {
+        std::vector<Vertex> Vertices{};
+        std::vector<uint32_t> Indices{};
+
+        void Clear()
+        {
+            Vertices.clear();
+            Indices.clear();
+        }
+
+        // Replaces the contents with a Wavefront OBJ file (see ObjLoader), throws when it can't be loaded
+        void LoadModel(const std::string& filePath);
+
+        AABB ComputeBounds() const
+        {
+            if (Vertices.empty())
+            {
+                return {};
+            }
+
+            AABB bounds{Vertices[0].Position, Vertices[0].Position};
+            for (const Vertex& vertex : Vertices)
+            {
+                bounds.Min = glm::min(bounds.Min, vertex.Position);
+                bounds.Max = glm::max(bounds.Max, vertex.Position);
+            }
+            return bounds;
+        }
+
+        MeshView GetView() const { return {Vertices, Indices, ComputeBounds()}; }
+    };
+}
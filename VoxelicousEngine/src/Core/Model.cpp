@@ -1,9 +1,8 @@
 #include "vepch.h"
-#include "Model.h"//#include <Utils.h>
+#include "Model.h"
 
-//#define TINYOBJLOADER_IMPLEMENTATION
-//#include <tinyobjloader/tiny_obj_loader.h>
-#define GLM_ENABLE_EXPERIMENTAL
+#include "Assets/MeshOptimizer.h"
+#include "Assets/MeshPack.h"
 
 #ifndef ENGINE_DIR
 #define ENGINE_DIR "../"
@@ -11,33 +10,37 @@
 
 namespace VoxelicousEngine
 {
-    /*template <>
-    struct std::hash<Model::Vertex>
+    Model::Model(Device& device, const Builder& builder) : Model(device, builder.GetView())
     {
-        size_t operator()(Model::Vertex const& vertex) const
-        {
-            size_t seed = 0;
-            hashCombine(seed, vertex.position, vertex.color, vertex.normal, vertex.uv);
-            return seed;
-        }
-    };*/
+    }
 
-    Model::Model(Device& device, const Builder& builder) : m_Device{device}
+    Model::Model(Device& device, const MeshView& mesh) : m_Device{device}, m_Bounds{mesh.Bounds}
     {
-        CreateVertexBuffers(builder.Vertices);
-        CreateIndexBuffers(builder.Indices);
+        CreateVertexBuffers(mesh.Vertices);
+        CreateIndexBuffers(mesh.Indices);
     }
 
     Model::~Model() = default;
 
-    /*std::unique_ptr<Model> Model::CreateModelFromFile(Device& device, const std::string& filepath)
+    std::unique_ptr<Model> Model::CreateModelFromFile(Device& device, const std::string& filePath)
     {
         Builder builder{};
-        builder.LoadModel(ENGINE_DIR + filepath);
+        builder.LoadModel(ENGINE_DIR + filePath);
+        MeshOptimizer::Optimize(builder);
         return std::make_unique<Model>(device, builder);
-    }*/
+    }
+
+    std::unique_ptr<Model> Model::CreateModelFromPack(Device& device, const std::string& filePath)
+    {
+        MeshPack pack;
+        if (!pack.Open(ENGINE_DIR + filePath))
+        {
+            throw std::runtime_error("failed to load mesh pack " + filePath + "!");
+        }
+        return std::make_unique<Model>(device, pack.GetView());
+    }
 
-    void Model::CreateVertexBuffers(const std::vector<Vertex>& vertices)
+    void Model::CreateVertexBuffers(const std::span<const Vertex> vertices)
     {
         m_VertexCount = static_cast<uint32_t>(vertices.size());
         assert(m_VertexCount >= 3 && "Vertex count must be at least 3");
@@ -67,7 +70,7 @@ namespace VoxelicousEngine
         m_Device.CopyBuffer(stagingBuffer.GetBuffer(), m_VertexBuffer->GetBuffer(), bufferSize);
     }
 
-    void Model::CreateIndexBuffers(const std::vector<uint32_t>& indices)
+    void Model::CreateIndexBuffers(const std::span<const uint32_t> indices)
     {
         m_IndexCount = static_cast<uint32_t>(indices.size());
         m_HasIndexBuffer = m_IndexCount > 0;
@@ -77,8 +80,12 @@ namespace VoxelicousEngine
             return;
         }
 
-        const VkDeviceSize bufferSize = sizeof(indices[0]) * m_IndexCount;
-        uint32_t indexSize = sizeof(indices[0]);
+        // Meshes with fewer than 65536 vertices get 16-bit indices, which halves index memory and fetch bandwidth.
+        // The narrowing happens while writing the staging buffer, so it costs no extra copy.
+        const bool narrow = m_VertexCount <= UINT16_MAX;
+        m_IndexType = narrow ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+        const uint32_t indexSize = narrow ? sizeof(uint16_t) : sizeof(uint32_t);
+        const VkDeviceSize bufferSize = static_cast<VkDeviceSize>(indexSize) * m_IndexCount;
 
         Buffer stagingBuffer
         {
@@ -90,7 +97,15 @@ namespace VoxelicousEngine
         };
 
         stagingBuffer.Map();
-        stagingBuffer.WriteToBuffer((void*)indices.data());
+        if (narrow)
+        {
+            auto* mapped = static_cast<uint16_t*>(stagingBuffer.GetMappedMemory());
+            std::ranges::transform(indices, mapped, [](const uint32_t index) { return static_cast<uint16_t>(index); });
+        }
+        else
+        {
+            stagingBuffer.WriteToBuffer(indices.data());
+        }
 
         m_IndexBuffer = std::make_unique<Buffer>(
             m_Device,
@@ -111,23 +126,29 @@ namespace VoxelicousEngine
 
         if (m_HasIndexBuffer)
         {
-            vkCmdBindIndexBuffer(commandBuffer, m_IndexBuffer->GetBuffer(), 0, VK_INDEX_TYPE_UINT32);
+            vkCmdBindIndexBuffer(commandBuffer, m_IndexBuffer->GetBuffer(), 0, m_IndexType);
         }
     }
 
-    void Model::Draw(const VkCommandBuffer commandBuffer) const
+    void Model::Draw(const VkCommandBuffer commandBuffer, const uint32_t firstInstance,
+                     const uint32_t instanceCount) const
     {
         if (m_HasIndexBuffer)
         {
-            vkCmdDrawIndexed(commandBuffer, m_IndexCount, 1, 0, 0, 0);
+            vkCmdDrawIndexed(commandBuffer, m_IndexCount, instanceCount, 0, 0, firstInstance);
         }
         else
         {
-            vkCmdDraw(commandBuffer, m_VertexCount, 1, 0, 0);
+            vkCmdDraw(commandBuffer, m_VertexCount, instanceCount, 0, firstInstance);
         }
     }
 
-    std::vector<VkVertexInputBindingDescription> Model::Vertex::GetBindingDescriptions()
+    VkDeviceSize Model::GetMemorySize() const
+    {
+        return m_VertexBuffer->GetBufferSize() + (m_HasIndexBuffer ? m_IndexBuffer->GetBufferSize() : 0);
+    }
+
+    std::vector<VkVertexInputBindingDescription> Model::GetBindingDescriptions()
     {
         std::vector<VkVertexInputBindingDescription> bindingDescriptions(1);
         bindingDescriptions[0].binding = 0;
@@ -136,7 +157,7 @@ namespace VoxelicousEngine
         return bindingDescriptions;
     }
 
-    std::vector<VkVertexInputAttributeDescription> Model::Vertex::GetAttributeDescriptions()
+    std::vector<VkVertexInputAttributeDescription> Model::GetAttributeDescriptions()
     {
         std::vector<VkVertexInputAttributeDescription> attributeDescriptions{};
 
@@ -147,73 +168,4 @@ namespace VoxelicousEngine
 
         return attributeDescriptions;
     }
-
-    /*void Model::Builder::loadModel(const std::string& filepath)
-    {
-        tinyobj::attrib_t attrib;
-        std::vector<tinyobj::shape_t> shapes;
-        std::vector<tinyobj::material_t> materials;
-        std::string warn, err;
-
-        if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, filepath.c_str()))
-        {
-            throw std::runtime_error(warn + err);
-        }
-
-        vertices.clear();
-        indices.clear();
-
-        std::unordered_map<Vertex, uint32_t> uniqueVertices;
-        for (const auto& shape : shapes)
-        {
-            for (const auto& index : shape.mesh.indices)
-            {
-                Vertex vertex{};
-
-                if (index.vertex_index >= 0)
-                {
-                    vertex.position =
-                    {
-                        attrib.vertices[3 * index.vertex_index + 0],
-                        attrib.vertices[3 * index.vertex_index + 1],
-                        attrib.vertices[3 * index.vertex_index + 2],
-                    };
-
-                    vertex.color =
-                    {
-                        attrib.colors[3 * index.vertex_index + 0],
-                        attrib.colors[3 * index.vertex_index + 1],
-                        attrib.colors[3 * index.vertex_index + 2],
-                    };
-                }
-
-                if (index.normal_index >= 0)
-                {
-                    vertex.normal =
-                    {
-                        attrib.normals[3 * index.normal_index + 0],
-                        attrib.normals[3 * index.normal_index + 1],
-                        attrib.normals[3 * index.normal_index + 2],
-                    };
-                }
-
-                if (index.texcoord_index >= 0)
-                {
-                    vertex.uv =
-                    {
-                        attrib.texcoords[2 * index.texcoord_index + 0],
-                        attrib.texcoords[2 * index.texcoord_index + 1],
-                    };
-                }
-
-                if (uniqueVertices.count(vertex) == 0)
-                {
-                    uniqueVertices[vertex] = static_cast<uint32_t>(vertices.size());
-                    vertices.push_back(vertex);
-                }
-                indices.push_back(uniqueVertices[vertex]);
-            }
-        }
-
-    }*/
 }
@@ -1,55 +1,46 @@
 #pragma once
 
+#include "Mesh.h"
 #include "Renderer/Device.h"
 #include "Renderer/Buffer.h"
 
-#define GLM_FORCE_RADIANS
-#define GLM_FORCE_DEPTH_ZERO_TO_ONE
-#include <glm/glm.hpp>
-
 namespace VoxelicousEngine
 {
     class Model
     {
     public:
-        struct Vertex
-        {
-            glm::vec3 Position{};
-            glm::vec3 Color{};
-            glm::vec3 Normal{};
-            glm::vec2 Uv{};
-
-            static std::vector<VkVertexInputBindingDescription> GetBindingDescriptions();
-            static std::vector<VkVertexInputAttributeDescription> GetAttributeDescriptions();
-
-            bool operator==(const Vertex& other) const
-            {
-                return Position == other.Position && Color == other.Color && Normal == other.Normal && Uv == other.Uv;
-            }
-        };
-
-        struct Builder
-        {
-            std::vector<Vertex> Vertices{};
-            std::vector<uint32_t> Indices{};
-
-            //void LoadModel(const std::string& filepath);
-        };
+        using Vertex = VoxelicousEngine::Vertex;
+        using Builder = MeshData;
 
         Model(Device& device, const Builder& builder);
+        // Uploads straight from the view, e.g. a mapped MeshPack, without an intermediate copy
+        Model(Device& device, const MeshView& mesh);
         ~Model();
 
         Model(const Model&) = delete;
         Model& operator=(const Model&) = delete;
+        // Movable so models can live in a ResourcePool
+        Model(Model&&) noexcept = default;
+
+        // filePath is relative to ENGINE_DIR, the mesh is run through MeshOptimizer before upload
+        static std::unique_ptr<Model> CreateModelFromFile(Device& device, const std::string& filePath);
+        // Loads a mesh pack written by MeshPack::Write, throws when it can't be opened
+        static std::unique_ptr<Model> CreateModelFromPack(Device& device, const std::string& filePath);
 
-        //static std::unique_ptr<Model> CreateModelFromFile(Device& device, const std::string& filepath);
+        static std::vector<VkVertexInputBindingDescription> GetBindingDescriptions();
+        static std::vector<VkVertexInputAttributeDescription> GetAttributeDescriptions();
 
         void Bind(VkCommandBuffer commandBuffer) const;
-        void Draw(VkCommandBuffer commandBuffer) const;
+        // Instances index the GPU object table through gl_InstanceIndex, which starts at firstInstance
+        void Draw(VkCommandBuffer commandBuffer, uint32_t firstInstance = 0, uint32_t instanceCount = 1) const;
+
+        const AABB& GetBounds() const { return m_Bounds; }
+        // Bytes of device memory held by the vertex and index buffers
+        VkDeviceSize GetMemorySize() const;
 
     private:
-        void CreateVertexBuffers(const std::vector<Vertex>& vertices);
-        void CreateIndexBuffers(const std::vector<uint32_t>& indices);
+        void CreateVertexBuffers(std::span<const Vertex> vertices);
+        void CreateIndexBuffers(std::span<const uint32_t> indices);
 
         Device& m_Device;
 
@@ -59,5 +50,8 @@ namespace VoxelicousEngine
         bool m_HasIndexBuffer = false;
         std::unique_ptr<Buffer> m_IndexBuffer;
         uint32_t m_IndexCount;
+        VkIndexType m_IndexType = VK_INDEX_TYPE_UINT32;
+
+        AABB m_Bounds;
     };
 }
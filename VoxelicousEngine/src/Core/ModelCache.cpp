@@ -0,0 +1,95 @@
+#include "vepch.h"
+#include "ModelCache.h"
+
+#include "Core.h"
+#include "Hash.h"
+
+namespace VoxelicousEngine
+{
+    ModelCache::ModelCache(Device& device) : m_Device{device}
+    {
+    }
+
+    uint64_t ModelCache::ComputeKey(const MeshView& mesh)
+    {
+        return HashBytes(mesh.Indices, HashBytes(mesh.Vertices));
+    }
+
+    uint64_t ModelCache::ComputeCheck(const MeshView& mesh)
+    {
+        return HashBytes(mesh.Indices, HashBytes(mesh.Vertices, CHECK_SEED));
+    }
+
+    MeshHandle ModelCache::Acquire(const MeshView& mesh)
+    {
+        VE_PROFILE_FUNCTION();
+
+        const uint64_t key = ComputeKey(mesh);
+        const auto vertexCount = static_cast<uint32_t>(mesh.Vertices.size());
+        const auto indexCount = static_cast<uint32_t>(mesh.Indices.size());
+        const uint64_t check = ComputeCheck(mesh);
+
+        const auto it = m_ByKey.find(key);
+        if (it != m_ByKey.end())
+        {
+            SlotInfo& info = m_SlotInfos[it->second.Index];
+            if (info.Check == check && info.VertexCount == vertexCount && info.IndexCount == indexCount)
+            {
+                m_HitCount++;
+                info.References++;
+                return it->second;
+            }
+            VE_CORE_WARN("Model cache key collision ({0:016x}), uploading an uncached model", key);
+        }
+
+        m_MissCount++;
+        const MeshHandle handle = m_Models.Create(m_Device, mesh);
+        if (handle.Index >= m_SlotInfos.size())
+        {
+            m_SlotInfos.resize(handle.Index + 1);
+        }
+        m_SlotInfos[handle.Index] = {key, check, 1, vertexCount, indexCount};
+        m_ByKey.try_emplace(key, handle);
+        return handle;
+    }
+
+    void ModelCache::AddReference(const MeshHandle mesh)
+    {
+        VE_CORE_ASSERT(m_Models.IsValid(mesh), "Referencing a released model!");
+        m_SlotInfos[mesh.Index].References++;
+    }
+
+    void ModelCache::Release(const MeshHandle mesh)
+    {
+        if (!m_Models.IsValid(mesh))
+        {
+            VE_CORE_WARN("Releasing a model that was already destroyed");
+            return;
+        }
+
+        SlotInfo& info = m_SlotInfos[mesh.Index];
+        if (--info.References > 0)
+        {
+            return;
+        }
+
+        // Collided models were never added to the key map, the entry belongs to another model then
+        if (const auto it = m_ByKey.find(info.Key); it != m_ByKey.end() && it->second == mesh)
+        {
+            m_ByKey.erase(it);
+        }
+        // Frames in flight may still draw it, the pool keeps only the empty moved-from model
+        m_Device.GetDeletionQueue().Destroy(std::move(*m_Models.Get(mesh)));
+        m_Models.Destroy(mesh);
+    }
+
+    VkDeviceSize ModelCache::GetMemorySize() const
+    {
+        VkDeviceSize size = 0;
+        for (const Model& model : m_Models.GetItems())
+        {
+            size += model.GetMemorySize();
+        }
+        return size;
+    }
+}
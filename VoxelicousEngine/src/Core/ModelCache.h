@@ -0,0 +1,68 @@
+#pragma once
+
+#include "Model.h"
+#include "ResourcePool.h"
+
+namespace VoxelicousEngine
+{
+    // Owns every Model of the app in a ResourcePool and deduplicates them by the content of their mesh, so all
+    // game objects built from the same vertices and indices (repeated prefabs, the same file loaded twice) share
+    // one vertex and one index buffer.
+    //
+    // Models are keyed by a hash of the vertex and index bytes. Acquire returns the handle of the live Model with
+    // the same content and counts one more reference to it; Release drops a reference and, when the last one goes
+    // away, hands the Model to the device's DeletionQueue, which frees its GPU buffers once no frame in flight can
+    // draw it anymore. Handles to a released Model resolve to nullptr right away.
+    // Only used from the main thread, like Model creation itself.
+    class ModelCache
+    {
+    public:
+        explicit ModelCache(Device& device);
+
+        ModelCache(const ModelCache&) = delete;
+        ModelCache& operator=(const ModelCache&) = delete;
+
+        static uint64_t ComputeKey(const MeshView& mesh);
+
+        // Uploads a new Model on a miss
+        MeshHandle Acquire(const MeshView& mesh);
+        MeshHandle Acquire(const Model::Builder& builder) { return Acquire(builder.GetView()); }
+        // Counts another user of a handle that was already acquired
+        void AddReference(MeshHandle mesh);
+        void Release(MeshHandle mesh);
+
+        // nullptr for null and released handles, valid until the next Acquire or Release
+        const Model* Get(const MeshHandle mesh) const { return m_Models.Get(mesh); }
+        const ResourcePool<Model>& GetModels() const { return m_Models; }
+
+        // GPU memory held by the live models
+        VkDeviceSize GetMemorySize() const;
+
+        uint32_t GetHitCount() const { return m_HitCount; }
+        uint32_t GetMissCount() const { return m_MissCount; }
+
+    private:
+        struct SlotInfo
+        {
+            uint64_t Key;
+            // Checked on a hit along with the counts, so two different meshes only alias if both 64-bit hashes
+            // collide at once; a mismatch uploads the mesh as an uncached model instead
+            uint64_t Check;
+            uint32_t References;
+            uint32_t VertexCount;
+            uint32_t IndexCount;
+        };
+
+        // Seeds the second, independent hash of the content
+        static constexpr uint64_t CHECK_SEED = 0x2545f4914f6cdd1dull;
+        static uint64_t ComputeCheck(const MeshView& mesh);
+
+        Device& m_Device;
+        ResourcePool<Model> m_Models;
+        // Indexed like the pool's slots, i.e. by MeshHandle::Index
+        std::vector<SlotInfo> m_SlotInfos;
+        std::unordered_map<uint64_t, MeshHandle> m_ByKey;
+        uint32_t m_HitCount = 0;
+        uint32_t m_MissCount = 0;
+    };
+}
@@ -0,0 +1,139 @@
+#include "vepch.h"
+#include "Profiler.h"
+
+#include <fstream>
+#include <mutex>
+#include <unordered_set>
+
+namespace VoxelicousEngine
+{
+    namespace
+    {
+        struct ProfilerSession
+        {
+            std::mutex Mutex;
+            std::ofstream File;
+            int64_t StartNs = 0;
+            bool FirstEvent = true;
+            // Buffers outlive their threads so late events can still be flushed
+            std::vector<std::unique_ptr<ProfileThreadBuffer>> ThreadBuffers;
+            // Node-based, so the interned strings never move
+            std::unordered_set<std::string> InternedNames;
+        };
+
+        ProfilerSession& GetSession()
+        {
+            static ProfilerSession session;
+            return session;
+        }
+
+        void WriteEvents(ProfilerSession& session)
+        {
+            for (const auto& buffer : session.ThreadBuffers)
+            {
+                const uint32_t threadId = buffer->GetThreadId();
+                buffer->Drain([&](const ProfileEvent& event)
+                {
+                    if (!session.File.is_open() || event.BeginNs < session.StartNs)
+                        return;
+
+                    session.File << (session.FirstEvent ? "\n" : ",\n");
+                    session.FirstEvent = false;
+
+                    session.File << R"({"cat":"function","ph":"X","pid":0,"tid":)" << threadId
+                        << R"(,"ts":)" << static_cast<double>(event.BeginNs - session.StartNs) / 1000.0
+                        << R"(,"dur":)" << static_cast<double>(event.EndNs - event.BeginNs) / 1000.0
+                        << R"(,"name":")";
+                    for (const char* c = event.Name; *c; c++)
+                    {
+                        session.File << (*c == '"' || *c == '\\' ? '\'' : *c);
+                    }
+                    session.File << "\"}";
+                });
+
+                if (const uint64_t dropped = buffer->TakeDroppedCount())
+                {
+                    VE_CORE_WARN("Profiler dropped {} events on thread {}, flush more often", dropped, threadId);
+                }
+            }
+        }
+    }
+
+    std::atomic<bool> Profiler::s_Active{false};
+
+    void Profiler::BeginSession(const std::string& filePath)
+    {
+        ProfilerSession& session = GetSession();
+        std::lock_guard lock(session.Mutex);
+
+        if (session.File.is_open())
+        {
+            VE_CORE_ERROR("Profiler session already active, ignoring {0}", filePath);
+            return;
+        }
+
+        session.File.open(filePath);
+        if (!session.File.is_open())
+        {
+            VE_CORE_ERROR("Failed to open profiler trace file {0}", filePath);
+            return;
+        }
+
+        session.File << std::fixed;
+        session.File.precision(3);
+        session.File << R"({"otherData":{},"displayTimeUnit":"ns","traceEvents":[)";
+        session.FirstEvent = true;
+        session.StartNs = Now();
+        s_Active.store(true, std::memory_order_relaxed);
+
+        VE_CORE_INFO("Started profiler session {0}", filePath);
+    }
+
+    void Profiler::EndSession()
+    {
+        ProfilerSession& session = GetSession();
+        std::lock_guard lock(session.Mutex);
+
+        if (!session.File.is_open())
+            return;
+
+        s_Active.store(false, std::memory_order_relaxed);
+        WriteEvents(session);
+        session.File << "\n]}\n";
+        session.File.close();
+    }
+
+    void Profiler::Flush()
+    {
+        if (!IsActive())
+            return;
+
+        ProfilerSession& session = GetSession();
+        std::lock_guard lock(session.Mutex);
+        WriteEvents(session);
+        session.File.flush();
+    }
+
+    const char* Profiler::Intern(const std::string_view name)
+    {
+        ProfilerSession& session = GetSession();
+        std::lock_guard lock(session.Mutex);
+        return session.InternedNames.emplace(name).first->c_str();
+    }
+
+    ProfileThreadBuffer& Profiler::GetThreadBuffer()
+    {
+        thread_local ProfileThreadBuffer* buffer = &RegisterThread();
+        return *buffer;
+    }
+
+    ProfileThreadBuffer& Profiler::RegisterThread()
+    {
+        ProfilerSession& session = GetSession();
+        std::lock_guard lock(session.Mutex);
+
+        const auto threadId = static_cast<uint32_t>(session.ThreadBuffers.size());
+        session.ThreadBuffers.push_back(std::make_unique<ProfileThreadBuffer>(threadId));
+        return *session.ThreadBuffers.back();
+    }
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace VoxelicousEngine
+{
+    struct ProfileEvent
+    {
+        const char* Name;
+        int64_t BeginNs;
+        int64_t EndNs;
+    };
+
+    // Fixed-size ring written only by its owning thread and drained only by Profiler::Flush, so neither
+    // side needs a lock. Events are dropped (and counted) when the ring is full.
+    class ProfileThreadBuffer
+    {
+    public:
+        static constexpr uint64_t CAPACITY = 1 << 14;
+
+        explicit ProfileThreadBuffer(const uint32_t threadId) : m_ThreadId{threadId}
+        {
+        }
+
+        void Push(const ProfileEvent& event)
+        {
+            const uint64_t head = m_Head.load(std::memory_order_relaxed);
+            if (head - m_Tail.load(std::memory_order_acquire) == CAPACITY)
+            {
+                m_Dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            m_Events[head & (CAPACITY - 1)] = event;
+            m_Head.store(head + 1, std::memory_order_release);
+        }
+
+        template <typename Fn>
+        void Drain(Fn&& fn)
+        {
+            const uint64_t head = m_Head.load(std::memory_order_acquire);
+            uint64_t tail = m_Tail.load(std::memory_order_relaxed);
+            for (; tail != head; tail++)
+            {
+                fn(m_Events[tail & (CAPACITY - 1)]);
+            }
+            m_Tail.store(tail, std::memory_order_release);
+        }
+
+        uint32_t GetThreadId() const { return m_ThreadId; }
+        uint64_t TakeDroppedCount() { return m_Dropped.exchange(0, std::memory_order_relaxed); }
+
+    private:
+        std::array<ProfileEvent, CAPACITY> m_Events;
+        alignas(64) std::atomic<uint64_t> m_Head{0};
+        alignas(64) std::atomic<uint64_t> m_Tail{0};
+        std::atomic<uint64_t> m_Dropped{0};
+        uint32_t m_ThreadId;
+    };
+
+    // Collects scopes from all threads and streams them into a Chrome trace JSON file
+    // (chrome://tracing, ui.perfetto.dev).
+    class Profiler
+    {
+    public:
+        static void BeginSession(const std::string& filePath);
+        static void EndSession();
+        // Writes every buffered event to the session file. Takes a lock and does file IO, so call it between
+        // frames, not inside a measured scope.
+        static void Flush();
+
+        // Scope names are stored as pointers until the next flush. Names built at runtime (e.g. a layer's name)
+        // go through Intern, which returns a copy that lives as long as the process.
+        static const char* Intern(std::string_view name);
+
+        static bool IsActive() { return s_Active.load(std::memory_order_relaxed); }
+
+        static int64_t Now()
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        static void Record(const ProfileEvent& event) { GetThreadBuffer().Push(event); }
+
+    private:
+        static ProfileThreadBuffer& GetThreadBuffer();
+        static ProfileThreadBuffer& RegisterThread();
+
+        static std::atomic<bool> s_Active;
+    };
+
+    class ProfileScope
+    {
+    public:
+        explicit ProfileScope(const char* name)
+            : m_Name{Profiler::IsActive() ? name : nullptr}, m_Begin{m_Name ? Profiler::Now() : 0}
+        {
+        }
+
+        ~ProfileScope()
+        {
+            if (m_Name)
+            {
+                Profiler::Record({m_Name, m_Begin, Profiler::Now()});
+            }
+        }
+
+        ProfileScope(const ProfileScope&) = delete;
+        ProfileScope& operator=(const ProfileScope&) = delete;
+
+    private:
+        const char* m_Name;
+        int64_t m_Begin;
+    };
+}
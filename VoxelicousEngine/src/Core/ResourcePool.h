@@ -0,0 +1,138 @@
+#pragma once
+
+#include "Handle.h"
+
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace VoxelicousEngine
+{
+    // Owns objects of one type in a dense array and hands out generational handles to them:
+    //
+    //   Items          the objects, contiguous, so loops over every resource walk memory linearly
+    //   Slots          per handle index: where the object sits in Items and the slot's current generation
+    //   DenseToSlot    per item: the slot that refers to it, to patch the slot when an item is moved
+    //
+    // Destroying an object moves the last item into its place, so item addresses and dense indices change on
+    // every Create and Destroy; only handles stay stable. Stale handles resolve to nullptr instead of to whatever
+    // reuses their slot. Not thread-safe.
+    template <typename T>
+    class ResourcePool
+    {
+    public:
+        static_assert(std::is_nothrow_move_constructible_v<T>, "Pooled resources must be nothrow movable");
+        static_assert(std::is_trivially_copyable_v<Handle<T>>);
+
+        ResourcePool() = default;
+
+        ResourcePool(const ResourcePool&) = delete;
+        ResourcePool& operator=(const ResourcePool&) = delete;
+
+        template <typename... Args>
+        Handle<T> Create(Args&&... args)
+        {
+            // Constructed first, so a throwing constructor leaves the pool unchanged
+            m_Items.emplace_back(std::forward<Args>(args)...);
+
+            uint32_t slotIndex;
+            if (!m_FreeSlots.empty())
+            {
+                slotIndex = m_FreeSlots.back();
+                m_FreeSlots.pop_back();
+            }
+            else
+            {
+                slotIndex = static_cast<uint32_t>(m_Slots.size());
+                m_Slots.push_back({0, 1});
+            }
+
+            Slot& slot = m_Slots[slotIndex];
+            slot.Dense = static_cast<uint32_t>(m_Items.size() - 1);
+            m_DenseToSlot.push_back(slotIndex);
+            return {slotIndex, slot.Generation};
+        }
+
+        // Returns false when the handle was already stale
+        bool Destroy(const Handle<T> handle)
+        {
+            if (!IsValid(handle))
+            {
+                return false;
+            }
+
+            Slot& slot = m_Slots[handle.Index];
+            const uint32_t last = static_cast<uint32_t>(m_Items.size() - 1);
+            if (slot.Dense != last)
+            {
+                if constexpr (std::is_move_assignable_v<T>)
+                {
+                    m_Items[slot.Dense] = std::move(m_Items[last]);
+                }
+                else
+                {
+                    // Resources holding a Device& can be moved but not assigned
+                    std::destroy_at(&m_Items[slot.Dense]);
+                    std::construct_at(&m_Items[slot.Dense], std::move(m_Items[last]));
+                }
+                m_DenseToSlot[slot.Dense] = m_DenseToSlot[last];
+                m_Slots[m_DenseToSlot[slot.Dense]].Dense = slot.Dense;
+            }
+            m_Items.pop_back();
+            m_DenseToSlot.pop_back();
+
+            // Generation 0 is reserved for null handles
+            slot.Generation = slot.Generation == UINT32_MAX ? 1 : slot.Generation + 1;
+            m_FreeSlots.push_back(handle.Index);
+            return true;
+        }
+
+        bool IsValid(const Handle<T> handle) const
+        {
+            return handle.Index < m_Slots.size() && m_Slots[handle.Index].Generation == handle.Generation;
+        }
+
+        // nullptr for null and stale handles. The pointer is invalidated by the next Create or Destroy.
+        T* Get(const Handle<T> handle)
+        {
+            return IsValid(handle) ? &m_Items[m_Slots[handle.Index].Dense] : nullptr;
+        }
+
+        const T* Get(const Handle<T> handle) const
+        {
+            return IsValid(handle) ? &m_Items[m_Slots[handle.Index].Dense] : nullptr;
+        }
+
+        uint32_t GetSize() const { return static_cast<uint32_t>(m_Items.size()); }
+
+        // Dense iteration, in no particular order
+        std::span<T> GetItems() { return m_Items; }
+        std::span<const T> GetItems() const { return m_Items; }
+        Handle<T> GetHandle(const uint32_t denseIndex) const
+        {
+            const uint32_t slotIndex = m_DenseToSlot[denseIndex];
+            return {slotIndex, m_Slots[slotIndex].Generation};
+        }
+
+        void Clear()
+        {
+            for (uint32_t denseIndex = GetSize(); denseIndex > 0; denseIndex--)
+            {
+                Destroy(GetHandle(denseIndex - 1));
+            }
+        }
+
+    private:
+        struct Slot
+        {
+            uint32_t Dense;
+            uint32_t Generation;
+        };
+
+        std::vector<T> m_Items;
+        std::vector<uint32_t> m_DenseToSlot;
+        std::vector<Slot> m_Slots;
+        std::vector<uint32_t> m_FreeSlots;
+    };
+}
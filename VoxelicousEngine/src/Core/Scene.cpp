@@ -0,0 +1,237 @@
+#include "vepch.h"
+#include "Scene.h"
+
+namespace VoxelicousEngine
+{
+    namespace
+    {
+        std::mutex s_RegistryMutex;
+        std::array<ComponentInfo, ComponentRegistry::MAX_COMPONENTS> s_ComponentInfos{};
+        uint32_t s_ComponentCount = 0;
+
+        uint32_t AlignUp(const uint32_t value, const uint32_t alignment)
+        {
+            return (value + alignment - 1) & ~(alignment - 1);
+        }
+    }
+
+    ComponentId ComponentRegistry::Register(const ComponentInfo& info)
+    {
+        std::scoped_lock lock{s_RegistryMutex};
+        if (s_ComponentCount == MAX_COMPONENTS)
+        {
+            throw std::runtime_error("too many component types!");
+        }
+        s_ComponentInfos[s_ComponentCount] = info;
+        return s_ComponentCount++;
+    }
+
+    const ComponentInfo& ComponentRegistry::GetInfo(const ComponentId id)
+    {
+        // Written before the id was handed out and never changed afterwards
+        return s_ComponentInfos[id];
+    }
+
+    Archetype::Archetype(const ComponentMask mask) : m_Mask{mask}
+    {
+        uint32_t rowSize = sizeof(Entity);
+        for (ComponentMask bits = mask; bits != 0; bits &= bits - 1)
+        {
+            const auto id = static_cast<ComponentId>(std::countr_zero(bits));
+            m_Components.push_back(id);
+            m_ComponentSizes[id] = ComponentRegistry::GetInfo(id).Size;
+            rowSize += m_ComponentSizes[id];
+        }
+
+        // Every column starts on a cache line, so SIMD loads of a column are aligned and chunks split across
+        // threads never share a line. That padding is reserved up front.
+        constexpr uint32_t lineSize = 64;
+        const auto padding = static_cast<uint32_t>(m_Components.size()) * lineSize;
+        m_ChunkCapacity = (ArchetypeChunk::SIZE - padding) / rowSize;
+
+        uint32_t offset = m_ChunkCapacity * static_cast<uint32_t>(sizeof(Entity));
+        for (const ComponentId id : m_Components)
+        {
+            offset = AlignUp(offset, lineSize);
+            m_ColumnOffsets[id] = offset;
+            offset += m_ChunkCapacity * m_ComponentSizes[id];
+        }
+        VE_CORE_ASSERT(offset <= ArchetypeChunk::SIZE, "Archetype columns overflow their chunk!");
+    }
+
+    Scene::~Scene()
+    {
+        Clear();
+    }
+
+    bool Scene::Destroy(const Entity entity)
+    {
+        std::scoped_lock lock{m_Mutex};
+        if (!IsAlive(entity))
+        {
+            return false;
+        }
+
+        EntityRecord& record = m_Records[entity.Index];
+        RemoveRow(*record.Archetype, record.Chunk, record.Row);
+        record.Archetype = nullptr;
+        // Generation 0 is reserved for null handles
+        record.Generation = record.Generation == UINT32_MAX ? 1 : record.Generation + 1;
+        m_FreeIndices.push_back(entity.Index);
+        return true;
+    }
+
+    void Scene::Clear()
+    {
+        VE_PROFILE_FUNCTION();
+
+        std::scoped_lock lock{m_Mutex};
+        for (Archetype* archetype : m_Archetypes)
+        {
+            for (const auto& chunk : archetype->m_Chunks)
+            {
+                for (const ComponentId id : archetype->m_Components)
+                {
+                    const ComponentInfo& info = ComponentRegistry::GetInfo(id);
+                    if (info.Destroy == nullptr) continue;
+                    for (uint32_t row = 0; row < chunk->Count; row++)
+                    {
+                        info.Destroy(chunk->Data + archetype->m_ColumnOffsets[id] + static_cast<size_t>(row) * info.Size);
+                    }
+                }
+
+                const auto* entities = reinterpret_cast<const Entity*>(chunk->Data);
+                for (uint32_t row = 0; row < chunk->Count; row++)
+                {
+                    EntityRecord& record = m_Records[entities[row].Index];
+                    record.Archetype = nullptr;
+                    record.Generation = record.Generation == UINT32_MAX ? 1 : record.Generation + 1;
+                    m_FreeIndices.push_back(entities[row].Index);
+                }
+            }
+            for (auto& chunk : archetype->m_Chunks)
+            {
+                chunk->Count = 0;
+                archetype->m_FreeChunks.push_back(std::move(chunk));
+            }
+            archetype->m_Chunks.clear();
+            archetype->m_EntityCount = 0;
+        }
+    }
+
+    Archetype& Scene::GetOrCreateArchetype(const ComponentMask mask)
+    {
+        auto& archetype = m_ArchetypesByMask[mask];
+        if (archetype == nullptr)
+        {
+            archetype.reset(new Archetype(mask));
+            m_Archetypes.push_back(archetype.get());
+        }
+        return *archetype;
+    }
+
+    Entity Scene::CreateEntity(const ComponentMask mask)
+    {
+        uint32_t index;
+        if (!m_FreeIndices.empty())
+        {
+            index = m_FreeIndices.back();
+            m_FreeIndices.pop_back();
+        }
+        else
+        {
+            index = static_cast<uint32_t>(m_Records.size());
+            m_Records.emplace_back();
+        }
+
+        const Entity entity{index, m_Records[index].Generation};
+        AllocateRow(GetOrCreateArchetype(mask), entity);
+        return entity;
+    }
+
+    void Scene::AllocateRow(Archetype& archetype, const Entity entity)
+    {
+        if (archetype.m_Chunks.empty() || archetype.m_Chunks.back()->Count == archetype.m_ChunkCapacity)
+        {
+            if (!archetype.m_FreeChunks.empty())
+            {
+                archetype.m_Chunks.push_back(std::move(archetype.m_FreeChunks.back()));
+                archetype.m_FreeChunks.pop_back();
+            }
+            else
+            {
+                // Not value-initialized, rows are written before they're read
+                archetype.m_Chunks.push_back(std::unique_ptr<ArchetypeChunk>(new ArchetypeChunk));
+            }
+        }
+
+        ArchetypeChunk& chunk = *archetype.m_Chunks.back();
+        const uint32_t row = chunk.Count++;
+        reinterpret_cast<Entity*>(chunk.Data)[row] = entity;
+        archetype.m_EntityCount++;
+
+        EntityRecord& record = m_Records[entity.Index];
+        record.Archetype = &archetype;
+        record.Chunk = archetype.GetChunkCount() - 1;
+        record.Row = row;
+    }
+
+    void Scene::RemoveRow(Archetype& archetype, const uint32_t chunk, const uint32_t row)
+    {
+        const uint32_t lastChunk = archetype.GetChunkCount() - 1;
+        ArchetypeChunk& last = *archetype.m_Chunks[lastChunk];
+        const uint32_t lastRow = last.Count - 1;
+        const bool fill = chunk != lastChunk || row != lastRow;
+
+        for (const ComponentId id : archetype.m_Components)
+        {
+            const ComponentInfo& info = ComponentRegistry::GetInfo(id);
+            void* removed = archetype.GetComponent(chunk, row, id);
+            if (info.Destroy != nullptr) info.Destroy(removed);
+            if (fill)
+            {
+                void* moved = archetype.GetComponent(lastChunk, lastRow, id);
+                info.MoveConstruct(removed, moved);
+                if (info.Destroy != nullptr) info.Destroy(moved);
+            }
+        }
+
+        if (fill)
+        {
+            const Entity moved = reinterpret_cast<const Entity*>(last.Data)[lastRow];
+            reinterpret_cast<Entity*>(archetype.m_Chunks[chunk]->Data)[row] = moved;
+            m_Records[moved.Index].Chunk = chunk;
+            m_Records[moved.Index].Row = row;
+        }
+
+        archetype.m_EntityCount--;
+        if (--last.Count == 0)
+        {
+            archetype.m_FreeChunks.push_back(std::move(archetype.m_Chunks.back()));
+            archetype.m_Chunks.pop_back();
+        }
+    }
+
+    void Scene::MoveEntity(const Entity entity, const ComponentMask mask)
+    {
+        EntityRecord& record = m_Records[entity.Index];
+        Archetype& source = *record.Archetype;
+        const uint32_t sourceChunk = record.Chunk;
+        const uint32_t sourceRow = record.Row;
+
+        Archetype& target = GetOrCreateArchetype(mask);
+        AllocateRow(target, entity);
+        for (const ComponentId id : source.m_Components)
+        {
+            if (mask & ComponentMask{1} << id)
+            {
+                ComponentRegistry::GetInfo(id).MoveConstruct(
+                    target.GetComponent(record.Chunk, record.Row, id), source.GetComponent(sourceChunk, sourceRow, id));
+            }
+        }
+
+        // Destroys the moved-from components along with the ones the entity lost. AllocateRow already pointed
+        // the record at the target, so patching the entity that fills the hole can't touch it.
+        RemoveRow(source, sourceChunk, sourceRow);
+    }
+}
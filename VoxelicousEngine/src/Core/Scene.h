@@ -0,0 +1,362 @@
+#pragma once
+
+#include "Core.h"
+#include "Handle.h"
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace VoxelicousEngine
+{
+    using ComponentId = uint32_t;
+    // One bit per ComponentId
+    using ComponentMask = uint64_t;
+
+    // What the chunk storage needs to know about a component type to move and destroy it without its type
+    struct ComponentInfo
+    {
+        uint32_t Size;
+        uint32_t Alignment;
+        // Move-constructs *dst from *src, src is destroyed separately
+        void (*MoveConstruct)(void* dst, void* src);
+        // nullptr for trivially destructible components
+        void (*Destroy)(void* object);
+    };
+
+    // Hands out dense ids to component types on their first use
+    class ComponentRegistry
+    {
+    public:
+        static constexpr uint32_t MAX_COMPONENTS = 64;
+
+        template <typename T>
+        static ComponentId GetId()
+        {
+            static_assert(std::is_same_v<T, std::remove_cvref_t<T>>, "Components are registered by their plain type");
+            static_assert(std::is_nothrow_move_constructible_v<T>, "Components must be nothrow movable");
+            static_assert(alignof(T) <= 64, "Component columns are aligned to a cache line at most");
+
+            // Initialized exactly once, even when several threads use the component for the first time together
+            static const ComponentId id = Register({
+                static_cast<uint32_t>(sizeof(T)),
+                static_cast<uint32_t>(alignof(T)),
+                [](void* dst, void* src) { std::construct_at(static_cast<T*>(dst), std::move(*static_cast<T*>(src))); },
+                std::is_trivially_destructible_v<T>
+                    ? nullptr
+                    : +[](void* object) { std::destroy_at(static_cast<T*>(object)); }
+            });
+            return id;
+        }
+
+        template <typename T>
+        static ComponentMask GetBit() { return ComponentMask{1} << GetId<std::remove_const_t<T>>(); }
+
+        static const ComponentInfo& GetInfo(ComponentId id);
+
+    private:
+        static ComponentId Register(const ComponentInfo& info);
+    };
+
+    // 16 KiB of entities sharing one archetype, stored as one array per component (SoA) after the entity array
+    struct ArchetypeChunk
+    {
+        static constexpr uint32_t SIZE = 16 * 1024;
+
+        alignas(64) std::byte Data[SIZE];
+        uint32_t Count = 0;
+    };
+
+    // All entities with exactly the same set of components. Chunks are kept packed: every chunk but the last is
+    // full, and removing an entity moves the last one into its row.
+    class Archetype
+    {
+    public:
+        ComponentMask GetMask() const { return m_Mask; }
+        std::span<const ComponentId> GetComponents() const { return m_Components; }
+        uint32_t GetChunkCapacity() const { return m_ChunkCapacity; }
+        uint32_t GetChunkCount() const { return static_cast<uint32_t>(m_Chunks.size()); }
+        uint32_t GetEntityCount() const { return m_EntityCount; }
+
+        std::span<const Entity> GetEntities(const uint32_t chunk) const
+        {
+            const ArchetypeChunk& data = *m_Chunks[chunk];
+            return {reinterpret_cast<const Entity*>(data.Data), data.Count};
+        }
+
+        // T may be const-qualified for read-only access, the archetype must have the component
+        template <typename T>
+        std::span<T> GetColumn(const uint32_t chunk) const
+        {
+            const ComponentId id = ComponentRegistry::GetId<std::remove_const_t<T>>();
+            VE_CORE_ASSERT(m_Mask & ComponentMask{1} << id, "Archetype doesn't have the component!");
+            ArchetypeChunk& data = *m_Chunks[chunk];
+            return {reinterpret_cast<T*>(data.Data + m_ColumnOffsets[id]), data.Count};
+        }
+
+    private:
+        friend class Scene;
+
+        explicit Archetype(ComponentMask mask);
+
+        void* GetComponent(const uint32_t chunk, const uint32_t row, const ComponentId id) const
+        {
+            return m_Chunks[chunk]->Data + m_ColumnOffsets[id] + static_cast<size_t>(row) * m_ComponentSizes[id];
+        }
+
+        ComponentMask m_Mask;
+        // Ascending ids
+        std::vector<ComponentId> m_Components;
+        // Byte offset of each component's column within a chunk, indexed by ComponentId
+        std::array<uint32_t, ComponentRegistry::MAX_COMPONENTS> m_ColumnOffsets{};
+        std::array<uint32_t, ComponentRegistry::MAX_COMPONENTS> m_ComponentSizes{};
+        uint32_t m_ChunkCapacity;
+        uint32_t m_EntityCount = 0;
+        std::vector<std::unique_ptr<ArchetypeChunk>> m_Chunks;
+        // Emptied chunks, reused before allocating so an entity count hovering around a chunk boundary or a
+        // scene refilled after Clear doesn't allocate
+        std::vector<std::unique_ptr<ArchetypeChunk>> m_FreeChunks;
+    };
+
+    // Entity-component storage. Entities are grouped by archetype, so a query walks a few tightly packed arrays
+    // per 16 KiB chunk instead of chasing one heap node per object, and chunks of a query can be handed out to
+    // the job system as independent pieces of work.
+    //
+    // Structural changes (Create, Destroy, Add, Remove, Clear) lock the scene and may be called from several
+    // threads at once, e.g. from jobs that spawn entities. They must not overlap queries, Get or other
+    // component access, which read the chunks without locking: adding or removing a component moves the entity
+    // to another archetype, and any removal moves another entity into its row. Destroyed entity indices are
+    // recycled with a new generation.
+    class Scene
+    {
+    public:
+        Scene() = default;
+        ~Scene();
+
+        Scene(const Scene&) = delete;
+        Scene& operator=(const Scene&) = delete;
+
+        template <typename... Ts>
+        Entity Create(Ts&&... components)
+        {
+            static_assert((std::is_nothrow_constructible_v<std::remove_cvref_t<Ts>, Ts&&> && ...),
+                "Move components into the scene, a throwing copy would leave a half-built row");
+            const ComponentMask mask = (ComponentMask{0} | ... | ComponentRegistry::GetBit<std::remove_cvref_t<Ts>>());
+            VE_CORE_ASSERT(std::popcount(mask) == sizeof...(Ts), "Entities can have each component only once!");
+
+            std::scoped_lock lock{m_Mutex};
+            const Entity entity = CreateEntity(mask);
+            const EntityRecord& record = m_Records[entity.Index];
+            (std::construct_at(GetComponent<std::remove_cvref_t<Ts>>(record), std::forward<Ts>(components)), ...);
+            return entity;
+        }
+
+        // Returns false when the entity was already destroyed
+        bool Destroy(Entity entity);
+
+        bool IsAlive(const Entity entity) const
+        {
+            return entity.Index < m_Records.size() && m_Records[entity.Index].Generation == entity.Generation &&
+                m_Records[entity.Index].Archetype != nullptr;
+        }
+
+        // Adds the component, or overwrites it when the entity already has one
+        template <typename T>
+        void Add(const Entity entity, T&& component)
+        {
+            using Component = std::remove_cvref_t<T>;
+            static_assert(std::is_nothrow_constructible_v<Component, T&&>,
+                "Move components into the scene, a throwing copy would leave a half-built row");
+
+            std::scoped_lock lock{m_Mutex};
+            VE_CORE_ASSERT(IsAlive(entity), "Adding a component to a destroyed entity!");
+            const EntityRecord& record = m_Records[entity.Index];
+            if (Component* existing = GetComponent<Component>(record))
+            {
+                *existing = std::forward<T>(component);
+                return;
+            }
+
+            MoveEntity(entity, record.Archetype->m_Mask | ComponentRegistry::GetBit<Component>());
+            std::construct_at(GetComponent<Component>(record), std::forward<T>(component));
+        }
+
+        template <typename T>
+        void Remove(const Entity entity)
+        {
+            std::scoped_lock lock{m_Mutex};
+            VE_CORE_ASSERT(IsAlive(entity), "Removing a component from a destroyed entity!");
+            const ComponentMask mask = m_Records[entity.Index].Archetype->m_Mask;
+            if (mask & ComponentRegistry::GetBit<T>())
+            {
+                MoveEntity(entity, mask & ~ComponentRegistry::GetBit<T>());
+            }
+        }
+
+        // nullptr when the entity is dead or lacks the component. Invalidated by the next structural change.
+        template <typename T>
+        T* Get(const Entity entity)
+        {
+            return IsAlive(entity) ? GetComponent<std::remove_const_t<T>>(m_Records[entity.Index]) : nullptr;
+        }
+
+        template <typename T>
+        bool Has(const Entity entity) const
+        {
+            return IsAlive(entity) && m_Records[entity.Index].Archetype->m_Mask & ComponentRegistry::GetBit<T>();
+        }
+
+        // Destroys every entity, archetypes stay allocated and keep their chunks for reuse
+        void Clear();
+
+        uint32_t GetEntityCount() const { return static_cast<uint32_t>(m_Records.size() - m_FreeIndices.size()); }
+        std::span<Archetype* const> GetArchetypes() const { return m_Archetypes; }
+
+        template <typename... Ts>
+        static ComponentMask GetMask() { return (ComponentMask{0} | ... | ComponentRegistry::GetBit<Ts>()); }
+
+        // Queries. Ts are the components an entity needs to match; const ones are only read. Entities with any
+        // of the components in without, e.g. GetMask<ParentComponent>(), are skipped. Chunks and entities are
+        // visited in storage order.
+
+        template <typename... Ts>
+        uint32_t Count(const ComponentMask without = 0) const
+        {
+            const ComponentMask mask = GetMask<Ts...>();
+            uint32_t count = 0;
+            for (const Archetype* archetype : m_Archetypes)
+            {
+                count += IsMatch(*archetype, mask, without) ? archetype->m_EntityCount : 0;
+            }
+            return count;
+        }
+
+        // fn(std::span<const Entity>, std::span<Ts>...) once per chunk, for loops over whole columns
+        template <typename... Ts, typename Fn>
+        void ForEachChunk(Fn&& fn, const ComponentMask without = 0)
+        {
+            const ComponentMask mask = GetMask<Ts...>();
+            for (const Archetype* archetype : m_Archetypes)
+            {
+                if (!IsMatch(*archetype, mask, without)) continue;
+                for (uint32_t chunk = 0; chunk < archetype->GetChunkCount(); chunk++)
+                {
+                    fn(archetype->GetEntities(chunk), archetype->GetColumn<Ts>(chunk)...);
+                }
+            }
+        }
+
+        // fn(Entity, Ts&...) once per entity
+        template <typename... Ts, typename Fn>
+        void Each(Fn&& fn, const ComponentMask without = 0)
+        {
+            ForEachChunk<Ts...>([&fn](const std::span<const Entity> entities, const std::span<Ts>... columns)
+            {
+                for (size_t row = 0; row < entities.size(); row++)
+                {
+                    fn(entities[row], columns[row]...);
+                }
+            }, without);
+        }
+
+        // Like ForEachChunk, with the matching chunks split across the job system's workers. fn runs
+        // concurrently for different chunks and must only write to the components it is given.
+        template <typename... Ts, typename Fn>
+        void ParallelForEachChunk(Fn&& fn, const ComponentMask without = 0)
+        {
+            const ComponentMask mask = GetMask<Ts...>();
+            uint32_t chunkCount = 0;
+            for (const Archetype* archetype : m_Archetypes)
+            {
+                chunkCount += IsMatch(*archetype, mask, without) ? archetype->GetChunkCount() : 0;
+            }
+
+            // Chunks are numbered across the matching archetypes in order; each batch walks the archetypes to its
+            // own range instead of reading a list of chunks, so the query allocates nothing per frame
+            const auto runBatch = [&](const uint32_t begin, const uint32_t end)
+            {
+                uint32_t first = 0;
+                for (const Archetype* archetype : m_Archetypes)
+                {
+                    if (first >= end) break;
+                    if (!IsMatch(*archetype, mask, without)) continue;
+                    const uint32_t count = archetype->GetChunkCount();
+                    for (uint32_t i = std::max(begin, first); i < std::min(end, first + count); i++)
+                    {
+                        fn(archetype->GetEntities(i - first), archetype->GetColumn<Ts>(i - first)...);
+                    }
+                    first += count;
+                }
+            };
+
+            JobSystem& jobs = JobSystem::Get();
+            // A few batches per thread balance uneven chunks without paying a job per chunk
+            const uint32_t batchSize = std::max(1u, chunkCount / ((jobs.GetThreadCount() + 1) * 4));
+            // A single captured reference fits std::function's inline storage, more captures would allocate
+            jobs.ParallelFor(chunkCount, batchSize, [&runBatch](const uint32_t begin, const uint32_t end)
+            {
+                runBatch(begin, end);
+            });
+        }
+
+        // fn(Entity, Ts&...) once per entity, chunks split across the job system's workers
+        template <typename... Ts, typename Fn>
+        void ParallelEach(Fn&& fn, const ComponentMask without = 0)
+        {
+            ParallelForEachChunk<Ts...>([&fn](const std::span<const Entity> entities, const std::span<Ts>... columns)
+            {
+                for (size_t row = 0; row < entities.size(); row++)
+                {
+                    fn(entities[row], columns[row]...);
+                }
+            }, without);
+        }
+
+    private:
+        struct EntityRecord
+        {
+            uint32_t Generation = 1;
+            uint32_t Chunk = 0;
+            uint32_t Row = 0;
+            // nullptr while the index is free
+            VoxelicousEngine::Archetype* Archetype = nullptr;
+        };
+
+        static bool IsMatch(const Archetype& archetype, const ComponentMask mask, const ComponentMask without)
+        {
+            return (archetype.m_Mask & mask) == mask && (archetype.m_Mask & without) == 0;
+        }
+
+        template <typename T>
+        T* GetComponent(const EntityRecord& record) const
+        {
+            const ComponentId id = ComponentRegistry::GetId<T>();
+            if (!(record.Archetype->m_Mask & ComponentMask{1} << id)) return nullptr;
+            return static_cast<T*>(record.Archetype->GetComponent(record.Chunk, record.Row, id));
+        }
+
+        Archetype& GetOrCreateArchetype(ComponentMask mask);
+        // Allocates an id and a row in the archetype of mask, leaving the components unconstructed
+        Entity CreateEntity(ComponentMask mask);
+        void AllocateRow(Archetype& archetype, Entity entity);
+        // Destroys the components of a row and fills it with the archetype's last entity
+        void RemoveRow(Archetype& archetype, uint32_t chunk, uint32_t row);
+        // Moves an entity to the archetype of mask, constructing nothing for components it gains
+        void MoveEntity(Entity entity, ComponentMask mask);
+
+        std::vector<EntityRecord> m_Records;
+        std::vector<uint32_t> m_FreeIndices;
+        std::unordered_map<ComponentMask, std::unique_ptr<Archetype>> m_ArchetypesByMask;
+        // Creation order, so queries visit archetypes deterministically
+        std::vector<Archetype*> m_Archetypes;
+        std::mutex m_Mutex;
+    };
+}
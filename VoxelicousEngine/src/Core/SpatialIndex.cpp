@@ -0,0 +1,557 @@
+#include "vepch.h"
+#include "SpatialIndex.h"
+
+#include "Core.h"
+
+namespace VoxelicousEngine
+{
+    namespace
+    {
+        constexpr uint32_t BIN_COUNT = 12;
+        // Deeper than this the SAH has stopped making progress on the objects, see SpatialIndex::MAX_DEPTH
+        constexpr uint32_t SAH_DEPTH = 64;
+        constexpr uint32_t NO_PARENT = UINT32_MAX;
+
+        AABB EmptyBounds()
+        {
+            constexpr float inf = std::numeric_limits<float>::infinity();
+            return {glm::vec3{inf}, glm::vec3{-inf}};
+        }
+
+        void Grow(AABB& bounds, const AABB& other)
+        {
+            bounds.Min = glm::min(bounds.Min, other.Min);
+            bounds.Max = glm::max(bounds.Max, other.Max);
+        }
+
+        bool IsSame(const AABB& a, const AABB& b)
+        {
+            return a.Min == b.Min && a.Max == b.Max;
+        }
+
+        // Half the surface area, which is all the SAH compares
+        float GetArea(const AABB& bounds)
+        {
+            const glm::vec3 size = bounds.Max - bounds.Min;
+            return size.x * size.y + size.y * size.z + size.z * size.x;
+        }
+
+        // Carries its box along, so partitioning keeps the boxes the next split reads contiguous
+        struct BuildItem
+        {
+            AABB Bounds;
+            glm::vec3 Centroid;
+            uint32_t Index;
+        };
+
+        struct BuildRange
+        {
+            uint32_t Node;
+            uint32_t Begin;
+            uint32_t End;
+            uint32_t Depth;
+        };
+
+        uint32_t GetBin(const BuildItem& item, const int axis, const float minCentroid, const float scale)
+        {
+            return std::min(static_cast<uint32_t>((item.Centroid[axis] - minCentroid) * scale), BIN_COUNT - 1);
+        }
+
+        // Cost of every split between bins along one axis, returns the best one and its bin
+        float FindBestSplit(const std::span<const BuildItem> items, const int axis, const float minCentroid,
+                            const float scale, uint32_t& bestBin)
+        {
+            std::array<AABB, BIN_COUNT> binBounds;
+            std::array<uint32_t, BIN_COUNT> binCounts{};
+            binBounds.fill(EmptyBounds());
+            for (const BuildItem& item : items)
+            {
+                const uint32_t bin = GetBin(item, axis, minCentroid, scale);
+                binCounts[bin]++;
+                Grow(binBounds[bin], item.Bounds);
+            }
+
+            // Right-hand sides swept from the back, left-hand sides on the way forward
+            std::array<float, BIN_COUNT> rightCosts{};
+            AABB right = EmptyBounds();
+            uint32_t rightCount = 0;
+            for (uint32_t bin = BIN_COUNT - 1; bin > 0; bin--)
+            {
+                Grow(right, binBounds[bin]);
+                rightCount += binCounts[bin];
+                rightCosts[bin] = rightCount > 0 ? GetArea(right) * static_cast<float>(rightCount) : 0.f;
+            }
+
+            float bestCost = std::numeric_limits<float>::infinity();
+            AABB left = EmptyBounds();
+            uint32_t leftCount = 0;
+            for (uint32_t bin = 1; bin < BIN_COUNT; bin++)
+            {
+                Grow(left, binBounds[bin - 1]);
+                leftCount += binCounts[bin - 1];
+                if (leftCount == 0 || leftCount == items.size()) continue;
+
+                const float cost = GetArea(left) * static_cast<float>(leftCount) + rightCosts[bin];
+                if (cost < bestCost)
+                {
+                    bestCost = cost;
+                    bestBin = bin;
+                }
+            }
+            return bestCost;
+        }
+    }
+
+    // Snapshot of the live proxies and the tree built from it, owned by the index until Refit swaps it in
+    struct SpatialIndex::BuildTask
+    {
+        JobCounter Counter;
+        std::vector<ProxyId> Ids;
+        std::vector<AABB> Bounds;
+
+        std::vector<Node> Nodes;
+        std::vector<uint32_t> Parents;
+        std::vector<ProxyId> Items;
+    };
+
+    // Top-down binned SAH build over the snapshot, children allocated in pairs
+    void SpatialIndex::BuildTree(BuildTask& build)
+    {
+        VE_PROFILE_FUNCTION();
+
+        const std::vector<ProxyId>& ids = build.Ids;
+        const std::vector<AABB>& bounds = build.Bounds;
+        std::vector<Node>& nodes = build.Nodes;
+        std::vector<uint32_t>& parents = build.Parents;
+        std::vector<ProxyId>& items = build.Items;
+
+        nodes.clear();
+        parents.clear();
+        items.clear();
+        const auto count = static_cast<uint32_t>(ids.size());
+        if (count == 0) return;
+
+        std::vector<BuildItem> order(count);
+        for (uint32_t i = 0; i < count; i++)
+        {
+            order[i] = {bounds[i], bounds[i].GetCenter(), i};
+        }
+
+        // A full binary tree with at least one object per leaf
+        nodes.reserve(2 * count);
+        parents.reserve(2 * count);
+        nodes.push_back({});
+        parents.push_back(NO_PARENT);
+
+        std::vector<BuildRange> stack;
+        stack.push_back({0, 0, count, 0});
+        while (!stack.empty())
+        {
+            const BuildRange range = stack.back();
+            stack.pop_back();
+
+            AABB nodeBounds = EmptyBounds();
+            AABB centroidBounds = EmptyBounds();
+            for (uint32_t i = range.Begin; i < range.End; i++)
+            {
+                Grow(nodeBounds, order[i].Bounds);
+                centroidBounds.Min = glm::min(centroidBounds.Min, order[i].Centroid);
+                centroidBounds.Max = glm::max(centroidBounds.Max, order[i].Centroid);
+            }
+            nodes[range.Node].Bounds = nodeBounds;
+
+            const uint32_t size = range.End - range.Begin;
+            if (size <= MAX_LEAF_SIZE)
+            {
+                nodes[range.Node].First = range.Begin;
+                nodes[range.Node].Count = size;
+                continue;
+            }
+
+            const std::span<BuildItem> slice{order.data() + range.Begin, size};
+            const glm::vec3 extent = centroidBounds.Max - centroidBounds.Min;
+            int axis = extent.x >= extent.y ? 0 : 1;
+            axis = extent.z > extent[axis] ? 2 : axis;
+
+            // Binning the largest axis only builds three times faster than trying all of them, for nearly
+            // the same query speed
+            uint32_t split = range.Begin + size / 2;
+            uint32_t bestBin = 0;
+            const float minCentroid = centroidBounds.Min[axis];
+            const float scale = static_cast<float>(BIN_COUNT) / extent[axis];
+            const bool binned = range.Depth < SAH_DEPTH && extent[axis] > 0.f &&
+                FindBestSplit(slice, axis, minCentroid, scale, bestBin) < std::numeric_limits<float>::infinity();
+            if (binned)
+            {
+                const auto middle = std::partition(slice.begin(), slice.end(), [=](const BuildItem& item)
+                {
+                    return GetBin(item, axis, minCentroid, scale) < bestBin;
+                });
+                split = range.Begin + static_cast<uint32_t>(middle - slice.begin());
+            }
+            else
+            {
+                // Too deep, or every centroid in the same spot: halve the range instead
+                std::nth_element(slice.begin(), slice.begin() + size / 2, slice.end(),
+                                 [axis](const BuildItem& a, const BuildItem& b)
+                                 {
+                                     return a.Centroid[axis] < b.Centroid[axis];
+                                 });
+            }
+
+            const auto left = static_cast<uint32_t>(nodes.size());
+            nodes[range.Node].First = left;
+            nodes[range.Node].Count = 0;
+            nodes.resize(nodes.size() + 2);
+            parents.push_back(range.Node);
+            parents.push_back(range.Node);
+            stack.push_back({left + 1, split, range.End, range.Depth + 1});
+            stack.push_back({left, range.Begin, split, range.Depth + 1});
+        }
+
+        items.resize(count);
+        for (uint32_t i = 0; i < count; i++)
+        {
+            items[i] = ids[order[i].Index];
+        }
+    }
+
+    Frustum Frustum::FromMatrix(const glm::mat4& viewProjection)
+    {
+        const auto row = [&viewProjection](const int i)
+        {
+            return glm::vec4{viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]};
+        };
+        const glm::vec4 x = row(0);
+        const glm::vec4 y = row(1);
+        const glm::vec4 z = row(2);
+        const glm::vec4 w = row(3);
+
+        Frustum frustum{};
+        frustum.Planes = {w + x, w - x, w + y, w - y, z, w - z};
+        for (glm::vec4& plane : frustum.Planes)
+        {
+            const float length = std::sqrt(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+            if (length > 0.f) plane = plane / length;
+        }
+        return frustum;
+    }
+
+    SpatialIndex::SpatialIndex() = default;
+
+    SpatialIndex::~SpatialIndex()
+    {
+        if (m_Build != nullptr)
+        {
+            JobSystem::Get().Wait(m_Build->Counter);
+        }
+    }
+
+    SpatialIndex::ProxyId SpatialIndex::Insert(const Entity entity, const AABB& bounds)
+    {
+        ProxyId id;
+        if (!m_FreeProxies.empty())
+        {
+            id = m_FreeProxies.back();
+            m_FreeProxies.pop_back();
+        }
+        else
+        {
+            id = static_cast<ProxyId>(m_Proxies.size());
+            m_Proxies.emplace_back();
+        }
+
+        Proxy& proxy = m_Proxies[id];
+        proxy.Bounds = bounds;
+        proxy.Entity = entity;
+        proxy.Leaf = INVALID_PROXY;
+        proxy.Alive = true;
+        AddLoose(id);
+        return id;
+    }
+
+    void SpatialIndex::Move(const ProxyId id, const AABB& bounds)
+    {
+        Proxy& proxy = m_Proxies[id];
+        VE_CORE_ASSERT(proxy.Alive, "Moving a removed proxy!");
+        proxy.Bounds = bounds;
+        if (proxy.Leaf != INVALID_PROXY)
+        {
+            MarkLeaf(proxy.Leaf);
+        }
+    }
+
+    void SpatialIndex::Remove(const ProxyId id)
+    {
+        Proxy& proxy = m_Proxies[id];
+        VE_CORE_ASSERT(proxy.Alive, "Removing a proxy twice!");
+        if (proxy.Leaf != INVALID_PROXY)
+        {
+            const Node& leaf = m_Nodes[proxy.Leaf];
+            for (uint32_t i = leaf.First; i < leaf.First + leaf.Count; i++)
+            {
+                if (m_LeafItems[i] == id) m_LeafItems[i] = INVALID_PROXY;
+            }
+            MarkLeaf(proxy.Leaf);
+            proxy.Leaf = INVALID_PROXY;
+        }
+        else
+        {
+            RemoveLoose(id);
+        }
+
+        proxy.Alive = false;
+        // The in-flight build's snapshot may still hold the id, ApplyBuild frees it once that's resolved
+        (m_Build != nullptr ? m_PendingFree : m_FreeProxies).push_back(id);
+    }
+
+    void SpatialIndex::Refit()
+    {
+        VE_PROFILE_FUNCTION();
+
+        if (m_Build != nullptr && m_Build->Counter.IsDone())
+        {
+            ApplyBuild();
+        }
+
+        if (m_FullRefit || m_DirtyLeaves.size() > m_Nodes.size() / 4)
+        {
+            // Children always come after their parent, so a backwards sweep sees them first
+            for (auto node = static_cast<uint32_t>(m_Nodes.size()); node-- > 0;)
+            {
+                if (m_Nodes[node].Count > 0)
+                {
+                    RefitLeaf(node);
+                    continue;
+                }
+                const uint32_t first = m_Nodes[node].First;
+                m_Nodes[node].Bounds = m_Nodes[first].Bounds;
+                Grow(m_Nodes[node].Bounds, m_Nodes[first + 1].Bounds);
+            }
+        }
+        else
+        {
+            for (const uint32_t leaf : m_DirtyLeaves)
+            {
+                RefitLeaf(leaf);
+                // Ancestors whose bounds didn't change leave everything above them as it is
+                for (uint32_t node = m_Parents[leaf]; node != NO_PARENT; node = m_Parents[node])
+                {
+                    const uint32_t first = m_Nodes[node].First;
+                    AABB bounds = m_Nodes[first].Bounds;
+                    Grow(bounds, m_Nodes[first + 1].Bounds);
+                    if (IsSame(bounds, m_Nodes[node].Bounds)) break;
+                    m_Nodes[node].Bounds = bounds;
+                }
+            }
+        }
+
+        for (const uint32_t leaf : m_DirtyLeaves)
+        {
+            m_LeafDirty[leaf] = 0;
+        }
+        m_DirtyLeaves.clear();
+        m_FullRefit = false;
+
+        // Rebuild on a schedule, or sooner once the loose list costs queries more than a stale tree does
+        m_RefitsSinceBuild++;
+        const bool stale = m_RefitsSinceBuild >= RebuildInterval;
+        const bool loose = m_Loose.size() > 64 + GetProxyCount() / 16;
+        if (m_Build == nullptr && GetProxyCount() > 0 && (stale || loose))
+        {
+            StartBuild();
+        }
+    }
+
+    void SpatialIndex::Rebuild()
+    {
+        VE_PROFILE_FUNCTION();
+
+        if (m_Build != nullptr)
+        {
+            JobSystem::Get().Wait(m_Build->Counter);
+            ApplyBuild();
+        }
+
+        m_Build = CreateBuildTask();
+        BuildTree(*m_Build);
+        ApplyBuild();
+    }
+
+    std::optional<RayHit> SpatialIndex::Raycast(const Ray& ray, const float maxDistance) const
+    {
+        const glm::vec3 inverse = GetInverseDirection(ray);
+        std::optional<RayHit> hit;
+        float best = maxDistance;
+        float distance = 0.f;
+
+        const auto test = [&](const Proxy& proxy)
+        {
+            if (IntersectRay(ray.Origin, inverse, proxy.Bounds, best, distance) && (!hit || distance < best))
+            {
+                best = distance;
+                hit = RayHit{proxy.Entity, distance};
+            }
+        };
+
+        // The loose objects first, they can only shrink the range the tree has to be searched in
+        for (const ProxyId id : m_Loose)
+        {
+            test(m_Proxies[id]);
+        }
+
+        if (m_Nodes.empty() || !IntersectRay(ray.Origin, inverse, m_Nodes[0].Bounds, best, distance))
+        {
+            return hit;
+        }
+
+        struct Entry
+        {
+            uint32_t Node;
+            float Distance;
+        };
+        std::array<Entry, MAX_DEPTH + 1> stack;
+        uint32_t size = 0;
+        stack[size++] = {0, distance};
+        while (size > 0)
+        {
+            const Entry entry = stack[--size];
+            // A closer hit was found since the node was pushed
+            if (entry.Distance > best) continue;
+
+            const Node& node = m_Nodes[entry.Node];
+            if (node.Count > 0)
+            {
+                for (uint32_t i = node.First; i < node.First + node.Count; i++)
+                {
+                    if (m_LeafItems[i] != INVALID_PROXY) test(m_Proxies[m_LeafItems[i]]);
+                }
+                continue;
+            }
+
+            float leftDistance = 0.f;
+            float rightDistance = 0.f;
+            const bool left = IntersectRay(ray.Origin, inverse, m_Nodes[node.First].Bounds, best, leftDistance);
+            const bool right = IntersectRay(ray.Origin, inverse, m_Nodes[node.First + 1].Bounds, best, rightDistance);
+            if (left && right)
+            {
+                // Nearer child on top, so it's searched first
+                const bool leftFirst = leftDistance <= rightDistance;
+                stack[size++] = leftFirst ? Entry{node.First + 1, rightDistance} : Entry{node.First, leftDistance};
+                stack[size++] = leftFirst ? Entry{node.First, leftDistance} : Entry{node.First + 1, rightDistance};
+            }
+            else if (left)
+            {
+                stack[size++] = {node.First, leftDistance};
+            }
+            else if (right)
+            {
+                stack[size++] = {node.First + 1, rightDistance};
+            }
+        }
+        return hit;
+    }
+
+    void SpatialIndex::MarkLeaf(const uint32_t leaf)
+    {
+        if (m_LeafDirty[leaf] == 0)
+        {
+            m_LeafDirty[leaf] = 1;
+            m_DirtyLeaves.push_back(leaf);
+        }
+    }
+
+    void SpatialIndex::RefitLeaf(const uint32_t leaf)
+    {
+        // Empty once all its proxies were removed, which no query can overlap
+        AABB bounds = EmptyBounds();
+        const Node& node = m_Nodes[leaf];
+        for (uint32_t i = node.First; i < node.First + node.Count; i++)
+        {
+            if (m_LeafItems[i] != INVALID_PROXY) Grow(bounds, m_Proxies[m_LeafItems[i]].Bounds);
+        }
+        m_Nodes[leaf].Bounds = bounds;
+    }
+
+    std::unique_ptr<SpatialIndex::BuildTask> SpatialIndex::CreateBuildTask() const
+    {
+        auto build = std::make_unique<BuildTask>();
+        build->Ids.reserve(GetProxyCount());
+        build->Bounds.reserve(GetProxyCount());
+        for (ProxyId id = 0; id < m_Proxies.size(); id++)
+        {
+            if (!m_Proxies[id].Alive) continue;
+            build->Ids.push_back(id);
+            build->Bounds.push_back(m_Proxies[id].Bounds);
+        }
+        return build;
+    }
+
+    void SpatialIndex::StartBuild()
+    {
+        m_Build = CreateBuildTask();
+        BuildTask* build = m_Build.get();
+        JobSystem::Get().Execute([build] { BuildTree(*build); }, &build->Counter);
+    }
+
+    void SpatialIndex::ApplyBuild()
+    {
+        VE_PROFILE_FUNCTION();
+
+        m_Nodes.swap(m_Build->Nodes);
+        m_Parents.swap(m_Build->Parents);
+        m_LeafItems.swap(m_Build->Items);
+        m_Build.reset();
+
+        for (Proxy& proxy : m_Proxies)
+        {
+            proxy.Leaf = INVALID_PROXY;
+        }
+        for (uint32_t node = 0; node < m_Nodes.size(); node++)
+        {
+            for (uint32_t i = m_Nodes[node].First; i < m_Nodes[node].First + m_Nodes[node].Count; i++)
+            {
+                // Removed while the tree was being built
+                if (!m_Proxies[m_LeafItems[i]].Alive)
+                {
+                    m_LeafItems[i] = INVALID_PROXY;
+                    continue;
+                }
+                m_Proxies[m_LeafItems[i]].Leaf = node;
+            }
+        }
+
+        // Objects inserted while the tree was being built stay loose until the next one
+        m_Loose.clear();
+        for (ProxyId id = 0; id < m_Proxies.size(); id++)
+        {
+            m_Proxies[id].LooseIndex = INVALID_PROXY;
+            if (m_Proxies[id].Alive && m_Proxies[id].Leaf == INVALID_PROXY) AddLoose(id);
+        }
+
+        m_FreeProxies.insert(m_FreeProxies.end(), m_PendingFree.begin(), m_PendingFree.end());
+        m_PendingFree.clear();
+
+        m_LeafDirty.assign(m_Nodes.size(), 0);
+        m_DirtyLeaves.clear();
+        // Objects that moved while the tree was being built are in it with their old boxes
+        m_FullRefit = true;
+        m_RefitsSinceBuild = 0;
+        m_BuildCount++;
+    }
+
+    void SpatialIndex::AddLoose(const ProxyId id)
+    {
+        m_Proxies[id].LooseIndex = static_cast<uint32_t>(m_Loose.size());
+        m_Loose.push_back(id);
+    }
+
+    void SpatialIndex::RemoveLoose(const ProxyId id)
+    {
+        const uint32_t index = m_Proxies[id].LooseIndex;
+        m_Loose[index] = m_Loose.back();
+        m_Proxies[m_Loose[index]].LooseIndex = index;
+        m_Loose.pop_back();
+        m_Proxies[id].LooseIndex = INVALID_PROXY;
+    }
+}
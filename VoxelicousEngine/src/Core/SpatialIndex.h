@@ -0,0 +1,257 @@
+#pragma once
+
+#include "Handle.h"
+#include "JobSystem.h"
+#include "Mesh.h"
+
+#include <array>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace VoxelicousEngine
+{
+    // Half-line from Origin along Direction; distances are measured in lengths of Direction
+    struct Ray
+    {
+        glm::vec3 Origin{0.f};
+        glm::vec3 Direction{0.f, 0.f, 1.f};
+    };
+
+    struct RayHit
+    {
+        VoxelicousEngine::Entity Entity{};
+        // Where the ray enters the entity's box, 0 when it starts inside
+        float Distance{0.f};
+    };
+
+    // Six planes (xyz normal pointing inwards, w offset) of a view-projection matrix with a [0, 1] depth range
+    struct Frustum
+    {
+        std::array<glm::vec4, 6> Planes{};
+
+        static Frustum FromMatrix(const glm::mat4& viewProjection);
+
+        // Conservative: boxes near a frustum corner may pass without touching it
+        bool Intersects(const AABB& bounds) const
+        {
+            const glm::vec3 center = bounds.GetCenter();
+            const glm::vec3 extent = bounds.GetExtent();
+            for (const glm::vec4& plane : Planes)
+            {
+                const float distance = plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w;
+                const float radius = std::abs(plane.x) * extent.x + std::abs(plane.y) * extent.y +
+                    std::abs(plane.z) * extent.z;
+                if (distance + radius < 0.f)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+    };
+
+    // Bounding volume hierarchy over the boxes of dynamic objects, for culling, picking and proximity queries.
+    //
+    // The tree is built top-down with the binned surface area heuristic, at most MAX_LEAF_SIZE objects per leaf,
+    // into a flat array where children always follow their parent. Moving an object only marks its leaf; Refit
+    // then recomputes the marked leaves and their ancestors, or sweeps the whole array bottom-up when most of the
+    // tree moved. Refitting keeps queries correct but lets the tree's quality decay as objects drift apart, so
+    // every RebuildInterval refits a fresh tree is built from a snapshot on the job system and swapped in by a
+    // later Refit. Objects inserted in between are kept in a short unsorted list that queries scan linearly.
+    //
+    // Not thread-safe. Queries may run concurrently with each other, but not with Insert, Move, Remove or Refit,
+    // and only see moves once Refit ran.
+    class SpatialIndex
+    {
+    public:
+        using ProxyId = uint32_t;
+
+        static constexpr ProxyId INVALID_PROXY = UINT32_MAX;
+        static constexpr uint32_t MAX_LEAF_SIZE = 4;
+        // Deepest a build goes: past depth 64 it stops following the SAH and splits at the median, which
+        // separates up to 2^32 objects within 32 more levels
+        static constexpr uint32_t MAX_DEPTH = 96;
+
+        SpatialIndex();
+        // Waits for a background rebuild still in flight
+        ~SpatialIndex();
+
+        SpatialIndex(const SpatialIndex&) = delete;
+        SpatialIndex& operator=(const SpatialIndex&) = delete;
+
+        ProxyId Insert(Entity entity, const AABB& bounds);
+        void Move(ProxyId proxy, const AABB& bounds);
+        void Remove(ProxyId proxy);
+
+        // Once per frame, after moving objects and before querying them
+        void Refit();
+        // Builds the tree right away, e.g. after loading a level
+        void Rebuild();
+
+        // fn(Entity) for every object whose box overlaps the query, in no particular order
+        template <typename Fn>
+        void QueryAabb(const AABB& bounds, Fn&& fn) const
+        {
+            Traverse([&bounds](const AABB& box) { return Overlaps(box, bounds); }, fn);
+        }
+
+        template <typename Fn>
+        void QuerySphere(const glm::vec3& center, const float radius, Fn&& fn) const
+        {
+            const float radiusSquared = radius * radius;
+            Traverse([&center, radiusSquared](const AABB& box)
+            {
+                const glm::vec3 closest = glm::clamp(center, box.Min, box.Max);
+                const glm::vec3 offset = closest - center;
+                return offset.x * offset.x + offset.y * offset.y + offset.z * offset.z <= radiusSquared;
+            }, fn);
+        }
+
+        template <typename Fn>
+        void QueryFrustum(const Frustum& frustum, Fn&& fn) const
+        {
+            Traverse([&frustum](const AABB& box) { return frustum.Intersects(box); }, fn);
+        }
+
+        // fn(Entity, float distance) for every box the ray enters within maxDistance
+        template <typename Fn>
+        void QueryRay(const Ray& ray, const float maxDistance, Fn&& fn) const
+        {
+            const glm::vec3 inverse = GetInverseDirection(ray);
+            float distance = 0.f;
+            Traverse([&](const AABB& box) { return IntersectRay(ray.Origin, inverse, box, maxDistance, distance); },
+                     [&](const Entity entity) { fn(entity, distance); });
+        }
+
+        // Nearest box along the ray, visiting subtrees front to back so far ones are skipped
+        std::optional<RayHit> Raycast(const Ray& ray, float maxDistance) const;
+
+        uint32_t GetProxyCount() const { return static_cast<uint32_t>(m_Proxies.size() - m_FreeProxies.size()); }
+        uint32_t GetNodeCount() const { return static_cast<uint32_t>(m_Nodes.size()); }
+        // Objects inserted since the last build, which queries test one by one
+        uint32_t GetLooseCount() const { return static_cast<uint32_t>(m_Loose.size()); }
+        uint32_t GetBuildCount() const { return m_BuildCount; }
+        bool IsRebuilding() const { return m_Build != nullptr; }
+
+        uint32_t RebuildInterval = 120;
+
+    private:
+        // Interior nodes have Count 0 and their children at First and First + 1, leaves Count items from First
+        struct Node
+        {
+            AABB Bounds;
+            uint32_t First;
+            uint32_t Count;
+        };
+
+        struct Proxy
+        {
+            AABB Bounds;
+            VoxelicousEngine::Entity Entity;
+            // Leaf holding the proxy, INVALID_PROXY while it's loose or free
+            uint32_t Leaf = INVALID_PROXY;
+            // Position in m_Loose while loose
+            uint32_t LooseIndex = INVALID_PROXY;
+            bool Alive = false;
+        };
+
+        struct BuildTask;
+
+        static bool Overlaps(const AABB& a, const AABB& b)
+        {
+            return a.Min.x <= b.Max.x && a.Max.x >= b.Min.x && a.Min.y <= b.Max.y && a.Max.y >= b.Min.y &&
+                a.Min.z <= b.Max.z && a.Max.z >= b.Min.z;
+        }
+
+        static glm::vec3 GetInverseDirection(const Ray& ray)
+        {
+            // Zero components turn into infinities, which the slab test handles
+            return {1.f / ray.Direction.x, 1.f / ray.Direction.y, 1.f / ray.Direction.z};
+        }
+
+        // Slab test, sets distance to where the ray enters the box
+        static bool IntersectRay(const glm::vec3& origin, const glm::vec3& inverse, const AABB& box,
+                                 const float maxDistance, float& distance)
+        {
+            float entry = 0.f;
+            float exit = maxDistance;
+            for (int axis = 0; axis < 3; axis++)
+            {
+                float t0 = (box.Min[axis] - origin[axis]) * inverse[axis];
+                float t1 = (box.Max[axis] - origin[axis]) * inverse[axis];
+                if (t0 > t1) std::swap(t0, t1);
+                // Written so a NaN from 0 * infinity leaves the interval as it is
+                entry = t0 > entry ? t0 : entry;
+                exit = t1 < exit ? t1 : exit;
+            }
+            distance = entry;
+            return entry <= exit;
+        }
+
+        template <typename Overlap, typename Fn>
+        void Traverse(const Overlap& overlaps, Fn&& fn) const
+        {
+            if (!m_Nodes.empty())
+            {
+                // Deeper than the build allows, see MAX_DEPTH
+                std::array<uint32_t, MAX_DEPTH + 1> stack;
+                uint32_t size = 0;
+                stack[size++] = 0;
+                while (size > 0)
+                {
+                    const Node& node = m_Nodes[stack[--size]];
+                    if (!overlaps(node.Bounds)) continue;
+
+                    if (node.Count == 0)
+                    {
+                        stack[size++] = node.First + 1;
+                        stack[size++] = node.First;
+                        continue;
+                    }
+
+                    for (uint32_t i = node.First; i < node.First + node.Count; i++)
+                    {
+                        if (m_LeafItems[i] == INVALID_PROXY) continue;
+                        const Proxy& proxy = m_Proxies[m_LeafItems[i]];
+                        if (overlaps(proxy.Bounds)) fn(proxy.Entity);
+                    }
+                }
+            }
+
+            for (const ProxyId id : m_Loose)
+            {
+                const Proxy& proxy = m_Proxies[id];
+                if (overlaps(proxy.Bounds)) fn(proxy.Entity);
+            }
+        }
+
+        void MarkLeaf(uint32_t leaf);
+        void RefitLeaf(uint32_t leaf);
+        static void BuildTree(BuildTask& build);
+        std::unique_ptr<BuildTask> CreateBuildTask() const;
+        void StartBuild();
+        void ApplyBuild();
+        void AddLoose(ProxyId id);
+        void RemoveLoose(ProxyId id);
+
+        std::vector<Proxy> m_Proxies;
+        std::vector<ProxyId> m_FreeProxies;
+        // Removed while a build was in flight, whose snapshot may still contain them
+        std::vector<ProxyId> m_PendingFree;
+        std::vector<ProxyId> m_Loose;
+
+        std::vector<Node> m_Nodes;
+        std::vector<uint32_t> m_Parents;
+        // Proxies of the leaves, INVALID_PROXY where one was removed
+        std::vector<ProxyId> m_LeafItems;
+
+        std::vector<uint32_t> m_DirtyLeaves;
+        std::vector<uint8_t> m_LeafDirty;
+        bool m_FullRefit = false;
+
+        std::unique_ptr<BuildTask> m_Build;
+        uint32_t m_RefitsSinceBuild = 0;
+        uint32_t m_BuildCount = 0;
+    };
+}
@@ -1,11 +1,6 @@
 #pragma once
 
-#include "Model.h"
-
-#include <unordered_map>
-#include <memory>
-
-#include <glm/gtc/matrix_transform.hpp>
+#include "Math.h"
 
 namespace VoxelicousEngine
 {
@@ -13,7 +8,9 @@ namespace VoxelicousEngine
     {
         glm::vec3 Translation{0.f, 0.f, 0.f};
         glm::vec3 Scale{1.f, 1.f, 1.f};
-        glm::vec3 Rotation;
+        glm::vec3 Rotation{0.f, 0.f, 0.f};
+
+        bool operator==(const TransformComponent&) const = default;
 
         glm::mat4 Mat4() const
         {
@@ -47,35 +44,4 @@ namespace VoxelicousEngine
             };
         }
     };
-
-    class GameObject
-    {
-    public:
-        using IdT = unsigned int;
-        using Map = std::unordered_map<IdT, GameObject>;
-
-        static GameObject CreateGameObject()
-        {
-            static IdT currentId = 0;
-            return GameObject(currentId++);
-        }
-
-        GameObject(const GameObject&) = delete;
-        GameObject& operator=(const GameObject&) = delete;
-        GameObject(GameObject&&) = default;
-        GameObject& operator=(GameObject&&) = default;
-
-        IdT GetId() const { return m_Id; }
-
-        std::shared_ptr<Model> Model{};
-        glm::vec3 Color{};
-        TransformComponent Transform{};
-
-    private:
-        explicit GameObject(const IdT objId) : m_Id(objId)
-        {
-        }
-
-        IdT m_Id;
-    };
 }
@@ -0,0 +1,354 @@
+#include "vepch.h"
+#include "TransformSystem.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define VE_TRANSFORM_SSE2 1
+#include <emmintrin.h>
+#else
+#define VE_TRANSFORM_SSE2 0
+#endif
+
+namespace VoxelicousEngine
+{
+    namespace
+    {
+        using Batch = std::array<const TransformComponent*, TransformSystem::BATCH_SIZE>;
+        using BatchOutput = std::array<glm::mat4*, TransformSystem::BATCH_SIZE>;
+
+        uint32_t NextVersion(const uint32_t version)
+        {
+            // 0 is the version of a matrix that was never computed
+            return version == UINT32_MAX ? 1 : version + 1;
+        }
+
+        // TransformComponent::Mat4 scales its translation column by w = 2, which the renderer's shaders expect.
+        // A parent's matrix is divided back down to w = 1 before it's applied to a child's Mat4, so the child
+        // carries that convention once instead of once per level of the hierarchy.
+        glm::mat4 ToAffine(glm::mat4 matrix)
+        {
+            matrix[3] = matrix[3] / matrix[3][3];
+            return matrix;
+        }
+
+#if VE_TRANSFORM_SSE2
+        // The three-constant reduction by pi/4 below stays accurate to about this angle
+        constexpr float MAX_BATCHED_ANGLE = 8192.f;
+
+        __m128 Abs(const __m128 x)
+        {
+            return _mm_andnot_ps(_mm_set1_ps(-0.f), x);
+        }
+
+        // Sine and cosine of four angles with the single-precision Cephes polynomials: the angle is reduced to
+        // [-pi/4, pi/4] around the nearest multiple of pi/4 (in three parts, to keep the reduction exact), the
+        // octant picks which polynomial gives the sine and which the cosine, and the signs are patched last.
+        void SinCos(__m128 x, __m128& sin, __m128& cos)
+        {
+            const __m128 signMask = _mm_set1_ps(-0.f);
+            __m128 sinSign = _mm_and_ps(x, signMask);
+            x = Abs(x);
+
+            // Octant, rounded up to even so the reduced angle is centered on 0
+            __m128i octant = _mm_cvttps_epi32(_mm_mul_ps(x, _mm_set1_ps(1.27323954473516f)));
+            octant = _mm_and_si128(_mm_add_epi32(octant, _mm_set1_epi32(1)), _mm_set1_epi32(~1));
+            const __m128 y = _mm_cvtepi32_ps(octant);
+
+            const __m128 sinSwap = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(octant, _mm_set1_epi32(4)), 29));
+            const __m128 cosSign = _mm_castsi128_ps(
+                _mm_slli_epi32(_mm_andnot_si128(_mm_sub_epi32(octant, _mm_set1_epi32(2)), _mm_set1_epi32(4)), 29));
+            // Set in the octants where the sine polynomial gives the sine
+            const __m128 sinPoly = _mm_castsi128_ps(
+                _mm_cmpeq_epi32(_mm_and_si128(octant, _mm_set1_epi32(2)), _mm_setzero_si128()));
+            sinSign = _mm_xor_ps(sinSign, sinSwap);
+
+            x = _mm_add_ps(x, _mm_mul_ps(y, _mm_set1_ps(-0.78515625f)));
+            x = _mm_add_ps(x, _mm_mul_ps(y, _mm_set1_ps(-2.4187564849853515625e-4f)));
+            x = _mm_add_ps(x, _mm_mul_ps(y, _mm_set1_ps(-3.77489497744594108e-8f)));
+            const __m128 z = _mm_mul_ps(x, x);
+
+            __m128 c = _mm_set1_ps(2.443315711809948e-5f);
+            c = _mm_add_ps(_mm_mul_ps(c, z), _mm_set1_ps(-1.388731625493765e-3f));
+            c = _mm_add_ps(_mm_mul_ps(c, z), _mm_set1_ps(4.166664568298827e-2f));
+            c = _mm_mul_ps(_mm_mul_ps(c, z), z);
+            c = _mm_add_ps(_mm_sub_ps(c, _mm_mul_ps(z, _mm_set1_ps(0.5f))), _mm_set1_ps(1.f));
+
+            __m128 s = _mm_set1_ps(-1.9515295891e-4f);
+            s = _mm_add_ps(_mm_mul_ps(s, z), _mm_set1_ps(8.3321608736e-3f));
+            s = _mm_add_ps(_mm_mul_ps(s, z), _mm_set1_ps(-1.6666654611e-1f));
+            s = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(s, z), x), x);
+
+            sin = _mm_xor_ps(_mm_or_ps(_mm_and_ps(sinPoly, s), _mm_andnot_ps(sinPoly, c)), sinSign);
+            cos = _mm_xor_ps(_mm_or_ps(_mm_and_ps(sinPoly, c), _mm_andnot_ps(sinPoly, s)), cosSign);
+        }
+
+        // Writes one column of each of the four matrices from the column's rows across the batch
+        void StoreColumn(__m128 x, __m128 y, __m128 z, __m128 w, const BatchOutput& matrices, const uint32_t count,
+                         const int column)
+        {
+            _MM_TRANSPOSE4_PS(x, y, z, w);
+            const std::array columns{x, y, z, w};
+            for (uint32_t i = 0; i < count; i++)
+            {
+                _mm_storeu_ps(&(*matrices[i])[column][0], columns[i]);
+            }
+        }
+#endif
+
+        // TransformComponent::Mat4 of count (1 to BATCH_SIZE) transforms, four objects per SSE2 register
+        void ComputeBatch(Batch transforms, const BatchOutput& matrices, const uint32_t count)
+        {
+#if VE_TRANSFORM_SSE2
+            // Unused lanes repeat the first transform and aren't stored
+            for (uint32_t i = count; i < TransformSystem::BATCH_SIZE; i++)
+            {
+                transforms[i] = transforms[0];
+            }
+
+            const auto load = [&transforms](const glm::vec3 TransformComponent::* member, const int axis)
+            {
+                return _mm_setr_ps((transforms[0]->*member)[axis], (transforms[1]->*member)[axis],
+                                   (transforms[2]->*member)[axis], (transforms[3]->*member)[axis]);
+            };
+
+            const __m128 rx = load(&TransformComponent::Rotation, 0);
+            const __m128 ry = load(&TransformComponent::Rotation, 1);
+            const __m128 rz = load(&TransformComponent::Rotation, 2);
+            const __m128 limit = _mm_set1_ps(MAX_BATCHED_ANGLE);
+            const __m128 largest = _mm_max_ps(Abs(rx), _mm_max_ps(Abs(ry), Abs(rz)));
+            // NaN angles fail the compare as well, so Mat4 decides what they turn into
+            if (_mm_movemask_ps(_mm_cmple_ps(largest, limit)) == 0xF)
+            {
+                __m128 s1, c1, s2, c2, s3, c3;
+                SinCos(ry, s1, c1);
+                SinCos(rx, s2, c2);
+                SinCos(rz, s3, c3);
+
+                const __m128 sx = load(&TransformComponent::Scale, 0);
+                const __m128 sy = load(&TransformComponent::Scale, 1);
+                const __m128 sz = load(&TransformComponent::Scale, 2);
+                const __m128 c1c3 = _mm_mul_ps(c1, c3);
+                const __m128 s1s2 = _mm_mul_ps(s1, s2);
+                const __m128 c1s2 = _mm_mul_ps(c1, s2);
+                const __m128 zero = _mm_setzero_ps();
+
+                StoreColumn(
+                    _mm_mul_ps(sx, _mm_add_ps(c1c3, _mm_mul_ps(s1s2, s3))),
+                    _mm_mul_ps(sx, _mm_mul_ps(c2, s3)),
+                    _mm_mul_ps(sx, _mm_sub_ps(_mm_mul_ps(c1s2, s3), _mm_mul_ps(c3, s1))),
+                    zero, matrices, count, 0);
+                StoreColumn(
+                    _mm_mul_ps(sy, _mm_sub_ps(_mm_mul_ps(c3, s1s2), _mm_mul_ps(c1, s3))),
+                    _mm_mul_ps(sy, _mm_mul_ps(c2, c3)),
+                    _mm_mul_ps(sy, _mm_add_ps(_mm_mul_ps(c1c3, s2), _mm_mul_ps(s1, s3))),
+                    zero, matrices, count, 1);
+                StoreColumn(
+                    _mm_mul_ps(sz, _mm_mul_ps(c2, s1)),
+                    _mm_xor_ps(_mm_mul_ps(sz, s2), _mm_set1_ps(-0.f)),
+                    _mm_mul_ps(sz, _mm_mul_ps(c1, c2)),
+                    zero, matrices, count, 2);
+
+                // Mat4 scales the translation column by 2, w included
+                const __m128 two = _mm_set1_ps(2.f);
+                StoreColumn(
+                    _mm_mul_ps(load(&TransformComponent::Translation, 0), two),
+                    _mm_mul_ps(load(&TransformComponent::Translation, 1), two),
+                    _mm_mul_ps(load(&TransformComponent::Translation, 2), two),
+                    two, matrices, count, 3);
+                return;
+            }
+#endif
+            for (uint32_t i = 0; i < count; i++)
+            {
+                *matrices[i] = transforms[i]->Mat4();
+            }
+        }
+    }
+
+    void TransformSystem::Update(Scene& scene)
+    {
+        VE_PROFILE_FUNCTION();
+
+        m_UpdateNumber++;
+        std::atomic<uint32_t> recomputed{0};
+        scene.ParallelForEachChunk<const TransformComponent, WorldTransformComponent>(
+            [&recomputed](std::span<const Entity>, const std::span<const TransformComponent> locals,
+                          const std::span<WorldTransformComponent> worlds)
+        {
+            Batch batch{};
+            BatchOutput outputs{};
+            uint32_t count = 0;
+            uint32_t chunkRecomputed = 0;
+            for (size_t row = 0; row < locals.size(); row++)
+            {
+                WorldTransformComponent& cached = worlds[row];
+                if (!cached.Dirty && cached.Local == locals[row]) continue;
+
+                cached.Local = locals[row];
+                cached.Dirty = false;
+                cached.Version = NextVersion(cached.Version);
+                batch[count] = &cached.Local;
+                outputs[count] = &cached.Matrix;
+                if (++count == BATCH_SIZE)
+                {
+                    ComputeBatch(batch, outputs, count);
+                    chunkRecomputed += count;
+                    count = 0;
+                }
+            }
+            if (count > 0)
+            {
+                ComputeBatch(batch, outputs, count);
+                chunkRecomputed += count;
+            }
+            recomputed.fetch_add(chunkRecomputed, std::memory_order_relaxed);
+        }, Scene::GetMask<ParentComponent>());
+        m_RecomputedCount = recomputed.load(std::memory_order_relaxed);
+
+        UpdateChildren(scene);
+    }
+
+    void TransformSystem::UpdateChildren(Scene& scene)
+    {
+        if (scene.Count<ParentComponent>() == 0)
+        {
+            return;
+        }
+
+        struct Pending
+        {
+            WorldTransformComponent* Target;
+            ParentComponent* Link;
+            // nullptr for children of dead parents, which are placed like roots
+            const WorldTransformComponent* Parent;
+        };
+
+        // A child is resolved once its parent is; children of children wait for the next pass
+        uint32_t resolved;
+        uint32_t unresolved;
+        do
+        {
+            resolved = 0;
+            unresolved = 0;
+            scene.ForEachChunk<const TransformComponent, WorldTransformComponent, ParentComponent>(
+                [&](std::span<const Entity>, const std::span<const TransformComponent> locals,
+                    const std::span<WorldTransformComponent> worlds, const std::span<ParentComponent> links)
+            {
+                std::array<Pending, BATCH_SIZE> pending{};
+                Batch batch{};
+                BatchOutput outputs{};
+                uint32_t count = 0;
+
+                // Children are only marked resolved once their matrix is written, so a child of theirs later
+                // in this pass can't read it half-done
+                const auto flush = [&]
+                {
+                    ComputeBatch(batch, outputs, count);
+                    for (uint32_t i = 0; i < count; i++)
+                    {
+                        if (pending[i].Parent != nullptr)
+                        {
+                            pending[i].Target->Matrix = ToAffine(pending[i].Parent->Matrix) * pending[i].Target->Matrix;
+                        }
+                        pending[i].Link->ResolvedUpdate = m_UpdateNumber;
+                    }
+                    m_RecomputedCount += count;
+                    resolved += count;
+                    count = 0;
+                };
+
+                for (size_t row = 0; row < locals.size(); row++)
+                {
+                    ParentComponent& link = links[row];
+                    if (link.ResolvedUpdate == m_UpdateNumber) continue;
+
+                    const WorldTransformComponent* parent = scene.Get<const WorldTransformComponent>(link.Parent);
+                    const ParentComponent* parentLink = scene.Get<const ParentComponent>(link.Parent);
+                    if (parent != nullptr && parentLink != nullptr && parentLink->ResolvedUpdate != m_UpdateNumber)
+                    {
+                        unresolved++;
+                        continue;
+                    }
+
+                    WorldTransformComponent& cached = worlds[row];
+                    const uint32_t parentVersion = parent != nullptr ? parent->Version : 0;
+                    if (!cached.Dirty && cached.Local == locals[row] && link.ParentVersion == parentVersion)
+                    {
+                        link.ResolvedUpdate = m_UpdateNumber;
+                        resolved++;
+                        continue;
+                    }
+
+                    cached.Local = locals[row];
+                    cached.Dirty = false;
+                    cached.Version = NextVersion(cached.Version);
+                    link.ParentVersion = parentVersion;
+                    pending[count] = {&cached, &link, parent};
+                    batch[count] = &cached.Local;
+                    outputs[count] = &cached.Matrix;
+                    if (++count == BATCH_SIZE)
+                    {
+                        flush();
+                    }
+                }
+                if (count > 0)
+                {
+                    flush();
+                }
+            });
+        }
+        while (unresolved > 0 && resolved > 0);
+
+        if (unresolved > 0)
+        {
+            VE_CORE_WARN("{0} entities are part of a parent cycle, their transforms are stale", unresolved);
+        }
+    }
+
+    bool TransformSystem::SetParent(Scene& scene, const Entity child, const Entity parent)
+    {
+        if (parent.IsNull())
+        {
+            scene.Remove<ParentComponent>(child);
+        }
+        else
+        {
+            for (Entity ancestor = parent; !ancestor.IsNull();)
+            {
+                if (ancestor == child)
+                {
+                    VE_CORE_WARN("Parenting an entity to itself or a descendant would form a cycle");
+                    return false;
+                }
+                const ParentComponent* link = scene.Get<const ParentComponent>(ancestor);
+                ancestor = link != nullptr ? link->Parent : Entity{};
+            }
+            scene.Add(child, ParentComponent{parent});
+        }
+
+        // The local transform didn't change, but the matrix relative to the new parent did
+        if (WorldTransformComponent* cached = scene.Get<WorldTransformComponent>(child))
+        {
+            cached->Dirty = true;
+        }
+        return true;
+    }
+
+    void TransformSystem::ComputeMatrices(const std::span<const TransformComponent> transforms,
+                                          const std::span<glm::mat4> matrices)
+    {
+        VE_CORE_ASSERT(transforms.size() == matrices.size(), "One matrix per transform!");
+
+        Batch batch{};
+        BatchOutput outputs{};
+        for (size_t begin = 0; begin < transforms.size(); begin += BATCH_SIZE)
+        {
+            const auto count = static_cast<uint32_t>(std::min<size_t>(BATCH_SIZE, transforms.size() - begin));
+            for (uint32_t i = 0; i < count; i++)
+            {
+                batch[i] = &transforms[begin + i];
+                outputs[i] = &matrices[begin + i];
+            }
+            ComputeBatch(batch, outputs, count);
+        }
+    }
+}
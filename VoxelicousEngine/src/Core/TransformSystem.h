@@ -0,0 +1,40 @@
+#pragma once
+
+#include "Components.h"
+#include "Scene.h"
+
+namespace VoxelicousEngine
+{
+    // Keeps the WorldTransformComponent of every entity in sync with its TransformComponent and parents.
+    //
+    // An entity is dirty when its local transform differs from the one its cached matrix was computed from, or
+    // when its parent's matrix changed since; clean entities cost one compare per update. Dirty local matrices
+    // are computed four at a time with SSE2 (vectorised sincos), falling back to TransformComponent::Mat4
+    // without SSE2 or for angles beyond the range reduction's accuracy.
+    //
+    // Roots are updated in parallel chunks on the job system. Children are resolved in passes after them, each
+    // pass handling the children whose parent is already up to date, so a hierarchy costs one pass per level.
+    class TransformSystem
+    {
+    public:
+        static constexpr uint32_t BATCH_SIZE = 4;
+
+        void Update(Scene& scene);
+
+        // Structural change, see Scene. A null parent detaches the child. Returns false, leaving the hierarchy
+        // unchanged, when parent is the child or one of its descendants.
+        static bool SetParent(Scene& scene, Entity child, Entity parent);
+
+        // Batched TransformComponent::Mat4
+        static void ComputeMatrices(std::span<const TransformComponent> transforms, std::span<glm::mat4> matrices);
+
+        // Matrices recomputed by the last update
+        uint32_t GetRecomputedCount() const { return m_RecomputedCount; }
+
+    private:
+        void UpdateChildren(Scene& scene);
+
+        uint64_t m_UpdateNumber = 0;
+        uint32_t m_RecomputedCount = 0;
+    };
+}
@@ -12,11 +12,14 @@ namespace VoxelicousEngine
         std::string Title;
         unsigned int Width;
         unsigned int Height;
+        // Render into offscreen images without creating an OS window or surface
+        bool Headless;
 
         explicit WindowProps(std::string title = "VoxelicousEngine",
                              const unsigned int width = 1280,
-                             const unsigned int height = 720)
-            : Title(std::move(title)), Width(width), Height(height)
+                             const unsigned int height = 720,
+                             const bool headless = false)
+            : Title(std::move(title)), Width(width), Height(height), Headless(headless)
         {
         }
     };
@@ -36,6 +39,7 @@ namespace VoxelicousEngine
 
         virtual VkSurfaceKHR GetVkSurfaceKHR() const = 0;
         virtual GLFWwindow* GetGLFW_Window() const = 0;
+        virtual bool IsHeadless() const = 0;
         //virtual SwapChain& GetSwapChain() const = 0;
 
         // Window attributes
@@ -65,17 +65,16 @@ namespace VoxelicousEngine
 
     class EventDispatcher
     {
-        template <typename T>
-        using EventFn = std::function<bool(T&)>;
-
     public:
         explicit EventDispatcher(Event& event)
             : m_Event(event)
         {
         }
 
-        template <typename T>
-        bool Dispatch(EventFn<T> func)
+        // F is any callable taking T&; taking it as a template instead of a std::function keeps dispatch
+        // free of allocations and lets the handler be inlined
+        template <typename T, typename F>
+        bool Dispatch(const F& func)
         {
             if (m_Event.GetEventType() == T::GetStaticType())
             {
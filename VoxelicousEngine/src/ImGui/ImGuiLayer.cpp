@@ -2,6 +2,7 @@
 #include "ImGuiLayer.h"
 
 #include "imgui.h"
+#include "Core/FrameStats.h"
 #include "Platform/Vulkan/ImGuiVulkanRenderer.h"
 #include "Platform/GLFW/ImGuiGlfwRenderer.h"
 
@@ -15,8 +16,8 @@ namespace VoxelicousEngine
         alignas(16) glm::vec4 lightColor{ 1.f };
     };*/
 
-    ImGuiLayer::ImGuiLayer(Renderer& renderer, Device& device, DescriptorPool& globalPool) : Layer("ImGuiLayer"),
-        m_Renderer(renderer), m_Device(device), m_GlobalPool(globalPool)
+    ImGuiLayer::ImGuiLayer(Renderer& renderer, Device& device) : Layer("ImGuiLayer"),
+        m_Renderer(renderer), m_Device(device)
     {
     }
 
@@ -28,12 +29,19 @@ namespace VoxelicousEngine
         ImGui::StyleColorsDark();
 
         ImGui_ImplGlfw_InitForVulkan(m_Window.GetGLFW_Window(), true);
+
+        m_DescriptorPool = DescriptorPool::Builder(m_Device)
+                           .SetMaxSets(IMGUI_MAX_TEXTURES)
+                           .AddPoolSize(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, IMGUI_MAX_TEXTURES)
+                           .SetPoolFlags(VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT)
+                           .Build();
+
         const App& app = App::Get();
         ImGui_ImplVulkan_InitInfo initInfo = {};
         initInfo.Instance = app.GetInstance().Get();
         initInfo.PhysicalDevice = m_Device.GetPhysicalDevice();
         initInfo.Device = m_Device.GetDevice();
-        initInfo.DescriptorPool = m_GlobalPool.GetDescriptorPool();
+        initInfo.DescriptorPool = m_DescriptorPool->GetDescriptorPool();
         initInfo.ImageCount = SwapChain::MAX_FRAMES_IN_FLIGHT;
         initInfo.Queue = m_Device.GetGraphicsQueue();
         initInfo.MinImageCount = 2;
@@ -53,10 +61,13 @@ namespace VoxelicousEngine
         ImGui_ImplVulkan_Shutdown();
         ImGui_ImplGlfw_Shutdown();
         ImGui::DestroyContext();
+        m_DescriptorPool.reset();
     }
 
     void ImGuiLayer::OnUpdate(const VkCommandBuffer commandBuffer)
     {
+        VE_ALLOCATION_SCOPE(ImGui);
+
         const auto newTime = std::chrono::steady_clock::now();
         float frameTime = std::chrono::duration<float>(newTime - m_CurrentTime).count();
         m_CurrentTime = newTime;
@@ -67,10 +78,137 @@ namespace VoxelicousEngine
         ImGui_ImplGlfw_NewFrame();
         ImGui::NewFrame();
         ImGui::ShowDemoWindow();
+        DrawRendererSettings();
+        DrawProfiler();
         ImGui::Render();
         ImGui_ImplVulkan_RenderDrawData(ImGui::GetDrawData(), commandBuffer, nullptr);
     }
 
+    void ImGuiLayer::DrawRendererSettings() const
+    {
+        static constexpr VkPresentModeKHR presentModes[] = {
+            VK_PRESENT_MODE_FIFO_KHR, VK_PRESENT_MODE_MAILBOX_KHR, VK_PRESENT_MODE_IMMEDIATE_KHR
+        };
+
+        ImGui::Begin("Renderer");
+
+        if (ImGui::BeginCombo("Present mode", SwapChain::PresentModeToString(m_Renderer.GetPresentMode())))
+        {
+            for (const VkPresentModeKHR presentMode : presentModes)
+            {
+                const bool selected = presentMode == m_Renderer.GetPresentMode();
+                if (ImGui::Selectable(SwapChain::PresentModeToString(presentMode), selected))
+                    m_Renderer.SetPresentMode(presentMode);
+            }
+            ImGui::EndCombo();
+        }
+        ImGui::Text("Active: %s", SwapChain::PresentModeToString(m_Renderer.GetSwapChain().GetPresentMode()));
+
+        int framesInFlight = static_cast<int>(m_Renderer.GetFramesInFlight());
+        if (ImGui::SliderInt("Frames in flight", &framesInFlight,
+                             SwapChain::MIN_FRAMES_IN_FLIGHT, SwapChain::MAX_FRAMES_IN_FLIGHT))
+        {
+            m_Renderer.SetFramesInFlight(static_cast<uint32_t>(framesInFlight));
+        }
+
+        ImGui::End();
+    }
+
+    void ImGuiLayer::DrawProfiler()
+    {
+        const GpuProfiler& profiler = m_Renderer.GetProfiler();
+
+        ImGui::Begin("Profiler");
+
+        if (!profiler.IsSupported())
+            ImGui::TextDisabled("GPU timestamps are not supported on this device");
+
+        if (ImGui::BeginTable("Scopes", 5, ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV))
+        {
+            ImGui::TableSetupColumn("Scope");
+            ImGui::TableSetupColumn("GPU ms");
+            ImGui::TableSetupColumn("GPU avg");
+            ImGui::TableSetupColumn("CPU ms");
+            ImGui::TableSetupColumn("CPU avg");
+            ImGui::TableHeadersRow();
+
+            for (const auto& scope : profiler.GetResults())
+            {
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::Indent(static_cast<float>(scope.Depth) * ImGui::GetStyle().IndentSpacing);
+                ImGui::TextUnformatted(scope.Name);
+                ImGui::Unindent(static_cast<float>(scope.Depth) * ImGui::GetStyle().IndentSpacing);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.3f", scope.GpuMs);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.3f", scope.AverageGpuMs);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.3f", scope.CpuMs);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.3f", scope.AverageCpuMs);
+            }
+            ImGui::EndTable();
+        }
+
+        ImGui::Separator();
+        ImGui::Text("Last %zu frames", FrameStats::WINDOW_SIZE);
+        if (ImGui::BeginTable("FrameStats", 5, ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV))
+        {
+            ImGui::TableSetupColumn("Metric (ms)");
+            ImGui::TableSetupColumn("p50");
+            ImGui::TableSetupColumn("p95");
+            ImGui::TableSetupColumn("p99");
+            ImGui::TableSetupColumn("max");
+            ImGui::TableHeadersRow();
+
+            for (size_t i = 0; i < static_cast<size_t>(FrameMetric::Count); i++)
+            {
+                const auto metric = static_cast<FrameMetric>(i);
+                const FrameStats::Summary summary = FrameStats::Get().GetWindowSummary(metric);
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(FrameStats::GetMetricName(metric));
+                ImGui::TableNextColumn();
+                ImGui::Text("%.3f", summary.P50Ms);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.3f", summary.P95Ms);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.3f", summary.P99Ms);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.3f", summary.MaxMs);
+            }
+            ImGui::EndTable();
+        }
+
+        if (AllocationTracker::IsEnabled())
+        {
+            // The previous frame's report; the current frame is still running
+            const AllocationFrameReport& allocations = AllocationTracker::GetLastFrame();
+            ImGui::Separator();
+            ImGui::Text("Allocations last frame: %llu (%llu bytes)",
+                        static_cast<unsigned long long>(allocations.Total.Allocations),
+                        static_cast<unsigned long long>(allocations.Total.Bytes));
+            for (size_t i = 0; i < allocations.Tags.size(); i++)
+            {
+                if (const AllocationCounters& counters = allocations.Tags[i]; counters.Allocations > 0)
+                {
+                    const auto tag = static_cast<AllocationTag>(i);
+                    ImGui::BulletText("%s: %llu (%llu bytes)", AllocationTracker::GetTagName(tag),
+                                      static_cast<unsigned long long>(counters.Allocations),
+                                      static_cast<unsigned long long>(counters.Bytes));
+                }
+            }
+        }
+
+        ImGui::InputText("##ExportPath", m_ProfilerExportPath.data(), m_ProfilerExportPath.size());
+        ImGui::SameLine();
+        if (ImGui::Button("Export CSV"))
+            profiler.ExportCsv(m_ProfilerExportPath.data());
+
+        ImGui::End();
+    }
+
     void ImGuiLayer::OnEvent(Event& event)
     {
     }
@@ -13,7 +13,7 @@ namespace VoxelicousEngine
     class ImGuiLayer final : public Layer
     {
     public:
-        ImGuiLayer(Renderer& renderer, Device& device, DescriptorPool& globalPool);
+        ImGuiLayer(Renderer& renderer, Device& device);
         ~ImGuiLayer() override;
 
         void OnAttach() override;
@@ -22,17 +22,25 @@ namespace VoxelicousEngine
         void OnEvent(Event& event) override;
 
     private:
+        // Font atlas plus any textures shown through ImGui::Image
+        static constexpr uint32_t IMGUI_MAX_TEXTURES = 64;
+
+        void DrawRendererSettings() const;
+        void DrawProfiler();
+
         Renderer& m_Renderer;
         Device& m_Device;
-        DescriptorPool& m_GlobalPool;
+        // The backend frees its texture sets individually, so it gets its own pool instead of an allocator
+        std::unique_ptr<DescriptorPool> m_DescriptorPool;
         Window& m_Window = App::Get().GetWindow();
 
         std::chrono::steady_clock::time_point m_CurrentTime;
+        std::array<char, 256> m_ProfilerExportPath{"gpu_profile.csv"};
 
-        std::unique_ptr<DescriptorSetLayout> m_GlobalSetLayout = DescriptorSetLayout::Builder(m_Device)
+        std::shared_ptr<DescriptorSetLayout> m_GlobalSetLayout = DescriptorSetLayout::Builder(m_Device)
                                                                  .AddBinding(
                                                                      0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
                                                                      VK_SHADER_STAGE_ALL_GRAPHICS)
-                                                                 .Build();
+                                                                 .BuildCached();
     };
 }
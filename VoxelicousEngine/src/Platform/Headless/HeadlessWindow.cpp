@@ -0,0 +1,31 @@
+#include "vepch.h"
+#include "HeadlessWindow.h"
+
+namespace VoxelicousEngine
+{
+    HeadlessWindow::HeadlessWindow(const WindowProps& props)
+    {
+        m_Data.Title = props.Title;
+        m_Data.Width = props.Width;
+        m_Data.Height = props.Height;
+        m_Data.VSync = true;
+
+        VE_CORE_INFO("Creating headless target {0} ({1}, {2})", props.Title, props.Width, props.Height);
+    }
+
+    HeadlessWindow::~HeadlessWindow() = default;
+
+    void HeadlessWindow::OnUpdate()
+    {
+    }
+
+    void HeadlessWindow::SetVSync(const bool enabled)
+    {
+        m_Data.VSync = enabled;
+    }
+
+    bool HeadlessWindow::IsVSync() const
+    {
+        return m_Data.VSync;
+    }
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "Core/Window.h"
+
+namespace VoxelicousEngine
+{
+    // Window stand-in for running without a display (benchmarks, CI). It owns no GLFW window and
+    // no surface, which makes the Renderer fall back to offscreen images instead of a swap chain.
+    class HeadlessWindow final : public Window
+    {
+    public:
+        explicit HeadlessWindow(const WindowProps& props);
+        ~HeadlessWindow() override;
+
+        void OnUpdate() override;
+
+        unsigned int GetWidth() const override { return m_Data.Width; }
+        unsigned int GetHeight() const override { return m_Data.Height; }
+
+        VkSurfaceKHR GetVkSurfaceKHR() const override { return VK_NULL_HANDLE; }
+        GLFWwindow* GetGLFW_Window() const override { return nullptr; }
+        bool IsHeadless() const override { return true; }
+
+        // Window attributes
+        void SetEventCallback(const EventCallbackFn& callback) override { m_Data.EventCallback = callback; }
+        void SetVSync(bool enabled) override;
+        bool IsVSync() const override;
+
+    private:
+        struct WindowData
+        {
+            std::string Title;
+            unsigned int Width;
+            unsigned int Height;
+            bool VSync;
+
+            EventCallbackFn EventCallback;
+        };
+
+        WindowData m_Data;
+    };
+}
@@ -2,6 +2,7 @@
 #include "WindowsWindow.h"
 
 #include "Core/App.h"
+#include "Platform/Headless/HeadlessWindow.h"
 #include "Events/AppEvent.h"
 #include "Events/MouseEvent.h"
 #include "Events/KeyEvent.h"
@@ -10,6 +11,9 @@ namespace VoxelicousEngine
 {
     Window* Window::Create(Instance& instance, const WindowProps& props)
     {
+        if (props.Headless)
+            return new HeadlessWindow(props);
+
         return new WindowsWindow(instance, props);
     }
 
@@ -134,7 +138,7 @@ namespace VoxelicousEngine
 
     void WindowsWindow::SetVSync(const bool enabled)
     {
-        // TODO: Vulkan VSYNC
+        // Picked up by the Renderer at the start of the next frame, which rebuilds the swap chain
         m_Data.VSync = enabled;
     }
 
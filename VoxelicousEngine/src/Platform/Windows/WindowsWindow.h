@@ -17,6 +17,7 @@ namespace VoxelicousEngine
 
         VkSurfaceKHR GetVkSurfaceKHR() const override { return m_VkSurface; }
         GLFWwindow* GetGLFW_Window() const override { return m_Window; }
+        bool IsHeadless() const override { return false; }
 
         //inline SwapChain& GetSwapChain() const override { return ; }
 
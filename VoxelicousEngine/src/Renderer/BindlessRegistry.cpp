@@ -0,0 +1,140 @@
+#include "vepch.h"
+#include "BindlessRegistry.h"
+#include "SwapChain.h"
+#include "Texture.h"
+
+namespace VoxelicousEngine
+{
+    uint32_t BindlessRegistry::IndexAllocator::Allocate()
+    {
+        if (!Free.empty())
+        {
+            const uint32_t index = Free.back();
+            Free.pop_back();
+            return index;
+        }
+        return Next < Capacity ? Next++ : INVALID_INDEX;
+    }
+
+    void BindlessRegistry::IndexAllocator::Release(const uint32_t index, const uint64_t frameNumber)
+    {
+        assert(index < Next && "Releasing an index that was never allocated");
+        Retired.emplace_back(index, frameNumber);
+    }
+
+    void BindlessRegistry::IndexAllocator::Collect(const uint64_t frameNumber)
+    {
+        // Retired in frame order, so the reusable ones are at the front
+        size_t count = 0;
+        while (count < Retired.size() && Retired[count].second + SwapChain::MAX_FRAMES_IN_FLIGHT <= frameNumber)
+        {
+            Free.push_back(Retired[count].first);
+            count++;
+        }
+        Retired.erase(Retired.begin(), Retired.begin() + static_cast<ptrdiff_t>(count));
+    }
+
+    BindlessRegistry::BindlessRegistry(Device& device) : m_Device{device}
+    {
+        assert(device.IsBindlessSupported() && "Bindless descriptors need descriptor indexing");
+
+        const BindlessLimits& limits = device.GetBindlessLimits();
+        m_Textures.Capacity = std::min(MAX_TEXTURES, limits.MaxSampledImages);
+        m_Buffers.Capacity = std::min(MAX_BUFFERS, limits.MaxStorageBuffers);
+
+        // Unused slots may stay unwritten, and slots the GPU isn't reading may be rewritten while the set is bound
+        constexpr VkDescriptorBindingFlags bindingFlags = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT |
+            VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT;
+        m_SetLayout = DescriptorSetLayout::Builder(m_Device)
+                      .AddBinding(TEXTURE_BINDING, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_ALL,
+                                  m_Textures.Capacity, bindingFlags)
+                      .AddBinding(BUFFER_BINDING, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_ALL,
+                                  m_Buffers.Capacity, bindingFlags)
+                      .SetFlags(VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT)
+                      .BuildCached();
+
+        m_Pool = DescriptorPool::Builder(m_Device)
+                 .SetMaxSets(1)
+                 .AddPoolSize(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, m_Textures.Capacity)
+                 .AddPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, m_Buffers.Capacity)
+                 .SetPoolFlags(VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT)
+                 .Build();
+        if (!m_Pool->AllocateDescriptor(m_SetLayout->GetDescriptorSetLayout(), m_DescriptorSet))
+        {
+            throw std::runtime_error("failed to allocate bindless descriptor set!");
+        }
+
+        VE_CORE_INFO("Bindless descriptors enabled: {} textures, {} storage buffers",
+                     m_Textures.Capacity, m_Buffers.Capacity);
+    }
+
+    BindlessRegistry::~BindlessRegistry() = default;
+
+    void BindlessRegistry::BeginFrame()
+    {
+        m_FrameNumber++;
+        m_Textures.Collect(m_FrameNumber);
+        m_Buffers.Collect(m_FrameNumber);
+    }
+
+    uint32_t BindlessRegistry::RegisterTexture(
+        const VkImageView imageView, const VkSampler sampler, const VkImageLayout imageLayout)
+    {
+        const uint32_t index = m_Textures.Allocate();
+        if (index == INVALID_INDEX)
+        {
+            VE_CORE_ERROR("Bindless texture array is full ({} textures)", m_Textures.Capacity);
+            return INVALID_INDEX;
+        }
+
+        const VkDescriptorImageInfo imageInfo{sampler, imageView, imageLayout};
+        VkWriteDescriptorSet write{};
+        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.dstSet = m_DescriptorSet;
+        write.dstBinding = TEXTURE_BINDING;
+        write.dstArrayElement = index;
+        write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        write.descriptorCount = 1;
+        write.pImageInfo = &imageInfo;
+        vkUpdateDescriptorSets(m_Device.GetDevice(), 1, &write, 0, nullptr);
+        return index;
+    }
+
+    uint32_t BindlessRegistry::RegisterTexture(const Texture& texture)
+    {
+        return RegisterTexture(texture.GetImageView(), texture.GetSampler());
+    }
+
+    uint32_t BindlessRegistry::RegisterBuffer(
+        const VkBuffer buffer, const VkDeviceSize offset, const VkDeviceSize range)
+    {
+        const uint32_t index = m_Buffers.Allocate();
+        if (index == INVALID_INDEX)
+        {
+            VE_CORE_ERROR("Bindless buffer array is full ({} buffers)", m_Buffers.Capacity);
+            return INVALID_INDEX;
+        }
+
+        const VkDescriptorBufferInfo bufferInfo{buffer, offset, range};
+        VkWriteDescriptorSet write{};
+        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.dstSet = m_DescriptorSet;
+        write.dstBinding = BUFFER_BINDING;
+        write.dstArrayElement = index;
+        write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        write.descriptorCount = 1;
+        write.pBufferInfo = &bufferInfo;
+        vkUpdateDescriptorSets(m_Device.GetDevice(), 1, &write, 0, nullptr);
+        return index;
+    }
+
+    void BindlessRegistry::ReleaseTexture(const uint32_t index)
+    {
+        m_Textures.Release(index, m_FrameNumber);
+    }
+
+    void BindlessRegistry::ReleaseBuffer(const uint32_t index)
+    {
+        m_Buffers.Release(index, m_FrameNumber);
+    }
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "Descriptors.h"
+
+namespace VoxelicousEngine
+{
+    class Texture;
+
+    // One descriptor set holding large, partially bound, update-after-bind arrays of textures and storage buffers.
+    // Resources are registered once and referenced from shaders by index (e.g. a material's texture index), so
+    // switching materials never rebinds descriptor sets. Material textures are TextureArrays, which register
+    // themselves on creation; shaders declare the arrays as
+    //
+    //   #extension GL_EXT_nonuniform_qualifier : require
+    //   layout (set = N, binding = 0) uniform sampler2DArray bindlessTextures[];
+    //   layout (set = N, binding = 1) readonly buffer BindlessBuffer { uint data[]; } bindlessBuffers[];
+    //
+    // and index them with nonuniformEXT() when the index may differ within a draw. Only available when
+    // Device::IsBindlessSupported().
+    class BindlessRegistry
+    {
+    public:
+        static constexpr uint32_t TEXTURE_BINDING = 0;
+        static constexpr uint32_t BUFFER_BINDING = 1;
+        static constexpr uint32_t MAX_TEXTURES = 16384;
+        static constexpr uint32_t MAX_BUFFERS = 4096;
+        static constexpr uint32_t INVALID_INDEX = UINT32_MAX;
+        // Material 0 draws an object with its vertex colours
+        static constexpr uint32_t NO_MATERIAL = 0;
+
+        // The material index of a texture array layer, as stored in MeshComponent::MaterialId and read by
+        // simple.frag: the texture index plus one in the high 16 bits, the layer in the low 16 bits
+        static constexpr uint32_t MakeMaterialIndex(const uint32_t textureIndex, const uint32_t layer)
+        {
+            return (textureIndex + 1) << 16 | layer;
+        }
+
+        static_assert(MAX_TEXTURES < 0xFFFF, "Texture indices must fit the material index");
+
+        explicit BindlessRegistry(Device& device);
+        ~BindlessRegistry();
+
+        BindlessRegistry(const BindlessRegistry&) = delete;
+        BindlessRegistry& operator=(const BindlessRegistry&) = delete;
+
+        // Called once per frame after the frame's fence wait, makes released indices reusable once no frame in
+        // flight can still read them
+        void BeginFrame();
+
+        // Returns the array index to use in shaders, or INVALID_INDEX when the array is full
+        uint32_t RegisterTexture(
+            VkImageView imageView, VkSampler sampler,
+            VkImageLayout imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+        uint32_t RegisterTexture(const Texture& texture);
+        uint32_t RegisterBuffer(VkBuffer buffer, VkDeviceSize offset = 0, VkDeviceSize range = VK_WHOLE_SIZE);
+
+        // The resource must stay alive until MAX_FRAMES_IN_FLIGHT frames have passed
+        void ReleaseTexture(uint32_t index);
+        void ReleaseBuffer(uint32_t index);
+
+        VkDescriptorSet GetDescriptorSet() const { return m_DescriptorSet; }
+        const std::shared_ptr<DescriptorSetLayout>& GetSetLayout() const { return m_SetLayout; }
+        uint32_t GetTextureCapacity() const { return m_Textures.Capacity; }
+        uint32_t GetBufferCapacity() const { return m_Buffers.Capacity; }
+
+    private:
+        // Hands out array slots; released slots wait out the frames in flight before they are reused
+        struct IndexAllocator
+        {
+            uint32_t Capacity = 0;
+            uint32_t Next = 0;
+            std::vector<uint32_t> Free;
+            std::vector<std::pair<uint32_t, uint64_t>> Retired;
+
+            uint32_t Allocate();
+            void Release(uint32_t index, uint64_t frameNumber);
+            void Collect(uint64_t frameNumber);
+        };
+
+        Device& m_Device;
+        std::shared_ptr<DescriptorSetLayout> m_SetLayout;
+        std::unique_ptr<DescriptorPool> m_Pool;
+        VkDescriptorSet m_DescriptorSet{VK_NULL_HANDLE};
+
+        IndexAllocator m_Textures;
+        IndexAllocator m_Buffers;
+        uint64_t m_FrameNumber{0};
+    };
+}
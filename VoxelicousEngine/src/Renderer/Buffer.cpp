@@ -47,6 +47,20 @@ namespace VoxelicousEngine
         device.CreateBuffer(m_BufferSize, usageFlags, memoryPropertyFlags, m_Buffer, m_Memory);
     }
 
+    Buffer::Buffer(Buffer&& other) noexcept
+        : m_Device{other.m_Device},
+          m_Mapped{std::exchange(other.m_Mapped, nullptr)},
+          m_Buffer{std::exchange(other.m_Buffer, VK_NULL_HANDLE)},
+          m_Memory{std::exchange(other.m_Memory, VK_NULL_HANDLE)},
+          m_BufferSize{other.m_BufferSize},
+          m_InstanceCount{other.m_InstanceCount},
+          m_InstanceSize{other.m_InstanceSize},
+          m_AlignmentSize{other.m_AlignmentSize},
+          m_UsageFlags{other.m_UsageFlags},
+          m_MemoryPropertyFlags{other.m_MemoryPropertyFlags}
+    {
+    }
+
     Buffer::~Buffer()
     {
         Unmap();
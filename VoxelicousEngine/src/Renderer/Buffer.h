@@ -18,6 +18,8 @@ namespace VoxelicousEngine
 
         Buffer(const Buffer&) = delete;
         Buffer& operator=(const Buffer&) = delete;
+        // The moved-from buffer is left empty and destroys nothing
+        Buffer(Buffer&& other) noexcept;
 
         VkResult Map(VkDeviceSize size = VK_WHOLE_SIZE, VkDeviceSize offset = 0);
         void Unmap();
@@ -36,7 +38,7 @@ namespace VoxelicousEngine
         void* GetMappedMemory() const { return m_Mapped; }
         uint32_t GetInstanceCount() const { return m_InstanceCount; }
         VkDeviceSize GetInstanceSize() const { return m_InstanceSize; }
-        VkDeviceSize GetAlignmentSize() const { return m_InstanceSize; }
+        VkDeviceSize GetAlignmentSize() const { return m_AlignmentSize; }
         VkBufferUsageFlags GetUsageFlags() const { return m_UsageFlags; }
         VkMemoryPropertyFlags GetMemoryPropertyFlags() const { return m_MemoryPropertyFlags; }
         VkDeviceSize GetBufferSize() const { return m_BufferSize; }
@@ -1,7 +1,9 @@
 #include "vepch.h"
 #include "DefaultLayer.h"
+#include "Core/Components.h"
 #include "Core/Model.h"
-#include "Core/GameObject.h"
+#include "TextureUploader.h"
+#include "Assets/MipGenerator.h"
 
 namespace VoxelicousEngine
 {
@@ -26,6 +28,35 @@ namespace VoxelicousEngine
         }
     };
 
+    // A checkered 16x16 block texture per cube, each layer in its own tint
+    static TextureData MakeBlockTextures(const uint32_t layerCount)
+    {
+        constexpr uint32_t size = 16;
+        constexpr uint8_t tints[3][3] = {{200, 90, 60}, {90, 170, 70}, {70, 110, 200}};
+
+        TextureData texture;
+        texture.Width = size;
+        texture.Height = size;
+        texture.LayerCount = layerCount;
+        texture.Pixels.resize(texture.GetMipSize(0));
+        for (uint32_t layer = 0; layer < layerCount; layer++)
+        {
+            const uint8_t* tint = tints[layer % 3];
+            for (uint32_t i = 0; i < size * size; i++)
+            {
+                const bool dark = (i % size / 4 + i / size / 4) % 2 == 0;
+                std::byte* pixel = texture.Pixels.data() + (static_cast<size_t>(layer) * size * size + i) * 4;
+                for (uint32_t channel = 0; channel < 3; channel++)
+                {
+                    pixel[channel] = static_cast<std::byte>(dark ? tint[channel] / 2 : tint[channel]);
+                }
+                pixel[3] = std::byte{255};
+            }
+        }
+        MipGenerator::Generate(texture);
+        return texture;
+    }
+
     struct GlobalUbo
     {
         glm::mat4 Projection{1.f};
@@ -35,8 +66,8 @@ namespace VoxelicousEngine
         alignas(16) glm::vec4 LightColor{1.f};
     };
 
-    DefaultLayer::DefaultLayer(Renderer& renderer, Device& device, DescriptorPool& globalPool) : Layer("DefaultLayer"),
-        m_Renderer(renderer), m_Device(device), m_GlobalPool(globalPool)
+    DefaultLayer::DefaultLayer(Renderer& renderer, Device& device, DescriptorAllocator& globalAllocator) : Layer("DefaultLayer"),
+        m_Renderer(renderer), m_Device(device), m_GlobalAllocator(globalAllocator)
     {
     }
 
@@ -44,50 +75,62 @@ namespace VoxelicousEngine
 
     void DefaultLayer::OnAttach()
     {
-        m_UboBuffers = std::vector<std::unique_ptr<Buffer>>(SwapChain::MAX_FRAMES_IN_FLIGHT);
-        for (auto& uboBuffer : m_UboBuffers)
+        WriteGlobalDescriptorSet();
+
+        // All three cubes share one upload
+        m_VoxelMesh = m_ModelCache.Acquire(VOXEL);
+
+        // Without descriptor indexing the cubes keep their vertex colours
+        constexpr uint32_t cubeCount = 3;
+        if (BindlessRegistry* bindless = m_Renderer.GetBindlessRegistry())
         {
-            uboBuffer = std::make_unique<Buffer>(
-                m_Device,
-                sizeof(GlobalUbo),
-                1,
-                VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
-                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT
-            );
-            uboBuffer->Map();
+            TextureData blockTextures = MakeBlockTextures(cubeCount);
+            m_BlockTextures = std::make_unique<TextureArray>(m_Device, blockTextures, Texture::SamplerSettings{},
+                                                             bindless);
+            TextureUploader uploader{m_Device};
+            uploader.Enqueue(*m_BlockTextures, std::move(blockTextures));
+            uploader.Flush();
         }
 
-        m_GlobalDescriptorSets = std::vector<VkDescriptorSet>(SwapChain::MAX_FRAMES_IN_FLIGHT);
-        for (size_t i = 0; i < m_GlobalDescriptorSets.size(); i++)
+        for (uint32_t i = 0; i < cubeCount; i++)
         {
-            auto bufferInfo = m_UboBuffers[i]->DescriptorInfo();
-            DescriptorWriter(*m_GlobalSetLayout, m_GlobalPool)
-                .WriteBuffer(0, &bufferInfo)
-                .Build(m_GlobalDescriptorSets[i]);
+            TransformComponent transform{};
+            transform.Translation = {static_cast<float>(i), 0, 0};
+            MeshComponent mesh{m_VoxelMesh};
+            if (m_BlockTextures && m_BlockTextures->GetBindlessIndex() != BindlessRegistry::INVALID_INDEX)
+            {
+                mesh.MaterialId = BindlessRegistry::MakeMaterialIndex(m_BlockTextures->GetBindlessIndex(), i);
+            }
+            m_Scene.Create(std::move(transform), WorldTransformComponent{}, mesh);
         }
+    }
 
-        const auto myModel = std::make_shared<Model>(m_Device, VOXEL);
-        const auto myModel1 = std::make_shared<Model>(m_Device, VOXEL);
-        const auto myModel2 = std::make_shared<Model>(m_Device, VOXEL);
-
-        auto gameObj = GameObject::CreateGameObject();
-        gameObj.Model = myModel;
-        gameObj.Transform.Translation = {0, 0, 0};
-        m_GameObjects.emplace(gameObj.GetId(), std::move(gameObj));
-
-        auto gameObj1 = GameObject::CreateGameObject();
-        gameObj1.Model = myModel1;
-        gameObj1.Transform.Translation = {1, 0, 0};
-        m_GameObjects.emplace(gameObj1.GetId(), std::move(gameObj1));
-
-        auto gameObj2 = GameObject::CreateGameObject();
-        gameObj2.Model = myModel2;
-        gameObj2.Transform.Translation = {2, 0, 0};
-        m_GameObjects.emplace(gameObj2.GetId(), std::move(gameObj2));
+    void DefaultLayer::WriteGlobalDescriptorSet()
+    {
+        auto uboInfo = m_Renderer.GetFrameRingBuffer().DescriptorInfo(sizeof(GlobalUbo));
+        auto objectTableInfo = m_ObjectTable.DescriptorInfo();
+        DescriptorWriter writer(*m_GlobalSetLayout, m_GlobalAllocator);
+        writer.WriteBuffer(0, &uboInfo).WriteBuffer(1, &objectTableInfo);
+        if (m_GlobalDescriptorSet == VK_NULL_HANDLE)
+        {
+            writer.Build(m_GlobalDescriptorSet);
+        }
+        else
+        {
+            writer.Overwrite(m_GlobalDescriptorSet);
+        }
     }
 
     void DefaultLayer::OnDetach()
     {
+        m_Scene.Clear();
+        m_ModelCache.Release(m_VoxelMesh);
+        m_VoxelMesh = {};
+        if (m_BlockTextures)
+        {
+            // Frames in flight may still sample it
+            m_Device.GetDeletionQueue().Destroy(std::move(m_BlockTextures));
+        }
     }
 
     void DefaultLayer::OnUpdate(const VkCommandBuffer commandBuffer)
@@ -95,30 +138,42 @@ namespace VoxelicousEngine
         const auto newTime = std::chrono::steady_clock::now();
         const float frameTime = std::chrono::duration<float>(newTime - m_CurrentTime).count();
         m_CurrentTime = newTime;
-        m_CameraController.MoveInPlaneXZ(m_Window.GetGLFW_Window(), frameTime, m_ViewerObject);
-        m_Camera.SetViewYXZ(m_ViewerObject.Transform.Translation, m_ViewerObject.Transform.Rotation);
+        if (!m_Window.IsHeadless())
+        {
+            m_CameraController.MoveInPlaneXZ(m_Window.GetGLFW_Window(), frameTime, m_ViewerTransform);
+        }
+        m_Camera.SetViewYXZ(m_ViewerTransform.Translation, m_ViewerTransform.Rotation);
 
         const float aspect = m_Renderer.GetAspectRatio();
         m_Camera.SetPerspectiveProjection(glm::radians(60.f), aspect, .1f, 100.f);
 
-        const int frameIndex = m_Renderer.GetFrameIndex();
+        //update
+        GlobalUbo ubo{};
+        ubo.Projection = m_Camera.GetProjection();
+        ubo.View = m_Camera.GetView();
+        const uint32_t uboOffset = m_Renderer.GetFrameRingBuffer().Push(ubo);
+
+        const auto frameIndex = static_cast<uint32_t>(m_Renderer.GetFrameIndex());
+        m_TransformSystem.Update(m_Scene);
+        if (m_ObjectTable.Update(m_Scene, frameIndex))
+        {
+            WriteGlobalDescriptorSet();
+        }
+
         const FrameInfo frameInfo
         {
-            frameIndex,
+            static_cast<int>(frameIndex),
             frameTime,
             commandBuffer,
             m_Camera,
-            m_GlobalDescriptorSets[frameIndex],
-            m_GameObjects
+            m_GlobalDescriptorSet,
+            uboOffset,
+            m_ObjectTable.GetFrameOffset(frameIndex),
+            m_Scene,
+            m_ObjectTable,
+            m_Renderer.GetFrameArena()
         };
 
-        //update
-        GlobalUbo ubo{};
-        ubo.Projection = m_Camera.GetProjection();
-        ubo.View = m_Camera.GetView();
-        m_UboBuffers[frameIndex]->WriteToBuffer(&ubo);
-        m_UboBuffers[frameIndex]->Flush();
-
         //render
         m_SimpleRendererSystem.RenderGameObjects(frameInfo);
     }
@@ -2,20 +2,21 @@
 
 #include "Core/Window.h"
 #include "Core/Layer.h"
-#include "Buffer.h"
 #include "Descriptors.h"
 #include "Core/App.h"
 #include "Renderer.h"
 #include "Camera.h"
 #include "SimpleRenderSystem.h"
+#include "Texture.h"
 #include "Core/KeyboardCameraController.h"
+#include "Core/TransformSystem.h"
 
 namespace VoxelicousEngine
 {
     class DefaultLayer final : public Layer
     {
     public:
-        explicit DefaultLayer(Renderer& renderer, Device& device, DescriptorPool& globalPool);
+        explicit DefaultLayer(Renderer& renderer, Device& device, DescriptorAllocator& globalAllocator);
         ~DefaultLayer() override;
 
         void OnAttach() override;
@@ -24,32 +25,44 @@ namespace VoxelicousEngine
         void OnEvent(Event& event) override;
 
     private:
+        void WriteGlobalDescriptorSet();
+
         Renderer& m_Renderer;
         Device& m_Device;
-        DescriptorPool& m_GlobalPool;
+        DescriptorAllocator& m_GlobalAllocator;
         Window& m_Window = App::Get().GetWindow();
-        GameObject m_ViewerObject = GameObject::CreateGameObject();
+        ModelCache& m_ModelCache = App::Get().GetModelCache();
+        TransformComponent m_ViewerTransform{};
         Camera m_Camera{};
         KeyboardCameraController m_CameraController;
 
         std::chrono::steady_clock::time_point m_CurrentTime;
 
+        // Points at the renderer's frame ring buffer and the object table, each frame binds it at the offsets
+        // of its own GlobalUbo and object table region
+        VkDescriptorSet m_GlobalDescriptorSet{VK_NULL_HANDLE};
+        GpuObjectTable m_ObjectTable{m_Device, m_ModelCache};
 
-        std::vector<std::unique_ptr<Buffer>> m_UboBuffers;
-        std::vector<VkDescriptorSet> m_GlobalDescriptorSets;
-
-        std::unique_ptr<DescriptorSetLayout> m_GlobalSetLayout = DescriptorSetLayout::Builder(m_Device)
+        std::shared_ptr<DescriptorSetLayout> m_GlobalSetLayout = DescriptorSetLayout::Builder(m_Device)
                                                                  .AddBinding(
-                                                                     0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+                                                                     0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
                                                                      VK_SHADER_STAGE_ALL_GRAPHICS)
-                                                                 .Build();
+                                                                 .AddBinding(
+                                                                     1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC,
+                                                                     VK_SHADER_STAGE_VERTEX_BIT)
+                                                                 .BuildCached();
 
         SimpleRenderSystem m_SimpleRendererSystem{
             m_Device,
             m_Renderer.GetSwapChainRenderPass(),
-            m_GlobalSetLayout->GetDescriptorSetLayout()
+            m_GlobalSetLayout->GetDescriptorSetLayout(),
+            m_Renderer.GetBindlessRegistry()
         };
 
-        GameObject::Map m_GameObjects;
+        Scene m_Scene;
+        TransformSystem m_TransformSystem;
+        MeshHandle m_VoxelMesh{};
+        // Null without bindless support
+        std::unique_ptr<TextureArray> m_BlockTextures;
     };
 }
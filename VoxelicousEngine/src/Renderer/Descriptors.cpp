@@ -1,5 +1,6 @@
 #include "vepch.h"
 #include "Descriptors.h"
+#include "LayoutCache.h"
 
 #include <ranges>
 
@@ -11,7 +12,8 @@ namespace VoxelicousEngine
         const uint32_t binding,
         const VkDescriptorType descriptorType,
         const VkShaderStageFlags stageFlags,
-        const uint32_t count)
+        const uint32_t count,
+        const VkDescriptorBindingFlags bindingFlags)
     {
         assert(m_Bindings.count(binding) == 0 && "Binding already in use");
         VkDescriptorSetLayoutBinding layoutBinding{};
@@ -20,28 +22,56 @@ namespace VoxelicousEngine
         layoutBinding.descriptorCount = count;
         layoutBinding.stageFlags = stageFlags;
         m_Bindings[binding] = layoutBinding;
+        if (bindingFlags != 0)
+        {
+            m_BindingFlags[binding] = bindingFlags;
+        }
+        return *this;
+    }
+
+    DescriptorSetLayout::Builder& DescriptorSetLayout::Builder::SetFlags(const VkDescriptorSetLayoutCreateFlags flags)
+    {
+        m_Flags = flags;
         return *this;
     }
 
     std::unique_ptr<DescriptorSetLayout> DescriptorSetLayout::Builder::Build() const
     {
-        return std::make_unique<DescriptorSetLayout>(m_Device, m_Bindings);
+        return std::make_unique<DescriptorSetLayout>(m_Device, m_Bindings, m_BindingFlags, m_Flags);
+    }
+
+    std::shared_ptr<DescriptorSetLayout> DescriptorSetLayout::Builder::BuildCached() const
+    {
+        return m_Device.GetLayoutCache().GetDescriptorSetLayout(m_Bindings, m_BindingFlags, m_Flags);
     }
 
     // *************** Descriptor Set Layout *********************
 
     DescriptorSetLayout::DescriptorSetLayout(
-        Device& device, const std::unordered_map<uint32_t, VkDescriptorSetLayoutBinding>& bindings)
+        Device& device,
+        const std::unordered_map<uint32_t, VkDescriptorSetLayoutBinding>& bindings,
+        const std::unordered_map<uint32_t, VkDescriptorBindingFlags>& bindingFlags,
+        const VkDescriptorSetLayoutCreateFlags flags)
         : m_Device{device}, m_Bindings{bindings}
     {
         std::vector<VkDescriptorSetLayoutBinding> setLayoutBindings{};
+        std::vector<VkDescriptorBindingFlags> setLayoutBindingFlags{};
         for (auto val : bindings | std::views::values)
         {
             setLayoutBindings.push_back(val);
+            const auto flagsIt = bindingFlags.find(val.binding);
+            setLayoutBindingFlags.push_back(flagsIt != bindingFlags.end() ? flagsIt->second : 0);
         }
 
+        VkDescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsInfo{};
+        bindingFlagsInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+        bindingFlagsInfo.bindingCount = static_cast<uint32_t>(setLayoutBindingFlags.size());
+        bindingFlagsInfo.pBindingFlags = setLayoutBindingFlags.data();
+
         VkDescriptorSetLayoutCreateInfo descriptorSetLayoutInfo{};
         descriptorSetLayoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        descriptorSetLayoutInfo.pNext = bindingFlags.empty() ? nullptr : &bindingFlagsInfo;
+        descriptorSetLayoutInfo.flags = flags;
         descriptorSetLayoutInfo.bindingCount = static_cast<uint32_t>(setLayoutBindings.size());
         descriptorSetLayoutInfo.pBindings = setLayoutBindings.data();
 
@@ -124,8 +154,7 @@ namespace VoxelicousEngine
         allocInfo.pSetLayouts = &descriptorSetLayout;
         allocInfo.descriptorSetCount = 1;
 
-        // Might want to create a "DescriptorPoolManager" class that handles this case, and builds
-        // a new pool whenever an old pool fills up. But this is beyond our current scope
+        // Fixed-size pools simply fail when full, use a DescriptorAllocator where the set count isn't known
         if (vkAllocateDescriptorSets(m_Device.GetDevice(), &allocInfo, &descriptor) != VK_SUCCESS)
         {
             return false;
@@ -147,10 +176,139 @@ namespace VoxelicousEngine
         vkResetDescriptorPool(m_Device.GetDevice(), m_DescriptorPool, 0);
     }
 
+    // *************** Descriptor Allocator *********************
+
+    namespace
+    {
+        constexpr DescriptorAllocator::PoolSizeRatio DEFAULT_POOL_RATIOS[] = {
+            {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1.0f},
+            {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1.0f},
+            {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1.0f},
+            {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, 1.0f},
+            {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 2.0f},
+            {VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 1.0f},
+            {VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 0.5f},
+            {VK_DESCRIPTOR_TYPE_SAMPLER, 0.5f},
+        };
+    }
+
+    DescriptorAllocator::DescriptorAllocator(Device& device, const uint32_t initialSetsPerPool)
+        : DescriptorAllocator(device, initialSetsPerPool, DEFAULT_POOL_RATIOS)
+    {
+    }
+
+    DescriptorAllocator::DescriptorAllocator(
+        Device& device, const uint32_t initialSetsPerPool, const std::span<const PoolSizeRatio> ratios)
+        : m_Device{device}, m_Ratios(ratios.begin(), ratios.end()),
+          m_SetsPerPool{std::clamp(initialSetsPerPool, 1u, MAX_SETS_PER_POOL)}
+    {
+    }
+
+    DescriptorAllocator::~DescriptorAllocator()
+    {
+        for (const VkDescriptorPool pool : m_ReadyPools)
+        {
+            vkDestroyDescriptorPool(m_Device.GetDevice(), pool, nullptr);
+        }
+        for (const VkDescriptorPool pool : m_FullPools)
+        {
+            vkDestroyDescriptorPool(m_Device.GetDevice(), pool, nullptr);
+        }
+        if (m_CurrentPool != VK_NULL_HANDLE)
+        {
+            vkDestroyDescriptorPool(m_Device.GetDevice(), m_CurrentPool, nullptr);
+        }
+    }
+
+    VkDescriptorPool DescriptorAllocator::CreatePool(const uint32_t setCount) const
+    {
+        std::array<VkDescriptorPoolSize, 16> poolSizes{};
+        assert(m_Ratios.size() <= poolSizes.size() && "Too many descriptor types for one pool");
+        for (size_t i = 0; i < m_Ratios.size(); i++)
+        {
+            poolSizes[i].type = m_Ratios[i].Type;
+            poolSizes[i].descriptorCount = std::max(1u, static_cast<uint32_t>(m_Ratios[i].Ratio * setCount));
+        }
+
+        VkDescriptorPoolCreateInfo descriptorPoolInfo{};
+        descriptorPoolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        descriptorPoolInfo.poolSizeCount = static_cast<uint32_t>(m_Ratios.size());
+        descriptorPoolInfo.pPoolSizes = poolSizes.data();
+        descriptorPoolInfo.maxSets = setCount;
+
+        VkDescriptorPool pool;
+        if (vkCreateDescriptorPool(m_Device.GetDevice(), &descriptorPoolInfo, nullptr, &pool) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create descriptor pool!");
+        }
+        return pool;
+    }
+
+    VkDescriptorPool DescriptorAllocator::GrabPool()
+    {
+        if (!m_ReadyPools.empty())
+        {
+            const VkDescriptorPool pool = m_ReadyPools.back();
+            m_ReadyPools.pop_back();
+            return pool;
+        }
+
+        // Each new pool is larger than the last, so a growing workload settles on few pools
+        const VkDescriptorPool pool = CreatePool(m_SetsPerPool);
+        m_SetsPerPool = std::min(m_SetsPerPool + m_SetsPerPool / 2, MAX_SETS_PER_POOL);
+        return pool;
+    }
+
+    bool DescriptorAllocator::Allocate(const VkDescriptorSetLayout descriptorSetLayout, VkDescriptorSet& descriptor)
+    {
+        if (m_CurrentPool == VK_NULL_HANDLE)
+        {
+            m_CurrentPool = GrabPool();
+        }
+
+        VkDescriptorSetAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocInfo.descriptorPool = m_CurrentPool;
+        allocInfo.pSetLayouts = &descriptorSetLayout;
+        allocInfo.descriptorSetCount = 1;
+
+        VkResult result = vkAllocateDescriptorSets(m_Device.GetDevice(), &allocInfo, &descriptor);
+        if (result == VK_ERROR_OUT_OF_POOL_MEMORY || result == VK_ERROR_FRAGMENTED_POOL)
+        {
+            m_FullPools.push_back(m_CurrentPool);
+            m_CurrentPool = GrabPool();
+            allocInfo.descriptorPool = m_CurrentPool;
+            result = vkAllocateDescriptorSets(m_Device.GetDevice(), &allocInfo, &descriptor);
+        }
+
+        if (result != VK_SUCCESS)
+        {
+            // Even a fresh pool is too small, the layout needs more descriptors of a type than the ratios give
+            VE_CORE_ERROR("Failed to allocate descriptor set!");
+            return false;
+        }
+        return true;
+    }
+
+    void DescriptorAllocator::Reset()
+    {
+        for (const VkDescriptorPool pool : m_FullPools)
+        {
+            vkResetDescriptorPool(m_Device.GetDevice(), pool, 0);
+            m_ReadyPools.push_back(pool);
+        }
+        m_FullPools.clear();
+
+        if (m_CurrentPool != VK_NULL_HANDLE)
+        {
+            vkResetDescriptorPool(m_Device.GetDevice(), m_CurrentPool, 0);
+        }
+    }
+
     // *************** Descriptor Writer *********************
 
-    DescriptorWriter::DescriptorWriter(DescriptorSetLayout& setLayout, DescriptorPool& pool)
-        : m_SetLayout{setLayout}, m_Pool{pool}
+    DescriptorWriter::DescriptorWriter(DescriptorSetLayout& setLayout, DescriptorAllocator& allocator)
+        : m_SetLayout{setLayout}, m_Allocator{allocator}
     {
     }
 
@@ -172,7 +330,8 @@ namespace VoxelicousEngine
         write.pBufferInfo = bufferInfo;
         write.descriptorCount = 1;
 
-        m_Writes.push_back(write);
+        assert(m_WriteCount < MAX_WRITES && "Too many writes for one descriptor writer");
+        m_Writes[m_WriteCount++] = write;
         return *this;
     }
 
@@ -194,13 +353,14 @@ namespace VoxelicousEngine
         write.pImageInfo = imageInfo;
         write.descriptorCount = 1;
 
-        m_Writes.push_back(write);
+        assert(m_WriteCount < MAX_WRITES && "Too many writes for one descriptor writer");
+        m_Writes[m_WriteCount++] = write;
         return *this;
     }
 
     bool DescriptorWriter::Build(VkDescriptorSet& set)
     {
-        if (const bool success = m_Pool.AllocateDescriptor(m_SetLayout.GetDescriptorSetLayout(), set); !success)
+        if (const bool success = m_Allocator.Allocate(m_SetLayout.GetDescriptorSetLayout(), set); !success)
         {
             return false;
         }
@@ -210,10 +370,10 @@ namespace VoxelicousEngine
 
     void DescriptorWriter::Overwrite(const VkDescriptorSet& set)
     {
-        for (auto& write : m_Writes)
+        for (uint32_t i = 0; i < m_WriteCount; i++)
         {
-            write.dstSet = set;
+            m_Writes[i].dstSet = set;
         }
-        vkUpdateDescriptorSets(m_Pool.m_Device.GetDevice(), m_Writes.size(), m_Writes.data(), 0, nullptr);
+        vkUpdateDescriptorSets(m_Allocator.m_Device.GetDevice(), m_WriteCount, m_Writes.data(), 0, nullptr);
     }
 }
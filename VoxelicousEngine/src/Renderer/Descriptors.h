@@ -2,6 +2,8 @@
 
 #include "Device.h"
 
+#include <span>
+
 namespace VoxelicousEngine
 {
     class DescriptorSetLayout
@@ -18,17 +20,28 @@ namespace VoxelicousEngine
                 uint32_t binding,
                 VkDescriptorType descriptorType,
                 VkShaderStageFlags stageFlags,
-                uint32_t count = 1);
+                uint32_t count = 1,
+                VkDescriptorBindingFlags bindingFlags = 0);
+            Builder& SetFlags(VkDescriptorSetLayoutCreateFlags flags);
 
             std::unique_ptr<DescriptorSetLayout> Build() const;
+            // Returns the device's shared layout for these bindings, see LayoutCache
+            std::shared_ptr<DescriptorSetLayout> BuildCached() const;
 
         private:
             Device& m_Device;
             std::unordered_map<uint32_t, VkDescriptorSetLayoutBinding> m_Bindings{};
+            std::unordered_map<uint32_t, VkDescriptorBindingFlags> m_BindingFlags{};
+            VkDescriptorSetLayoutCreateFlags m_Flags{0};
         };
 
+        // Binding flags (e.g. PARTIALLY_BOUND, UPDATE_AFTER_BIND) need descriptor indexing, see
+        // Device::IsBindlessSupported
         DescriptorSetLayout(
-            Device& device, const std::unordered_map<uint32_t, VkDescriptorSetLayoutBinding>& bindings);
+            Device& device,
+            const std::unordered_map<uint32_t, VkDescriptorSetLayoutBinding>& bindings,
+            const std::unordered_map<uint32_t, VkDescriptorBindingFlags>& bindingFlags = {},
+            VkDescriptorSetLayoutCreateFlags flags = 0);
         ~DescriptorSetLayout();
         DescriptorSetLayout(const DescriptorSetLayout&) = delete;
         DescriptorSetLayout& operator=(const DescriptorSetLayout&) = delete;
@@ -90,10 +103,61 @@ namespace VoxelicousEngine
         friend class DescriptorWriter;
     };
 
+    // Hands out descriptor sets from a growing list of pools, so allocation never depends on up-front sizing.
+    // When the current pool runs out it is retired as full and a recycled or new, larger pool takes over.
+    // Sets can't be freed one by one: Reset() returns every pool at once, which suits per-frame allocators
+    // and allocators that live as long as the sets they hand out. Not thread-safe.
+    class DescriptorAllocator
+    {
+    public:
+        // Descriptors of each type reserved per set in a pool
+        struct PoolSizeRatio
+        {
+            VkDescriptorType Type;
+            float Ratio;
+        };
+
+        static constexpr uint32_t INITIAL_SETS_PER_POOL = 64;
+        static constexpr uint32_t MAX_SETS_PER_POOL = 4096;
+
+        explicit DescriptorAllocator(Device& device, uint32_t initialSetsPerPool = INITIAL_SETS_PER_POOL);
+        DescriptorAllocator(Device& device, uint32_t initialSetsPerPool, std::span<const PoolSizeRatio> ratios);
+        ~DescriptorAllocator();
+        DescriptorAllocator(const DescriptorAllocator&) = delete;
+        DescriptorAllocator& operator=(const DescriptorAllocator&) = delete;
+
+        bool Allocate(VkDescriptorSetLayout descriptorSetLayout, VkDescriptorSet& descriptor);
+
+        // Resets all pools, invalidating every set allocated from them. The GPU must be done with those sets.
+        void Reset();
+
+        uint32_t GetPoolCount() const
+        {
+            return static_cast<uint32_t>(m_ReadyPools.size() + m_FullPools.size()) +
+                (m_CurrentPool != VK_NULL_HANDLE ? 1 : 0);
+        }
+
+    private:
+        VkDescriptorPool GrabPool();
+        VkDescriptorPool CreatePool(uint32_t setCount) const;
+
+        Device& m_Device;
+        std::vector<PoolSizeRatio> m_Ratios;
+        std::vector<VkDescriptorPool> m_ReadyPools;
+        std::vector<VkDescriptorPool> m_FullPools;
+        VkDescriptorPool m_CurrentPool{VK_NULL_HANDLE};
+        uint32_t m_SetsPerPool;
+
+        friend class DescriptorWriter;
+    };
+
     class DescriptorWriter
     {
     public:
-        DescriptorWriter(DescriptorSetLayout& setLayout, DescriptorPool& pool);
+        // Writers are short-lived and usually built every frame, so writes live inline instead of on the heap
+        static constexpr uint32_t MAX_WRITES = 32;
+
+        DescriptorWriter(DescriptorSetLayout& setLayout, DescriptorAllocator& allocator);
 
         DescriptorWriter& WriteBuffer(uint32_t binding, const VkDescriptorBufferInfo* bufferInfo);
         DescriptorWriter& WriteImage(uint32_t binding, const VkDescriptorImageInfo* imageInfo);
@@ -103,7 +167,8 @@ namespace VoxelicousEngine
 
     private:
         DescriptorSetLayout& m_SetLayout;
-        DescriptorPool& m_Pool;
-        std::vector<VkWriteDescriptorSet> m_Writes;
+        DescriptorAllocator& m_Allocator;
+        std::array<VkWriteDescriptorSet, MAX_WRITES> m_Writes{};
+        uint32_t m_WriteCount{0};
     };
 }
@@ -1,20 +1,31 @@
 #include "vepch.h"
 #include "Device.h"
+#include "LayoutCache.h"
 
 #include <GLFW/glfw3.h>
 
 namespace VoxelicousEngine
 {
     // class member functions
-    Device::Device(const VkInstance vkInstance, const VkSurfaceKHR surface) : m_VkInstance(vkInstance)
+    Device::Device(const VkInstance vkInstance, const VkSurfaceKHR surface)
+        : m_VkInstance(vkInstance), m_Headless(surface == VK_NULL_HANDLE)
     {
+        if (!m_Headless)
+        {
+            m_DeviceExtensions.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+        }
+
         PickPhysicalDevice(surface);
         CreateLogicalDevice(surface);
         CreateCommandPool(surface);
+        m_LayoutCache = std::make_unique<LayoutCache>(*this);
     }
 
     Device::~Device()
     {
+        vkDeviceWaitIdle(m_Device);
+        m_DeletionQueue.Flush();
+        m_LayoutCache.reset();
         vkDestroyCommandPool(m_Device, m_CommandPool, nullptr);
         vkDestroyDevice(m_Device, nullptr);
     }
@@ -67,11 +78,36 @@ namespace VoxelicousEngine
             queueCreateInfos.push_back(queueCreateInfo);
         }
 
+        VkPhysicalDeviceFeatures supportedFeatures;
+        vkGetPhysicalDeviceFeatures(m_PhysicalDevice, &supportedFeatures);
+        m_TextureCompressionBCSupported = supportedFeatures.textureCompressionBC == VK_TRUE;
+
         VkPhysicalDeviceFeatures deviceFeatures = {};
         deviceFeatures.samplerAnisotropy = VK_TRUE;
+        deviceFeatures.textureCompressionBC = supportedFeatures.textureCompressionBC;
+
+        VkPhysicalDeviceVulkan12Features vulkan12Features{};
+        vulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+        m_BindlessSupported = QueryBindlessSupport();
+        if (m_BindlessSupported)
+        {
+            vulkan12Features.descriptorIndexing = VK_TRUE;
+            vulkan12Features.runtimeDescriptorArray = VK_TRUE;
+            vulkan12Features.descriptorBindingPartiallyBound = VK_TRUE;
+            vulkan12Features.descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+            vulkan12Features.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+            vulkan12Features.descriptorBindingStorageBufferUpdateAfterBind = VK_TRUE;
+            vulkan12Features.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+            vulkan12Features.shaderStorageBufferArrayNonUniformIndexing = VK_TRUE;
+        }
+        else
+        {
+            VE_CORE_WARN("Descriptor indexing is not supported, bindless descriptors are disabled");
+        }
 
         VkDeviceCreateInfo createInfo = {};
         createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+        createInfo.pNext = m_BindlessSupported ? &vulkan12Features : nullptr;
 
         createInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
         createInfo.pQueueCreateInfos = queueCreateInfos.data();
@@ -92,6 +128,50 @@ namespace VoxelicousEngine
         vkGetDeviceQueue(m_Device, indices.PresentFamily, 0, &m_PresentQueue);
     }
 
+    bool Device::QueryBindlessSupport()
+    {
+        if (Properties.apiVersion < VK_API_VERSION_1_2)
+        {
+            return false;
+        }
+
+        VkPhysicalDeviceVulkan12Features supported{};
+        supported.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+        VkPhysicalDeviceFeatures2 features{};
+        features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+        features.pNext = &supported;
+        vkGetPhysicalDeviceFeatures2(m_PhysicalDevice, &features);
+
+        if (!supported.descriptorIndexing || !supported.runtimeDescriptorArray ||
+            !supported.descriptorBindingPartiallyBound || !supported.descriptorBindingUpdateUnusedWhilePending ||
+            !supported.descriptorBindingSampledImageUpdateAfterBind ||
+            !supported.descriptorBindingStorageBufferUpdateAfterBind ||
+            !supported.shaderSampledImageArrayNonUniformIndexing ||
+            !supported.shaderStorageBufferArrayNonUniformIndexing)
+        {
+            return false;
+        }
+
+        VkPhysicalDeviceVulkan12Properties vulkan12Properties{};
+        vulkan12Properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_PROPERTIES;
+        VkPhysicalDeviceProperties2 properties{};
+        properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+        properties.pNext = &vulkan12Properties;
+        vkGetPhysicalDeviceProperties2(m_PhysicalDevice, &properties);
+
+        // Combined image samplers count against both the sampled image and the sampler limits
+        m_BindlessLimits.MaxSampledImages = std::min({
+            vulkan12Properties.maxDescriptorSetUpdateAfterBindSampledImages,
+            vulkan12Properties.maxPerStageDescriptorUpdateAfterBindSampledImages,
+            vulkan12Properties.maxDescriptorSetUpdateAfterBindSamplers,
+            vulkan12Properties.maxPerStageDescriptorUpdateAfterBindSamplers
+        });
+        m_BindlessLimits.MaxStorageBuffers = std::min(
+            vulkan12Properties.maxDescriptorSetUpdateAfterBindStorageBuffers,
+            vulkan12Properties.maxPerStageDescriptorUpdateAfterBindStorageBuffers);
+        return true;
+    }
+
     void Device::CreateCommandPool(const VkSurfaceKHR surface)
     {
         const QueueFamilyIndices queueFamilyIndices = FindPhysicalQueueFamilies(surface);
@@ -114,8 +194,8 @@ namespace VoxelicousEngine
 
         bool extensionsSupported = CheckDeviceExtensionSupport(device);
 
-        bool swapChainAdequate = false;
-        if (extensionsSupported)
+        bool swapChainAdequate = surface == VK_NULL_HANDLE;
+        if (extensionsSupported && !swapChainAdequate)
         {
             SwapChainSupportDetails swapChainSupport = QuerySwapChainSupport(device, surface);
             swapChainAdequate = !swapChainSupport.Formats.empty() && !swapChainSupport.PresentModes.empty();
@@ -169,8 +249,12 @@ namespace VoxelicousEngine
                 indices.GraphicsFamilyHasValue = true;
             }
             
-            VkBool32 presentSupport = false;
-            vkGetPhysicalDeviceSurfaceSupportKHR(device, i, surface, &presentSupport);
+            // Without a surface nothing is presented, so the graphics queue doubles as the present queue
+            VkBool32 presentSupport = (queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT) ? VK_TRUE : VK_FALSE;
+            if (surface != VK_NULL_HANDLE)
+            {
+                vkGetPhysicalDeviceSurfaceSupportKHR(device, i, surface, &presentSupport);
+            }
             
             if (queueFamily.queueCount > 0 && presentSupport)
             {
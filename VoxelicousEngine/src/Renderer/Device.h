@@ -1,6 +1,7 @@
 #pragma once
 
 #include "vulkan/vulkan.h"
+#include "Core/DeletionQueue.h"
 
 namespace VoxelicousEngine
 {
@@ -20,9 +21,20 @@ namespace VoxelicousEngine
         bool IsComplete() const { return GraphicsFamilyHasValue && PresentFamilyHasValue; }
     };
 
+    class LayoutCache;
+
+    // Largest update-after-bind descriptor arrays the device allows in one set and shader stage
+    struct BindlessLimits
+    {
+        uint32_t MaxSampledImages = 0;
+        uint32_t MaxStorageBuffers = 0;
+    };
+
     class Device
     {
     public:
+        // Passing VK_NULL_HANDLE as surface creates a headless device without presentation support,
+        // which also accepts software implementations such as lavapipe.
         explicit Device(VkInstance vkInstance, VkSurfaceKHR surface);
         ~Device();
 
@@ -37,6 +49,18 @@ namespace VoxelicousEngine
         VkQueue GetGraphicsQueue() const { return m_GraphicsQueue; }
         VkQueue GetPresentQueue() const { return m_PresentQueue; }
         VkPhysicalDevice GetPhysicalDevice() const { return m_PhysicalDevice; }
+        bool IsHeadless() const { return m_Headless; }
+        LayoutCache& GetLayoutCache() const { return *m_LayoutCache; }
+        // Resources released while frames may still use them, retired by the renderer as frames complete
+        DeletionQueue& GetDeletionQueue() { return m_DeletionQueue; }
+
+        // Descriptor indexing (core in Vulkan 1.2) with partially bound, update-after-bind arrays of sampled images
+        // and storage buffers, enabled whenever the device supports it
+        bool IsBindlessSupported() const { return m_BindlessSupported; }
+        const BindlessLimits& GetBindlessLimits() const { return m_BindlessLimits; }
+
+        // BC1-7 sampling, enabled whenever the device supports it (all desktop GPUs)
+        bool IsTextureCompressionBCSupported() const { return m_TextureCompressionBCSupported; }
 
         SwapChainSupportDetails GetSwapChainSupport(const VkSurfaceKHR surface) const
         {
@@ -77,6 +101,7 @@ namespace VoxelicousEngine
         void PickPhysicalDevice(VkSurfaceKHR surface);
         void CreateLogicalDevice(VkSurfaceKHR surface);
         void CreateCommandPool(VkSurfaceKHR surface);
+        bool QueryBindlessSupport();
 
         // helper functions
         bool IsDeviceSuitable(VkPhysicalDevice device, VkSurfaceKHR surface) const;
@@ -91,7 +116,13 @@ namespace VoxelicousEngine
         VkDevice m_Device;
         VkQueue m_GraphicsQueue;
         VkQueue m_PresentQueue;
-
-        const std::vector<const char*> m_DeviceExtensions = {VK_KHR_SWAPCHAIN_EXTENSION_NAME};
+        bool m_Headless;
+        bool m_BindlessSupported{false};
+        bool m_TextureCompressionBCSupported{false};
+        BindlessLimits m_BindlessLimits;
+
+        std::vector<const char*> m_DeviceExtensions;
+        std::unique_ptr<LayoutCache> m_LayoutCache;
+        DeletionQueue m_DeletionQueue;
     };
 }
@@ -1,7 +1,9 @@
 #pragma once
 
 #include "Camera.h"
-#include "Core/GameObject.h"
+#include "GpuObjectTable.h"
+#include "Core/LinearArena.h"
+#include "Core/Scene.h"
 
 #include <vulkan/vulkan.h>
 
@@ -14,6 +16,13 @@ namespace VoxelicousEngine
         VkCommandBuffer CommandBuffer;
         Camera& Camera;
         VkDescriptorSet GlobalDescriptorSet;
-        GameObject::Map& GameObjects;
+        // Dynamic offset of this frame's GlobalUbo in the frame ring buffer
+        uint32_t GlobalUboOffset;
+        // Dynamic offset of this frame's region of the object table
+        uint32_t ObjectTableOffset;
+        VoxelicousEngine::Scene& Scene;
+        const GpuObjectTable& ObjectTable;
+        // Scratch memory for this frame's draw lists and other transient data, see Renderer::GetFrameArena
+        LinearArena& FrameArena;
     };
 }
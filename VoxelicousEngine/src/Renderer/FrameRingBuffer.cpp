@@ -0,0 +1,69 @@
+#include "vepch.h"
+#include "FrameRingBuffer.h"
+
+namespace VoxelicousEngine
+{
+    FrameRingBuffer::FrameRingBuffer(Device& device, const uint32_t frameCount, const VkDeviceSize frameSize)
+        : m_FrameCount{frameCount}
+    {
+        const auto& limits = device.Properties.limits;
+        m_MinAlignment = std::max(limits.minUniformBufferOffsetAlignment, limits.minStorageBufferOffsetAlignment);
+
+        // Vulkan guarantees a host-visible, host-coherent memory type for buffers, so nothing is ever flushed
+        m_Buffer = std::make_unique<Buffer>(
+            device,
+            frameSize,
+            frameCount,
+            VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            m_MinAlignment);
+        if (m_Buffer->Map() != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to map frame ring buffer!");
+        }
+
+        assert(m_Buffer->GetBufferSize() <= UINT32_MAX && "Dynamic offsets are 32 bit");
+        BeginFrame(0);
+    }
+
+    void FrameRingBuffer::BeginFrame(const uint32_t frameIndex)
+    {
+        VE_CORE_ASSERT(frameIndex < m_FrameCount, "Frame index out of range!");
+        m_FrameBegin = m_Buffer->GetAlignmentSize() * frameIndex;
+        m_FrameEnd = m_FrameBegin + m_Buffer->GetAlignmentSize();
+        m_Head = m_FrameBegin;
+    }
+
+    FrameRingBuffer::Allocation FrameRingBuffer::Allocate(const VkDeviceSize size, const VkDeviceSize alignment)
+    {
+        assert((alignment & (alignment - 1)) == 0 && "Alignment must be a power of two");
+        const VkDeviceSize align = std::max(alignment, m_MinAlignment);
+
+        VkDeviceSize offset = m_Head + align - 1 & ~(align - 1);
+        if (offset + size > m_FrameEnd)
+        {
+            // Overwriting this frame's earlier data glitches a frame, running past the region would corrupt one
+            // that is still in flight
+            if (!m_OverflowReported)
+            {
+                VE_CORE_ERROR("Frame ring buffer out of space ({} of {} bytes used, {} requested)",
+                              GetUsed(), GetFrameSize(), size);
+                m_OverflowReported = true;
+            }
+            VE_CORE_ASSERT(size <= GetFrameSize(), "Allocation larger than a whole frame region!");
+            offset = m_FrameBegin;
+        }
+        m_Head = offset + size;
+
+        Allocation allocation;
+        allocation.Data = static_cast<std::byte*>(m_Buffer->GetMappedMemory()) + offset;
+        allocation.Offset = static_cast<uint32_t>(offset);
+        allocation.Size = size;
+        return allocation;
+    }
+
+    VkDescriptorBufferInfo FrameRingBuffer::DescriptorInfo(const VkDeviceSize range) const
+    {
+        return VkDescriptorBufferInfo{m_Buffer->GetBuffer(), 0, range};
+    }
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "Buffer.h"
+
+#include <cstring>
+#include <type_traits>
+
+namespace VoxelicousEngine
+{
+    // Persistently mapped buffer split into one region per frame in flight. Transient uniform and storage data
+    // is sub-allocated linearly from the current frame's region and bound with dynamic offsets, so any number
+    // of constant blocks shares one VkBuffer and one descriptor set. The memory is host-coherent, writes need
+    // no flush. A region is only rewritten after the fence of the frame that last used it has been waited on.
+    class FrameRingBuffer
+    {
+    public:
+        static constexpr VkDeviceSize DEFAULT_FRAME_SIZE = 1024 * 1024;
+
+        struct Allocation
+        {
+            void* Data = nullptr;
+            // Offset from the start of the buffer, passed as the dynamic offset when binding
+            uint32_t Offset = 0;
+            VkDeviceSize Size = 0;
+        };
+
+        FrameRingBuffer(Device& device, uint32_t frameCount, VkDeviceSize frameSize = DEFAULT_FRAME_SIZE);
+
+        FrameRingBuffer(const FrameRingBuffer&) = delete;
+        FrameRingBuffer& operator=(const FrameRingBuffer&) = delete;
+
+        // Starts writing into the region of frameIndex, discarding what that frame wrote last time
+        void BeginFrame(uint32_t frameIndex);
+
+        // Alignment is raised to the device's minimum uniform and storage buffer offset alignment
+        Allocation Allocate(VkDeviceSize size, VkDeviceSize alignment = 1);
+
+        // Copies data into the current frame and returns its dynamic offset
+        template <typename T>
+        uint32_t Push(const T& data)
+        {
+            static_assert(std::is_trivially_copyable_v<T>, "Frame ring data is copied straight to the GPU");
+            const Allocation allocation = Allocate(sizeof(T), alignof(T));
+            std::memcpy(allocation.Data, &data, sizeof(T));
+            return allocation.Offset;
+        }
+
+        // Descriptor for a *_DYNAMIC binding reading range bytes from whichever offset is bound
+        VkDescriptorBufferInfo DescriptorInfo(VkDeviceSize range) const;
+
+        VkBuffer GetBuffer() const { return m_Buffer->GetBuffer(); }
+        VkDeviceSize GetFrameSize() const { return m_Buffer->GetAlignmentSize(); }
+        VkDeviceSize GetUsed() const { return m_Head - m_FrameBegin; }
+
+    private:
+        std::unique_ptr<Buffer> m_Buffer;
+        uint32_t m_FrameCount;
+        VkDeviceSize m_MinAlignment;
+
+        VkDeviceSize m_FrameBegin{0};
+        VkDeviceSize m_FrameEnd{0};
+        VkDeviceSize m_Head{0};
+        bool m_OverflowReported{false};
+    };
+}
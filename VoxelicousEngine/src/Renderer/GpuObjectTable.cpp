@@ -0,0 +1,150 @@
+#include "vepch.h"
+#include "GpuObjectTable.h"
+
+#include <bit>
+
+namespace VoxelicousEngine
+{
+    GpuObjectTable::GpuObjectTable(Device& device, const ModelCache& models, const uint32_t capacity)
+        : m_Device{device}, m_Models{models}
+    {
+        Reallocate(std::max(capacity, 1u));
+    }
+
+    void GpuObjectTable::Reallocate(const uint32_t capacity)
+    {
+        if (m_Buffer != nullptr)
+        {
+            // Every frame in flight may still read the old buffer
+            vkDeviceWaitIdle(m_Device.GetDevice());
+            VE_CORE_INFO("Growing GPU object table from {} to {} objects", m_Capacity, capacity);
+        }
+
+        m_Capacity = capacity;
+        m_Buffer = std::make_unique<Buffer>(
+            m_Device,
+            sizeof(GpuObjectData) * capacity,
+            SwapChain::MAX_FRAMES_IN_FLIGHT,
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            m_Device.Properties.limits.minStorageBufferOffsetAlignment);
+        if (m_Buffer->Map() != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to map GPU object table!");
+        }
+
+        m_Slots.reserve(capacity);
+        m_Data.reserve(capacity);
+        for (Slot& slot : m_Slots)
+        {
+            slot.PendingFrames = ALL_FRAMES;
+        }
+    }
+
+    GpuObjectData GpuObjectTable::MakeObjectData(const glm::mat4& matrix, const uint32_t materialId, const Model& model)
+    {
+        GpuObjectData data{};
+        data.ModelMatrix = matrix;
+        data.MaterialIndex = materialId;
+
+        // Transform the model's box into a conservative sphere; the matrix is affine up to its w scale
+        const AABB& bounds = model.GetBounds();
+        const glm::mat4& m = data.ModelMatrix;
+        const float w = m[3][3];
+        const glm::vec4 center = m * glm::vec4(bounds.GetCenter(), 1.f);
+        const float maxScale = std::max({
+            glm::length(glm::vec3(m[0])), glm::length(glm::vec3(m[1])), glm::length(glm::vec3(m[2]))
+        });
+        data.BoundingSphere = glm::vec4(glm::vec3(center) / center.w, glm::length(bounds.GetExtent()) * maxScale / w);
+        return data;
+    }
+
+    bool GpuObjectTable::Update(Scene& scene, const uint32_t frameIndex)
+    {
+        VE_PROFILE_FUNCTION();
+        VE_CORE_ASSERT(frameIndex < SwapChain::MAX_FRAMES_IN_FLIGHT, "Frame index out of range!");
+
+        bool reallocated = false;
+        const uint32_t objectCount = scene.Count<WorldTransformComponent, MeshComponent>();
+        if (objectCount > m_Capacity)
+        {
+            Reallocate(std::bit_ceil(objectCount));
+            reallocated = true;
+        }
+
+        m_UpdateNumber++;
+        scene.Each<const WorldTransformComponent, const MeshComponent>(
+            [&](const Entity entity, const WorldTransformComponent& transform, const MeshComponent& mesh)
+        {
+            // Entities whose mesh is null or was released are left out like removed objects
+            const Model* model = m_Models.Get(mesh.Mesh);
+            if (model == nullptr) return;
+
+            const auto [it, inserted] = m_SlotById.try_emplace(entity.GetKey(), static_cast<uint32_t>(m_Slots.size()));
+            if (inserted)
+            {
+                m_Slots.push_back({entity});
+                m_Data.emplace_back();
+            }
+
+            Slot& slot = m_Slots[it->second];
+            slot.LastSeen = m_UpdateNumber;
+            if (inserted || slot.Mesh != mesh.Mesh || slot.MaterialId != mesh.MaterialId ||
+                slot.TransformVersion != transform.Version)
+            {
+                slot.Mesh = mesh.Mesh;
+                slot.MaterialId = mesh.MaterialId;
+                slot.TransformVersion = transform.Version;
+                slot.PendingFrames = ALL_FRAMES;
+                m_Data[it->second] = MakeObjectData(transform.Matrix, mesh.MaterialId, *model);
+            }
+        });
+
+        // Fill the holes of removed objects with the last slot to keep the table dense
+        for (uint32_t index = 0; index < m_Slots.size();)
+        {
+            if (m_Slots[index].LastSeen == m_UpdateNumber)
+            {
+                index++;
+                continue;
+            }
+
+            m_SlotById.erase(m_Slots[index].Id.GetKey());
+            if (index + 1 != m_Slots.size())
+            {
+                m_Slots[index] = m_Slots.back();
+                m_Data[index] = m_Data.back();
+                m_Slots[index].PendingFrames = ALL_FRAMES;
+                m_SlotById[m_Slots[index].Id.GetKey()] = index;
+            }
+            m_Slots.pop_back();
+            m_Data.pop_back();
+        }
+
+        auto* region = reinterpret_cast<GpuObjectData*>(
+            static_cast<std::byte*>(m_Buffer->GetMappedMemory()) + GetFrameOffset(frameIndex));
+        const auto frameBit = static_cast<uint8_t>(1u << frameIndex);
+        m_UploadCount = 0;
+        for (uint32_t index = 0; index < m_Slots.size(); index++)
+        {
+            if (m_Slots[index].PendingFrames & frameBit)
+            {
+                region[index] = m_Data[index];
+                m_Slots[index].PendingFrames &= ~frameBit;
+                m_UploadCount++;
+            }
+        }
+
+        return reallocated;
+    }
+
+    VkDescriptorBufferInfo GpuObjectTable::DescriptorInfo() const
+    {
+        return m_Buffer->DescriptorInfo(sizeof(GpuObjectData) * m_Capacity, 0);
+    }
+
+    uint32_t GpuObjectTable::GetFrameOffset(const uint32_t frameIndex) const
+    {
+        return static_cast<uint32_t>(m_Buffer->GetAlignmentSize() * frameIndex);
+    }
+}
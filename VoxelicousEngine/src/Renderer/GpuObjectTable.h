@@ -0,0 +1,85 @@
+#pragma once
+
+#include "Buffer.h"
+#include "SwapChain.h"
+#include "Core/Components.h"
+#include "Core/ModelCache.h"
+#include "Core/Scene.h"
+
+namespace VoxelicousEngine
+{
+    // Per-object shader data, laid out to match ObjectData in the std430 object table of simple.vert
+    struct GpuObjectData
+    {
+        glm::mat4 ModelMatrix{1.f};
+        // World-space bounding sphere, center in xyz and radius in w
+        glm::vec4 BoundingSphere{0.f};
+        uint32_t MaterialIndex{0};
+        uint32_t Padding[3]{};
+    };
+
+    static_assert(sizeof(GpuObjectData) == 96, "GpuObjectData must match the std430 layout of the shaders");
+
+    // Mirrors every entity with a world transform and a live mesh into a storage buffer that shaders index with
+    // gl_InstanceIndex. Objects are packed densely, so the index of an object may change when another one is removed.
+    //
+    // Layers are recorded inside the render pass, where no transfer can be issued, so the table is a host-coherent
+    // buffer with one region per frame in flight. Only objects whose world matrix (as cached by TransformSystem),
+    // model or material changed are rewritten, once into each region as that region becomes free.
+    class GpuObjectTable
+    {
+    public:
+        static constexpr uint32_t DEFAULT_CAPACITY = 1024;
+
+        GpuObjectTable(Device& device, const ModelCache& models, uint32_t capacity = DEFAULT_CAPACITY);
+
+        GpuObjectTable(const GpuObjectTable&) = delete;
+        GpuObjectTable& operator=(const GpuObjectTable&) = delete;
+
+        // Adds new objects, drops removed ones and uploads changes into the region of frameIndex.
+        // Returns true when the buffer was reallocated, descriptors referring to it must then be rewritten.
+        bool Update(Scene& scene, uint32_t frameIndex);
+
+        // Descriptor for a STORAGE_BUFFER_DYNAMIC binding, bound at GetFrameOffset(frameIndex)
+        VkDescriptorBufferInfo DescriptorInfo() const;
+        uint32_t GetFrameOffset(uint32_t frameIndex) const;
+
+        uint32_t GetObjectCount() const { return static_cast<uint32_t>(m_Slots.size()); }
+        MeshHandle GetMesh(const uint32_t objectIndex) const { return m_Slots[objectIndex].Mesh; }
+        // Valid until the model cache changes, i.e. for the frame's recording
+        const Model* GetModel(const uint32_t objectIndex) const { return m_Models.Get(m_Slots[objectIndex].Mesh); }
+        // Objects written to the GPU by the last update
+        uint32_t GetUploadCount() const { return m_UploadCount; }
+
+    private:
+        static constexpr uint8_t ALL_FRAMES = (1u << SwapChain::MAX_FRAMES_IN_FLIGHT) - 1;
+
+        struct Slot
+        {
+            Entity Id;
+            MeshHandle Mesh;
+            // WorldTransformComponent::Version the data was built from
+            uint32_t TransformVersion;
+            uint32_t MaterialId;
+            uint64_t LastSeen;
+            // One bit per frame region that still holds stale data for this object
+            uint8_t PendingFrames;
+        };
+
+        void Reallocate(uint32_t capacity);
+        static GpuObjectData MakeObjectData(const glm::mat4& matrix, uint32_t materialId, const Model& model);
+
+        Device& m_Device;
+        const ModelCache& m_Models;
+        std::unique_ptr<Buffer> m_Buffer;
+        uint32_t m_Capacity{0};
+
+        std::vector<Slot> m_Slots;
+        std::vector<GpuObjectData> m_Data;
+        // Keyed by Entity::GetKey
+        std::unordered_map<uint64_t, uint32_t> m_SlotById;
+
+        uint64_t m_UpdateNumber{0};
+        uint32_t m_UploadCount{0};
+    };
+}
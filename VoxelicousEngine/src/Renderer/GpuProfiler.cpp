@@ -0,0 +1,238 @@
+#include "vepch.h"
+#include "GpuProfiler.h"
+#include "Core/FrameStats.h"
+
+#include <fstream>
+
+namespace VoxelicousEngine
+{
+    float GpuProfiler::RollingAverage::Add(const float sample)
+    {
+        Sum += sample - Samples[Next];
+        Samples[Next] = sample;
+        Next = (Next + 1) % AVERAGE_WINDOW;
+        Count = std::min(Count + 1, AVERAGE_WINDOW);
+        return Sum / static_cast<float>(Count);
+    }
+
+    GpuProfiler::GpuProfiler(Device& device) : m_Device{device}
+    {
+        m_RecordedFrames.resize(MAX_RECORDED_FRAMES);
+        for (RecordedFrame& frame : m_RecordedFrames)
+        {
+            frame.Scopes.reserve(MAX_SCOPES);
+        }
+
+        const auto& limits = m_Device.Properties.limits;
+        const QueueFamilyIndices indices = m_Device.FindPhysicalQueueFamilies(VK_NULL_HANDLE);
+
+        uint32_t queueFamilyCount = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties(m_Device.GetPhysicalDevice(), &queueFamilyCount, nullptr);
+        std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+        vkGetPhysicalDeviceQueueFamilyProperties(m_Device.GetPhysicalDevice(), &queueFamilyCount, queueFamilies.data());
+
+        const uint32_t validBits = indices.GraphicsFamilyHasValue
+                                       ? queueFamilies[indices.GraphicsFamily].timestampValidBits
+                                       : 0;
+        m_Supported = validBits != 0 && limits.timestampPeriod > 0.0f;
+        if (!m_Supported)
+        {
+            VE_CORE_WARN("GPU timestamps are not supported by the graphics queue, only CPU timings are profiled");
+            return;
+        }
+
+        m_TimestampPeriod = limits.timestampPeriod;
+        m_TimestampMask = validBits >= 64 ? ~0ull : (1ull << validBits) - 1;
+
+        VkQueryPoolCreateInfo queryPoolInfo{};
+        queryPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        queryPoolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+        queryPoolInfo.queryCount = MAX_SCOPES * 2;
+
+        for (auto& slot : m_Slots)
+        {
+            if (vkCreateQueryPool(m_Device.GetDevice(), &queryPoolInfo, nullptr, &slot.QueryPool) != VK_SUCCESS)
+            {
+                throw std::runtime_error("failed to create timestamp query pool!");
+            }
+        }
+    }
+
+    GpuProfiler::~GpuProfiler()
+    {
+        for (const auto& slot : m_Slots)
+        {
+            if (slot.QueryPool != VK_NULL_HANDLE)
+            {
+                vkDestroyQueryPool(m_Device.GetDevice(), slot.QueryPool, nullptr);
+            }
+        }
+    }
+
+    void GpuProfiler::BeginFrame(const VkCommandBuffer commandBuffer, const uint32_t frameIndex)
+    {
+        VE_CORE_ASSERT(m_OpenScopes.empty(), "Profiler scopes left open at the end of the previous frame!");
+        VE_CORE_ASSERT(frameIndex < m_Slots.size(), "Frame index out of range!");
+
+        VE_ALLOCATION_SCOPE(Profiler);
+
+        FrameSlot& slot = m_Slots[frameIndex];
+        CollectResults(slot);
+
+        slot.Scopes.clear();
+        slot.QueryCount = 0;
+        slot.FrameNumber = m_FrameNumber++;
+        m_OpenScopes.clear();
+        m_CurrentSlot = &slot;
+
+        if (m_Supported)
+        {
+            vkCmdResetQueryPool(commandBuffer, slot.QueryPool, 0, MAX_SCOPES * 2);
+        }
+    }
+
+    void GpuProfiler::BeginScope(const VkCommandBuffer commandBuffer, const char* name)
+    {
+        VE_CORE_ASSERT(m_CurrentSlot, "Profiler scope opened outside of a frame!");
+
+        ScopeEntry entry{};
+        entry.Name = name;
+        entry.Depth = static_cast<uint32_t>(m_OpenScopes.size());
+        entry.HasQuery = m_Supported && m_CurrentSlot->QueryCount + 2 <= MAX_SCOPES * 2;
+        if (m_Supported && !entry.HasQuery && !m_OverflowReported)
+        {
+            VE_CORE_WARN("More than {} GPU profiler scopes in one frame, extra scopes are timed on the CPU only",
+                         MAX_SCOPES);
+            m_OverflowReported = true;
+        }
+
+        if (entry.HasQuery)
+        {
+            entry.Query = m_CurrentSlot->QueryCount;
+            m_CurrentSlot->QueryCount += 2;
+            vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, m_CurrentSlot->QueryPool,
+                                entry.Query);
+        }
+
+        m_OpenScopes.push_back(static_cast<uint32_t>(m_CurrentSlot->Scopes.size()));
+        entry.CpuBegin = std::chrono::steady_clock::now();
+        m_CurrentSlot->Scopes.push_back(entry);
+    }
+
+    void GpuProfiler::EndScope(const VkCommandBuffer commandBuffer)
+    {
+        VE_CORE_ASSERT(!m_OpenScopes.empty(), "EndScope called without a matching BeginScope!");
+
+        ScopeEntry& entry = m_CurrentSlot->Scopes[m_OpenScopes.back()];
+        m_OpenScopes.pop_back();
+
+        entry.CpuEnd = std::chrono::steady_clock::now();
+        if (entry.HasQuery)
+        {
+            vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, m_CurrentSlot->QueryPool,
+                                entry.Query + 1);
+        }
+    }
+
+    void GpuProfiler::CollectResults(FrameSlot& slot)
+    {
+        if (slot.Scopes.empty())
+        {
+            return;
+        }
+
+        // Each query is followed by its availability value, so a frame that is somehow still executing
+        // is skipped instead of waited on.
+        std::array<uint64_t, MAX_SCOPES * 2 * 2> queryResults{};
+        if (m_Supported && slot.QueryCount > 0)
+        {
+            const VkResult result = vkGetQueryPoolResults(
+                m_Device.GetDevice(),
+                slot.QueryPool,
+                0,
+                slot.QueryCount,
+                sizeof(queryResults),
+                queryResults.data(),
+                sizeof(uint64_t) * 2,
+                VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+            if (result != VK_SUCCESS && result != VK_NOT_READY)
+            {
+                VE_CORE_ERROR("Failed to read GPU timestamp queries!");
+                return;
+            }
+
+            // Drop the whole frame rather than report partial timings
+            for (uint32_t query = 0; query < slot.QueryCount; query++)
+            {
+                if (queryResults[query * 2 + 1] == 0)
+                {
+                    return;
+                }
+            }
+        }
+
+        // The frame's GPU time spans from its first timestamp to the latest one written after it
+        if (m_Supported && slot.QueryCount > 0)
+        {
+            uint64_t frameTicks = 0;
+            for (uint32_t query = 1; query < slot.QueryCount; query++)
+            {
+                frameTicks = std::max(frameTicks, (queryResults[query * 2] - queryResults[0]) & m_TimestampMask);
+            }
+            FrameStats::Get().Record(FrameMetric::GpuFrame,
+                                     static_cast<uint64_t>(static_cast<double>(frameTicks) * m_TimestampPeriod));
+        }
+
+        m_Results.clear();
+        for (const ScopeEntry& entry : slot.Scopes)
+        {
+            float gpuMs = 0.0f;
+            if (entry.HasQuery)
+            {
+                const uint64_t* begin = &queryResults[entry.Query * 2];
+                const uint64_t* end = &queryResults[(entry.Query + 1) * 2];
+                const uint64_t ticks = (end[0] - begin[0]) & m_TimestampMask;
+                gpuMs = static_cast<float>(static_cast<double>(ticks) * m_TimestampPeriod * 1e-6);
+            }
+            const float cpuMs = std::chrono::duration<float, std::milli>(entry.CpuEnd - entry.CpuBegin).count();
+
+            auto& [gpuAverage, cpuAverage] = m_Averages[entry.Name];
+            m_Results.push_back({
+                entry.Name, entry.Depth, gpuMs, cpuMs, gpuAverage.Add(gpuMs), cpuAverage.Add(cpuMs)
+            });
+        }
+
+        RecordedFrame& recorded = m_RecordedFrames[m_NextRecordedFrame];
+        recorded.FrameNumber = slot.FrameNumber;
+        recorded.Scopes.assign(m_Results.begin(), m_Results.end());
+        m_NextRecordedFrame = (m_NextRecordedFrame + 1) % MAX_RECORDED_FRAMES;
+        m_RecordedFrameCount = std::min(m_RecordedFrameCount + 1, MAX_RECORDED_FRAMES);
+    }
+
+    bool GpuProfiler::ExportCsv(const std::string& filePath) const
+    {
+        std::ofstream file{filePath};
+        if (!file.is_open())
+        {
+            VE_CORE_ERROR("Failed to open profiler export file {0}", filePath);
+            return false;
+        }
+
+        file << "frame,scope,depth,gpu_ms,cpu_ms,avg_gpu_ms,avg_cpu_ms\n";
+        // Oldest frame first
+        for (size_t i = 0; i < m_RecordedFrameCount; i++)
+        {
+            const size_t index = (m_NextRecordedFrame + MAX_RECORDED_FRAMES - m_RecordedFrameCount + i) %
+                MAX_RECORDED_FRAMES;
+            const auto& [frameNumber, scopes] = m_RecordedFrames[index];
+            for (const ScopeResult& scope : scopes)
+            {
+                file << frameNumber << ',' << scope.Name << ',' << scope.Depth << ',' << scope.GpuMs << ','
+                    << scope.CpuMs << ',' << scope.AverageGpuMs << ',' << scope.AverageCpuMs << '\n';
+            }
+        }
+
+        VE_CORE_INFO("Exported {0} profiled frames to {1}", m_RecordedFrameCount, filePath);
+        return true;
+    }
+}
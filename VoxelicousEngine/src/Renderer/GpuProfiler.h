@@ -0,0 +1,128 @@
+#pragma once
+
+#include "Device.h"
+#include "SwapChain.h"
+
+#include <chrono>
+
+namespace VoxelicousEngine
+{
+    // Measures named, nestable scopes of a command buffer with timestamp queries. Each frame in flight
+    // owns its own query pool, and results are read back the next time that frame slot comes around
+    // (after its fence was waited on), so collecting them never stalls the CPU.
+    class GpuProfiler
+    {
+    public:
+        static constexpr uint32_t MAX_SCOPES = 64;
+        static constexpr uint32_t AVERAGE_WINDOW = 64;
+        static constexpr size_t MAX_RECORDED_FRAMES = 600;
+
+        struct ScopeResult
+        {
+            const char* Name;
+            uint32_t Depth;
+            float GpuMs;
+            float CpuMs;
+            float AverageGpuMs;
+            float AverageCpuMs;
+        };
+
+        explicit GpuProfiler(Device& device);
+        ~GpuProfiler();
+
+        GpuProfiler(const GpuProfiler&) = delete;
+        GpuProfiler& operator=(const GpuProfiler&) = delete;
+
+        // Collects the results of the last submission of frameIndex and resets its queries. Has to be
+        // recorded outside of a render pass, before any scope of the frame.
+        void BeginFrame(VkCommandBuffer commandBuffer, uint32_t frameIndex);
+
+        // The name has to stay valid until the frame's results are collected (string literals, layer names)
+        void BeginScope(VkCommandBuffer commandBuffer, const char* name);
+        void EndScope(VkCommandBuffer commandBuffer);
+
+        bool IsSupported() const { return m_Supported; }
+
+        // Scopes of the most recently completed frame, in recording order
+        const std::vector<ScopeResult>& GetResults() const { return m_Results; }
+
+        // Writes every recorded frame (up to MAX_RECORDED_FRAMES) as one row per scope
+        bool ExportCsv(const std::string& filePath) const;
+
+    private:
+        struct ScopeEntry
+        {
+            const char* Name;
+            uint32_t Depth;
+            uint32_t Query;
+            bool HasQuery;
+            std::chrono::steady_clock::time_point CpuBegin;
+            std::chrono::steady_clock::time_point CpuEnd;
+        };
+
+        struct FrameSlot
+        {
+            VkQueryPool QueryPool = VK_NULL_HANDLE;
+            uint32_t QueryCount = 0;
+            uint64_t FrameNumber = 0;
+            std::vector<ScopeEntry> Scopes;
+        };
+
+        struct RollingAverage
+        {
+            std::array<float, AVERAGE_WINDOW> Samples{};
+            uint32_t Next = 0;
+            uint32_t Count = 0;
+            float Sum = 0.0f;
+
+            float Add(float sample);
+        };
+
+        struct RecordedFrame
+        {
+            uint64_t FrameNumber;
+            std::vector<ScopeResult> Scopes;
+        };
+
+        void CollectResults(FrameSlot& slot);
+
+        Device& m_Device;
+        bool m_Supported{false};
+        float m_TimestampPeriod{1.0f};
+        uint64_t m_TimestampMask{~0ull};
+
+        std::array<FrameSlot, SwapChain::MAX_FRAMES_IN_FLIGHT> m_Slots;
+        FrameSlot* m_CurrentSlot{nullptr};
+        std::vector<uint32_t> m_OpenScopes;
+        uint64_t m_FrameNumber{0};
+        bool m_OverflowReported{false};
+
+        std::vector<ScopeResult> m_Results;
+        // Keyed by the scope name pointer, which has to outlive the profiler anyway
+        std::unordered_map<const char*, std::pair<RollingAverage, RollingAverage>> m_Averages;
+        // Ring of MAX_RECORDED_FRAMES preallocated frames, so recording does not allocate once warmed up
+        std::vector<RecordedFrame> m_RecordedFrames;
+        size_t m_RecordedFrameCount{0};
+        size_t m_NextRecordedFrame{0};
+    };
+
+    // Scoped helper: opens a profiler scope on construction and closes it on destruction
+    class GpuProfileScope
+    {
+    public:
+        GpuProfileScope(GpuProfiler& profiler, const VkCommandBuffer commandBuffer, const char* name)
+            : m_Profiler{profiler}, m_CommandBuffer{commandBuffer}
+        {
+            m_Profiler.BeginScope(m_CommandBuffer, name);
+        }
+
+        ~GpuProfileScope() { m_Profiler.EndScope(m_CommandBuffer); }
+
+        GpuProfileScope(const GpuProfileScope&) = delete;
+        GpuProfileScope& operator=(const GpuProfileScope&) = delete;
+
+    private:
+        GpuProfiler& m_Profiler;
+        VkCommandBuffer m_CommandBuffer;
+    };
+}
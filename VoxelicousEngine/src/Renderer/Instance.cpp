@@ -47,7 +47,7 @@ namespace VoxelicousEngine
         }
     }
 
-    Instance::Instance()
+    Instance::Instance(const bool headless) : m_Headless(headless)
     {
         if (m_EnableValidationLayers && !CheckValidationLayerSupport())
         {
@@ -90,7 +90,10 @@ namespace VoxelicousEngine
             VE_CORE_ERROR("Failed to create instance!");
         }
 
-        HasGlfwRequiredInstanceExtensions();
+        if (!m_Headless)
+        {
+            HasGlfwRequiredInstanceExtensions();
+        }
         SetupDebugMessenger();
     }
 
@@ -184,10 +187,13 @@ namespace VoxelicousEngine
 
     std::vector<const char*> Instance::GetRequiredExtensions() const
     {
-        uint32_t glfwExtensionCount = 0;
-        const char** glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
-
-        std::vector extensions(glfwExtensions, glfwExtensions + glfwExtensionCount);
+        std::vector<const char*> extensions;
+        if (!m_Headless)
+        {
+            uint32_t glfwExtensionCount = 0;
+            const char** glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
+            extensions.assign(glfwExtensions, glfwExtensions + glfwExtensionCount);
+        }
 
         if (m_EnableValidationLayers)
         {
@@ -13,7 +13,8 @@ namespace VoxelicousEngine
 #endif
 
     public:
-        Instance();
+        // A headless instance skips the window system extensions GLFW would require
+        explicit Instance(bool headless = false);
 
         ~Instance();
 
@@ -32,6 +33,7 @@ namespace VoxelicousEngine
 
         VkInstance m_Instance;
         VkDebugUtilsMessengerEXT m_DebugMessenger;
+        bool m_Headless;
 
         std::vector<const char*> m_ValidationLayers = {"VK_LAYER_KHRONOS_validation"};
     };
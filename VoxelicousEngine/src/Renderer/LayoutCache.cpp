@@ -0,0 +1,145 @@
+#include "vepch.h"
+#include "LayoutCache.h"
+
+#include <ranges>
+
+namespace VoxelicousEngine
+{
+    namespace
+    {
+        void HashCombine(size_t& seed, const uint64_t value)
+        {
+            seed ^= std::hash<uint64_t>{}(value) + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2);
+        }
+
+        bool IsSameBinding(const VkDescriptorSetLayoutBinding& a, const VkDescriptorSetLayoutBinding& b)
+        {
+            return a.binding == b.binding && a.descriptorType == b.descriptorType &&
+                a.descriptorCount == b.descriptorCount && a.stageFlags == b.stageFlags &&
+                a.pImmutableSamplers == b.pImmutableSamplers;
+        }
+
+        bool IsSameRange(const VkPushConstantRange& a, const VkPushConstantRange& b)
+        {
+            return a.stageFlags == b.stageFlags && a.offset == b.offset && a.size == b.size;
+        }
+    }
+
+    bool LayoutCache::SetLayoutKey::operator==(const SetLayoutKey& other) const
+    {
+        return Flags == other.Flags && BindingFlags == other.BindingFlags &&
+            std::ranges::equal(Bindings, other.Bindings, IsSameBinding);
+    }
+
+    bool LayoutCache::PipelineLayoutKey::operator==(const PipelineLayoutKey& other) const
+    {
+        return SetLayouts == other.SetLayouts && std::ranges::equal(PushConstantRanges, other.PushConstantRanges,
+                                                                    IsSameRange);
+    }
+
+    size_t LayoutCache::KeyHash::operator()(const SetLayoutKey& key) const
+    {
+        size_t seed = key.Bindings.size();
+        HashCombine(seed, key.Flags);
+        for (const VkDescriptorBindingFlags flags : key.BindingFlags)
+        {
+            HashCombine(seed, flags);
+        }
+        for (const VkDescriptorSetLayoutBinding& binding : key.Bindings)
+        {
+            HashCombine(seed, binding.binding);
+            HashCombine(seed, binding.descriptorType);
+            HashCombine(seed, binding.descriptorCount);
+            HashCombine(seed, binding.stageFlags);
+            HashCombine(seed, reinterpret_cast<uintptr_t>(binding.pImmutableSamplers));
+        }
+        return seed;
+    }
+
+    size_t LayoutCache::KeyHash::operator()(const PipelineLayoutKey& key) const
+    {
+        size_t seed = key.SetLayouts.size();
+        for (const VkDescriptorSetLayout setLayout : key.SetLayouts)
+        {
+            HashCombine(seed, reinterpret_cast<uint64_t>(setLayout));
+        }
+        for (const VkPushConstantRange& range : key.PushConstantRanges)
+        {
+            HashCombine(seed, range.stageFlags);
+            HashCombine(seed, range.offset);
+            HashCombine(seed, range.size);
+        }
+        return seed;
+    }
+
+    LayoutCache::LayoutCache(Device& device) : m_Device{device}
+    {
+    }
+
+    LayoutCache::~LayoutCache()
+    {
+        for (const VkPipelineLayout pipelineLayout : m_PipelineLayouts | std::views::values)
+        {
+            vkDestroyPipelineLayout(m_Device.GetDevice(), pipelineLayout, nullptr);
+        }
+    }
+
+    std::shared_ptr<DescriptorSetLayout> LayoutCache::GetDescriptorSetLayout(
+        const std::unordered_map<uint32_t, VkDescriptorSetLayoutBinding>& bindings,
+        const std::unordered_map<uint32_t, VkDescriptorBindingFlags>& bindingFlags,
+        const VkDescriptorSetLayoutCreateFlags flags)
+    {
+        SetLayoutKey key;
+        key.Flags = flags;
+        key.Bindings.reserve(bindings.size());
+        for (const VkDescriptorSetLayoutBinding& binding : bindings | std::views::values)
+        {
+            key.Bindings.push_back(binding);
+        }
+        std::ranges::sort(key.Bindings, std::less{}, &VkDescriptorSetLayoutBinding::binding);
+        for (const VkDescriptorSetLayoutBinding& binding : key.Bindings)
+        {
+            const auto it = bindingFlags.find(binding.binding);
+            key.BindingFlags.push_back(it != bindingFlags.end() ? it->second : 0);
+        }
+
+        if (const auto it = m_SetLayouts.find(key); it != m_SetLayouts.end())
+        {
+            return it->second;
+        }
+
+        auto setLayout = std::make_shared<DescriptorSetLayout>(m_Device, bindings, bindingFlags, flags);
+        m_SetLayouts.emplace(std::move(key), setLayout);
+        return setLayout;
+    }
+
+    VkPipelineLayout LayoutCache::GetPipelineLayout(
+        const std::span<const VkDescriptorSetLayout> setLayouts,
+        const std::span<const VkPushConstantRange> pushConstantRanges)
+    {
+        PipelineLayoutKey key{
+            {setLayouts.begin(), setLayouts.end()},
+            {pushConstantRanges.begin(), pushConstantRanges.end()}
+        };
+        if (const auto it = m_PipelineLayouts.find(key); it != m_PipelineLayouts.end())
+        {
+            return it->second;
+        }
+
+        VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+        pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        pipelineLayoutInfo.setLayoutCount = static_cast<uint32_t>(setLayouts.size());
+        pipelineLayoutInfo.pSetLayouts = setLayouts.data();
+        pipelineLayoutInfo.pushConstantRangeCount = static_cast<uint32_t>(pushConstantRanges.size());
+        pipelineLayoutInfo.pPushConstantRanges = pushConstantRanges.data();
+
+        VkPipelineLayout pipelineLayout;
+        if (vkCreatePipelineLayout(m_Device.GetDevice(), &pipelineLayoutInfo, nullptr, &pipelineLayout) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create pipeline layout!");
+        }
+
+        m_PipelineLayouts.emplace(std::move(key), pipelineLayout);
+        return pipelineLayout;
+    }
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "Descriptors.h"
+
+#include <span>
+
+namespace VoxelicousEngine
+{
+    // Deduplicates descriptor set layouts and pipeline layouts by their contents. Identical requests return the
+    // same handles, so render systems built from the same bindings share layouts, and sets bound through one
+    // pipeline layout stay bound across every pipeline created with it. Entries live as long as the device.
+    class LayoutCache
+    {
+    public:
+        explicit LayoutCache(Device& device);
+        ~LayoutCache();
+
+        LayoutCache(const LayoutCache&) = delete;
+        LayoutCache& operator=(const LayoutCache&) = delete;
+
+        std::shared_ptr<DescriptorSetLayout> GetDescriptorSetLayout(
+            const std::unordered_map<uint32_t, VkDescriptorSetLayoutBinding>& bindings,
+            const std::unordered_map<uint32_t, VkDescriptorBindingFlags>& bindingFlags = {},
+            VkDescriptorSetLayoutCreateFlags flags = 0);
+
+        VkPipelineLayout GetPipelineLayout(
+            std::span<const VkDescriptorSetLayout> setLayouts,
+            std::span<const VkPushConstantRange> pushConstantRanges = {});
+
+        size_t GetDescriptorSetLayoutCount() const { return m_SetLayouts.size(); }
+        size_t GetPipelineLayoutCount() const { return m_PipelineLayouts.size(); }
+
+    private:
+        struct SetLayoutKey
+        {
+            // Sorted by binding number, with the flags of each binding at the same index
+            std::vector<VkDescriptorSetLayoutBinding> Bindings;
+            std::vector<VkDescriptorBindingFlags> BindingFlags;
+            VkDescriptorSetLayoutCreateFlags Flags;
+
+            bool operator==(const SetLayoutKey& other) const;
+        };
+
+        struct PipelineLayoutKey
+        {
+            std::vector<VkDescriptorSetLayout> SetLayouts;
+            std::vector<VkPushConstantRange> PushConstantRanges;
+
+            bool operator==(const PipelineLayoutKey& other) const;
+        };
+
+        struct KeyHash
+        {
+            size_t operator()(const SetLayoutKey& key) const;
+            size_t operator()(const PipelineLayoutKey& key) const;
+        };
+
+        Device& m_Device;
+        std::unordered_map<SetLayoutKey, std::shared_ptr<DescriptorSetLayout>, KeyHash> m_SetLayouts;
+        std::unordered_map<PipelineLayoutKey, VkPipelineLayout, KeyHash> m_PipelineLayouts;
+    };
+}
@@ -22,6 +22,14 @@ namespace VoxelicousEngine
         CreateGraphicsPipeline(vertFilepath, fragFilepath, configInfo);
     }
 
+    Pipeline::Pipeline(Pipeline&& other) noexcept
+        : m_Device{other.m_Device},
+          m_GraphicsPipeline{std::exchange(other.m_GraphicsPipeline, VK_NULL_HANDLE)},
+          m_VertShaderModule{std::exchange(other.m_VertShaderModule, VK_NULL_HANDLE)},
+          m_FragShaderModule{std::exchange(other.m_FragShaderModule, VK_NULL_HANDLE)}
+    {
+    }
+
     Pipeline::~Pipeline()
     {
         vkDestroyShaderModule(m_Device.GetDevice(), m_VertShaderModule, nullptr);
@@ -29,7 +37,7 @@ namespace VoxelicousEngine
         vkDestroyPipeline(m_Device.GetDevice(), m_GraphicsPipeline, nullptr);
     }
 
-    std::vector<uint32_t> Pipeline::LoadShader(const std::string& filePath, ShaderType type)
+    const std::vector<uint32_t>& Pipeline::LoadShader(const std::string& filePath, ShaderType type)
     {
         // Use the shader manager to load and potentially compile the shader
         return GetShaderManager().LoadShader(filePath, type);
@@ -44,8 +52,8 @@ namespace VoxelicousEngine
             "Cannot create graphics pipeline: no renderPass provided in configInfo!");
 
         // Load and potentially compile the shaders
-        const auto vertCode = LoadShader(vertFilepath, ShaderType::Vertex);
-        const auto fragCode = LoadShader(fragFilepath, ShaderType::Fragment);
+        const auto& vertCode = LoadShader(vertFilepath, ShaderType::Vertex);
+        const auto& fragCode = LoadShader(fragFilepath, ShaderType::Fragment);
 
         if (vertCode.empty() || fragCode.empty())
         {
@@ -201,7 +209,7 @@ namespace VoxelicousEngine
         configInfo.DynamicStateInfo.dynamicStateCount = static_cast<uint32_t>(configInfo.DynamicStateEnables.size());
         configInfo.DynamicStateInfo.flags = 0;
 
-        configInfo.BindingDescriptions = Model::Vertex::GetBindingDescriptions();
-        configInfo.AttributeDescriptions = Model::Vertex::GetAttributeDescriptions();
+        configInfo.BindingDescriptions = Model::GetBindingDescriptions();
+        configInfo.AttributeDescriptions = Model::GetAttributeDescriptions();
     }
 }
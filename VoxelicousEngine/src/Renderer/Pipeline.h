@@ -39,6 +39,8 @@ namespace VoxelicousEngine
 
         Pipeline(const Pipeline&) = delete;
         Pipeline& operator=(const Pipeline&) = delete;
+        // The moved-from pipeline is left empty and destroys nothing
+        Pipeline(Pipeline&& other) noexcept;
         Pipeline() = delete;
 
         void Bind(VkCommandBuffer commandBuffer) const;
@@ -54,7 +56,7 @@ namespace VoxelicousEngine
 
     private:
         // This replaces the old ReadFile method
-        std::vector<uint32_t> LoadShader(const std::string& filePath, ShaderType type);
+        const std::vector<uint32_t>& LoadShader(const std::string& filePath, ShaderType type);
 
         void CreateGraphicsPipeline(
             const std::string& vertFilepath,
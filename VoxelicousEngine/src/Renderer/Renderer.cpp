@@ -6,13 +6,39 @@
 
 namespace VoxelicousEngine
 {
-    Renderer::Renderer(Window& window, Device& device) : m_Window{window}, m_Device{device}
+    // V-Sync caps the frame rate at the display's refresh rate with FIFO. Without it frames are presented
+    // immediately, and the swap chain falls back to mailbox, which is uncapped but tear-free, where immediate
+    // isn't supported.
+    static VkPresentModeKHR GetVSyncPresentMode(const bool vSync)
+    {
+        return vSync ? VK_PRESENT_MODE_FIFO_KHR : VK_PRESENT_MODE_IMMEDIATE_KHR;
+    }
+
+    Renderer::Renderer(Window& window, Device& device)
+        : m_Window{window}, m_Device{device}, m_PresentMode{GetVSyncPresentMode(window.IsVSync())},
+          m_VSync{window.IsVSync()}
     {
         RecreateSwapChain();
         CreateCommandBuffers();
+        m_Profiler = std::make_unique<GpuProfiler>(m_Device);
+        m_FrameRingBuffer = std::make_unique<FrameRingBuffer>(m_Device, SwapChain::MAX_FRAMES_IN_FLIGHT);
+        for (auto& allocator : m_FrameDescriptorAllocators)
+        {
+            allocator = std::make_unique<DescriptorAllocator>(m_Device);
+        }
+        if (m_Device.IsBindlessSupported())
+        {
+            m_BindlessRegistry = std::make_unique<BindlessRegistry>(m_Device);
+        }
     }
 
-    Renderer::~Renderer() { FreeCommandBuffers(); }
+    Renderer::~Renderer()
+    {
+        // Queued textures release their bindless indices when destroyed, which needs the registry still alive
+        vkDeviceWaitIdle(m_Device.GetDevice());
+        m_Device.GetDeletionQueue().Flush();
+        FreeCommandBuffers();
+    }
 
     void Renderer::OnWindowResized()
     {
@@ -29,15 +55,19 @@ namespace VoxelicousEngine
         }
 
         vkDeviceWaitIdle(m_Device.GetDevice());
+        // Nothing is in flight anymore, which also covers a change of the frames in flight count
+        m_Device.GetDeletionQueue().Flush();
 
         if (m_SwapChain == nullptr)
         {
-            m_SwapChain = std::make_unique<SwapChain>(m_Device, extent, m_Window.GetVkSurfaceKHR());
+            m_SwapChain = std::make_unique<SwapChain>(
+                m_Device, extent, m_Window.GetVkSurfaceKHR(), m_PresentMode, m_FramesInFlight);
         }
         else
         {
             std::shared_ptr oldSwapChain = std::move(m_SwapChain);
-            m_SwapChain = std::make_unique<SwapChain>(m_Device, extent, m_Window.GetVkSurfaceKHR(), oldSwapChain);
+            m_SwapChain = std::make_unique<SwapChain>(
+                m_Device, extent, m_Window.GetVkSurfaceKHR(), m_PresentMode, m_FramesInFlight, oldSwapChain);
 
             if (!oldSwapChain->CompareSwapFormats(*m_SwapChain))
             {
@@ -46,9 +76,73 @@ namespace VoxelicousEngine
         }
     }
 
+    void Renderer::SetFramesInFlight(const uint32_t framesInFlight)
+    {
+        const uint32_t clamped = std::clamp<uint32_t>(
+            framesInFlight, SwapChain::MIN_FRAMES_IN_FLIGHT, SwapChain::MAX_FRAMES_IN_FLIGHT);
+        if (clamped != framesInFlight)
+        {
+            VE_CORE_WARN("Frames in flight {} out of range, using {}", framesInFlight, clamped);
+        }
+
+        if (clamped != m_FramesInFlight)
+        {
+            m_FramesInFlight = clamped;
+            m_SettingsChanged = true;
+        }
+    }
+
+    void Renderer::SetPresentMode(const VkPresentModeKHR presentMode)
+    {
+        if (presentMode != m_PresentMode)
+        {
+            m_PresentMode = presentMode;
+            m_SettingsChanged = true;
+        }
+    }
+
+    void Renderer::ApplyPendingSettings()
+    {
+        if (const bool vSync = m_Window.IsVSync(); vSync != m_VSync)
+        {
+            m_VSync = vSync;
+            SetPresentMode(GetVSyncPresentMode(vSync));
+        }
+
+        if (!m_SettingsChanged)
+        {
+            return;
+        }
+        m_SettingsChanged = false;
+
+        VE_CORE_INFO("Rebuilding swap chain: {} frame(s) in flight, present mode {}",
+                     m_FramesInFlight, SwapChain::PresentModeToString(m_PresentMode));
+
+        RecreateSwapChain();
+        if (m_CommandBuffers.size() != m_FramesInFlight)
+        {
+            FreeCommandBuffers();
+            CreateCommandBuffers();
+        }
+        m_CurrentFrameIndex = 0;
+    }
+
+    void Renderer::CaptureFrame(std::vector<uint8_t>& pixels) const
+    {
+        VE_CORE_ASSERT(!m_IsFrameStarted, "Can't capture a frame while it is still being recorded!");
+        if (!m_SwapChain->IsHeadless())
+        {
+            VE_CORE_ERROR("Frame capture is only supported by the headless renderer!");
+            return;
+        }
+
+        vkDeviceWaitIdle(m_Device.GetDevice());
+        m_SwapChain->CopyImageToHost(m_CurrentImageIndex, pixels);
+    }
+
     void Renderer::CreateCommandBuffers()
     {
-        m_CommandBuffers.resize(SwapChain::MAX_FRAMES_IN_FLIGHT);
+        m_CommandBuffers.resize(m_FramesInFlight);
 
         VkCommandBufferAllocateInfo allocInfo{};
         allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
@@ -75,7 +169,11 @@ namespace VoxelicousEngine
 
     VkCommandBuffer Renderer::BeginFrame()
     {
+        VE_PROFILE_FUNCTION();
+        VE_ALLOCATION_SCOPE(Renderer);
+
         VE_CORE_ASSERT(!m_IsFrameStarted && "Can't call beginFrame while already in progress!");
+        ApplyPendingSettings();
         Pipeline::GetShaderManager().CheckForChanges();
 
         const auto result = m_SwapChain->AcquireNextImage(&m_CurrentImageIndex);
@@ -92,6 +190,15 @@ namespace VoxelicousEngine
         }
 
         m_IsFrameStarted = true;
+        // AcquireNextImage waited for this frame index's fence, so its previous contents are no longer in use
+        m_FrameArenas[m_CurrentFrameIndex].Reset();
+        m_FrameRingBuffer->BeginFrame(static_cast<uint32_t>(m_CurrentFrameIndex));
+        m_FrameDescriptorAllocators[m_CurrentFrameIndex]->Reset();
+        m_Device.GetDeletionQueue().BeginFrame(++m_FrameNumber, m_FramesInFlight);
+        if (m_BindlessRegistry)
+        {
+            m_BindlessRegistry->BeginFrame();
+        }
 
         const auto commandBuffer = GetCurrentCommandBuffer();
 
@@ -103,11 +210,16 @@ namespace VoxelicousEngine
         {
             VE_CORE_ERROR("Failed to begin recording command buffer!");
         }
+
+        m_Profiler->BeginFrame(commandBuffer, static_cast<uint32_t>(m_CurrentFrameIndex));
         return commandBuffer;
     }
 
     void Renderer::EndFrame()
     {
+        VE_PROFILE_FUNCTION();
+        VE_ALLOCATION_SCOPE(Renderer);
+
         VE_CORE_ASSERT(m_IsFrameStarted && "Can't call endFrame while frame is not in progress!");
         const auto commandBuffer = GetCurrentCommandBuffer();
         if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS)
@@ -127,7 +239,7 @@ namespace VoxelicousEngine
         }
 
         m_IsFrameStarted = false;
-        m_CurrentFrameIndex = (m_CurrentFrameIndex + 1) % SwapChain::MAX_FRAMES_IN_FLIGHT;
+        m_CurrentFrameIndex = (m_CurrentFrameIndex + 1) % static_cast<int>(m_FramesInFlight);
     }
 
     void Renderer::BeginSwapChainRendererPass(const VkCommandBuffer commandBuffer) const
@@ -3,6 +3,11 @@
 #include "Core/Window.h"
 #include "Device.h"
 #include "SwapChain.h"
+#include "GpuProfiler.h"
+#include "FrameRingBuffer.h"
+#include "Descriptors.h"
+#include "BindlessRegistry.h"
+#include "Core/LinearArena.h"
 #include "Events/Event.h"
 
 namespace VoxelicousEngine
@@ -21,6 +26,7 @@ namespace VoxelicousEngine
         bool IsFrameInProgress() const { return m_IsFrameStarted; }
 
         SwapChain& GetSwapChain() const { return *m_SwapChain; }
+        GpuProfiler& GetProfiler() const { return *m_Profiler; }
 
         VkCommandBuffer GetCurrentCommandBuffer() const
         {
@@ -34,6 +40,38 @@ namespace VoxelicousEngine
             return m_CurrentFrameIndex;
         }
 
+        // Transient CPU memory for the current frame, reset once the GPU has finished the previous frame that
+        // used the same index. Nothing allocated here survives past MAX_FRAMES_IN_FLIGHT frames.
+        LinearArena& GetFrameArena()
+        {
+            assert(m_IsFrameStarted && "Cannot get frame arena when frame not in progress");
+            return m_FrameArenas[m_CurrentFrameIndex];
+        }
+
+        // Transient uniform and storage data for the current frame, bound with dynamic offsets. Shares the
+        // lifetime rules of the frame arena; the buffer itself lives as long as the renderer.
+        FrameRingBuffer& GetFrameRingBuffer() const { return *m_FrameRingBuffer; }
+
+        // Descriptor sets that only live for the current frame, reset together with the frame arena
+        DescriptorAllocator& GetFrameDescriptorAllocator()
+        {
+            assert(m_IsFrameStarted && "Cannot get frame descriptor allocator when frame not in progress");
+            return *m_FrameDescriptorAllocators[m_CurrentFrameIndex];
+        }
+
+        // Null when the device doesn't support descriptor indexing
+        BindlessRegistry* GetBindlessRegistry() const { return m_BindlessRegistry.get(); }
+
+        // Both settings are applied at the start of the next frame by rebuilding the swap chain
+        void SetFramesInFlight(uint32_t framesInFlight);
+        uint32_t GetFramesInFlight() const { return m_FramesInFlight; }
+        void SetPresentMode(VkPresentModeKHR presentMode);
+        VkPresentModeKHR GetPresentMode() const { return m_PresentMode; }
+
+        // Waits for the GPU and reads back the most recently submitted image (headless mode only).
+        // Pixels are tightly packed 8-bit RGBA/BGRA as reported by GetSwapChain().GetSwapChainImageFormat().
+        void CaptureFrame(std::vector<uint8_t>& pixels) const;
+
         VkCommandBuffer BeginFrame();
         void EndFrame();
         void BeginSwapChainRendererPass(VkCommandBuffer commandBuffer) const;
@@ -44,17 +82,30 @@ namespace VoxelicousEngine
         void FreeCommandBuffers();
         void DrawFrame();
         void RecreateSwapChain();
+        void ApplyPendingSettings();
 
         void OnWindowResized();
 
         Window& m_Window;
         Device& m_Device;
         std::unique_ptr<SwapChain> m_SwapChain;
+        std::unique_ptr<GpuProfiler> m_Profiler;
+        std::unique_ptr<FrameRingBuffer> m_FrameRingBuffer;
+        std::unique_ptr<BindlessRegistry> m_BindlessRegistry;
         std::vector<VkCommandBuffer> m_CommandBuffers;
+        std::array<LinearArena, SwapChain::MAX_FRAMES_IN_FLIGHT> m_FrameArenas;
+        std::array<std::unique_ptr<DescriptorAllocator>, SwapChain::MAX_FRAMES_IN_FLIGHT> m_FrameDescriptorAllocators;
 
         uint32_t m_CurrentImageIndex{0};
         int m_CurrentFrameIndex{0};
+        // Frames begun so far, tags resources queued on the device's deletion queue
+        uint64_t m_FrameNumber{0};
         bool m_IsFrameStarted{false};
         bool m_WasWindowResized{false};
+
+        uint32_t m_FramesInFlight{SwapChain::DEFAULT_FRAMES_IN_FLIGHT};
+        VkPresentModeKHR m_PresentMode;
+        bool m_VSync;
+        bool m_SettingsChanged{false};
     };
 }
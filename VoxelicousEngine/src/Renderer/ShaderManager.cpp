@@ -5,7 +5,9 @@
 #include <fstream>
 #include <iostream>
 #include <filesystem>
+#ifdef VE_PLATFORM_WINDOWS
 #include <process.h>
+#endif
 #include <algorithm>  // For std::replace
 
 namespace VoxelicousEngine
@@ -13,8 +15,16 @@ namespace VoxelicousEngine
     ShaderManager::ShaderManager() = default;
     ShaderManager::~ShaderManager() = default;
 
-    std::vector<uint32_t> ShaderManager::LoadShader(const std::string& filePath, ShaderType type, bool forceRecompile)
+    const std::vector<uint32_t>& ShaderManager::GetCode(const ShaderInfo& info)
     {
+        static const std::vector<uint32_t> empty;
+        return info.compiledCode ? *info.compiledCode : empty;
+    }
+
+    const std::vector<uint32_t>& ShaderManager::LoadShader(const std::string& filePath, ShaderType type, bool forceRecompile)
+    {
+        VE_PROFILE_FUNCTION();
+
         // If type is unknown, try to infer from file extension
         ShaderType shaderType = type;
         if (shaderType == ShaderType::Unknown)
@@ -23,7 +33,8 @@ namespace VoxelicousEngine
             if (shaderType == ShaderType::Unknown)
             {
                 VE_CORE_ERROR("Could not determine shader type from file extension: {}", filePath);
-                return {};
+                static const std::vector<uint32_t> empty;
+                return empty;
             }
         }
 
@@ -49,13 +60,13 @@ namespace VoxelicousEngine
                     it->second.compiledCode = ReadCompiledShader(GetCompiledShaderPath(filePath));
                 }
                 
-                return it->second.compiledCode.value_or(std::vector<uint32_t>{});
+                return GetCode(it->second);
             }
             
             // If the shader hasn't changed and we have compiled code
             if (it->second.compiledCode.has_value())
             {
-                return it->second.compiledCode.value();
+                return *it->second.compiledCode;
             }
         }
         else
@@ -63,6 +74,7 @@ namespace VoxelicousEngine
             // First time seeing this shader, add it to the cache
             ShaderInfo info;
             info.filePath = filePath;
+            info.sourcePath = filePath;
             info.type = shaderType;
             
             // Check if there's already a compiled version on disk
@@ -86,14 +98,11 @@ namespace VoxelicousEngine
             else
             {
                 // Use existing compiled version
-                info.compiledCode = existingCompiled;
+                info.compiledCode = std::move(existingCompiled);
             }
             
-            // Add to cache
-            m_ShaderCache[filePath] = info;
-            
-            // Return the compiled code or empty vector if compilation failed
-            return info.compiledCode.value_or(std::vector<uint32_t>{});
+            // Add to cache and return the compiled code or empty vector if compilation failed
+            return GetCode(m_ShaderCache[filePath] = std::move(info));
         }
         
         // If we reach here, we need to compile the shader
@@ -104,6 +113,7 @@ namespace VoxelicousEngine
         // Update or create cache entry
         ShaderInfo& info = m_ShaderCache[filePath];
         info.filePath = filePath;
+        info.sourcePath = filePath;
         info.type = shaderType;
         
         if (success)
@@ -111,17 +121,22 @@ namespace VoxelicousEngine
             info.compiledCode = ReadCompiledShader(GetCompiledShaderPath(filePath));
         }
         
-        return info.compiledCode.value_or(std::vector<uint32_t>{});
+        return GetCode(info);
     }
 
     void ShaderManager::CheckForChanges()
     {
+        VE_PROFILE_FUNCTION();
+
+        VE_ALLOCATION_SCOPE(Shaders);
+
+        // Runs every frame: only stat the cached paths, the slower checks happen once something changed
         for (auto& [path, info] : m_ShaderCache)
         {
-            std::filesystem::file_time_type lastModified;
-            bool changed = HasShaderSourceChanged(path, lastModified);
+            std::error_code error;
+            const auto lastModified = std::filesystem::last_write_time(info.sourcePath, error);
             
-            if (changed)
+            if (!error && lastModified > info.lastModifiedTime)
             {
                 VE_CORE_INFO("Shader changed, recompiling: {}", path);
                 info.lastModifiedTime = lastModified;
@@ -203,6 +218,8 @@ namespace VoxelicousEngine
 
     bool ShaderManager::CompileShaderWithGlslc(const std::string& filePath, ShaderType type, bool optimize)
     {
+        VE_PROFILE_FUNCTION();
+
         try
         {
             // Make sure the file exists
@@ -212,6 +229,7 @@ namespace VoxelicousEngine
                 return false;
             }
             
+#ifdef VE_PLATFORM_WINDOWS
             // Use a fixed path to glslc
             std::string glslcPath;
             
@@ -249,6 +267,23 @@ namespace VoxelicousEngine
             
             // Input file and output file with an extra closing quote
             cmd += "\"" + normalizedInputPath + "\" -o \"" + normalizedOutputPath + "\"\"";
+#else
+            // Prefer the SDK's glslc and fall back to the one on PATH (distribution packages, CI images)
+            std::string glslcPath = "glslc";
+            if (const char* vulkanSdkDir = std::getenv("VULKAN_SDK"))
+            {
+                if (const std::string sdkGlslc = std::string(vulkanSdkDir) + "/bin/glslc";
+                    std::filesystem::exists(sdkGlslc))
+                {
+                    glslcPath = sdkGlslc;
+                }
+            }
+
+            std::string cmd = "\"" + glslcPath + "\" ";
+            if (optimize)
+                cmd += "-O ";
+            cmd += "\"" + filePath + "\" -o \"" + GetCompiledShaderPath(filePath) + "\"";
+#endif
             
             // Execute the command
             VE_CORE_INFO("Executing: {}", cmd);
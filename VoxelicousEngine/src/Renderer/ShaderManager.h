@@ -20,6 +20,8 @@ namespace VoxelicousEngine
     struct ShaderInfo
     {
         std::string filePath;
+        // Kept alongside filePath so polling for changes does not build a new path every frame
+        std::filesystem::path sourcePath;
         ShaderType type;
         bool hasChanged = false;
         std::optional<std::vector<uint32_t>> compiledCode;
@@ -36,8 +38,9 @@ namespace VoxelicousEngine
         ShaderManager(const ShaderManager&) = delete;
         ShaderManager& operator=(const ShaderManager&) = delete;
 
-        // Load and compile a shader, return SPIR-V code
-        std::vector<uint32_t> LoadShader(const std::string& filePath, ShaderType type, bool forceRecompile = false);
+        // Load and compile a shader, return SPIR-V code (empty on failure). The reference stays valid until
+        // the shader is recompiled.
+        const std::vector<uint32_t>& LoadShader(const std::string& filePath, ShaderType type, bool forceRecompile = false);
         
         // Check if any shaders need recompilation and update them
         void CheckForChanges();
@@ -52,6 +55,8 @@ namespace VoxelicousEngine
         static std::string GetCompiledShaderPath(const std::string& filePath);
 
     private:
+        static const std::vector<uint32_t>& GetCode(const ShaderInfo& info);
+
         std::unordered_map<std::string, ShaderInfo> m_ShaderCache;
         bool m_OptimizeShaders = true;
 
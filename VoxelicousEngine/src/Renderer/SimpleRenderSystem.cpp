@@ -1,6 +1,7 @@
 #include "vepch.h"
 #include "SimpleRenderSystem.h"
 #include "Core/Core.h"
+#include "LayoutCache.h"
 
 #define GLM_FORCE_RADIANS
 #define GLM_FORCE_DEPTH_ZERO_TO_ONE
@@ -9,41 +10,38 @@
 
 namespace VoxelicousEngine
 {
-    struct SimplePushConstantData
+    struct DrawItem
     {
-        glm::mat4 ModelMatrix{1.f};
+        MeshHandle Mesh;
+        uint32_t ObjectIndex;
     };
 
     SimpleRenderSystem::SimpleRenderSystem(Device& device, const VkRenderPass renderPass,
-                                           const VkDescriptorSetLayout globalSetLayout) : m_Device(device)
+                                           const VkDescriptorSetLayout globalSetLayout,
+                                           const BindlessRegistry* bindless) : m_Device(device), m_Bindless(bindless)
     {
         CreatePipelineLayout(globalSetLayout);
         CreatePipeline(renderPass);
     }
 
-    SimpleRenderSystem::~SimpleRenderSystem()
-    {
-        vkDestroyPipelineLayout(m_Device.GetDevice(), m_PipelineLayout, nullptr);
-    }
+    // The pipeline layout belongs to the device's layout cache
+    SimpleRenderSystem::~SimpleRenderSystem() = default;
 
     void SimpleRenderSystem::CreatePipelineLayout(const VkDescriptorSetLayout globalSetLayout)
     {
-        VkPushConstantRange pushConstantRange;
-        pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
-        pushConstantRange.offset = 0;
-        pushConstantRange.size = sizeof(SimplePushConstantData);
-
-        const std::vector descriptorSetLayouts{globalSetLayout};
-
-        VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
-        pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-        pipelineLayoutInfo.setLayoutCount = static_cast<uint32_t>(descriptorSetLayouts.size());
-        pipelineLayoutInfo.pSetLayouts = descriptorSetLayouts.data();
-        pipelineLayoutInfo.pushConstantRangeCount = 1;
-        pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
-        if (vkCreatePipelineLayout(m_Device.GetDevice(), &pipelineLayoutInfo, nullptr, &m_PipelineLayout) != VK_SUCCESS)
+        // Every system on the global set (and the bindless set) shares this layout, so the sets stay bound across
+        // their pipelines
+        if (m_Bindless)
         {
-            VE_CORE_ERROR("Failed to create pipeline layout!");
+            const std::array descriptorSetLayouts{
+                globalSetLayout, m_Bindless->GetSetLayout()->GetDescriptorSetLayout()
+            };
+            m_PipelineLayout = m_Device.GetLayoutCache().GetPipelineLayout(descriptorSetLayouts);
+        }
+        else
+        {
+            const std::array descriptorSetLayouts{globalSetLayout};
+            m_PipelineLayout = m_Device.GetLayoutCache().GetPipelineLayout(descriptorSetLayouts);
         }
     }
 
@@ -60,21 +58,18 @@ namespace VoxelicousEngine
         m_Pipeline = std::make_unique<Pipeline>(
             m_Device,
             "shaders/simple.vert",
-            "shaders/simple.frag",
+            m_Bindless ? "shaders/simple.frag" : "shaders/simple_untextured.frag",
             pipelineConfig
         );
-        
-        // Check for shader changes periodically
-        Pipeline::GetShaderManager().CheckForChanges();
     }
 
     void SimpleRenderSystem::RenderGameObjects(const FrameInfo& frameInfo) const
     {
-        // Check for shader changes before rendering
-        Pipeline::GetShaderManager().CheckForChanges();
-        
+        // Shader changes are polled once per frame by Renderer::BeginFrame
         m_Pipeline->Bind(frameInfo.CommandBuffer);
 
+        // Dynamic offsets are consumed in binding order: global UBO, then object table
+        const std::array dynamicOffsets{frameInfo.GlobalUboOffset, frameInfo.ObjectTableOffset};
         vkCmdBindDescriptorSets(
             frameInfo.CommandBuffer,
             VK_PIPELINE_BIND_POINT_GRAPHICS,
@@ -82,27 +77,49 @@ namespace VoxelicousEngine
             0,
             1,
             &frameInfo.GlobalDescriptorSet,
-            0,
-            nullptr
+            static_cast<uint32_t>(dynamicOffsets.size()),
+            dynamicOffsets.data()
         );
+        if (m_Bindless)
+        {
+            const VkDescriptorSet bindlessSet = m_Bindless->GetDescriptorSet();
+            vkCmdBindDescriptorSets(
+                frameInfo.CommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_PipelineLayout, 1, 1, &bindlessSet, 0,
+                nullptr);
+        }
+
+        // Build the draw list in frame memory, sorted so each model's buffers are bound once
+        const GpuObjectTable& objectTable = frameInfo.ObjectTable;
+        ArenaVector<DrawItem> drawList{ArenaAllocator<DrawItem>(frameInfo.FrameArena)};
+        drawList.reserve(objectTable.GetObjectCount());
+        for (uint32_t objectIndex = 0; objectIndex < objectTable.GetObjectCount(); objectIndex++)
+        {
+            drawList.push_back({objectTable.GetMesh(objectIndex), objectIndex});
+        }
+        std::ranges::sort(drawList, [](const DrawItem& a, const DrawItem& b)
+        {
+            return a.Mesh != b.Mesh ? a.Mesh.GetKey() < b.Mesh.GetKey() : a.ObjectIndex < b.ObjectIndex;
+        });
 
-        for (auto& val : frameInfo.GameObjects | std::views::values)
+        // Objects sharing a model with consecutive table indices become one instanced draw
+        for (size_t begin = 0; begin < drawList.size();)
         {
-            auto& obj = val;
-            if (obj.Model == nullptr) continue;
-            SimplePushConstantData push{};
-            push.ModelMatrix = obj.Transform.Mat4();
+            const DrawItem& first = drawList[begin];
+            size_t end = begin + 1;
+            while (end < drawList.size() && drawList[end].Mesh == first.Mesh &&
+                drawList[end].ObjectIndex == first.ObjectIndex + (end - begin))
+            {
+                end++;
+            }
 
-            vkCmdPushConstants(
-                frameInfo.CommandBuffer,
-                m_PipelineLayout,
-                VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
-                0,
-                sizeof(SimplePushConstantData),
-                &push
-            );
-            obj.Model->Bind(frameInfo.CommandBuffer);
-            obj.Model->Draw(frameInfo.CommandBuffer);
+            // The table only holds objects whose mesh was live at its update, which is this frame's
+            const Model* model = objectTable.GetModel(first.ObjectIndex);
+            if (begin == 0 || drawList[begin - 1].Mesh != first.Mesh)
+            {
+                model->Bind(frameInfo.CommandBuffer);
+            }
+            model->Draw(frameInfo.CommandBuffer, first.ObjectIndex, static_cast<uint32_t>(end - begin));
+            begin = end;
         }
     }
 }
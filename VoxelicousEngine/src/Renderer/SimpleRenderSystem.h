@@ -3,13 +3,19 @@
 #include "Pipeline.h"
 #include "Device.h"
 #include "FrameInfo.h"
+#include "BindlessRegistry.h"
 
 namespace VoxelicousEngine
 {
+    // Draws every object of the GPU object table. With a BindlessRegistry its set is bound as set 1 and objects
+    // whose material isn't BindlessRegistry::NO_MATERIAL are textured from it; without one (no descriptor
+    // indexing) every object keeps its vertex colours.
     class SimpleRenderSystem
     {
     public:
-        SimpleRenderSystem(Device& device, VkRenderPass renderPass, VkDescriptorSetLayout globalSetLayout);
+        SimpleRenderSystem(
+            Device& device, VkRenderPass renderPass, VkDescriptorSetLayout globalSetLayout,
+            const BindlessRegistry* bindless);
         ~SimpleRenderSystem();
 
         SimpleRenderSystem(const SimpleRenderSystem&) = delete;
@@ -22,6 +28,7 @@ namespace VoxelicousEngine
         void CreatePipeline(VkRenderPass renderPass);
 
         Device& m_Device;
+        const BindlessRegistry* m_Bindless;
 
         std::unique_ptr<Pipeline> m_Pipeline;
         VkPipelineLayout m_PipelineLayout;
@@ -1,17 +1,25 @@
 #include "vepch.h"
 #include "SwapChain.h"
 
+#include "Core/Core.h"
+#include "Core/FrameStats.h"
+
 namespace VoxelicousEngine
 {
-    SwapChain::SwapChain(Device& deviceRef, const VkExtent2D extent, const VkSurfaceKHR surface)
-        : m_Device{deviceRef}, m_WindowExtent{extent}
+    SwapChain::SwapChain(Device& deviceRef, const VkExtent2D extent, const VkSurfaceKHR surface,
+                         const VkPresentModeKHR preferredPresentMode, const uint32_t framesInFlight)
+        : m_PreferredPresentMode{preferredPresentMode}, m_FramesInFlight{framesInFlight},
+          m_Headless{surface == VK_NULL_HANDLE}, m_Device{deviceRef}, m_WindowExtent{extent}
     {
         Init(surface);
     }
 
     SwapChain::SwapChain(Device& deviceRef, const VkExtent2D extent, const VkSurfaceKHR surface,
+                         const VkPresentModeKHR preferredPresentMode, const uint32_t framesInFlight,
                          std::shared_ptr<SwapChain> previous)
-        : m_Device{deviceRef}, m_WindowExtent{extent}, m_OldSwapChain{std::move(previous)}
+        : m_PreferredPresentMode{preferredPresentMode}, m_FramesInFlight{framesInFlight},
+          m_Headless{surface == VK_NULL_HANDLE}, m_Device{deviceRef}, m_WindowExtent{extent},
+          m_OldSwapChain{std::move(previous)}
     {
         Init(surface);
 
@@ -20,7 +28,16 @@ namespace VoxelicousEngine
 
     void SwapChain::Init(const VkSurfaceKHR surface)
     {
-        CreateSwapChain(surface);
+        VE_CORE_ASSERT(m_FramesInFlight >= MIN_FRAMES_IN_FLIGHT && m_FramesInFlight <= MAX_FRAMES_IN_FLIGHT,
+                       "Frames in flight out of range!");
+        if (m_Headless)
+        {
+            CreateOffscreenImages();
+        }
+        else
+        {
+            CreateSwapChain(surface);
+        }
         CreateImageViews();
         CreateRenderPass();
         CreateDepthResources();
@@ -42,6 +59,12 @@ namespace VoxelicousEngine
             m_SwapChain = nullptr;
         }
 
+        for (size_t i = 0; i < m_OffscreenImageMemories.size(); i++)
+        {
+            vkDestroyImage(m_Device.GetDevice(), m_SwapChainImages[i], nullptr);
+            vkFreeMemory(m_Device.GetDevice(), m_OffscreenImageMemories[i], nullptr);
+        }
+
         for (size_t i = 0; i < m_DepthImages.size(); i++)
         {
             vkDestroyImageView(m_Device.GetDevice(), m_DepthImageViews[i], nullptr);
@@ -57,7 +80,7 @@ namespace VoxelicousEngine
         vkDestroyRenderPass(m_Device.GetDevice(), m_RenderPass, nullptr);
 
         // cleanup synchronization objects
-        for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+        for (size_t i = 0; i < m_FramesInFlight; i++)
         {
             vkDestroySemaphore(m_Device.GetDevice(), m_RenderFinishedSemaphores[i], nullptr);
             vkDestroySemaphore(m_Device.GetDevice(), m_ImageAvailableSemaphores[i], nullptr);
@@ -67,12 +90,23 @@ namespace VoxelicousEngine
 
     VkResult SwapChain::AcquireNextImage(uint32_t* imageIndex) const
     {
+        VE_PROFILE_FUNCTION();
+
+        const int64_t waitBegin = Profiler::Now();
         vkWaitForFences(
             m_Device.GetDevice(),
             1,
             &m_InFlightFences[m_CurrentFrame],
             VK_TRUE,
             std::numeric_limits<uint64_t>::max());
+        FrameStats::Get().Record(FrameMetric::FenceWait, Profiler::Now() - waitBegin);
+
+        if (m_Headless)
+        {
+            // Offscreen images are owned per frame, so the fence wait above is all the synchronization needed
+            *imageIndex = static_cast<uint32_t>(m_CurrentFrame);
+            return VK_SUCCESS;
+        }
 
         const VkResult result = vkAcquireNextImageKHR(
             m_Device.GetDevice(),
@@ -99,7 +133,7 @@ namespace VoxelicousEngine
 
         const VkSemaphore waitSemaphores[] = {m_ImageAvailableSemaphores[m_CurrentFrame]};
         constexpr VkPipelineStageFlags waitStages[] = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
-        submitInfo.waitSemaphoreCount = 1;
+        submitInfo.waitSemaphoreCount = m_Headless ? 0 : 1;
         submitInfo.pWaitSemaphores = waitSemaphores;
         submitInfo.pWaitDstStageMask = waitStages;
 
@@ -107,7 +141,7 @@ namespace VoxelicousEngine
         submitInfo.pCommandBuffers = buffers;
 
         const VkSemaphore signalSemaphores[] = {m_RenderFinishedSemaphores[m_CurrentFrame]};
-        submitInfo.signalSemaphoreCount = 1;
+        submitInfo.signalSemaphoreCount = m_Headless ? 0 : 1;
         submitInfo.pSignalSemaphores = signalSemaphores;
 
         vkResetFences(m_Device.GetDevice(), 1, &m_InFlightFences[m_CurrentFrame]);
@@ -116,6 +150,12 @@ namespace VoxelicousEngine
             VE_CORE_ERROR("Failed to submit draw command buffer!");
         }
 
+        if (m_Headless)
+        {
+            m_CurrentFrame = (m_CurrentFrame + 1) % m_FramesInFlight;
+            return VK_SUCCESS;
+        }
+
         VkPresentInfoKHR presentInfo = {};
         presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
 
@@ -128,9 +168,11 @@ namespace VoxelicousEngine
 
         presentInfo.pImageIndices = imageIndex;
 
+        const int64_t presentBegin = Profiler::Now();
         const auto result = vkQueuePresentKHR(m_Device.GetPresentQueue(), &presentInfo);
+        FrameStats::Get().Record(FrameMetric::Present, Profiler::Now() - presentBegin);
 
-        m_CurrentFrame = (m_CurrentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
+        m_CurrentFrame = (m_CurrentFrame + 1) % m_FramesInFlight;
 
         return result;
     }
@@ -140,7 +182,8 @@ namespace VoxelicousEngine
         const SwapChainSupportDetails swapChainSupport = m_Device.GetSwapChainSupport(surface);
 
         const VkSurfaceFormatKHR surfaceFormat = ChooseSwapSurfaceFormat(swapChainSupport.Formats);
-        const VkPresentModeKHR presentMode = ChooseSwapPresentMode(swapChainSupport.PresentModes);
+        const VkPresentModeKHR presentMode = ChooseSwapPresentMode(
+            swapChainSupport.PresentModes, m_PreferredPresentMode);
         const VkExtent2D extent = ChooseSwapExtent(swapChainSupport.Capabilities);
 
         uint32_t imageCount = swapChainSupport.Capabilities.minImageCount + 1;
@@ -200,6 +243,118 @@ namespace VoxelicousEngine
 
         m_SwapChainImageFormat = surfaceFormat.format;
         m_SwapChainExtent = extent;
+        m_PresentMode = presentMode;
+    }
+
+    void SwapChain::CreateOffscreenImages()
+    {
+        m_SwapChainImageFormat = m_Device.FindSupportedFormat(
+            {VK_FORMAT_B8G8R8A8_SRGB, VK_FORMAT_R8G8B8A8_SRGB},
+            VK_IMAGE_TILING_OPTIMAL,
+            VK_FORMAT_FEATURE_COLOR_ATTACHMENT_BIT | VK_FORMAT_FEATURE_TRANSFER_SRC_BIT);
+        m_SwapChainExtent = m_WindowExtent;
+        m_PresentMode = m_PreferredPresentMode;
+
+        m_SwapChainImages.resize(m_FramesInFlight);
+        m_OffscreenImageMemories.resize(m_FramesInFlight);
+
+        for (size_t i = 0; i < m_SwapChainImages.size(); i++)
+        {
+            VkImageCreateInfo imageInfo{};
+            imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+            imageInfo.imageType = VK_IMAGE_TYPE_2D;
+            imageInfo.extent.width = m_SwapChainExtent.width;
+            imageInfo.extent.height = m_SwapChainExtent.height;
+            imageInfo.extent.depth = 1;
+            imageInfo.mipLevels = 1;
+            imageInfo.arrayLayers = 1;
+            imageInfo.format = m_SwapChainImageFormat;
+            imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+            imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+            imageInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+            imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+            imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+            imageInfo.flags = 0;
+
+            m_Device.CreateImageWithInfo(
+                imageInfo,
+                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                m_SwapChainImages[i],
+                m_OffscreenImageMemories[i]);
+        }
+    }
+
+    void SwapChain::CopyImageToHost(const uint32_t imageIndex, std::vector<uint8_t>& pixels) const
+    {
+        VE_CORE_ASSERT(m_Headless, "Only headless swap chain images can be read back!");
+
+        constexpr VkDeviceSize bytesPerPixel = 4;
+        const VkDeviceSize imageSize =
+            static_cast<VkDeviceSize>(m_SwapChainExtent.width) * m_SwapChainExtent.height * bytesPerPixel;
+
+        VkBuffer stagingBuffer;
+        VkDeviceMemory stagingMemory;
+        m_Device.CreateBuffer(
+            imageSize,
+            VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            stagingBuffer,
+            stagingMemory);
+
+        const VkCommandBuffer commandBuffer = m_Device.BeginSingleTimeCommands();
+
+        // The render pass leaves the image in TRANSFER_SRC_OPTIMAL; make its color writes visible to the copy
+        VkImageMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = m_SwapChainImages[imageIndex];
+        barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        barrier.subresourceRange.baseMipLevel = 0;
+        barrier.subresourceRange.levelCount = 1;
+        barrier.subresourceRange.baseArrayLayer = 0;
+        barrier.subresourceRange.layerCount = 1;
+        vkCmdPipelineBarrier(
+            commandBuffer,
+            VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            0,
+            0, nullptr,
+            0, nullptr,
+            1, &barrier);
+
+        VkBufferImageCopy region{};
+        region.bufferOffset = 0;
+        region.bufferRowLength = 0;
+        region.bufferImageHeight = 0;
+        region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        region.imageSubresource.mipLevel = 0;
+        region.imageSubresource.baseArrayLayer = 0;
+        region.imageSubresource.layerCount = 1;
+        region.imageOffset = {0, 0, 0};
+        region.imageExtent = {m_SwapChainExtent.width, m_SwapChainExtent.height, 1};
+        vkCmdCopyImageToBuffer(
+            commandBuffer,
+            m_SwapChainImages[imageIndex],
+            VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+            stagingBuffer,
+            1,
+            &region);
+
+        m_Device.EndSingleTimeCommands(commandBuffer);
+
+        pixels.resize(imageSize);
+        void* mapped;
+        vkMapMemory(m_Device.GetDevice(), stagingMemory, 0, imageSize, 0, &mapped);
+        memcpy(pixels.data(), mapped, imageSize);
+        vkUnmapMemory(m_Device.GetDevice(), stagingMemory);
+
+        vkDestroyBuffer(m_Device.GetDevice(), stagingBuffer, nullptr);
+        vkFreeMemory(m_Device.GetDevice(), stagingMemory, nullptr);
     }
 
     void SwapChain::CreateImageViews()
@@ -249,7 +404,8 @@ namespace VoxelicousEngine
         colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
         colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
         colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-        colorAttachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+        colorAttachment.finalLayout =
+            m_Headless ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
 
         VkAttachmentReference colorAttachmentRef;
         colorAttachmentRef.attachment = 0;
@@ -370,9 +526,9 @@ namespace VoxelicousEngine
 
     void SwapChain::CreateSyncObjects()
     {
-        m_ImageAvailableSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
-        m_RenderFinishedSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
-        m_InFlightFences.resize(MAX_FRAMES_IN_FLIGHT);
+        m_ImageAvailableSemaphores.resize(m_FramesInFlight);
+        m_RenderFinishedSemaphores.resize(m_FramesInFlight);
+        m_InFlightFences.resize(m_FramesInFlight);
         m_ImagesInFlight.resize(ImageCount(), VK_NULL_HANDLE);
 
         VkSemaphoreCreateInfo semaphoreInfo = {};
@@ -382,7 +538,7 @@ namespace VoxelicousEngine
         fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
         fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
 
-        for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+        for (size_t i = 0; i < m_FramesInFlight; i++)
         {
             if (vkCreateSemaphore(m_Device.GetDevice(), &semaphoreInfo, nullptr, &m_ImageAvailableSemaphores[i]) !=
                 VK_SUCCESS ||
@@ -411,26 +567,46 @@ namespace VoxelicousEngine
     }
 
     VkPresentModeKHR SwapChain::ChooseSwapPresentMode(
-        const std::vector<VkPresentModeKHR>& availablePresentModes)
+        const std::vector<VkPresentModeKHR>& availablePresentModes, const VkPresentModeKHR preferredPresentMode)
     {
         for (const auto& availablePresentMode : availablePresentModes)
         {
-            if (availablePresentMode == VK_PRESENT_MODE_MAILBOX_KHR)
+            if (availablePresentMode == preferredPresentMode)
             {
-                VE_CORE_TRACE("Present mode: Mailbox");
+                VE_CORE_TRACE("Present mode: {}", PresentModeToString(availablePresentMode));
                 return availablePresentMode;
             }
         }
 
-        // for (const auto &availablePresentMode : availablePresentModes) {
-        //   if (availablePresentMode == VK_PRESENT_MODE_IMMEDIATE_KHR) {
-        //     std::cout << "Present mode: Immediate" << std::endl;
-        //     return availablePresentMode;
-        //   }
-        // }
+        // Mailbox keeps an uncapped frame rate where immediate is missing. Otherwise FIFO is the only mode the
+        // spec guarantees, so it is the fallback for anything unsupported.
+        VkPresentModeKHR fallback = VK_PRESENT_MODE_FIFO_KHR;
+        if (preferredPresentMode == VK_PRESENT_MODE_IMMEDIATE_KHR &&
+            std::find(availablePresentModes.begin(), availablePresentModes.end(), VK_PRESENT_MODE_MAILBOX_KHR) !=
+            availablePresentModes.end())
+        {
+            fallback = VK_PRESENT_MODE_MAILBOX_KHR;
+        }
+        VE_CORE_WARN("Present mode {} not supported, falling back to {}",
+                     PresentModeToString(preferredPresentMode), PresentModeToString(fallback));
+        return fallback;
+    }
 
-        VE_CORE_TRACE("Present mode: V-Sync");
-        return VK_PRESENT_MODE_FIFO_KHR;
+    const char* SwapChain::PresentModeToString(const VkPresentModeKHR presentMode)
+    {
+        switch (presentMode)
+        {
+        case VK_PRESENT_MODE_IMMEDIATE_KHR:
+            return "Immediate";
+        case VK_PRESENT_MODE_MAILBOX_KHR:
+            return "Mailbox";
+        case VK_PRESENT_MODE_FIFO_KHR:
+            return "V-Sync";
+        case VK_PRESENT_MODE_FIFO_RELAXED_KHR:
+            return "V-Sync (relaxed)";
+        default:
+            return "Unknown";
+        }
     }
 
     VkExtent2D SwapChain::ChooseSwapExtent(const VkSurfaceCapabilitiesKHR& capabilities) const
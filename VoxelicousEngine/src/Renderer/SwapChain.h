@@ -9,10 +9,15 @@ namespace VoxelicousEngine
     class SwapChain
     {
     public:
-        static constexpr int MAX_FRAMES_IN_FLIGHT = 2;
-
-        SwapChain(Device& deviceRef, VkExtent2D extent, VkSurfaceKHR surface);
-        SwapChain(Device& deviceRef, VkExtent2D extent, VkSurfaceKHR surface, std::shared_ptr<SwapChain> previous);
+        // Upper bound for per-frame resources; the active count is chosen at runtime via Renderer::SetFramesInFlight
+        static constexpr int MAX_FRAMES_IN_FLIGHT = 3;
+        static constexpr int MIN_FRAMES_IN_FLIGHT = 1;
+        static constexpr int DEFAULT_FRAMES_IN_FLIGHT = 2;
+
+        SwapChain(Device& deviceRef, VkExtent2D extent, VkSurfaceKHR surface,
+                  VkPresentModeKHR preferredPresentMode, uint32_t framesInFlight);
+        SwapChain(Device& deviceRef, VkExtent2D extent, VkSurfaceKHR surface,
+                  VkPresentModeKHR preferredPresentMode, uint32_t framesInFlight, std::shared_ptr<SwapChain> previous);
         ~SwapChain();
 
         SwapChain(const SwapChain&) = delete;
@@ -26,6 +31,9 @@ namespace VoxelicousEngine
         VkExtent2D GetSwapChainExtent() const { return m_SwapChainExtent; }
         uint32_t Width() const { return m_SwapChainExtent.width; }
         uint32_t Height() const { return m_SwapChainExtent.height; }
+        uint32_t GetFramesInFlight() const { return m_FramesInFlight; }
+        bool IsHeadless() const { return m_Headless; }
+        VkPresentModeKHR GetPresentMode() const { return m_PresentMode; }
 
         float ExtentAspectRatio() const
         {
@@ -33,10 +41,15 @@ namespace VoxelicousEngine
         }
 
         VkFormat FindDepthFormat() const;
+        static const char* PresentModeToString(VkPresentModeKHR presentMode);
 
         VkResult AcquireNextImage(uint32_t* imageIndex) const;
         VkResult SubmitCommandBuffers(const VkCommandBuffer* buffers, const uint32_t* imageIndex);
 
+        // Copies a rendered image into tightly packed host memory in GetSwapChainImageFormat() layout.
+        // Only available for headless swap chains, whose images are created with transfer source usage.
+        void CopyImageToHost(uint32_t imageIndex, std::vector<uint8_t>& pixels) const;
+
         bool CompareSwapFormats(const SwapChain& swapChain) const
         {
             return swapChain.m_SwapChainDepthFormat == m_SwapChainDepthFormat &&
@@ -46,6 +59,7 @@ namespace VoxelicousEngine
     private:
         void Init(VkSurfaceKHR surface);
         void CreateSwapChain(VkSurfaceKHR surface);
+        void CreateOffscreenImages();
         void CreateImageViews();
         void CreateDepthResources();
         void CreateRenderPass();
@@ -56,9 +70,13 @@ namespace VoxelicousEngine
         static VkSurfaceFormatKHR ChooseSwapSurfaceFormat(
             const std::vector<VkSurfaceFormatKHR>& availableFormats);
         static VkPresentModeKHR ChooseSwapPresentMode(
-            const std::vector<VkPresentModeKHR>& availablePresentModes);
+            const std::vector<VkPresentModeKHR>& availablePresentModes, VkPresentModeKHR preferredPresentMode);
         VkExtent2D ChooseSwapExtent(const VkSurfaceCapabilitiesKHR& capabilities) const;
 
+        VkPresentModeKHR m_PreferredPresentMode;
+        VkPresentModeKHR m_PresentMode;
+        uint32_t m_FramesInFlight;
+
         VkFormat m_SwapChainImageFormat;
         VkFormat m_SwapChainDepthFormat;
         VkExtent2D m_SwapChainExtent;
@@ -71,11 +89,14 @@ namespace VoxelicousEngine
         std::vector<VkImageView> m_DepthImageViews;
         std::vector<VkImage> m_SwapChainImages;
         std::vector<VkImageView> m_SwapChainImageViews;
+        // Headless mode owns its images instead of borrowing them from a VkSwapchainKHR
+        std::vector<VkDeviceMemory> m_OffscreenImageMemories;
+        bool m_Headless;
 
         Device& m_Device;
         VkExtent2D m_WindowExtent;
 
-        VkSwapchainKHR m_SwapChain;
+        VkSwapchainKHR m_SwapChain{VK_NULL_HANDLE};
         std::shared_ptr<SwapChain> m_OldSwapChain;
 
         std::vector<VkSemaphore> m_ImageAvailableSemaphores;
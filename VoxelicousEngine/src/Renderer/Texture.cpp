@@ -0,0 +1,154 @@
+#include "vepch.h"
+#include "Texture.h"
+#include "TextureUploader.h"
+#include "BindlessRegistry.h"
+
+#include "Assets/TexturePack.h"
+
+namespace VoxelicousEngine
+{
+    Texture::Texture(Device& device, const TextureData& texture, const bool isArray, const SamplerSettings& sampler)
+        : m_Device{device}, m_Format{ToVkFormat(texture.Format)}, m_Width{texture.Width}, m_Height{texture.Height},
+          m_MipCount{texture.MipCount}, m_LayerCount{texture.LayerCount}
+    {
+        assert(m_Width > 0 && m_Height > 0 && m_LayerCount > 0 && m_MipCount > 0 && "Texture has no pixels");
+        if (IsCompressedTextureFormat(texture.Format) && !m_Device.IsTextureCompressionBCSupported())
+        {
+            throw std::runtime_error("block-compressed textures are not supported by the device!");
+        }
+
+        VkImageCreateInfo imageInfo{};
+        imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        imageInfo.imageType = VK_IMAGE_TYPE_2D;
+        imageInfo.format = m_Format;
+        imageInfo.extent = {m_Width, m_Height, 1};
+        imageInfo.mipLevels = m_MipCount;
+        imageInfo.arrayLayers = m_LayerCount;
+        imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+        imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+        imageInfo.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+        imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        m_Device.CreateImageWithInfo(imageInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_Image, m_Memory);
+
+        VkImageViewCreateInfo viewInfo{};
+        viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        viewInfo.image = m_Image;
+        viewInfo.viewType = isArray ? VK_IMAGE_VIEW_TYPE_2D_ARRAY : VK_IMAGE_VIEW_TYPE_2D;
+        viewInfo.format = m_Format;
+        viewInfo.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, m_MipCount, 0, m_LayerCount};
+        if (vkCreateImageView(m_Device.GetDevice(), &viewInfo, nullptr, &m_ImageView) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create texture image view!");
+        }
+
+        VkSamplerCreateInfo samplerInfo{};
+        samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+        samplerInfo.magFilter = sampler.MagFilter;
+        samplerInfo.minFilter = VK_FILTER_LINEAR;
+        samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+        samplerInfo.addressModeU = sampler.AddressMode;
+        samplerInfo.addressModeV = sampler.AddressMode;
+        samplerInfo.addressModeW = sampler.AddressMode;
+        samplerInfo.anisotropyEnable = sampler.MaxAnisotropy > 1.0f ? VK_TRUE : VK_FALSE;
+        samplerInfo.maxAnisotropy = std::min(sampler.MaxAnisotropy, m_Device.Properties.limits.maxSamplerAnisotropy);
+        samplerInfo.minLod = 0.0f;
+        samplerInfo.maxLod = static_cast<float>(m_MipCount);
+        samplerInfo.borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
+        if (vkCreateSampler(m_Device.GetDevice(), &samplerInfo, nullptr, &m_Sampler) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create texture sampler!");
+        }
+    }
+
+    Texture::Texture(Texture&& other) noexcept
+        : m_Device{other.m_Device},
+          m_Image{std::exchange(other.m_Image, VK_NULL_HANDLE)},
+          m_Memory{std::exchange(other.m_Memory, VK_NULL_HANDLE)},
+          m_ImageView{std::exchange(other.m_ImageView, VK_NULL_HANDLE)},
+          m_Sampler{std::exchange(other.m_Sampler, VK_NULL_HANDLE)},
+          m_Format{other.m_Format},
+          m_Width{other.m_Width},
+          m_Height{other.m_Height},
+          m_MipCount{other.m_MipCount},
+          m_LayerCount{other.m_LayerCount}
+    {
+    }
+
+    Texture::~Texture()
+    {
+        vkDestroySampler(m_Device.GetDevice(), m_Sampler, nullptr);
+        vkDestroyImageView(m_Device.GetDevice(), m_ImageView, nullptr);
+        vkDestroyImage(m_Device.GetDevice(), m_Image, nullptr);
+        vkFreeMemory(m_Device.GetDevice(), m_Memory, nullptr);
+    }
+
+    VkFormat Texture::ToVkFormat(const TextureFormat format)
+    {
+        switch (format)
+        {
+        case TextureFormat::RGBA8Unorm: return VK_FORMAT_R8G8B8A8_UNORM;
+        case TextureFormat::RGBA8Srgb: return VK_FORMAT_R8G8B8A8_SRGB;
+        case TextureFormat::BC1RgbaUnorm: return VK_FORMAT_BC1_RGBA_UNORM_BLOCK;
+        case TextureFormat::BC1RgbaSrgb: return VK_FORMAT_BC1_RGBA_SRGB_BLOCK;
+        case TextureFormat::BC4Unorm: return VK_FORMAT_BC4_UNORM_BLOCK;
+        case TextureFormat::BC5Unorm: return VK_FORMAT_BC5_UNORM_BLOCK;
+        case TextureFormat::BC7Unorm: return VK_FORMAT_BC7_UNORM_BLOCK;
+        case TextureFormat::BC7Srgb: return VK_FORMAT_BC7_SRGB_BLOCK;
+        }
+        throw std::runtime_error("unsupported texture format!");
+    }
+
+    TextureArray::TextureArray(
+        Device& device, const TextureData& texture, const SamplerSettings& sampler, BindlessRegistry* bindless)
+        : Texture(device, texture, true, sampler), m_Bindless{bindless},
+          m_BindlessIndex{bindless ? bindless->RegisterTexture(*this) : BindlessRegistry::INVALID_INDEX}
+    {
+        m_LayerLookup.reserve(texture.LayerNames.size());
+        for (uint32_t layer = 0; layer < texture.LayerNames.size(); layer++)
+        {
+            m_LayerLookup.emplace(texture.LayerNames[layer], layer);
+        }
+    }
+
+    TextureArray::TextureArray(TextureArray&& other) noexcept
+        : Texture(std::move(other)),
+          m_LayerLookup{std::move(other.m_LayerLookup)},
+          m_Bindless{std::exchange(other.m_Bindless, nullptr)},
+          m_BindlessIndex{std::exchange(other.m_BindlessIndex, BindlessRegistry::INVALID_INDEX)}
+    {
+    }
+
+    // The registry holds the index back for the frames in flight, the image itself is usually destroyed through
+    // the device's DeletionQueue
+    TextureArray::~TextureArray()
+    {
+        if (m_Bindless && m_BindlessIndex != BindlessRegistry::INVALID_INDEX)
+        {
+            m_Bindless->ReleaseTexture(m_BindlessIndex);
+        }
+    }
+
+    std::unique_ptr<TextureArray> TextureArray::LoadPack(
+        Device& device, TextureUploader& uploader, const std::string& filePath, const SamplerSettings& sampler,
+        BindlessRegistry* bindless)
+    {
+        VE_PROFILE_FUNCTION();
+
+        TextureData texture;
+        if (!TexturePack::Read(filePath, texture))
+        {
+            throw std::runtime_error("failed to load texture pack " + filePath + "!");
+        }
+
+        auto textureArray = std::make_unique<TextureArray>(device, texture, sampler, bindless);
+        uploader.Enqueue(*textureArray, std::move(texture));
+        return textureArray;
+    }
+
+    uint32_t TextureArray::GetLayer(const std::string& name) const
+    {
+        const auto it = m_LayerLookup.find(name);
+        return it != m_LayerLookup.end() ? it->second : INVALID_LAYER;
+    }
+}
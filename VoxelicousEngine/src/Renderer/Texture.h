@@ -0,0 +1,100 @@
+#pragma once
+
+#include "Device.h"
+#include "Assets/TextureData.h"
+
+namespace VoxelicousEngine
+{
+    class TextureUploader;
+    class BindlessRegistry;
+
+    // A sampled 2D image with its mip chain, view and sampler. Creating a texture only allocates it, the pixels
+    // arrive through a TextureUploader, which also moves it to SHADER_READ_ONLY_OPTIMAL.
+    class Texture
+    {
+    public:
+        struct SamplerSettings
+        {
+            // Nearest keeps voxel block textures crisp up close, minification always filters between mips
+            VkFilter MagFilter = VK_FILTER_NEAREST;
+            VkSamplerAddressMode AddressMode = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+            float MaxAnisotropy = 8.0f;
+        };
+
+        // Array textures always get a 2D_ARRAY view, even with a single layer
+        Texture(Device& device, const TextureData& texture, bool isArray, const SamplerSettings& sampler);
+        Texture(Device& device, const TextureData& texture) : Texture(device, texture, false, {})
+        {
+        }
+        virtual ~Texture();
+
+        Texture(const Texture&) = delete;
+        Texture& operator=(const Texture&) = delete;
+        // The moved-from texture is left empty and destroys nothing
+        Texture(Texture&& other) noexcept;
+
+        VkImage GetImage() const { return m_Image; }
+        VkImageView GetImageView() const { return m_ImageView; }
+        VkSampler GetSampler() const { return m_Sampler; }
+        VkFormat GetFormat() const { return m_Format; }
+        uint32_t GetWidth() const { return m_Width; }
+        uint32_t GetHeight() const { return m_Height; }
+        uint32_t GetMipCount() const { return m_MipCount; }
+        uint32_t GetLayerCount() const { return m_LayerCount; }
+
+        VkDescriptorImageInfo DescriptorInfo() const
+        {
+            return {m_Sampler, m_ImageView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+        }
+
+        static VkFormat ToVkFormat(TextureFormat format);
+
+    protected:
+        Device& m_Device;
+
+    private:
+        VkImage m_Image{VK_NULL_HANDLE};
+        VkDeviceMemory m_Memory{VK_NULL_HANDLE};
+        VkImageView m_ImageView{VK_NULL_HANDLE};
+        VkSampler m_Sampler{VK_NULL_HANDLE};
+        VkFormat m_Format;
+        uint32_t m_Width;
+        uint32_t m_Height;
+        uint32_t m_MipCount;
+        uint32_t m_LayerCount;
+    };
+
+    // Equally sized textures in the layers of one image, e.g. every voxel block texture. Shaders sample it as a
+    // sampler2DArray with the layer as third coordinate, so a whole chunk draws with a single binding.
+    //
+    // Given a BindlessRegistry, the array registers itself on creation and releases its index when destroyed;
+    // materials then refer to its layers through BindlessRegistry::MakeMaterialIndex(GetBindlessIndex(), layer).
+    class TextureArray : public Texture
+    {
+    public:
+        static constexpr uint32_t INVALID_LAYER = UINT32_MAX;
+
+        TextureArray(
+            Device& device, const TextureData& texture, const SamplerSettings& sampler = {},
+            BindlessRegistry* bindless = nullptr);
+        ~TextureArray() override;
+
+        TextureArray(TextureArray&& other) noexcept;
+
+        // Loads a texture pack and queues its upload, the array is ready for sampling after the next
+        // TextureUploader::Flush. Block-compressed packs upload as stored. Throws when the pack can't be read.
+        static std::unique_ptr<TextureArray> LoadPack(
+            Device& device, TextureUploader& uploader, const std::string& filePath, const SamplerSettings& sampler = {},
+            BindlessRegistry* bindless = nullptr);
+
+        // Layer of a named texture, or INVALID_LAYER
+        uint32_t GetLayer(const std::string& name) const;
+        // Index in the registry's texture array, or BindlessRegistry::INVALID_INDEX when not registered
+        uint32_t GetBindlessIndex() const { return m_BindlessIndex; }
+
+    private:
+        std::unordered_map<std::string, uint32_t> m_LayerLookup;
+        BindlessRegistry* m_Bindless;
+        uint32_t m_BindlessIndex;
+    };
+}
@@ -0,0 +1,134 @@
+#include "vepch.h"
+#include "TextureUploader.h"
+#include "Buffer.h"
+
+namespace VoxelicousEngine
+{
+    namespace
+    {
+        // Copy offsets must be multiples of the texel block size and of 4, 16 covers every format
+        constexpr VkDeviceSize STAGING_ALIGNMENT = 16;
+
+        VkImageMemoryBarrier MakeLayoutBarrier(
+            const Texture& texture, const VkImageLayout oldLayout, const VkImageLayout newLayout,
+            const VkAccessFlags srcAccess, const VkAccessFlags dstAccess)
+        {
+            VkImageMemoryBarrier barrier{};
+            barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+            barrier.oldLayout = oldLayout;
+            barrier.newLayout = newLayout;
+            barrier.srcAccessMask = srcAccess;
+            barrier.dstAccessMask = dstAccess;
+            barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.image = texture.GetImage();
+            barrier.subresourceRange = {
+                VK_IMAGE_ASPECT_COLOR_BIT, 0, texture.GetMipCount(), 0, texture.GetLayerCount()
+            };
+            return barrier;
+        }
+    }
+
+    TextureUploader::TextureUploader(Device& device) : m_Device{device}
+    {
+    }
+
+    TextureUploader::~TextureUploader()
+    {
+        if (!m_Pending.empty())
+        {
+            VE_CORE_WARN("{0} texture uploads were never flushed", m_Pending.size());
+        }
+    }
+
+    void TextureUploader::Enqueue(Texture& texture, const TextureData& data)
+    {
+        assert(data.Pixels.size() == data.GetTotalSize() && "Texture data doesn't match its size");
+        assert(data.MipCount == texture.GetMipCount() && data.LayerCount == texture.GetLayerCount() &&
+            "Texture data doesn't match the texture");
+        m_Pending.push_back({&texture, &data});
+    }
+
+    void TextureUploader::Enqueue(Texture& texture, TextureData&& data)
+    {
+        m_OwnedData.push_back(std::make_unique<TextureData>(std::move(data)));
+        Enqueue(texture, *m_OwnedData.back());
+    }
+
+    void TextureUploader::Flush()
+    {
+        VE_PROFILE_FUNCTION();
+
+        if (m_Pending.empty())
+        {
+            return;
+        }
+
+        std::vector<VkDeviceSize> offsets;
+        offsets.reserve(m_Pending.size());
+        VkDeviceSize stagingSize = 0;
+        for (const PendingUpload& upload : m_Pending)
+        {
+            offsets.push_back(stagingSize);
+            stagingSize += (upload.Data->Pixels.size() + STAGING_ALIGNMENT - 1) & ~(STAGING_ALIGNMENT - 1);
+        }
+
+        Buffer stagingBuffer{
+            m_Device,
+            stagingSize,
+            1,
+            VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+        };
+        stagingBuffer.Map();
+
+        std::vector<VkImageMemoryBarrier> toTransfer;
+        std::vector<VkImageMemoryBarrier> toShaderRead;
+        toTransfer.reserve(m_Pending.size());
+        toShaderRead.reserve(m_Pending.size());
+        for (size_t i = 0; i < m_Pending.size(); i++)
+        {
+            const PendingUpload& upload = m_Pending[i];
+            stagingBuffer.WriteToBuffer(upload.Data->Pixels.data(), upload.Data->Pixels.size(), offsets[i]);
+            toTransfer.push_back(MakeLayoutBarrier(
+                *upload.Target, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                0, VK_ACCESS_TRANSFER_WRITE_BIT));
+            toShaderRead.push_back(MakeLayoutBarrier(
+                *upload.Target, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT));
+        }
+
+        const VkCommandBuffer commandBuffer = m_Device.BeginSingleTimeCommands();
+        vkCmdPipelineBarrier(
+            commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
+            0, nullptr, 0, nullptr, static_cast<uint32_t>(toTransfer.size()), toTransfer.data());
+
+        std::vector<VkBufferImageCopy> regions;
+        for (size_t i = 0; i < m_Pending.size(); i++)
+        {
+            const TextureData& data = *m_Pending[i].Data;
+            regions.clear();
+            for (uint32_t mip = 0; mip < data.MipCount; mip++)
+            {
+                VkBufferImageCopy region{};
+                region.bufferOffset = offsets[i] + data.GetMipOffset(mip);
+                region.imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, mip, 0, data.LayerCount};
+                region.imageExtent = {data.GetMipWidth(mip), data.GetMipHeight(mip), 1};
+                regions.push_back(region);
+            }
+            vkCmdCopyBufferToImage(
+                commandBuffer, stagingBuffer.GetBuffer(), m_Pending[i].Target->GetImage(),
+                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, static_cast<uint32_t>(regions.size()), regions.data());
+        }
+
+        vkCmdPipelineBarrier(
+            commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+            VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0,
+            0, nullptr, 0, nullptr, static_cast<uint32_t>(toShaderRead.size()), toShaderRead.data());
+        m_Device.EndSingleTimeCommands(commandBuffer);
+
+        VE_CORE_INFO("Uploaded {0} textures ({1} KiB) in one submission", m_Pending.size(), stagingSize / 1024);
+        m_Pending.clear();
+        m_OwnedData.clear();
+    }
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "Texture.h"
+
+namespace VoxelicousEngine
+{
+    // Collects texture uploads and submits them together: one staging buffer holding every queued mip chain and
+    // one command buffer with a barrier batch into TRANSFER_DST, one copy per image (a region per mip covering all
+    // layers) and a barrier batch into SHADER_READ_ONLY. Loading many textures costs a single queue submission
+    // and wait instead of one per image.
+    class TextureUploader
+    {
+    public:
+        explicit TextureUploader(Device& device);
+        ~TextureUploader();
+
+        TextureUploader(const TextureUploader&) = delete;
+        TextureUploader& operator=(const TextureUploader&) = delete;
+
+        // The texture and the data must stay alive until Flush
+        void Enqueue(Texture& texture, const TextureData& data);
+        // Takes ownership of the data, for loaders that don't keep the CPU copy
+        void Enqueue(Texture& texture, TextureData&& data);
+
+        // Records and submits every queued upload, then waits for the copies to finish
+        void Flush();
+
+        size_t GetPendingCount() const { return m_Pending.size(); }
+
+    private:
+        struct PendingUpload
+        {
+            Texture* Target;
+            const TextureData* Data;
+        };
+
+        Device& m_Device;
+        std::vector<PendingUpload> m_Pending;
+        std::vector<std::unique_ptr<TextureData>> m_OwnedData;
+    };
+}
@@ -0,0 +1,20 @@
+#include "vepch.h"
+#include "Chunk.h"
+
+namespace VoxelicousEngine
+{
+    void Chunk::Set(const int32_t x, const int32_t y, const int32_t z, const VoxelId voxel)
+    {
+        assert(IsInside(x, y, z) && "Voxel coordinate outside of the chunk");
+
+        VoxelId& current = m_Voxels[GetIndex(x, y, z)];
+        m_SolidCount += static_cast<uint32_t>(IsSolid(voxel)) - static_cast<uint32_t>(IsSolid(current));
+        current = voxel;
+    }
+
+    void Chunk::Fill(const VoxelId voxel)
+    {
+        m_Voxels.fill(voxel);
+        m_SolidCount = IsSolid(voxel) ? VOLUME : 0;
+    }
+}
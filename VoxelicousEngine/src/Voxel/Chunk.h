@@ -0,0 +1,37 @@
+#pragma once
+
+#include "Voxel.h"
+
+#include <array>
+
+namespace VoxelicousEngine
+{
+    // Cubic block of voxels stored as a flat x-major array
+    class Chunk
+    {
+    public:
+        static constexpr int32_t SIZE = 32;
+        static constexpr int32_t VOLUME = SIZE * SIZE * SIZE;
+
+        static constexpr bool IsInside(const int32_t x, const int32_t y, const int32_t z)
+        {
+            return x >= 0 && y >= 0 && z >= 0 && x < SIZE && y < SIZE && z < SIZE;
+        }
+
+        static constexpr int32_t GetIndex(const int32_t x, const int32_t y, const int32_t z)
+        {
+            return x + SIZE * (y + SIZE * z);
+        }
+
+        VoxelId Get(const int32_t x, const int32_t y, const int32_t z) const { return m_Voxels[GetIndex(x, y, z)]; }
+        void Set(int32_t x, int32_t y, int32_t z, VoxelId voxel);
+        void Fill(VoxelId voxel);
+
+        bool IsEmpty() const { return m_SolidCount == 0; }
+        uint32_t GetSolidCount() const { return m_SolidCount; }
+
+    private:
+        std::array<VoxelId, VOLUME> m_Voxels{};
+        uint32_t m_SolidCount = 0;
+    };
+}
@@ -0,0 +1,161 @@
+#include "vepch.h"
+#include "ChunkMesher.h"
+#include "World.h"
+
+namespace VoxelicousEngine
+{
+    namespace
+    {
+        VoxelId Sample(const Chunk& chunk, const ChunkNeighbours& neighbours, glm::ivec3 position)
+        {
+            if (Chunk::IsInside(position.x, position.y, position.z))
+            {
+                return chunk.Get(position.x, position.y, position.z);
+            }
+
+            // Samples leave the chunk by at most one voxel along a single axis
+            uint32_t side = 0;
+            for (int32_t axis = 0; axis < 3; axis++)
+            {
+                if (position[axis] < 0)
+                {
+                    side = axis * 2;
+                    position[axis] += Chunk::SIZE;
+                }
+                else if (position[axis] >= Chunk::SIZE)
+                {
+                    side = axis * 2 + 1;
+                    position[axis] -= Chunk::SIZE;
+                }
+            }
+
+            const Chunk* neighbour = neighbours.Chunks[side];
+            return neighbour ? neighbour->Get(position.x, position.y, position.z) : Voxels::AIR;
+        }
+
+        void EmitQuad(MeshData& mesh, const glm::vec3& origin, const glm::vec3& du, const glm::vec3& dv,
+                      const glm::vec3& normal, const bool positive, const VoxelId voxel)
+        {
+            const auto base = static_cast<uint32_t>(mesh.Vertices.size());
+            const glm::vec3 color = GetVoxelColor(voxel);
+            const float width = glm::length(du);
+            const float height = glm::length(dv);
+
+            mesh.Vertices.push_back({origin, color, normal, {0.0f, 0.0f}});
+            mesh.Vertices.push_back({origin + du, color, normal, {width, 0.0f}});
+            mesh.Vertices.push_back({origin + du + dv, color, normal, {width, height}});
+            mesh.Vertices.push_back({origin + dv, color, normal, {0.0f, height}});
+
+            // du x dv points along the positive axis; flip the winding for faces pointing the other way
+            if (positive)
+                mesh.Indices.insert(mesh.Indices.end(), {base, base + 1, base + 2, base, base + 2, base + 3});
+            else
+                mesh.Indices.insert(mesh.Indices.end(), {base, base + 2, base + 1, base, base + 3, base + 2});
+        }
+    }
+
+    ChunkNeighbours ChunkNeighbours::FromWorld(const World& world, const glm::ivec3& chunkCoord)
+    {
+        ChunkNeighbours neighbours;
+        for (int32_t axis = 0; axis < 3; axis++)
+        {
+            glm::ivec3 offset{0};
+            offset[axis] = -1;
+            neighbours.Chunks[axis * 2] = world.GetChunk(chunkCoord + offset);
+            offset[axis] = 1;
+            neighbours.Chunks[axis * 2 + 1] = world.GetChunk(chunkCoord + offset);
+        }
+        return neighbours;
+    }
+
+    uint32_t ChunkMesher::Mesh(const Chunk& chunk, const ChunkNeighbours& neighbours, MeshData& mesh)
+    {
+        VE_ALLOCATION_SCOPE(Voxel);
+
+        if (chunk.IsEmpty())
+        {
+            return 0;
+        }
+
+        constexpr int32_t size = Chunk::SIZE;
+        std::array<VoxelId, size * size> mask{};
+        uint32_t quadCount = 0;
+
+        for (int32_t axis = 0; axis < 3; axis++)
+        {
+            // u, v and axis form a right-handed basis
+            const int32_t u = (axis + 1) % 3;
+            const int32_t v = (axis + 2) % 3;
+
+            for (const bool positive : {false, true})
+            {
+                glm::vec3 normal{0.0f};
+                normal[axis] = positive ? 1.0f : -1.0f;
+
+                for (int32_t slice = 0; slice < size; slice++)
+                {
+                    // A face is visible where a solid voxel borders air in the face direction
+                    for (int32_t j = 0; j < size; j++)
+                    {
+                        for (int32_t i = 0; i < size; i++)
+                        {
+                            glm::ivec3 position;
+                            position[axis] = slice;
+                            position[u] = i;
+                            position[v] = j;
+                            const VoxelId voxel = chunk.Get(position.x, position.y, position.z);
+
+                            position[axis] += positive ? 1 : -1;
+                            const bool visible = IsSolid(voxel) && !IsSolid(Sample(chunk, neighbours, position));
+                            mask[i + j * size] = visible ? voxel : Voxels::AIR;
+                        }
+                    }
+
+                    for (int32_t j = 0; j < size; j++)
+                    {
+                        for (int32_t i = 0; i < size;)
+                        {
+                            const VoxelId voxel = mask[i + j * size];
+                            if (voxel == Voxels::AIR)
+                            {
+                                i++;
+                                continue;
+                            }
+
+                            int32_t width = 1;
+                            while (i + width < size && mask[i + width + j * size] == voxel)
+                                width++;
+
+                            int32_t height = 1;
+                            for (; j + height < size; height++)
+                            {
+                                const VoxelId* row = &mask[i + (j + height) * size];
+                                if (!std::all_of(row, row + width, [voxel](const VoxelId id) { return id == voxel; }))
+                                    break;
+                            }
+
+                            for (int32_t h = 0; h < height; h++)
+                            {
+                                std::fill_n(&mask[i + (j + h) * size], width, Voxels::AIR);
+                            }
+
+                            glm::vec3 origin{0.0f};
+                            origin[axis] = static_cast<float>(slice + (positive ? 1 : 0));
+                            origin[u] = static_cast<float>(i);
+                            origin[v] = static_cast<float>(j);
+                            glm::vec3 du{0.0f};
+                            du[u] = static_cast<float>(width);
+                            glm::vec3 dv{0.0f};
+                            dv[v] = static_cast<float>(height);
+
+                            EmitQuad(mesh, origin, du, dv, normal, positive, voxel);
+                            quadCount++;
+                            i += width;
+                        }
+                    }
+                }
+            }
+        }
+        return quadCount;
+    }
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "Chunk.h"
+#include "Core/Mesh.h"
+
+namespace VoxelicousEngine
+{
+    class World;
+
+    // The six face-adjacent chunks, used to cull faces on chunk borders. Missing neighbours count as air.
+    struct ChunkNeighbours
+    {
+        enum Side : uint32_t { NegativeX, PositiveX, NegativeY, PositiveY, NegativeZ, PositiveZ, Count };
+
+        std::array<const Chunk*, Count> Chunks{};
+
+        static ChunkNeighbours FromWorld(const World& world, const glm::ivec3& chunkCoord);
+    };
+
+    // Greedy mesher: merges coplanar visible faces of the same voxel type into larger quads, slice by
+    // slice along each axis. Vertex positions are in chunk-local voxel units.
+    class ChunkMesher
+    {
+    public:
+        // Appends the chunk's quads to mesh, returns the number of quads written
+        static uint32_t Mesh(const Chunk& chunk, const ChunkNeighbours& neighbours, MeshData& mesh);
+    };
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "Core/Math.h"
+
+#include <cstdint>
+
+namespace VoxelicousEngine
+{
+    using VoxelId = uint16_t;
+
+    namespace Voxels
+    {
+        constexpr VoxelId AIR = 0;
+        constexpr VoxelId STONE = 1;
+        constexpr VoxelId DIRT = 2;
+        constexpr VoxelId GRASS = 3;
+        constexpr VoxelId SAND = 4;
+        constexpr VoxelId COUNT = 5;
+    }
+
+    inline bool IsSolid(const VoxelId voxel) { return voxel != Voxels::AIR; }
+
+    inline glm::vec3 GetVoxelColor(const VoxelId voxel)
+    {
+        switch (voxel)
+        {
+        case Voxels::STONE: return {0.5f, 0.5f, 0.5f};
+        case Voxels::DIRT: return {0.45f, 0.3f, 0.15f};
+        case Voxels::GRASS: return {0.2f, 0.65f, 0.2f};
+        case Voxels::SAND: return {0.85f, 0.8f, 0.55f};
+        default: return {1.0f, 0.0f, 1.0f};
+        }
+    }
+}
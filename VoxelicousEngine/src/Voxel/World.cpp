@@ -0,0 +1,68 @@
+#include "vepch.h"
+#include "World.h"
+
+namespace VoxelicousEngine
+{
+    namespace
+    {
+        // Rounds towards negative infinity so that voxel -1 lands in chunk -1
+        int32_t FloorDiv(const int32_t value, const int32_t divisor)
+        {
+            return (value >= 0 ? value : value - divisor + 1) / divisor;
+        }
+    }
+
+    Chunk* World::GetChunk(const glm::ivec3& chunkCoord)
+    {
+        const auto it = m_Chunks.find(chunkCoord);
+        return it != m_Chunks.end() ? it->second.get() : nullptr;
+    }
+
+    const Chunk* World::GetChunk(const glm::ivec3& chunkCoord) const
+    {
+        const auto it = m_Chunks.find(chunkCoord);
+        return it != m_Chunks.end() ? it->second.get() : nullptr;
+    }
+
+    Chunk& World::GetOrCreateChunk(const glm::ivec3& chunkCoord)
+    {
+        auto& chunk = m_Chunks[chunkCoord];
+        if (!chunk)
+        {
+            chunk = std::make_unique<Chunk>();
+        }
+        return *chunk;
+    }
+
+    VoxelId World::GetVoxel(const glm::ivec3& worldPosition) const
+    {
+        const Chunk* chunk = GetChunk(WorldToChunk(worldPosition));
+        if (!chunk)
+        {
+            return Voxels::AIR;
+        }
+
+        const glm::ivec3 local = WorldToLocal(worldPosition);
+        return chunk->Get(local.x, local.y, local.z);
+    }
+
+    void World::SetVoxel(const glm::ivec3& worldPosition, const VoxelId voxel)
+    {
+        const glm::ivec3 local = WorldToLocal(worldPosition);
+        GetOrCreateChunk(WorldToChunk(worldPosition)).Set(local.x, local.y, local.z, voxel);
+    }
+
+    glm::ivec3 World::WorldToChunk(const glm::ivec3& worldPosition)
+    {
+        return {
+            FloorDiv(worldPosition.x, Chunk::SIZE),
+            FloorDiv(worldPosition.y, Chunk::SIZE),
+            FloorDiv(worldPosition.z, Chunk::SIZE)
+        };
+    }
+
+    glm::ivec3 World::WorldToLocal(const glm::ivec3& worldPosition)
+    {
+        return worldPosition - WorldToChunk(worldPosition) * Chunk::SIZE;
+    }
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "Chunk.h"
+
+#include <memory>
+#include <unordered_map>
+
+namespace VoxelicousEngine
+{
+    struct ChunkCoordHash
+    {
+        size_t operator()(const glm::ivec3& coord) const
+        {
+            // Large primes spread neighbouring coordinates over the buckets
+            return static_cast<size_t>(coord.x) * 73856093u
+                ^ static_cast<size_t>(coord.y) * 19349663u
+                ^ static_cast<size_t>(coord.z) * 83492791u;
+        }
+    };
+
+    // Sparse set of chunks addressed by chunk coordinates. Not thread safe: create chunks up front and
+    // then fill or mesh distinct chunks from worker threads.
+    class World
+    {
+    public:
+        using ChunkMap = std::unordered_map<glm::ivec3, std::unique_ptr<Chunk>, ChunkCoordHash>;
+
+        Chunk* GetChunk(const glm::ivec3& chunkCoord);
+        const Chunk* GetChunk(const glm::ivec3& chunkCoord) const;
+        Chunk& GetOrCreateChunk(const glm::ivec3& chunkCoord);
+        void RemoveChunk(const glm::ivec3& chunkCoord) { m_Chunks.erase(chunkCoord); }
+
+        VoxelId GetVoxel(const glm::ivec3& worldPosition) const;
+        void SetVoxel(const glm::ivec3& worldPosition, VoxelId voxel);
+
+        const ChunkMap& GetChunks() const { return m_Chunks; }
+
+        static glm::ivec3 WorldToChunk(const glm::ivec3& worldPosition);
+        static glm::ivec3 WorldToLocal(const glm::ivec3& worldPosition);
+
+    private:
+        ChunkMap m_Chunks;
+    };
+}
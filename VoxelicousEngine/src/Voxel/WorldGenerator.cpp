@@ -0,0 +1,98 @@
+#include "vepch.h"
+#include "WorldGenerator.h"
+
+#include <cmath>
+
+namespace VoxelicousEngine
+{
+    namespace
+    {
+        uint32_t HashLattice(const int32_t x, const int32_t z, const uint32_t seed)
+        {
+            uint32_t hash = seed;
+            hash ^= static_cast<uint32_t>(x) * 0x27d4eb2du;
+            hash = (hash ^ (hash >> 15)) * 0x85ebca6bu;
+            hash ^= static_cast<uint32_t>(z) * 0x165667b1u;
+            hash = (hash ^ (hash >> 13)) * 0xc2b2ae35u;
+            return hash ^ (hash >> 16);
+        }
+
+        float ToUnitFloat(const uint32_t hash)
+        {
+            return static_cast<float>(hash >> 8) * (1.0f / 16777216.0f);
+        }
+    }
+
+    float WorldGenerator::ValueNoise(const float x, const float z, const uint32_t octave) const
+    {
+        const float cellX = std::floor(x);
+        const float cellZ = std::floor(z);
+        const auto x0 = static_cast<int32_t>(cellX);
+        const auto z0 = static_cast<int32_t>(cellZ);
+        const uint32_t seed = m_Settings.Seed + octave * 0x9e3779b9u;
+
+        // Smoothstep keeps the interpolated surface free of visible creases at cell borders
+        float tx = x - cellX;
+        float tz = z - cellZ;
+        tx = tx * tx * (3.0f - 2.0f * tx);
+        tz = tz * tz * (3.0f - 2.0f * tz);
+
+        const float v00 = ToUnitFloat(HashLattice(x0, z0, seed));
+        const float v10 = ToUnitFloat(HashLattice(x0 + 1, z0, seed));
+        const float v01 = ToUnitFloat(HashLattice(x0, z0 + 1, seed));
+        const float v11 = ToUnitFloat(HashLattice(x0 + 1, z0 + 1, seed));
+
+        const float near = v00 + (v10 - v00) * tx;
+        const float far = v01 + (v11 - v01) * tx;
+        return near + (far - near) * tz;
+    }
+
+    int32_t WorldGenerator::GetHeight(const int32_t worldX, const int32_t worldZ) const
+    {
+        float x = static_cast<float>(worldX) * m_Settings.Frequency;
+        float z = static_cast<float>(worldZ) * m_Settings.Frequency;
+
+        float value = 0.0f;
+        float amplitude = 0.5f;
+        float totalAmplitude = 0.0f;
+        for (uint32_t octave = 0; octave < m_Settings.Octaves; octave++)
+        {
+            value += ValueNoise(x, z, octave) * amplitude;
+            totalAmplitude += amplitude;
+            amplitude *= 0.5f;
+            x *= 2.0f;
+            z *= 2.0f;
+        }
+
+        const float normalized = totalAmplitude > 0.0f ? value / totalAmplitude : 0.0f;
+        return m_Settings.BaseHeight + static_cast<int32_t>(normalized * static_cast<float>(m_Settings.HeightRange));
+    }
+
+    void WorldGenerator::Generate(Chunk& chunk, const glm::ivec3& chunkCoord) const
+    {
+        constexpr int32_t dirtDepth = 3;
+        const glm::ivec3 origin = chunkCoord * Chunk::SIZE;
+
+        chunk.Fill(Voxels::AIR);
+        for (int32_t z = 0; z < Chunk::SIZE; z++)
+        {
+            for (int32_t x = 0; x < Chunk::SIZE; x++)
+            {
+                const int32_t height = GetHeight(origin.x + x, origin.z + z);
+                const bool beach = height <= m_Settings.SeaLevel;
+                const int32_t top = std::min(height - origin.y, Chunk::SIZE - 1);
+
+                for (int32_t y = 0; y <= top; y++)
+                {
+                    const int32_t depth = height - (origin.y + y);
+                    VoxelId voxel = Voxels::STONE;
+                    if (depth == 0)
+                        voxel = beach ? Voxels::SAND : Voxels::GRASS;
+                    else if (depth <= dirtDepth)
+                        voxel = beach ? Voxels::SAND : Voxels::DIRT;
+                    chunk.Set(x, y, z, voxel);
+                }
+            }
+        }
+    }
+}
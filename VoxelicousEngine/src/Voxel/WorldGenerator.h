@@ -0,0 +1,38 @@
+#pragma once
+
+#include "Chunk.h"
+
+namespace VoxelicousEngine
+{
+    struct WorldGeneratorSettings
+    {
+        uint32_t Seed = 1337;
+        // Terrain height in voxels is BaseHeight plus up to HeightRange
+        int32_t BaseHeight = 8;
+        int32_t HeightRange = 40;
+        int32_t SeaLevel = 14;
+        float Frequency = 1.0f / 96.0f;
+        uint32_t Octaves = 4;
+    };
+
+    // Deterministic heightmap terrain: fractal value noise with grass on top of a few layers of dirt
+    // over stone, and sand along the sea level. Y is up in voxel space.
+    class WorldGenerator
+    {
+    public:
+        explicit WorldGenerator(const WorldGeneratorSettings& settings = {}) : m_Settings{settings}
+        {
+        }
+
+        int32_t GetHeight(int32_t worldX, int32_t worldZ) const;
+        // Fills a chunk completely; safe to call for different chunks from several threads
+        void Generate(Chunk& chunk, const glm::ivec3& chunkCoord) const;
+
+        const WorldGeneratorSettings& GetSettings() const { return m_Settings; }
+
+    private:
+        float ValueNoise(float x, float z, uint32_t octave) const;
+
+        WorldGeneratorSettings m_Settings;
+    };
+}
@@ -1,8 +1,11 @@
 #version 460 core
+#extension GL_EXT_nonuniform_qualifier : require
 
 layout (location = 0) in vec3 fragColor;
 layout (location = 1) in vec3 fragPositionWorld;
 layout (location = 2) in vec3 fragNormalWorld;
+layout (location = 3) flat in uint fragMaterialIndex;
+layout (location = 4) in vec3 fragPositionObject;
 
 layout (location = 0) out vec4 outColor;
 
@@ -14,9 +17,16 @@ layout (set = 0, binding = 0) uniform GlobalUbo{
     vec4 lightColor;
 } ubo;
 
-layout (push_constant) uniform Push{
-    mat4 modelMatrix;
-} push;
+// BindlessRegistry's texture array, every material texture is a TextureArray
+layout (set = 1, binding = 0) uniform sampler2DArray bindlessTextures[];
+
+// Voxels have no UVs, each face is mapped by projecting the object-space position (-1 to 1) onto its plane
+vec2 faceUv(vec3 position) {
+    vec3 faceNormal = abs(cross(dFdx(position), dFdy(position)));
+    vec2 planar = faceNormal.x >= max(faceNormal.y, faceNormal.z) ? position.zy
+        : faceNormal.y >= faceNormal.z ? position.xz : position.xy;
+    return planar * 0.5 + 0.5;
+}
 
 void main() {
     vec3 directionToLight = ubo.lightPosition - fragPositionWorld;
@@ -26,5 +36,17 @@ void main() {
     vec3 ambientLight = ubo.ambientLightColor.xyz * ubo.ambientLightColor.w;
     vec3 diffuseLight = lightColor * max(dot(normalize(fragNormalWorld), normalize(directionToLight)), 0);
     
-    outColor = vec4(fragColor, 1.0);
+    // Derivatives must be taken outside the material branch
+    vec2 uv = faceUv(fragPositionObject);
+    vec2 uvDx = dFdx(uv);
+    vec2 uvDy = dFdy(uv);
+
+    // See BindlessRegistry::MakeMaterialIndex, material 0 keeps the vertex colour
+    vec3 color = fragColor;
+    if (fragMaterialIndex != 0u) {
+        uint textureIndex = (fragMaterialIndex >> 16) - 1u;
+        float layer = float(fragMaterialIndex & 0xFFFFu);
+        color = textureGrad(bindlessTextures[nonuniformEXT(textureIndex)], vec3(uv, layer), uvDx, uvDy).rgb;
+    }
+    outColor = vec4(color, 1.0);
 }
\ No newline at end of file
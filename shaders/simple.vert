@@ -8,6 +8,8 @@ layout (location = 3) in vec2 uv;
 layout (location = 0) out vec3 fragColor;
 layout (location = 1) out vec3 fragPosWorld;
 layout (location = 2) out vec3 fragNormalWorld;
+layout (location = 3) flat out uint fragMaterialIndex;
+layout (location = 4) out vec3 fragPositionObject;
 
 layout (set = 0, binding = 0) uniform GlobalUbo {
     mat4 projection;
@@ -17,14 +19,24 @@ layout (set = 0, binding = 0) uniform GlobalUbo {
     vec4 lightColor;
 } ubo;
 
-layout (push_constant) uniform Push {
+struct ObjectData {
     mat4 modelMatrix;
-} push;
+    vec4 boundingSphere;
+    uint materialIndex;
+};
+
+layout (std430, set = 0, binding = 1) readonly buffer ObjectTable {
+    ObjectData objects[];
+} objectTable;
 
 void main() {
-    vec4 positionWorld = push.modelMatrix * vec4(position, 1.0);
+    // Draws pass the object's table index as firstInstance
+    mat4 modelMatrix = objectTable.objects[gl_InstanceIndex].modelMatrix;
+    vec4 positionWorld = modelMatrix * vec4(position, 1.0);
     gl_Position = ubo.projection * ubo.view * positionWorld;
-    fragNormalWorld = normalize(mat3(push.modelMatrix) * normal);
+    fragNormalWorld = normalize(mat3(modelMatrix) * normal);
     fragPosWorld = positionWorld.xyz;
     fragColor = color;
+    fragMaterialIndex = objectTable.objects[gl_InstanceIndex].materialIndex;
+    fragPositionObject = position;
 }
\ No newline at end of file
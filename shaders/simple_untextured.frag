@@ -0,0 +1,26 @@
+#version 460 core
+
+layout (location = 0) in vec3 fragColor;
+layout (location = 1) in vec3 fragPositionWorld;
+layout (location = 2) in vec3 fragNormalWorld;
+
+layout (location = 0) out vec4 outColor;
+
+layout (set = 0, binding = 0) uniform GlobalUbo{
+    mat4 projection;
+    mat4 view;
+    vec4 ambientLightColor;
+    vec3 lightPosition;
+    vec4 lightColor;
+} ubo;
+
+void main() {
+    vec3 directionToLight = ubo.lightPosition - fragPositionWorld;
+    float attenuation = 1.0 / dot(directionToLight, directionToLight);
+    
+    vec3 lightColor = ubo.lightColor.xyz * ubo.lightColor.w * attenuation;
+    vec3 ambientLight = ubo.ambientLightColor.xyz * ubo.ambientLightColor.w;
+    vec3 diffuseLight = lightColor * max(dot(normalize(fragNormalWorld), normalize(directionToLight)), 0);
+    
+    outColor = vec4(fragColor, 1.0);
+}
\ No newline at end of file